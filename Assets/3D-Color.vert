@@ -4,8 +4,15 @@ in vec4 vColor;
 
 out vec4 fColor;
 
+// Built-in per-frame uniforms
+layout(std140) uniform FrameUniforms
+{
+    mat4 gViewMatrix;
+    mat4 gProjMatrix;
+    mat4 gWorldToProjMatrix;
+};
+
 // Built-in uniforms
-uniform mat4 gWorldToProjMatrix;
 uniform mat4 gObjectToWorldMatrix;
 
 // User-defined uniforms
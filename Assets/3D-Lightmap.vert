@@ -1,12 +1,20 @@
 #version 150
 in vec3 vPos;
 in vec2 vUV1;
+in vec2 vUV2;
 
 out vec2 fUV1;
 out vec2 fUV2;
 
+// Built-in per-frame uniforms
+layout(std140) uniform FrameUniforms
+{
+    mat4 gViewMatrix;
+    mat4 gProjMatrix;
+    mat4 gWorldToProjMatrix;
+};
+
 // Built-in uniforms
-uniform mat4 gWorldToProjMatrix;
 uniform mat4 gObjectToWorldMatrix;
 
 // User-defined uniforms
@@ -17,8 +25,9 @@ void main()
     // Pass through the UV attribute.
     fUV1 = vUV1;
 
-    // Calculate light map UV by applying offset/scale to texture UV.
-    fUV2 = (vUV1 + uLightmapScaleOffset.zw) * uLightmapScaleOffset.xy;
+    // Calculate light map UV by applying offset/scale to lightmap UV.
+    // If the offset/scale is already baked into the vertex data, this will be an identity transform.
+    fUV2 = (vUV2 + uLightmapScaleOffset.zw) * uLightmapScaleOffset.xy;
 
     // Transform vertex obj->world->view->proj.
     gl_Position = gWorldToProjMatrix * gObjectToWorldMatrix * vec4(vPos, 1.0f);
@@ -3,9 +3,16 @@ in vec3 vPos;
 
 out vec3 fTexCoords;
 
+// Built-in per-frame uniforms
+layout(std140) uniform FrameUniforms
+{
+    mat4 gViewMatrix;
+    mat4 gProjMatrix;
+    mat4 gWorldToProjMatrix;
+};
+
 // Built-in uniforms
 uniform mat4 gObjectToWorldMatrix;
-uniform mat4 gWorldToProjMatrix;
 
 void main()
 {
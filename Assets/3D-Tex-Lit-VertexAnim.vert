@@ -0,0 +1,60 @@
+#version 150
+in vec3 vNormal;
+in vec2 vUV1;
+
+out vec3 fNormal;
+out vec2 fUV1;
+out vec3 fLightDir;
+
+// Built-in per-frame uniforms
+layout(std140) uniform FrameUniforms
+{
+    mat4 gViewMatrix;
+    mat4 gProjMatrix;
+    mat4 gWorldToProjMatrix;
+};
+
+// Built-in uniforms
+uniform mat4 gObjectToWorldMatrix;
+uniform mat4 gWorldToObjectMatrix;
+
+// User-defined uniforms
+uniform vec4 uLightPos = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+// Every vertex pose of the playing vertex animation, as (x, y, z) floats for each vertex.
+uniform samplerBuffer uVertexPoses;
+
+// Where the two poses being blended start in the pose buffer (in floats), and how far to blend between them.
+uniform int uPoseOffsetFrom = 0;
+uniform int uPoseOffsetTo = 0;
+uniform float uPoseT = 0.0f;
+
+vec3 GetPosePosition(int poseOffset)
+{
+    int index = poseOffset + gl_VertexID * 3;
+    return vec3(texelFetch(uVertexPoses, index).r,
+                texelFetch(uVertexPoses, index + 1).r,
+                texelFetch(uVertexPoses, index + 2).r);
+}
+
+void main()
+{
+    // Position comes from blending two poses of the vertex animation, rather than from a vertex attribute.
+    vec3 pos = mix(GetPosePosition(uPoseOffsetFrom), GetPosePosition(uPoseOffsetTo), uPoseT);
+
+    // Pass through UV attribute.
+    fUV1 = vUV1;
+
+    // Pass through normal attribute.
+    fNormal = vNormal;
+
+    // Convert light position to object space, pass to pixel shader.
+    mat4 worldToObjectMatrix = gWorldToObjectMatrix;
+    vec4 localLightPos = worldToObjectMatrix * uLightPos;
+
+    // Pass surface-to-light offset to pixel shader. Do not normalize here for proper interpolation.
+    fLightDir = vec3((localLightPos - vec4(pos, 1.0f)).xyz);
+
+    // Transform position obj->world->view->proj.
+    gl_Position = gWorldToProjMatrix * gObjectToWorldMatrix * vec4(pos, 1.0f);
+}
@@ -7,10 +7,15 @@ out vec3 fNormal;
 out vec2 fUV1;
 out vec3 fLightDir;
 
+// Built-in per-frame uniforms
+layout(std140) uniform FrameUniforms
+{
+    mat4 gViewMatrix;
+    mat4 gProjMatrix;
+    mat4 gWorldToProjMatrix;
+};
+
 // Built-in uniforms
-uniform mat4 gViewMatrix;
-uniform mat4 gProjMatrix;
-uniform mat4 gWorldToProjMatrix;
 uniform mat4 gObjectToWorldMatrix;
 uniform mat4 gWorldToObjectMatrix;
 
@@ -5,6 +5,7 @@ out vec4 oColor;
 
 // Built-in uniforms
 uniform float gAlphaTest;
+uniform vec4 gChromaKey; // Texels of this color are discarded. Alpha of zero means no chroma key.
 
 // User-defined uniforms
 uniform vec4 uColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);
@@ -12,7 +13,12 @@ uniform sampler2D uDiffuse;
 
 void main()
 {
-    vec4 texel = texture(uDiffuse, fUV1) * uColor;
+    vec4 texel = texture(uDiffuse, fUV1);
+
+    // Discard texels that match the chroma key. Allow half a color step of error, so only exact 8-bit matches are discarded.
+    if(gChromaKey.a > 0.0f && all(lessThan(abs(texel.rgb - gChromaKey.rgb), vec3(0.5f / 255.0f)))) { discard; }
+
+    texel *= uColor;
     if(texel.a < gAlphaTest) { discard; }
     oColor = texel;
 }
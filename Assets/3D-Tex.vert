@@ -6,8 +6,15 @@ in vec2 vUV1;
 out vec4 fColor;
 out vec2 fUV1;
 
+// Built-in per-frame uniforms
+layout(std140) uniform FrameUniforms
+{
+    mat4 gViewMatrix;
+    mat4 gProjMatrix;
+    mat4 gWorldToProjMatrix;
+};
+
 // Built-in uniforms
-uniform mat4 gWorldToProjMatrix;
 uniform mat4 gObjectToWorldMatrix;
 
 void main()
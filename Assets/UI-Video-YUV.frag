@@ -0,0 +1,34 @@
+#version 150
+in vec2 fUV1;
+
+out vec4 oColor;
+
+// Built-in uniforms
+uniform vec4 gChromaKey; // Pixels of this color are discarded. Alpha of zero means no chroma key.
+
+// User-defined uniforms
+uniform vec4 uColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+// Video frames are in YUV 4:2:0 format, with each plane stored in its own single-channel texture.
+// The Y (luma) plane is full size, and the U/V (chroma) planes are half size in each dimension.
+uniform sampler2D uDiffuse;
+uniform sampler2D uChromaU;
+uniform sampler2D uChromaV;
+
+void main()
+{
+    // Sample each plane. Video uses "limited range" values, so Y is in 16-235 and U/V are centered on 128.
+    float y = (texture(uDiffuse, fUV1).r - (16.0f / 255.0f)) * (255.0f / 219.0f);
+    float u = texture(uChromaU, fUV1).r - 0.5f;
+    float v = texture(uChromaV, fUV1).r - 0.5f;
+
+    // Convert to RGB using BT.601 coefficients (the same conversion ffmpeg's swscale uses by default).
+    vec3 rgb = clamp(vec3(y + 1.596f * v,
+                          y - 0.391f * u - 0.813f * v,
+                          y + 2.018f * u), 0.0f, 1.0f);
+
+    // Discard pixels that match the chroma key.
+    // Converted colors can be a step or two off from what an exact conversion would give, so allow a bit of error.
+    if(gChromaKey.a > 0.0f && all(lessThan(abs(rgb - gChromaKey.rgb), vec3(2.5f / 255.0f)))) { discard; }
+    oColor = vec4(rgb, 1.0f) * uColor;
+}
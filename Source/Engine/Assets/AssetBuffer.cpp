@@ -0,0 +1,81 @@
+#include "AssetBuffer.h"
+
+#include <cstring>
+
+/*static*/ AssetBuffer AssetBuffer::Own(uint8_t* data, uint32_t size)
+{
+    return AssetBuffer(data, size, true);
+}
+
+/*static*/ AssetBuffer AssetBuffer::Borrow(const uint8_t* data, uint32_t size)
+{
+    return AssetBuffer(data, size, false);
+}
+
+AssetBuffer::AssetBuffer(const uint8_t* data, uint32_t size, bool owned) :
+    mData(data),
+    mSize(data != nullptr ? size : 0),
+    mOwned(owned && data != nullptr)
+{
+
+}
+
+AssetBuffer::~AssetBuffer()
+{
+    if(mOwned)
+    {
+        delete[] mData;
+    }
+}
+
+AssetBuffer::AssetBuffer(AssetBuffer&& other) noexcept :
+    mData(other.mData),
+    mSize(other.mSize),
+    mOwned(other.mOwned)
+{
+    other.mData = nullptr;
+    other.mSize = 0;
+    other.mOwned = false;
+}
+
+AssetBuffer& AssetBuffer::operator=(AssetBuffer&& other) noexcept
+{
+    if(this != &other)
+    {
+        if(mOwned)
+        {
+            delete[] mData;
+        }
+
+        mData = other.mData;
+        mSize = other.mSize;
+        mOwned = other.mOwned;
+
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mOwned = false;
+    }
+    return *this;
+}
+
+uint8_t* AssetBuffer::Release()
+{
+    if(mData == nullptr) { return nullptr; }
+
+    // If we own the data, just hand it over. Otherwise, the caller needs a copy it can own.
+    uint8_t* data = nullptr;
+    if(mOwned)
+    {
+        data = const_cast<uint8_t*>(mData);
+    }
+    else
+    {
+        data = new uint8_t[mSize];
+        memcpy(data, mData, mSize);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+    mOwned = false;
+    return data;
+}
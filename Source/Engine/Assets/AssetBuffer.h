@@ -0,0 +1,49 @@
+//
+// Clark Kromenaker
+//
+// A read-only buffer of asset data, handed to an asset when it loads.
+//
+// The data is either OWNED (e.g. decompressed or read from a loose file - deleted when the buffer goes away)
+// or BORROWED (e.g. a view into a memory mapped Barn file - not deleted, and must not outlive the Barn).
+// Borrowing lets uncompressed Barn assets load with no allocation or copy at all.
+//
+#pragma once
+#include <cstdint>
+
+class AssetBuffer
+{
+public:
+    // Takes ownership of a new'd buffer; it is deleted when this AssetBuffer is destroyed.
+    static AssetBuffer Own(uint8_t* data, uint32_t size);
+
+    // Points to memory owned by someone else; that memory must stay valid while this AssetBuffer is in use.
+    static AssetBuffer Borrow(const uint8_t* data, uint32_t size);
+
+    AssetBuffer() = default;
+    ~AssetBuffer();
+
+    // Move only - copying would either double delete or require a deep copy.
+    AssetBuffer(const AssetBuffer&) = delete;
+    AssetBuffer& operator=(const AssetBuffer&) = delete;
+    AssetBuffer(AssetBuffer&& other) noexcept;
+    AssetBuffer& operator=(AssetBuffer&& other) noexcept;
+
+    const uint8_t* GetData() const { return mData; }
+    uint32_t GetSize() const { return mSize; }
+
+    bool IsValid() const { return mData != nullptr; }
+    bool IsOwned() const { return mOwned; }
+
+    // Gives up the data as a new'd buffer the caller owns. If the data was borrowed, a copy is made.
+    // After calling this, the AssetBuffer is empty.
+    uint8_t* Release();
+
+private:
+    const uint8_t* mData = nullptr;
+    uint32_t mSize = 0;
+
+    // If true, we must delete the data when done with it.
+    bool mOwned = false;
+
+    AssetBuffer(const uint8_t* data, uint32_t size, bool owned);
+};
@@ -1,19 +1,27 @@
 #include "AssetManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include "FileSystem.h"
 #include "Loader.h"
 #include "Localizer.h"
 #include "mstream.h"
+#include "Profiler.h"
 #include "Renderer.h"
 #include "SheepManager.h"
 #include "StringUtil.h"
 #include "ThreadPool.h"
+#include "ThreadUtil.h"
 
 // Includes for all asset types
 #include "Animation.h"
@@ -418,8 +426,138 @@ Shader* AssetManager::LoadShader(const std::string& vertName, const std::string&
     return shader;
 }
 
+void AssetManager::PreloadAssets(const std::vector<std::string>& assetNames, AssetScope scope)
+{
+    TIMER_SCOPED("AssetManager::PreloadAssets");
+
+    // Figure out which assets actually need to be loaded.
+    // The request list is shared with background threads, which may still be starting up after this function returns.
+    auto requests = std::make_shared<std::vector<PreloadRequest>>();
+    requests->reserve(assetNames.size());
+    std::string_set_ci requestedNames;
+    for(const std::string& assetName : assetNames)
+    {
+        // Ignore duplicates.
+        if(assetName.empty() || !requestedNames.insert(assetName).second) { continue; }
+
+        // Set up type-specific load steps, based on the asset's extension.
+        PreloadRequest request;
+        request.name = assetName;
+        bool alreadyLoaded = false;
+        bool supported = VisitCacheForExtension(assetName, [this, scope, &request, &alreadyLoaded](auto* cache) {
+            if(cache->Get(request.name) != nullptr)
+            {
+                alreadyLoaded = true;
+                return;
+            }
+            request.loadOnThread = [this, cache, scope](PreloadRequest& request) {
+                PreloadOnThread(cache, request, scope);
+            };
+            request.finishLoad = [this, cache, scope](PreloadRequest& request) {
+                FinishPreload(cache, request, scope);
+            };
+        });
+        if(!supported)
+        {
+            std::cout << "Can't preload " << assetName << " - unsupported asset type." << std::endl;
+            continue;
+        }
+        if(!alreadyLoaded)
+        {
+            requests->push_back(std::move(request));
+        }
+    }
+    if(requests->empty()) { return; }
+
+    // Pool threads AND this thread pull requests off the list until none remain.
+    // This thread helps out (rather than just waiting), so the batch still completes even if all pool threads are busy.
+    struct PreloadProgress
+    {
+        std::atomic<size_t> nextIndex { 0 };
+        std::atomic<size_t> doneCount { 0 };
+        std::mutex mutex;
+        std::condition_variable condVar;
+    };
+    auto progress = std::make_shared<PreloadProgress>();
+    auto processRequests = [requests, progress]() {
+        size_t index = 0;
+        while((index = progress->nextIndex++) < requests->size())
+        {
+            PreloadRequest& request = (*requests)[index];
+            request.loadOnThread(request);
+
+            // If this was the last one, wake up the requesting thread.
+            if(++progress->doneCount == requests->size())
+            {
+                std::lock_guard<std::mutex> lock(progress->mutex);
+                progress->condVar.notify_all();
+            }
+        }
+    };
+    size_t helperCount = std::min(requests->size() - 1, static_cast<size_t>(ThreadPool::GetThreadCount()));
+    for(size_t i = 0; i < helperCount; ++i)
+    {
+        ThreadPool::AddTask(processRequests);
+    }
+    processRequests();
+
+    // Wait for any requests still being worked on by other threads.
+    {
+        std::unique_lock<std::mutex> lock(progress->mutex);
+        progress->condVar.wait(lock, [&requests, &progress]() {
+            return progress->doneCount == requests->size();
+        });
+    }
+
+    // Finish loading on this thread: cache assets that were loaded in the background, and fully load the rest.
+    for(PreloadRequest& request : *requests)
+    {
+        request.finishLoad(request);
+    }
+}
+
+void AssetManager::QueueTextureUploads(const std::vector<Texture*>& textures)
+{
+    // Textures must be uploaded to the GPU on the main thread.
+    if(ThreadUtil::OnMainThread())
+    {
+        TIMER_SCOPED("AssetManager::QueueTextureUploads");
+        for(Texture* texture : textures)
+        {
+            texture->UploadToGPU();
+        }
+        return;
+    }
+
+    // Otherwise, the main thread takes over these textures when UploadPreloadedTextures is called.
+    std::lock_guard<std::mutex> lock(mPendingTextureUploadsMutex);
+    mPendingTextureUploads.insert(mPendingTextureUploads.end(), textures.begin(), textures.end());
+}
+
+void AssetManager::UploadPreloadedTextures()
+{
+    TIMER_SCOPED("AssetManager::UploadPreloadedTextures");
+    std::vector<Texture*> textures;
+    {
+        std::lock_guard<std::mutex> lock(mPendingTextureUploadsMutex);
+        textures.swap(mPendingTextureUploads);
+    }
+    for(Texture* texture : textures)
+    {
+        texture->UploadToGPU();
+    }
+}
+
 void AssetManager::UnloadAssets(AssetScope scope)
 {
+    // Don't try to upload any textures that are about to be deleted.
+    {
+        std::lock_guard<std::mutex> lock(mPendingTextureUploadsMutex);
+        mPendingTextureUploads.erase(std::remove_if(mPendingTextureUploads.begin(), mPendingTextureUploads.end(), [scope](Texture* texture) {
+            return scope == AssetScope::Global || texture->GetScope() == scope;
+        }), mPendingTextureUploads.end());
+    }
+
     mShaderCache.Unload(scope);
 
     mConfigCache.Unload(scope);
@@ -544,10 +682,16 @@ T* AssetManager::LoadAsset(const std::string& assetName, AssetScope scope, Asset
     //printf("Loading asset %s\n", assetName.c_str());
 
     // Create buffer containing this asset's data. If this fails, the asset doesn't exist, so we can't load it.
-    uint32_t bufferSize = 0;
-    uint8_t* buffer = CreateAssetBuffer(assetName, bufferSize);
-    if(buffer == nullptr) { return nullptr; }
+    AssetBuffer buffer = CreateAssetBuffer(assetName);
+    if(!buffer.IsValid()) { return nullptr; }
 
+    // Create asset from asset buffer.
+    return CreateAsset<T>(assetName, scope, cache, buffer, deleteBuffer);
+}
+
+template<typename T>
+T* AssetManager::CreateAsset(const std::string& assetName, AssetScope scope, AssetCache<T>* cache, AssetBuffer& buffer, bool deleteBuffer)
+{
     // Create asset from asset buffer.
     std::string upperName = StringUtil::ToUpperCopy(assetName);
     T* asset = new T(upperName, scope);
@@ -559,13 +703,7 @@ T* AssetManager::LoadAsset(const std::string& assetName, AssetScope scope, Asset
     }
 
     // Load the asset on the main thread.
-    asset->Load(buffer, bufferSize);
-
-    // Delete the buffer after use (or it'll leak).
-    if(deleteBuffer)
-    {
-        delete[] buffer;
-    }
+    LoadFromBuffer(asset, buffer, deleteBuffer);
     return asset;
 }
 
@@ -610,24 +748,16 @@ T* AssetManager::LoadAssetAsync(const std::string& assetName, AssetScope scope,
 
     // Load in background.
     Loader::AddLoadingTask();
-    ThreadPool::AddTask([this, deleteBuffer](void* arg){
-        T* asset = static_cast<T*>(arg);
+    ThreadPool::AddTask([this, asset, deleteBuffer](){
         //printf("Loading asset: %s\n", asset->GetName().c_str());
 
         // Create buffer containing this asset's data. If this fails, the asset doesn't exist, so we can't load it.
-        uint32_t bufferSize = 0;
-        uint8_t* buffer = CreateAssetBuffer(asset->GetName(), bufferSize);
-        if(buffer == nullptr) { return; }
+        AssetBuffer buffer = CreateAssetBuffer(asset->GetName());
+        if(!buffer.IsValid()) { return; }
 
         // Ok, now we can load the asset's data.
-        asset->Load(buffer, bufferSize);
-
-        // Delete the buffer after use (or it'll leak).
-        if(deleteBuffer)
-        {
-            delete[] buffer;
-        }
-    }, asset, [asset, callback](){
+        LoadFromBuffer(asset, buffer, deleteBuffer);
+    }, [asset, callback](){
         //printf("Loaded asset: %s\n", asset->GetName().c_str());
         if(callback != nullptr)
         {
@@ -641,26 +771,78 @@ T* AssetManager::LoadAssetAsync(const std::string& assetName, AssetScope scope,
     #endif
 }
 
-uint8_t* AssetManager::CreateAssetBuffer(const std::string& assetName, uint32_t& outBufferSize)
+AssetBuffer AssetManager::CreateAssetBuffer(const std::string& assetName)
 {
     // First, see if the asset exists at any asset search path.
     // If so, we load the asset directly from file.
     // Loose files take precedence over packaged barn assets.
+    uint32_t bufferSize = 0;
     std::string assetPath = GetAssetPath(assetName);
     if(!assetPath.empty())
     {
-        return File::ReadIntoBuffer(assetPath, outBufferSize);
+        uint8_t* buffer = File::ReadIntoBuffer(assetPath, bufferSize);
+        return AssetBuffer::Own(buffer, bufferSize);
     }
 
     // If no file to load, we'll get the asset from a barn.
     BarnFile* barn = GetBarnContainingAsset(assetName);
     if(barn != nullptr)
     {
-        return barn->CreateAssetBuffer(assetName, outBufferSize);
+        // Uncompressed assets in memory mapped Barns can be used in-place, no copy required.
+        const uint8_t* data = barn->GetAssetData(assetName, bufferSize);
+        if(data != nullptr)
+        {
+            return AssetBuffer::Borrow(data, bufferSize);
+        }
+
+        // Otherwise, the Barn must create a buffer for us (reading and/or decompressing the data).
+        uint8_t* buffer = barn->CreateAssetBuffer(assetName, bufferSize);
+        return AssetBuffer::Own(buffer, bufferSize);
     }
 
     // Couldn't find this asset!
-    return nullptr;
+    return AssetBuffer();
+}
+
+namespace
+{
+    // Asset types whose Load function accepts an AssetBuffer directly.
+    // These only read from the buffer, so they can load from borrowed Barn memory with no copy.
+    // Any other asset type has a Load(uint8_t*, uint32_t) function that may modify or take ownership of the data.
+    template<typename T> struct LoadsFromAssetBuffer : std::false_type { };
+    template<> struct LoadsFromAssetBuffer<Animation> : std::true_type { };
+    template<> struct LoadsFromAssetBuffer<BSP> : std::true_type { };
+    template<> struct LoadsFromAssetBuffer<Model> : std::true_type { };
+    template<> struct LoadsFromAssetBuffer<SheepScript> : std::true_type { };
+    template<> struct LoadsFromAssetBuffer<Texture> : std::true_type { };
+
+    template<typename T>
+    void LoadAssetFromBuffer(T* asset, AssetBuffer& buffer, bool deleteBuffer, std::true_type)
+    {
+        // The asset only reads from the buffer, so we can pass it on as-is (owned or borrowed).
+        asset->Load(buffer);
+    }
+
+    template<typename T>
+    void LoadAssetFromBuffer(T* asset, AssetBuffer& buffer, bool deleteBuffer, std::false_type)
+    {
+        // The asset needs a buffer it can modify or own. If the data is borrowed, this makes a copy.
+        uint32_t bufferSize = buffer.GetSize();
+        uint8_t* data = buffer.Release();
+        asset->Load(data, bufferSize);
+
+        // Delete the buffer after use (or it'll leak), unless the asset took ownership of it.
+        if(deleteBuffer)
+        {
+            delete[] data;
+        }
+    }
+}
+
+template<typename T>
+void AssetManager::LoadFromBuffer(T* asset, AssetBuffer& buffer, bool deleteBuffer)
+{
+    LoadAssetFromBuffer(asset, buffer, deleteBuffer, LoadsFromAssetBuffer<T>());
 }
 
 template<class T>
@@ -679,3 +861,71 @@ void AssetManager::UnloadAsset(T* asset, std::unordered_map_ci<std::string, T*>*
     // Delete asset.
     delete asset;
 }
+
+namespace
+{
+    // Asset types that can be fully loaded on a background thread during a preload.
+    // Their Load functions only parse data - they don't load other assets, touch the graphics API, or use other shared state.
+    template<typename T> struct LoadsOffMainThread : std::false_type { };
+    template<> struct LoadsOffMainThread<BSPLightmap> : std::true_type { };
+    template<> struct LoadsOffMainThread<Model> : std::true_type { };
+    template<> struct LoadsOffMainThread<Texture> : std::true_type { };
+    template<> struct LoadsOffMainThread<VertexAnimation> : std::true_type { };
+}
+
+template<typename Func>
+bool AssetManager::VisitCacheForExtension(const std::string& assetName, Func func)
+{
+    // Only asset types that are loaded from a buffer they don't take ownership of are supported.
+    std::string extension = Path::GetExtension(assetName);
+    if(StringUtil::EqualsIgnoreCase(extension, "BMP")) { func(&mTextureCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "MOD")) { func(&mModelCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "BSP")) { func(&mBspCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "MUL")) { func(&mBspLightmapCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "ANM")) { func(&mAnimationCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "MOM")) { func(&mMomAnimationCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "YAK")) { func(&mYakCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "ACT")) { func(&mVertexAnimationCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "GAS")) { func(&mGasCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "SEQ")) { func(&mSequenceCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "SHP")) { func(&mSheepCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "NVC")) { func(&mNvcCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "SIF")) { func(&mSifCache); }
+    else if(StringUtil::EqualsIgnoreCase(extension, "SCN")) { func(&mSceneAssetCache); }
+    else { return false; }
+    return true;
+}
+
+template<typename T>
+void AssetManager::PreloadOnThread(AssetCache<T>* cache, PreloadRequest& request, AssetScope scope)
+{
+    // Reading/decompressing asset data is always safe to do on a background thread.
+    request.buffer = CreateAssetBuffer(request.name);
+    if(!request.buffer.IsValid()) { return; }
+
+    // Some asset types can also be loaded here. Caching is left for the requesting thread.
+    if(LoadsOffMainThread<T>::value)
+    {
+        T* asset = new T(StringUtil::ToUpperCopy(request.name), scope);
+        LoadFromBuffer(asset, request.buffer, true);
+        request.asset = asset;
+    }
+}
+
+template<typename T>
+void AssetManager::FinishPreload(AssetCache<T>* cache, PreloadRequest& request, AssetScope scope)
+{
+    // Asset was already loaded on a background thread - just needs to be cached.
+    if(request.asset != nullptr)
+    {
+        cache->Set(request.name, static_cast<T*>(request.asset));
+        return;
+    }
+
+    // Otherwise, load from the buffer created on the background thread.
+    // Something else may have loaded the asset in the meantime; don't load it twice.
+    if(request.buffer.IsValid() && cache->Get(request.name) == nullptr)
+    {
+        request.asset = CreateAsset<T>(request.name, scope, cache, request.buffer);
+    }
+}
@@ -6,10 +6,12 @@
 #pragma once
 #include <functional>
 #include <initializer_list>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "Asset.h"
+#include "AssetBuffer.h"
 #include "AssetCache.h"
 #include "BarnFile.h"
 #include "StringUtil.h"
@@ -100,6 +102,21 @@ public:
     Shader* LoadShader(const std::string& name);
     Shader* LoadShader(const std::string& vertName, const std::string& fragName);
 
+    // Preloading Assets
+    // Loads a batch of assets, fanning decompression (and parsing, for asset types that allow it) across the thread pool.
+    // Afterwards, the assets are cached, so the usual Load functions return them without doing any work.
+    // Asset type is determined from each name's extension.
+    void PreloadAssets(const std::vector<std::string>& assetNames, AssetScope scope = AssetScope::Global);
+
+    // Preloading doesn't upload textures to the GPU, since callers often modify them after loading (e.g. LoadSceneTexture).
+    // Once a caller is completely done with a batch of textures, it hands them off here to be uploaded in one pass.
+    // On the main thread, they're uploaded right away. On other threads (e.g. the Loader), they wait for UploadPreloadedTextures.
+    void QueueTextureUploads(const std::vector<Texture*>& textures);
+
+    // Uploads textures queued by other threads to the GPU. Must be called on the main thread.
+    // Only call this once the threads that queued textures are done loading (e.g. when the Loader finishes).
+    void UploadPreloadedTextures();
+
     // Unloading Assets
     void UnloadAssets(AssetScope scope);
 
@@ -150,6 +167,10 @@ private:
 
     AssetCache<Shader> mShaderCache;
 
+    // Textures queued for upload off the main thread, waiting to be uploaded to the GPU.
+    std::vector<Texture*> mPendingTextureUploads;
+    std::mutex mPendingTextureUploadsMutex;
+
     // Retrieve a barn bundle by name, or by contained asset.
     BarnFile* GetBarn(const std::string& barnName);
     BarnFile* GetBarnContainingAsset(const std::string& assetName);
@@ -163,7 +184,35 @@ private:
     template<typename T> T* LoadAsset(const std::string& name, AssetScope scope, AssetCache<T>* cache, bool deleteBuffer = true);
     template<typename T> T* LoadAssetAsync(const std::string& name, AssetScope scope, AssetCache<T>* cache, bool deleteBuffer = true, std::function<void(T*)> callback = nullptr);
 
-    uint8_t* CreateAssetBuffer(const std::string& assetName, uint32_t& outBufferSize);
+    // Creates an asset from an already created asset buffer, adding it to the cache (if any).
+    template<typename T> T* CreateAsset(const std::string& name, AssetScope scope, AssetCache<T>* cache, AssetBuffer& buffer, bool deleteBuffer = true);
+
+    // An asset being preloaded as part of a batch.
+    struct PreloadRequest
+    {
+        // Name of the asset (also the cache key).
+        std::string name;
+
+        // Type-specific load steps: one done on a background thread, the other on the thread that requested the preload.
+        std::function<void(PreloadRequest&)> loadOnThread;
+        std::function<void(PreloadRequest&)> finishLoad;
+
+        // The asset's data, created on a background thread.
+        AssetBuffer buffer;
+
+        // If the asset type can be loaded on a background thread, this is the loaded asset.
+        Asset* asset = nullptr;
+    };
+    template<typename Func> bool VisitCacheForExtension(const std::string& assetName, Func func);
+    template<typename T> void PreloadOnThread(AssetCache<T>* cache, PreloadRequest& request, AssetScope scope);
+    template<typename T> void FinishPreload(AssetCache<T>* cache, PreloadRequest& request, AssetScope scope);
+
+    // Creates a buffer containing an asset's data. Uncompressed Barn assets are borrowed directly from the Barn when possible.
+    AssetBuffer CreateAssetBuffer(const std::string& assetName);
+
+    // Passes an asset buffer to an asset's load function.
+    // Some asset types load directly from a (possibly borrowed) AssetBuffer; others require a mutable buffer they can own.
+    template<typename T> void LoadFromBuffer(T* asset, AssetBuffer& buffer, bool deleteBuffer);
 
     template<class T> void UnloadAsset(T* asset, std::unordered_map_ci<std::string, T*>* cache = nullptr);
 };
@@ -1,5 +1,6 @@
 #include "BarnFile.h"
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -7,17 +8,28 @@
 #include "minilzo.h"
 #include "zlib.h"
 
+#include "AssetBuffer.h"
 #include "FileSystem.h"
 #include "SheepScript.h"
 #include "Texture.h"
 
 BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriority) :
     mName(filePath),
-    mSearchPriority(searchPriority),
-    mReader(filePath.c_str())
+    mSearchPriority(searchPriority)
 {
+    // Prefer mapping the whole file into memory. This allows any number of threads to extract assets at once.
+    // If mapping fails for some reason (e.g. out of address space), fall back on reading via a file stream.
+    if(mMappedFile.Open(filePath))
+    {
+        mReader.reset(new BinaryReader(mMappedFile.GetData(), mMappedFile.GetSize()));
+    }
+    else
+    {
+        mReader.reset(new BinaryReader(filePath.c_str()));
+    }
+
     // Make sure we can actually read this file.
-    if(!mReader.OK())
+    if(!mReader->OK())
     {
         std::cout << "Can't read barn file at " << filePath << std::endl;
         return;
@@ -25,8 +37,8 @@ BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriorit
 
     // 8 bytes: two specific 4-byte ints must appear at the beginning of the file.
     // In text form, this is a string "GK3!Barn".
-    uint32_t gameIdentifier = mReader.ReadUInt();
-    uint32_t barnIdentifier = mReader.ReadUInt();
+    uint32_t gameIdentifier = mReader->ReadUInt();
+    uint32_t barnIdentifier = mReader->ReadUInt();
     if(gameIdentifier != kGameIdentifier && barnIdentifier != kBarnIdentifier)
     {
         std::cout << "Invalid file type!" << std::endl;
@@ -36,64 +48,64 @@ BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriorit
     // 4-bytes: unknown constant value (65536)
     // 4-bytes: unknown constant value (65536)
     // 4-bytes: appears to be file size, or size of assets in BRN bundle.
-    mReader.Skip(12);
+    mReader->Skip(12);
 
     // This value indicates the offset past the file header data to what I'd
     // call the "table of contents" or "toc".
-    uint32_t tocOffset = mReader.ReadUInt();
+    uint32_t tocOffset = mReader->ReadUInt();
 
     // This additional header data can be read in if desired, but it
     // isn't really relevant to the file functionality.
     /*
     {
         // 4-bytes: EXE/Content build # (119 in both cases)
-        mReader.ReadUInt();
-        mReader.ReadUInt();
+        mReader->ReadUInt();
+        mReader->ReadUInt();
 
         // 4-bytes: unknown value
-        mReader.ReadUInt();
+        mReader->ReadUInt();
 
         // Two dates, 2-bytes per element.
         // The dates are both on the same day, just a few minutes apart.
         // Maybe like a build start/end time for the bundles?
         short year, month, day, hour, minute, second;
-        year = mReader.ReadShort();
-        month = mReader.ReadShort();
-        mReader.ReadShort(); // unknown value
-        day = mReader.ReadShort();
-        hour = mReader.ReadShort();
-        minute = mReader.ReadShort();
-        second = mReader.ReadShort();
+        year = mReader->ReadShort();
+        month = mReader->ReadShort();
+        mReader->ReadShort(); // unknown value
+        day = mReader->ReadShort();
+        hour = mReader->ReadShort();
+        minute = mReader->ReadShort();
+        second = mReader->ReadShort();
         cout << year << "/" << month << "/" << day << ", " << hour << ":" << minute << ":" << second << endl;
 
         // 2-bytes: unknown variable value.
-        mReader.ReadShort();
-
-        year = mReader.ReadShort();
-        month = mReader.ReadShort();
-        mReader.ReadShort(); // unknown value
-        day = mReader.ReadShort();
-        hour = mReader.ReadShort();
-        minute = mReader.ReadShort();
-        second = mReader.ReadShort();
+        mReader->ReadShort();
+
+        year = mReader->ReadShort();
+        month = mReader->ReadShort();
+        mReader->ReadShort(); // unknown value
+        day = mReader->ReadShort();
+        hour = mReader->ReadShort();
+        minute = mReader->ReadShort();
+        second = mReader->ReadShort();
         cout << year << "/" << month << "/" << day << ", " << hour << ":" << minute << ":" << second << endl;
 
         // 2-bytes: unknown variable value.
-        mReader.ReadShort();
+        mReader->ReadShort();
 
         // Copyright notice
         char copyright[65];
-        mReader.Read(copyright, 64);
+        mReader->Read(copyright, 64);
         copyright[64] = '\0';
         cout << copyright << endl;
     }
     */
 
     // Seek to table of contents offset.
-    mReader.Seek(tocOffset);
+    mReader->Seek(tocOffset);
 
     // First value in TOC is number of TOC entries.
-    uint32_t tocEntryCount = mReader.ReadUInt();
+    uint32_t tocEntryCount = mReader->ReadUInt();
 
     // Each toc entry will specify a header offset and a data offset.
     std::vector<uint32_t> headerOffsets;
@@ -108,14 +120,14 @@ BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriorit
         // The type is either "DDir" or "Data".
         // DDir specifies a directory of assets.
         // Data specifies file offset to start reading actual data.
-        uint32_t type = mReader.ReadUInt();
+        uint32_t type = mReader->ReadUInt();
 
         // Some unknown values.
-        mReader.Skip(16);
+        mReader->Skip(16);
 
         // Read header and data offsets.
-        uint32_t headerOffset = mReader.ReadUInt();
-        uint32_t dataOffset = mReader.ReadUInt();
+        uint32_t headerOffset = mReader->ReadUInt();
+        uint32_t dataOffset = mReader->ReadUInt();
 
         // For DDir, we'll save the offsets so we can iterate over them below.
         // For Data, we'll just save the data offset value.
@@ -135,22 +147,22 @@ BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriorit
     mReferencedBarns.resize(tocEntryCount);
     for(size_t i = 0; i < headerOffsets.size(); ++i)
     {
-        mReader.Seek(headerOffsets[i]);
+        mReader->Seek(headerOffsets[i]);
 
         // The name of the Barn file for these assets. NOTE that it appears
         // a Barn file can contain "pointers" to assets in other Barn files.
         // If this name is empty, it means the asset is contained within THIS Barn file.
         // However, if the name isn't empty, it means the asset is in another Barn file.
-        mReader.ReadString(32, mReferencedBarns[i]);
+        mReader->ReadString(32, mReferencedBarns[i]);
         bool isPointer = !mReferencedBarns[i].empty();
 
         // 4 bytes - unknown value
         // 40 bytes - a human-readable description for this Barn file
         // 4 bytes - unknown value
-        mReader.Skip(48);
+        mReader->Skip(48);
 
-        uint32_t numAssets = mReader.ReadUInt();
-        mReader.Seek(dataOffsets[i]);
+        uint32_t numAssets = mReader->ReadUInt();
+        mReader->Seek(dataOffsets[i]);
         for(uint32_t j = 0; j < numAssets; ++j)
         {
             BarnAsset asset;
@@ -164,16 +176,16 @@ BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriorit
 
             // Asset size, in bytes.
             // But we need to read compression type before we know whether this is compressed or uncompressed size.
-            asset.size = mReader.ReadUInt();
+            asset.size = mReader->ReadUInt();
 
             // Read in the asset offset. This is the offset from the start of the data section.
-            asset.offset = mReader.ReadUInt();
+            asset.offset = mReader->ReadUInt();
 
             // Unknown values.
-            mReader.Skip(5);
+            mReader->Skip(5);
 
             // Read in compression type.
-            asset.compressionType = static_cast<CompressionType>(mReader.ReadByte());
+            asset.compressionType = static_cast<CompressionType>(mReader->ReadByte());
 
             // Compression type 3 should just be treated as type none.
             // Not sure if type 3 is actually different in some way?
@@ -183,14 +195,20 @@ BarnFile::BarnFile(const std::string& filePath, BarnSearchPriority searchPriorit
             }
 
             // Read in asset name.
-            mReader.ReadString8(asset.name);
-            mReader.Skip(1); // null terminator is also present - skip it
+            mReader->ReadString8(asset.name);
+            mReader->Skip(1); // null terminator is also present - skip it
             //std::cout << asset.name << ", " << (int)asset.compressionType << ", " << asset.compressedSize << ", " << asset.uncompressedSize << std::endl;
 
             // Map asset name to asset for fast lookup later.
             mAssetMap[asset.name] = asset;
         }
     }
+
+    // When memory mapped, all further reads go directly against the mapped memory.
+    if(mMappedFile.IsOpen())
+    {
+        mReader.reset();
+    }
 }
 
 BarnAsset* BarnFile::GetAsset(const std::string& assetName)
@@ -203,6 +221,31 @@ BarnAsset* BarnFile::GetAsset(const std::string& assetName)
     return nullptr;
 }
 
+const uint8_t* BarnFile::GetAssetData(const std::string& assetName, uint32_t& outDataSize)
+{
+    outDataSize = 0;
+
+    // Only possible if the Barn is memory mapped - otherwise, there's no persistent memory to point into.
+    if(!mMappedFile.IsOpen()) { return nullptr; }
+
+    // Data must be present in this Barn and uncompressed to be used directly.
+    BarnAsset* asset = GetAsset(assetName);
+    if(asset == nullptr || asset->IsPointer() || asset->compressionType != CompressionType::None)
+    {
+        return nullptr;
+    }
+
+    // Make sure the asset's data actually fits within the file (guards against truncated/corrupt Barns).
+    uint32_t dataStart = mDataOffset + asset->offset;
+    if(dataStart > mMappedFile.GetSize() || asset->size > mMappedFile.GetSize() - dataStart)
+    {
+        std::cout << "Asset " << asset->name << " extends past end of Barn file!" << std::endl;
+        return nullptr;
+    }
+    outDataSize = asset->size;
+    return mMappedFile.GetData() + dataStart;
+}
+
 uint8_t* BarnFile::CreateAssetBuffer(const std::string& assetName, uint32_t& outBufferSize)
 {
     // Use a sane default value for this.
@@ -226,139 +269,88 @@ uint8_t* BarnFile::CreateAssetBuffer(const std::string& assetName, uint32_t& out
     // If this is an uncompressed asset, we can simply read the bytes and be done with it - easy.
     if(asset->compressionType == CompressionType::None)
     {
+        // When memory mapped, copy straight out of the mapping. No lock or seek required.
+        if(mMappedFile.IsOpen())
+        {
+            uint32_t dataSize = 0;
+            const uint8_t* data = GetAssetData(assetName, dataSize);
+            if(data == nullptr) { return nullptr; }
+
+            uint8_t* buffer = new uint8_t[dataSize];
+            memcpy(buffer, data, dataSize);
+            outBufferSize = dataSize;
+            return buffer;
+        }
+
         // Allocate buffer to hold asset data.
         uint8_t* buffer = new uint8_t[asset->size];
         outBufferSize = asset->size;
 
         // Seek to the data and read into the buffer. Since it's already uncompressed, we're done!
         mReaderMutex.lock();
-        mReader.Seek(mDataOffset + asset->offset);
-        mReader.Read(buffer, asset->size);
+        mReader->Seek(mDataOffset + asset->offset);
+        mReader->Read(buffer, asset->size);
         mReaderMutex.unlock();
         return buffer;
     }
 
-    // Otherwise, data is compressed - we need to read in compressed data, and then use an appropriate decompressor.
-    // Create buffer to hold compressed data.
-    uint8_t* compressedBuffer = new uint8_t[asset->size];
-
-    // Read compressed data into a buffer.
-    // Also grab the decompressed asset size while we're there.
-    mReaderMutex.lock();
-    mReader.Seek(mDataOffset + asset->offset);
-    outBufferSize = mReader.ReadUInt();
-    mReader.Skip(4);
-    uint32_t readCount = mReader.Read(compressedBuffer, asset->size);
-    mReaderMutex.unlock();
-
-    // Make sure we read what we were expecting.
-    // The "-1" case can happen when reading the last file in the barn, but asset is still valid.
-    if(readCount != asset->size && readCount != asset->size - 1)
-    {
-        std::cout << "Didn't read desired number of bytes." << std::endl;
-        delete[] compressedBuffer;
-        return nullptr;
-    }
-
-    // Create buffer for uncompressed data.
-    uint8_t* buffer = new uint8_t[outBufferSize];
-
-    // How we decompress the data depends on the compression type...
-    if(asset->compressionType == CompressionType::Zlib)
+    // Otherwise, data is compressed - we need to get at the compressed data, and then use an appropriate decompressor.
+    // The compressed data is preceded by the decompressed size and an unknown 4-byte value.
+    const uint32_t kCompressedHeaderSize = 8;
+    const uint8_t* compressedData = nullptr;
+    uint32_t compressedSize = asset->size;
+    uint8_t* compressedBuffer = nullptr;
+    if(mMappedFile.IsOpen())
     {
-        // Create params object.
-        z_stream strm {};
-        strm.next_in = compressedBuffer;
-        strm.avail_in = asset->size;
-        strm.next_out = buffer;
-        strm.avail_out = outBufferSize;
-        strm.zalloc = Z_NULL;
-        strm.zfree = Z_NULL;
-        strm.opaque = Z_NULL;
-
-        // Make sure zlib is initialized for "inflation".
-        int result = inflateInit(&strm);
-        if(result != Z_OK)
-        {
-            std::cout << "Error when calling inflateInit: " << result << std::endl;
-            delete[] compressedBuffer;
-            delete[] buffer;
-            return nullptr;
-        }
-
-        // Inflate the data!
-        result = inflate(&strm, Z_FINISH);
-        if(result != Z_STREAM_END)
+        // Make sure the compressed header is actually within the file.
+        uint32_t dataStart = mDataOffset + asset->offset;
+        if(dataStart > mMappedFile.GetSize() || mMappedFile.GetSize() - dataStart < kCompressedHeaderSize)
         {
-            std::cout << "Inflate didn't inflate entire stream, or an error occurred: " << result << std::endl;
-            delete[] compressedBuffer;
-            delete[] buffer;
+            std::cout << "Asset " << asset->name << " extends past end of Barn file!" << std::endl;
             return nullptr;
         }
+        memcpy(&outBufferSize, mMappedFile.GetData() + dataStart, sizeof(uint32_t));
 
-        // Uninit zlib.
-        result = inflateEnd(&strm);
-        if(result != Z_OK)
+        // The last asset in the Barn can claim one more byte than the file actually has - clamp to what's available.
+        compressedData = mMappedFile.GetData() + dataStart + kCompressedHeaderSize;
+        uint32_t availableSize = mMappedFile.GetSize() - dataStart - kCompressedHeaderSize;
+        if(compressedSize > availableSize)
         {
-            std::cout << "Error while ending inflate: " << result << std::endl;
-            delete[] compressedBuffer;
-            delete[] buffer;
-            return nullptr;
+            compressedSize = availableSize;
         }
     }
-    else if(asset->compressionType == CompressionType::Lzo)
+    else
     {
-        // Make sure LZO library is initialized.
-        static bool initLzo = false;
-        if(!initLzo)
-        {
-            int initResult = lzo_init();
-            if(initResult == LZO_E_OK)
-            {
-                initLzo = true;
-            }
-            else
-            {
-                std::cout << "Failed to init LZO!" << std::endl;
-                delete[] compressedBuffer;
-                delete[] buffer;
-                return nullptr;
-            }
-        }
-
-        // Decompress using LZO library. GK3 data appears to be compressed with lzo1x.
-        //std::cout << asset->name << ": decompressing " << asset->compressedSize << " bytes to a buffer of size " << bufferSize << std::endl;
-        lzo_bytep compressedPtr = static_cast<lzo_bytep>(compressedBuffer);
-        lzo_bytep bufferPtr = static_cast<lzo_bytep>(buffer);
-        lzo_uint bufferSize = 0;
-        int result = lzo1x_decompress(compressedPtr, asset->size, bufferPtr, &bufferSize, nullptr);
-
-        // For some reason *most* GK3 data decompresses with result of LZO_E_INPUT_NOT_CONSUMED.
-        // This still works OK. It may indicate that "compressedSize" passed is larger than the compressed data.
-        // I'll let it slide for now...but it might indicate an earlier read error, or I'm missing something somewhere.
-        if(result != LZO_E_OK && result != LZO_E_INPUT_NOT_CONSUMED)
-        {
-            std::cout << "Error during LZO decompress: " << result << std::endl;
-            delete[] compressedBuffer;
-            delete[] buffer;
-            return nullptr;
-        }
+        // Create buffer to hold compressed data.
+        compressedBuffer = new uint8_t[asset->size];
 
-        // Set buffer size for caller to use.
-        outBufferSize = static_cast<uint32_t>(bufferSize);
+        // Read compressed data into a buffer.
+        // Also grab the decompressed asset size while we're there.
+        mReaderMutex.lock();
+        mReader->Seek(mDataOffset + asset->offset);
+        outBufferSize = mReader->ReadUInt();
+        mReader->Skip(4);
+        compressedSize = mReader->Read(compressedBuffer, asset->size);
+        mReaderMutex.unlock();
+        compressedData = compressedBuffer;
     }
-    else
+
+    // Make sure we read what we were expecting.
+    // The "-1" case can happen when reading the last file in the barn, but asset is still valid.
+    if(compressedSize != asset->size && compressedSize != asset->size - 1)
     {
-        std::cout << "Asset " << asset->name << " has invalid compression type " << (int)asset->compressionType << std::endl;
+        std::cout << "Didn't read desired number of bytes." << std::endl;
         delete[] compressedBuffer;
-        delete[] buffer;
         return nullptr;
     }
 
-    // Delete compressed data buffer.
+    // Decompress into a new buffer. Compressed data buffer (if any) is no longer needed after that.
+    uint8_t* buffer = Decompress(*asset, compressedData, compressedSize, outBufferSize);
     delete[] compressedBuffer;
-
-    // Return decompressed buffer.
+    if(buffer == nullptr)
+    {
+        outBufferSize = 0;
+    }
     return buffer;
 }
 
@@ -416,7 +408,7 @@ bool BarnFile::WriteToFile(const std::string& assetName, const std::string& outp
         if(assetName.find(".BMP") != std::string::npos)
         {
             Texture tex(assetName, AssetScope::Manual);
-            tex.Load(assetData, bufferSize);
+            tex.Load(AssetBuffer::Borrow(assetData, bufferSize));
             tex.WriteToFile(outputPath);
             result = true;
         }
@@ -425,7 +417,7 @@ bool BarnFile::WriteToFile(const std::string& assetName, const std::string& outp
         {
             // If sheep asset is compiled, we need to decompile it to get any useful data.
             SheepScript script(assetName, AssetScope::Manual);
-            script.Load(assetData, bufferSize);
+            script.Load(AssetBuffer::Borrow(assetData, bufferSize));
             script.Decompile(outputPath);
             result = true;
         }
@@ -491,3 +483,93 @@ void BarnFile::OutputAssetList() const
         std::cout << entry.second.name << " - " << static_cast<int>(entry.second.compressionType) << " - " << entry.second.size << std::endl;
     }
 }
+
+uint8_t* BarnFile::Decompress(const BarnAsset& asset, const uint8_t* compressedData, uint32_t compressedSize, uint32_t& inOutBufferSize)
+{
+    // Create buffer for uncompressed data.
+    uint8_t* buffer = new uint8_t[inOutBufferSize];
+
+    // How we decompress the data depends on the compression type...
+    if(asset.compressionType == CompressionType::Zlib)
+    {
+        // Create params object.
+        // zlib doesn't modify input data, but its API isn't const-correct unless ZLIB_CONST is defined.
+        z_stream strm {};
+        strm.next_in = const_cast<Bytef*>(compressedData);
+        strm.avail_in = compressedSize;
+        strm.next_out = buffer;
+        strm.avail_out = inOutBufferSize;
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+
+        // Make sure zlib is initialized for "inflation".
+        int result = inflateInit(&strm);
+        if(result != Z_OK)
+        {
+            std::cout << "Error when calling inflateInit: " << result << std::endl;
+            delete[] buffer;
+            return nullptr;
+        }
+
+        // Inflate the data!
+        result = inflate(&strm, Z_FINISH);
+        if(result != Z_STREAM_END)
+        {
+            std::cout << "Inflate didn't inflate entire stream, or an error occurred: " << result << std::endl;
+            inflateEnd(&strm);
+            delete[] buffer;
+            return nullptr;
+        }
+
+        // Uninit zlib.
+        result = inflateEnd(&strm);
+        if(result != Z_OK)
+        {
+            std::cout << "Error while ending inflate: " << result << std::endl;
+            delete[] buffer;
+            return nullptr;
+        }
+    }
+    else if(asset.compressionType == CompressionType::Lzo)
+    {
+        // Make sure LZO library is initialized.
+        // Multiple threads may decompress at once, so guard this with a function-local static (thread-safe init).
+        static const bool initLzo = (lzo_init() == LZO_E_OK);
+        if(!initLzo)
+        {
+            std::cout << "Failed to init LZO!" << std::endl;
+            delete[] buffer;
+            return nullptr;
+        }
+
+        // Decompress using LZO library. GK3 data appears to be compressed with lzo1x.
+        //std::cout << asset.name << ": decompressing " << compressedSize << " bytes to a buffer of size " << inOutBufferSize << std::endl;
+        lzo_bytep compressedPtr = const_cast<lzo_bytep>(compressedData);
+        lzo_bytep bufferPtr = static_cast<lzo_bytep>(buffer);
+        lzo_uint bufferSize = 0;
+        int result = lzo1x_decompress(compressedPtr, compressedSize, bufferPtr, &bufferSize, nullptr);
+
+        // For some reason *most* GK3 data decompresses with result of LZO_E_INPUT_NOT_CONSUMED.
+        // This still works OK. It may indicate that "compressedSize" passed is larger than the compressed data.
+        // I'll let it slide for now...but it might indicate an earlier read error, or I'm missing something somewhere.
+        if(result != LZO_E_OK && result != LZO_E_INPUT_NOT_CONSUMED)
+        {
+            std::cout << "Error during LZO decompress: " << result << std::endl;
+            delete[] buffer;
+            return nullptr;
+        }
+
+        // Set buffer size for caller to use.
+        inOutBufferSize = static_cast<uint32_t>(bufferSize);
+    }
+    else
+    {
+        std::cout << "Asset " << asset.name << " has invalid compression type " << (int)asset.compressionType << std::endl;
+        delete[] buffer;
+        return nullptr;
+    }
+
+    // Return decompressed buffer.
+    return buffer;
+}
@@ -8,11 +8,13 @@
 //
 #pragma once
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include "BinaryReader.h"
+#include "MemoryMappedFile.h"
 #include "StringUtil.h"
 
 enum class CompressionType
@@ -63,6 +65,13 @@ public:
     // Creates a buffer containing the desired asset. Caller owns the returned buffer.
     uint8_t* CreateAssetBuffer(const std::string& assetName, uint32_t& outBufferSize);
 
+    // Returns a read-only pointer directly into the Barn's memory for the desired asset, or null if that's not possible.
+    // Only works for uncompressed assets in a memory mapped Barn. Pointer is valid for as long as this Barn is loaded.
+    const uint8_t* GetAssetData(const std::string& assetName, uint32_t& outDataSize);
+
+    // If true, the Barn is memory mapped, and assets can be extracted from multiple threads without locking.
+    bool IsMemoryMapped() const { return mMappedFile.IsOpen(); }
+
     // For debugging, write assets to file.
     bool WriteToFile(const std::string& assetName);
     bool WriteToFile(const std::string& assetName, const std::string& outputDir);
@@ -96,9 +105,12 @@ private:
     // Offset within the file to where the data is located.
     uint32_t mDataOffset = 0;
 
-    // Binary reader for extracting data.
+    // The entire Barn file, mapped into memory. Threads can read from this simultaneously, no locking needed.
+    MemoryMappedFile mMappedFile;
+
+    // Binary reader for extracting data, used only if memory mapping the Barn failed.
     // Extraction may occur on multiple threads at once, so a mutex is required to guard access.
-    BinaryReader mReader;
+    std::unique_ptr<BinaryReader> mReader;
     std::mutex mReaderMutex;
 
     // If *this* Barn contains pointers to *other* Barns, this contains the names of those other Barns.
@@ -108,4 +120,7 @@ private:
     // Map of asset name to an asset handle. Assets must be extracted before being used.
     // Asset names are case-insensitive.
     std::string_map_ci<BarnAsset> mAssetMap;
+
+    // Decompresses an asset's compressed data into a new buffer. Caller owns the returned buffer.
+    uint8_t* Decompress(const BarnAsset& asset, const uint8_t* compressedData, uint32_t compressedSize, uint32_t& inOutBufferSize);
 };
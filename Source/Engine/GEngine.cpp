@@ -51,7 +51,7 @@ bool GEngine::Initialize()
 
     // Init threads.
     ThreadUtil::Init();
-    ThreadPool::Init(4);
+    ThreadPool::Init();
 
     // Tell console to log itself to the "Console" report stream.
     gConsole.SetReportStream(&gReportManager.GetReportStream("Console"));
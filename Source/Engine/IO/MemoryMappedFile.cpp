@@ -0,0 +1,104 @@
+#include "MemoryMappedFile.h"
+
+#include "Platform.h"
+
+#if defined(PLATFORM_WINDOWS)
+#include <Windows.h>
+#elif defined(HAVE_UNISTD_H)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    Close();
+}
+
+bool MemoryMappedFile::Open(const std::string& filePath)
+{
+    // Get rid of any previous mapping first.
+    Close();
+
+    #if defined(PLATFORM_WINDOWS)
+    {
+        HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(file == INVALID_HANDLE_VALUE) { return false; }
+
+        // Barn files are well under 4GB, but check anyway - sizes are stored as 32-bit values everywhere.
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > UINT32_MAX)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(mapping == NULL)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // This can fail on 32-bit builds if there isn't enough contiguous address space for the whole file.
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(data == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        mFileHandle = file;
+        mMappingHandle = mapping;
+        mData = static_cast<const uint8_t*>(data);
+        mSize = static_cast<uint32_t>(fileSize.QuadPart);
+        return true;
+    }
+    #elif defined(HAVE_UNISTD_H)
+    {
+        int fd = open(filePath.c_str(), O_RDONLY);
+        if(fd < 0) { return false; }
+
+        struct stat fileStat;
+        if(fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 || static_cast<uint64_t>(fileStat.st_size) > UINT32_MAX)
+        {
+            close(fd);
+            return false;
+        }
+
+        // Once mapped, the file descriptor is no longer needed - the mapping keeps the file alive.
+        void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED) { return false; }
+
+        mData = static_cast<const uint8_t*>(data);
+        mSize = static_cast<uint32_t>(fileStat.st_size);
+        return true;
+    }
+    #else
+    {
+        // No mapping support on this platform - callers should fall back on stream reads.
+        return false;
+    }
+    #endif
+}
+
+void MemoryMappedFile::Close()
+{
+    if(mData == nullptr) { return; }
+
+    #if defined(PLATFORM_WINDOWS)
+    UnmapViewOfFile(mData);
+    CloseHandle(static_cast<HANDLE>(mMappingHandle));
+    CloseHandle(static_cast<HANDLE>(mFileHandle));
+    #elif defined(HAVE_UNISTD_H)
+    munmap(const_cast<uint8_t*>(mData), mSize);
+    #endif
+
+    mData = nullptr;
+    mSize = 0;
+    mFileHandle = nullptr;
+    mMappingHandle = nullptr;
+}
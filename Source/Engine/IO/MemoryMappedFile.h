@@ -0,0 +1,41 @@
+//
+// Clark Kromenaker
+//
+// Maps an entire file into memory as a read-only blob of bytes.
+//
+// Once mapped, any number of threads can read from the data at the same time - no seeking, no locking.
+// The OS pages data in on demand, so mapping a large file is cheap until bytes are actually touched.
+//
+#pragma once
+#include <cstdint>
+#include <string>
+
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile() = default;
+    ~MemoryMappedFile();
+
+    // Mappings can't be copied - only one owner should unmap the memory.
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    // Maps the file at the given path. Returns false if the file can't be opened or mapped.
+    bool Open(const std::string& filePath);
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+
+    const uint8_t* GetData() const { return mData; }
+    uint32_t GetSize() const { return mSize; }
+
+private:
+    // Start of mapped memory, and number of bytes mapped.
+    const uint8_t* mData = nullptr;
+    uint32_t mSize = 0;
+
+    // Platform-specific handles required to unmap later.
+    // On Windows, these are the file and file mapping HANDLEs. Unused elsewhere.
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+};
@@ -0,0 +1,38 @@
+#include "Interpolate.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define INTERPOLATE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define INTERPOLATE_NEON
+#endif
+
+void Interpolate::Linear(const float* a, const float* b, float t, float* out, uint32_t count)
+{
+    // Do four floats at a time with SIMD, if possible. Unaligned loads/stores are used, so arrays needn't be specially aligned.
+    uint32_t i = 0;
+    #if defined(INTERPOLATE_SSE)
+    __m128 tx4 = _mm_set1_ps(t);
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 ax4 = _mm_loadu_ps(a + i);
+        __m128 bx4 = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(out + i, _mm_add_ps(ax4, _mm_mul_ps(_mm_sub_ps(bx4, ax4), tx4)));
+    }
+    #elif defined(INTERPOLATE_NEON)
+    float32x4_t tx4 = vdupq_n_f32(t);
+    for(; i + 4 <= count; i += 4)
+    {
+        float32x4_t ax4 = vld1q_f32(a + i);
+        float32x4_t bx4 = vld1q_f32(b + i);
+        vst1q_f32(out + i, vmlaq_f32(ax4, vsubq_f32(bx4, ax4), tx4));
+    }
+    #endif
+
+    // Do any remaining floats one at a time.
+    for(; i < count; ++i)
+    {
+        out[i] = Linear(a[i], b[i], t);
+    }
+}
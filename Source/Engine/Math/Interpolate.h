@@ -4,6 +4,7 @@
 // Functions related to interpolating between two values in various ways.
 //
 #pragma once
+#include <cstdint>
 
 namespace Interpolate
 {
@@ -13,6 +14,10 @@ namespace Interpolate
         return a + ((b - a) * t);
     }
 
+    // Linearly interpolates "count" floats from two arrays into an output array (which can be the same as either input).
+    // Uses SIMD instructions when available, so this is much faster than interpolating element-by-element.
+    void Linear(const float* a, const float* b, float t, float* out, uint32_t count);
+
     namespace Internal
     {
         inline float Flip(float t) { return 1.0f - t; }
@@ -84,6 +84,10 @@ public:
 
     void SetDirty();
 
+    // Incremented every time this transform (or a parent) changes.
+    // Unlike the dirty flags, this isn't reset when matrices are recalculated, so other systems can use it to tell if the transform changed since they last checked.
+    uint32_t GetChangeCount() const { return mChangeCount; }
+
 protected:
     virtual void CalcLocalPosition() { }
 
@@ -101,6 +105,7 @@ protected:
     // We only recalculate our matrices when we have to. This keeps track of that.
     bool mLocalToWorldDirty = true;
     bool mWorldToLocalDirty = true;
+    uint32_t mChangeCount = 0;
 
     // If we are a child of any other transform, parent is set.
     // If we have any children, they are in the children vector.
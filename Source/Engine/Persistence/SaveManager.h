@@ -41,6 +41,7 @@
 #define PREFS_HARDWARE_RENDERER "Engine\\Hardware"
     #define PREFS_MIPMAPS "Mip Mapping"
     #define PREFS_TRILINEAR_FILTERING "Trilinear Filtering"
+    #define PREFS_GRAPHICS_API "Graphics API"
 
 struct SaveSummary
 {
@@ -0,0 +1,304 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+
+namespace
+{
+    void Combine(const Vector3& min1, const Vector3& max1, const Vector3& min2, const Vector3& max2, Vector3& outMin, Vector3& outMax)
+    {
+        outMin = Vector3(std::min(min1.x, min2.x), std::min(min1.y, min2.y), std::min(min1.z, min2.z));
+        outMax = Vector3(std::max(max1.x, max2.x), std::max(max1.y, max2.y), std::max(max1.z, max2.z));
+    }
+
+    bool Contains(const Vector3& outerMin, const Vector3& outerMax, const Vector3& innerMin, const Vector3& innerMax)
+    {
+        return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && outerMin.z <= innerMin.z &&
+               outerMax.x >= innerMax.x && outerMax.y >= innerMax.y && outerMax.z >= innerMax.z;
+    }
+
+    float GetSurfaceArea(const Vector3& min, const Vector3& max)
+    {
+        Vector3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+}
+
+uint32_t AABBTree::Add(const AABB& aabb, uint32_t objectIndex)
+{
+    uint32_t id = AllocateNode();
+    Node& node = mNodes[id];
+    Vector3 margin(mMargin, mMargin, mMargin);
+    node.min = aabb.GetMin() - margin;
+    node.max = aabb.GetMax() + margin;
+    node.height = 0;
+    node.objectIndex = objectIndex;
+    InsertLeaf(id);
+    return id;
+}
+
+bool AABBTree::Update(uint32_t id, const AABB& aabb)
+{
+    // If the new bounds still fit in the fattened bounds, nothing needs to change.
+    Node& node = mNodes[id];
+    if(Contains(node.min, node.max, aabb.GetMin(), aabb.GetMax())) { return false; }
+
+    // Otherwise, re-insert the object with new fattened bounds.
+    RemoveLeaf(id);
+    Vector3 margin(mMargin, mMargin, mMargin);
+    node.min = aabb.GetMin() - margin;
+    node.max = aabb.GetMax() + margin;
+    InsertLeaf(id);
+    return true;
+}
+
+void AABBTree::Remove(uint32_t id)
+{
+    RemoveLeaf(id);
+    FreeNode(id);
+}
+
+void AABBTree::Clear()
+{
+    mNodes.clear();
+    mRootIndex = kInvalidId;
+    mFreeIndex = kInvalidId;
+}
+
+uint32_t AABBTree::AllocateNode()
+{
+    // Reuse an unused node if possible.
+    uint32_t nodeIndex = mFreeIndex;
+    if(nodeIndex != kInvalidId)
+    {
+        mFreeIndex = mNodes[nodeIndex].parent;
+        mNodes[nodeIndex] = Node();
+    }
+    else
+    {
+        nodeIndex = static_cast<uint32_t>(mNodes.size());
+        mNodes.emplace_back();
+    }
+    return nodeIndex;
+}
+
+void AABBTree::FreeNode(uint32_t nodeIndex)
+{
+    mNodes[nodeIndex] = Node();
+    mNodes[nodeIndex].parent = mFreeIndex;
+    mFreeIndex = nodeIndex;
+}
+
+void AABBTree::InsertLeaf(uint32_t leafIndex)
+{
+    // First leaf becomes the root.
+    if(mRootIndex == kInvalidId)
+    {
+        mRootIndex = leafIndex;
+        mNodes[leafIndex].parent = kInvalidId;
+        return;
+    }
+
+    // Find the best sibling for the new leaf, by walking down the tree and picking the child that results in the least added surface area.
+    Vector3 leafMin = mNodes[leafIndex].min;
+    Vector3 leafMax = mNodes[leafIndex].max;
+    uint32_t siblingIndex = mRootIndex;
+    while(!mNodes[siblingIndex].IsLeaf())
+    {
+        const Node& node = mNodes[siblingIndex];
+        Vector3 combinedMin;
+        Vector3 combinedMax;
+        Combine(node.min, node.max, leafMin, leafMax, combinedMin, combinedMax);
+        float area = GetSurfaceArea(node.min, node.max);
+        float combinedArea = GetSurfaceArea(combinedMin, combinedMax);
+
+        // Cost of making a new parent for this node and the leaf.
+        float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree.
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        // Cost of descending into each child.
+        float childCosts[2];
+        uint32_t children[2] = { node.child1, node.child2 };
+        for(int i = 0; i < 2; ++i)
+        {
+            const Node& child = mNodes[children[i]];
+            Combine(child.min, child.max, leafMin, leafMax, combinedMin, combinedMax);
+            float newArea = GetSurfaceArea(combinedMin, combinedMax);
+            if(child.IsLeaf())
+            {
+                childCosts[i] = newArea + inheritanceCost;
+            }
+            else
+            {
+                childCosts[i] = (newArea - GetSurfaceArea(child.min, child.max)) + inheritanceCost;
+            }
+        }
+
+        // Stop here if that's cheapest. Otherwise, descend into the cheaper child.
+        if(cost < childCosts[0] && cost < childCosts[1]) { break; }
+        siblingIndex = childCosts[0] < childCosts[1] ? children[0] : children[1];
+    }
+
+    // Create a new parent for the sibling and the leaf.
+    uint32_t oldParentIndex = mNodes[siblingIndex].parent;
+    uint32_t newParentIndex = AllocateNode();
+    Node& newParent = mNodes[newParentIndex];
+    newParent.parent = oldParentIndex;
+    Combine(mNodes[siblingIndex].min, mNodes[siblingIndex].max, leafMin, leafMax, newParent.min, newParent.max);
+    newParent.height = mNodes[siblingIndex].height + 1;
+    newParent.child1 = siblingIndex;
+    newParent.child2 = leafIndex;
+    mNodes[siblingIndex].parent = newParentIndex;
+    mNodes[leafIndex].parent = newParentIndex;
+
+    if(oldParentIndex == kInvalidId)
+    {
+        // The sibling was the root.
+        mRootIndex = newParentIndex;
+    }
+    else if(mNodes[oldParentIndex].child1 == siblingIndex)
+    {
+        mNodes[oldParentIndex].child1 = newParentIndex;
+    }
+    else
+    {
+        mNodes[oldParentIndex].child2 = newParentIndex;
+    }
+
+    // Bounds and heights above the new parent have changed.
+    RefitAncestors(oldParentIndex);
+}
+
+void AABBTree::RemoveLeaf(uint32_t leafIndex)
+{
+    if(leafIndex == mRootIndex)
+    {
+        mRootIndex = kInvalidId;
+        return;
+    }
+
+    // The leaf's parent is removed, and the leaf's sibling takes its place.
+    uint32_t parentIndex = mNodes[leafIndex].parent;
+    uint32_t grandparentIndex = mNodes[parentIndex].parent;
+    uint32_t siblingIndex = mNodes[parentIndex].child1 == leafIndex ? mNodes[parentIndex].child2 : mNodes[parentIndex].child1;
+    if(grandparentIndex == kInvalidId)
+    {
+        mRootIndex = siblingIndex;
+        mNodes[siblingIndex].parent = kInvalidId;
+        FreeNode(parentIndex);
+    }
+    else
+    {
+        if(mNodes[grandparentIndex].child1 == parentIndex)
+        {
+            mNodes[grandparentIndex].child1 = siblingIndex;
+        }
+        else
+        {
+            mNodes[grandparentIndex].child2 = siblingIndex;
+        }
+        mNodes[siblingIndex].parent = grandparentIndex;
+        FreeNode(parentIndex);
+        RefitAncestors(grandparentIndex);
+    }
+}
+
+void AABBTree::RefitAncestors(uint32_t nodeIndex)
+{
+    // Walk up the tree, rebalancing and recalculating bounds and heights.
+    while(nodeIndex != kInvalidId)
+    {
+        nodeIndex = Balance(nodeIndex);
+
+        Node& node = mNodes[nodeIndex];
+        const Node& child1 = mNodes[node.child1];
+        const Node& child2 = mNodes[node.child2];
+        Combine(child1.min, child1.max, child2.min, child2.max, node.min, node.max);
+        node.height = 1 + std::max(child1.height, child2.height);
+        nodeIndex = node.parent;
+    }
+}
+
+uint32_t AABBTree::Balance(uint32_t aIndex)
+{
+    // If one child of node A is more than one level taller than the other, rotate the taller child (C) up to take A's place.
+    // A becomes a child of C, and keeps its shorter child (B). C's taller child (F) stays with C, and its shorter child (G) moves to A.
+    // Returns the index of the node that's now in A's place.
+    Node& a = mNodes[aIndex];
+    if(a.IsLeaf()) { return aIndex; }
+
+    int balance = mNodes[a.child2].height - mNodes[a.child1].height;
+    if(balance >= -1 && balance <= 1) { return aIndex; }
+
+    // C is the taller child, B is the other.
+    uint32_t cIndex = balance > 1 ? a.child2 : a.child1;
+    uint32_t bIndex = balance > 1 ? a.child1 : a.child2;
+    Node& b = mNodes[bIndex];
+    Node& c = mNodes[cIndex];
+
+    // C takes A's place in the tree.
+    c.parent = a.parent;
+    a.parent = cIndex;
+    if(c.parent == kInvalidId)
+    {
+        mRootIndex = cIndex;
+    }
+    else if(mNodes[c.parent].child1 == aIndex)
+    {
+        mNodes[c.parent].child1 = cIndex;
+    }
+    else
+    {
+        mNodes[c.parent].child2 = cIndex;
+    }
+
+    // C's taller child (F) stays with C. The shorter one (G) goes to A, in place of C.
+    uint32_t fIndex = c.child1;
+    uint32_t gIndex = c.child2;
+    if(mNodes[fIndex].height < mNodes[gIndex].height)
+    {
+        std::swap(fIndex, gIndex);
+    }
+    c.child1 = aIndex;
+    c.child2 = fIndex;
+    if(balance > 1)
+    {
+        a.child2 = gIndex;
+    }
+    else
+    {
+        a.child1 = gIndex;
+    }
+    mNodes[gIndex].parent = aIndex;
+
+    Combine(b.min, b.max, mNodes[gIndex].min, mNodes[gIndex].max, a.min, a.max);
+    a.height = 1 + std::max(b.height, mNodes[gIndex].height);
+    Combine(a.min, a.max, mNodes[fIndex].min, mNodes[fIndex].max, c.min, c.max);
+    c.height = 1 + std::max(a.height, mNodes[fIndex].height);
+    return cIndex;
+}
+
+bool AABBTree::TestRayBounds(const Vector3& rayOrigin, const Vector3& invDirection, const Vector3& min, const Vector3& max, float maxT, float& outT)
+{
+    // Slab test: intersect the ray with the pair of planes on each axis, and see if the ranges overlap.
+    float t1 = (min.x - rayOrigin.x) * invDirection.x;
+    float t2 = (max.x - rayOrigin.x) * invDirection.x;
+    float tMin = std::min(t1, t2);
+    float tMax = std::max(t1, t2);
+
+    t1 = (min.y - rayOrigin.y) * invDirection.y;
+    t2 = (max.y - rayOrigin.y) * invDirection.y;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    t1 = (min.z - rayOrigin.z) * invDirection.z;
+    t2 = (max.z - rayOrigin.z) * invDirection.z;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    // Missed if ranges don't overlap, box is behind the ray, or box is farther than the nearest hit so far.
+    if(tMax < tMin || tMax < 0.0f || tMin > maxT) { return false; }
+    outT = std::max(tMin, 0.0f);
+    return true;
+}
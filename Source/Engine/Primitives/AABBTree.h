@@ -0,0 +1,153 @@
+//
+// Clark Kromenaker
+//
+// A dynamic bounding volume tree over a set of objects' AABBs, for quickly finding objects a ray might hit.
+//
+// Unlike TriangleBVH, objects can be added, moved, and removed at any time, and the tree is updated incrementally.
+// Each object's AABB is stored "fattened" by a margin, so small movements don't require changing the tree at all.
+// Objects are identified by an index provided when they're added (e.g. an index into some list of objects).
+//
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#include "AABB.h"
+#include "Ray.h"
+#include "Vector3.h"
+
+class AABBTree
+{
+public:
+    static const uint32_t kInvalidId = UINT32_MAX;
+
+    AABBTree(float margin = 0.0f) : mMargin(margin) { }
+
+    // Adds an object with the given bounds. Returns an ID used to update or remove the object later.
+    uint32_t Add(const AABB& aabb, uint32_t objectIndex);
+
+    // Updates an object's bounds. Returns true if the tree changed (the bounds moved outside the object's fattened bounds).
+    bool Update(uint32_t id, const AABB& aabb);
+
+    void Remove(uint32_t id);
+    void Clear();
+
+    uint32_t GetObjectIndex(uint32_t id) const { return mNodes[id].objectIndex; }
+    AABB GetFatAABB(uint32_t id) const { return AABB(mNodes[id].min, mNodes[id].max); }
+
+    // Height of the tree (zero for a single leaf), or -1 if empty. Useful for checking the tree stays balanced.
+    int GetHeight() const { return mRootIndex != kInvalidId ? mNodes[mRootIndex].height : -1; }
+
+    // Finds objects whose (fattened) bounds are hit by the ray, nearer than "maxT".
+    // Objects are visited roughly nearest first. For each, "hit(objectIndex, aabbT)" is called.
+    // It returns the new "maxT" - return a smaller value (e.g. the distance to an actual hit on the object) to skip anything further away.
+    template<typename HitFunc>
+    void Raycast(const Ray& ray, float maxT, HitFunc hit) const;
+
+private:
+    struct Node
+    {
+        // Bounds of this node. For leaves, this is the fattened bounds of the object.
+        Vector3 min;
+        Vector3 max;
+
+        // Parent node, or next free node if this node is unused.
+        uint32_t parent = kInvalidId;
+
+        // Child nodes. Leaves have no children.
+        uint32_t child1 = kInvalidId;
+        uint32_t child2 = kInvalidId;
+
+        // Height of the subtree under this node. Leaves are zero, unused nodes are -1.
+        int height = -1;
+
+        // For leaves, the index of the object.
+        uint32_t objectIndex = 0;
+
+        bool IsLeaf() const { return child1 == kInvalidId; }
+    };
+
+    // How much to fatten object bounds by on each side.
+    float mMargin = 0.0f;
+
+    // All nodes, used and unused. IDs are indexes into this list.
+    std::vector<Node> mNodes;
+
+    // The root node, and the first node in a linked list of unused nodes.
+    uint32_t mRootIndex = kInvalidId;
+    uint32_t mFreeIndex = kInvalidId;
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t nodeIndex);
+
+    void InsertLeaf(uint32_t leafIndex);
+    void RemoveLeaf(uint32_t leafIndex);
+    void RefitAncestors(uint32_t nodeIndex);
+    uint32_t Balance(uint32_t nodeIndex);
+
+    static bool TestRayBounds(const Vector3& rayOrigin, const Vector3& invDirection, const Vector3& min, const Vector3& max, float maxT, float& outT);
+};
+
+template<typename HitFunc>
+void AABBTree::Raycast(const Ray& ray, float maxT, HitFunc hit) const
+{
+    if(mRootIndex == kInvalidId) { return; }
+
+    // Precalculate inverse direction for bounds tests.
+    // Division by zero produces infinities, which the slab test handles correctly.
+    Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    float rootT = 0.0f;
+    if(!TestRayBounds(ray.origin, invDirection, mNodes[mRootIndex].min, mNodes[mRootIndex].max, maxT, rootT)) { return; }
+
+    // Traverse the tree with an explicit stack. Each entry also stores where the ray enters the node's bounds.
+    // The tree is kept balanced, so its height (and the stack size needed) is tiny compared to this.
+    struct StackEntry
+    {
+        uint32_t nodeIndex;
+        float t;
+    };
+    StackEntry stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = { mRootIndex, rootT };
+    while(stackSize > 0)
+    {
+        StackEntry entry = stack[--stackSize];
+
+        // A hit found since this node was pushed may be nearer than this node.
+        if(entry.t > maxT) { continue; }
+
+        const Node& node = mNodes[entry.nodeIndex];
+        if(node.IsLeaf())
+        {
+            maxT = hit(node.objectIndex, entry.t);
+        }
+        else
+        {
+            // Visit the nearer child first, so that farther subtrees are more likely to be skipped.
+            uint32_t children[2] = { node.child1, node.child2 };
+            float childT[2];
+            bool childHit[2];
+            for(int i = 0; i < 2; ++i)
+            {
+                const Node& child = mNodes[children[i]];
+                childHit[i] = TestRayBounds(ray.origin, invDirection, child.min, child.max, maxT, childT[i]);
+            }
+            if(childHit[0] && childHit[1])
+            {
+                // Push the farther child first, so the nearer one is popped next.
+                int nearer = childT[0] <= childT[1] ? 0 : 1;
+                stack[stackSize++] = { children[1 - nearer], childT[1 - nearer] };
+                stack[stackSize++] = { children[nearer], childT[nearer] };
+            }
+            else if(childHit[0])
+            {
+                stack[stackSize++] = { children[0], childT[0] };
+            }
+            else if(childHit[1])
+            {
+                stack[stackSize++] = { children[1], childT[1] };
+            }
+        }
+    }
+}
@@ -26,6 +26,9 @@ struct RaycastHit
     // A name/identifier for the thing hit.
     std::string name;
 
+    // If the thing hit is part of something larger (e.g. an object in a BSP), the index of that part. Otherwise, -1.
+    int index = -1;
+
     // An actor hit.
     Actor* actor = nullptr;
 };
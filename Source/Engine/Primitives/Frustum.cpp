@@ -1,5 +1,6 @@
 #include "Frustum.h"
 
+#include "AABB.h"
 #include "Matrix4.h"
 
 Frustum::Frustum(const Matrix4& matrix)
@@ -44,6 +45,26 @@ bool Frustum::ContainsPoint(const Vector3& point) const
         top.GetSignedDistance(point) >= 0.0f;
 }
 
+bool Frustum::IntersectsAABB(const AABB& aabb) const
+{
+    // For each plane, find the projected "radius" of the box onto the plane normal.
+    // If the box center is farther behind any plane than that radius, the box is entirely outside the frustum.
+    Vector3 center = aabb.GetCenter();
+    Vector3 extents = aabb.GetExtents();
+    const Plane* planes[6] = { &near, &far, &left, &right, &bottom, &top };
+    for(const Plane* plane : planes)
+    {
+        float radius = extents.x * Math::Abs(plane->normal.x) +
+                       extents.y * Math::Abs(plane->normal.y) +
+                       extents.z * Math::Abs(plane->normal.z);
+        if(plane->GetSignedDistance(center) < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 //TODO: Problem with this code: it gets nearest point to *planes* rather than the actual box of the frustum. Not correct.
 //TODO: Need to research correct algorithm for this.
 /*
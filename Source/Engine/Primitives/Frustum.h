@@ -9,6 +9,7 @@
 #pragma once
 #include "Plane.h"
 
+class AABB;
 class Matrix4;
 class Vector3;
 
@@ -19,6 +20,10 @@ public:
     Frustum(const Matrix4& matrix);
 
     bool ContainsPoint(const Vector3& point) const;
+
+    // Returns true if any part of the AABB may be inside the frustum.
+    // This is conservative: boxes near the frustum's corners may pass even if slightly outside, but boxes inside never fail.
+    bool IntersectsAABB(const AABB& aabb) const;
     //Vector3 GetClosestPoint(const Vector3& point) const;
 
     // The frustum just consists of 6 planes forming the bounding area.
@@ -0,0 +1,43 @@
+#include "RectPacker.h"
+
+RectPacker::RectPacker(uint32_t width, uint32_t height) :
+    mWidth(width),
+    mHeight(height)
+{
+
+}
+
+bool RectPacker::Pack(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY)
+{
+    if(width > mWidth || height > mHeight) { return false; }
+
+    // Use the existing shelf that fits this rect with the least wasted height.
+    Shelf* bestShelf = nullptr;
+    for(Shelf& shelf : mShelves)
+    {
+        if(shelf.height >= height && mWidth - shelf.usedWidth >= width)
+        {
+            if(bestShelf == nullptr || shelf.height < bestShelf->height)
+            {
+                bestShelf = &shelf;
+            }
+        }
+    }
+
+    // If no existing shelf fits, start a new shelf below the others.
+    if(bestShelf == nullptr)
+    {
+        if(mHeight - mUsedHeight < height) { return false; }
+        mShelves.emplace_back();
+        bestShelf = &mShelves.back();
+        bestShelf->y = mUsedHeight;
+        bestShelf->height = height;
+        mUsedHeight += height;
+    }
+
+    // Place the rect at the end of the shelf.
+    outX = bestShelf->usedWidth;
+    outY = bestShelf->y;
+    bestShelf->usedWidth += width;
+    return true;
+}
@@ -0,0 +1,41 @@
+//
+// Clark Kromenaker
+//
+// Packs rectangles into a fixed-size area, such as a texture atlas.
+//
+// Uses "shelves": rows whose height is set by the first rect placed in them.
+// Packing is tightest if rects are added tallest-first.
+//
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class RectPacker
+{
+public:
+    RectPacker(uint32_t width, uint32_t height);
+
+    // Finds a spot for a rect of the given size. Returns false if there's no room for it.
+    bool Pack(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+
+    uint32_t GetWidth() const { return mWidth; }
+    uint32_t GetHeight() const { return mHeight; }
+
+    // Height of the packed area, from the top to the bottom of the last shelf.
+    uint32_t GetUsedHeight() const { return mUsedHeight; }
+
+private:
+    // Size of the area being packed.
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+
+    // A row of rects. Rects are placed left to right.
+    struct Shelf
+    {
+        uint32_t y = 0;
+        uint32_t height = 0;
+        uint32_t usedWidth = 0;
+    };
+    std::vector<Shelf> mShelves;
+    uint32_t mUsedHeight = 0;
+};
@@ -0,0 +1,363 @@
+#include "TriangleBVH.h"
+
+#include <algorithm>
+
+#include "Matrix4.h"
+#include "Sphere.h"
+#include "Triangle.h"
+
+namespace
+{
+    // Nodes with this many triangles or fewer always become leaves.
+    const uint32_t kMaxLeafTriangles = 4;
+
+    // Past this depth, nodes always become leaves. Keeps the raycast traversal stack bounded.
+    const uint32_t kMaxDepth = 48;
+
+    // Number of buckets used to approximate the SAH cost of splitting along an axis.
+    const int kBinCount = 12;
+
+    // Relative cost of traversing a node vs. testing a triangle.
+    const float kTraversalCost = 1.0f;
+
+    void GrowBounds(Vector3& min, Vector3& max, const Vector3& point)
+    {
+        min.x = std::min(min.x, point.x);
+        min.y = std::min(min.y, point.y);
+        min.z = std::min(min.z, point.z);
+        max.x = std::max(max.x, point.x);
+        max.y = std::max(max.y, point.y);
+        max.z = std::max(max.z, point.z);
+    }
+
+    float GetSurfaceArea(const Vector3& min, const Vector3& max)
+    {
+        Vector3 size = max - min;
+        if(size.x < 0.0f || size.y < 0.0f || size.z < 0.0f) { return 0.0f; }
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+}
+
+uint32_t TriangleBVH::AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2, uint32_t flags)
+{
+    Triangle triangle;
+    triangle.p0 = p0;
+    triangle.p1 = p1;
+    triangle.p2 = p2;
+    triangle.normal = ::Triangle::GetNormal(p0, p1, p2);
+    triangle.index = static_cast<uint32_t>(mTriangles.size());
+    triangle.flags = flags;
+    mTriangles.push_back(triangle);
+    mTriangleSlots.push_back(triangle.index);
+    return triangle.index;
+}
+
+void TriangleBVH::Build()
+{
+    mNodes.clear();
+    if(mTriangles.empty()) { return; }
+
+    // A binary tree with N leaves has 2N - 1 nodes.
+    mNodes.reserve(2 * (mTriangles.size() / kMaxLeafTriangles + 1));
+
+    // Centroids are used to decide which side of a split each triangle goes on.
+    // Kept in a parallel list and reordered along with the triangles.
+    std::vector<Vector3> centroids(mTriangles.size());
+    for(size_t i = 0; i < mTriangles.size(); ++i)
+    {
+        centroids[i] = (mTriangles[i].p0 + mTriangles[i].p1 + mTriangles[i].p2) / 3.0f;
+    }
+    BuildNode(0, static_cast<uint32_t>(mTriangles.size()), 0, centroids);
+
+    // Triangles were reordered during the build, so update triangle index => list position mappings.
+    for(uint32_t i = 0; i < mTriangles.size(); ++i)
+    {
+        mTriangleSlots[mTriangles[i].index] = i;
+    }
+}
+
+void TriangleBVH::Clear()
+{
+    mTriangles.clear();
+    mTriangleSlots.clear();
+    mNodes.clear();
+}
+
+void TriangleBVH::SetFlags(uint32_t triangleIndex, uint32_t flags)
+{
+    mTriangles[mTriangleSlots[triangleIndex]].flags = flags;
+}
+
+void TriangleBVH::UpdateNodeFlags()
+{
+    if(!mNodes.empty())
+    {
+        UpdateNodeFlags(0);
+    }
+}
+
+void TriangleBVH::SetTriangle(uint32_t triangleIndex, const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+    Triangle& triangle = mTriangles[mTriangleSlots[triangleIndex]];
+    triangle.p0 = p0;
+    triangle.p1 = p1;
+    triangle.p2 = p2;
+    triangle.normal = ::Triangle::GetNormal(p0, p1, p2);
+}
+
+void TriangleBVH::Refit()
+{
+    // Children always come after their parent in the nodes list.
+    // So, going backwards through the list, a node's children are always refit before the node itself.
+    for(size_t i = mNodes.size(); i-- > 0;)
+    {
+        Node& node = mNodes[i];
+        Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        if(node.IsLeaf())
+        {
+            for(uint32_t j = node.offset; j < node.offset + node.triangleCount; ++j)
+            {
+                GrowBounds(min, max, mTriangles[j].p0);
+                GrowBounds(min, max, mTriangles[j].p1);
+                GrowBounds(min, max, mTriangles[j].p2);
+            }
+        }
+        else
+        {
+            const Node& firstChild = mNodes[i + 1];
+            const Node& secondChild = mNodes[node.offset];
+            GrowBounds(min, max, firstChild.min);
+            GrowBounds(min, max, firstChild.max);
+            GrowBounds(min, max, secondChild.min);
+            GrowBounds(min, max, secondChild.max);
+        }
+        node.min = min;
+        node.max = max;
+    }
+}
+
+int TriangleBVH::SweepSphere(const Sphere& sphere, const Vector3& moveOffset, uint32_t flagMask, float& outSphereT, Vector3& outCollisionNormal) const
+{
+    return SweepSphere(sphere, moveOffset, Matrix4::Identity, flagMask, outSphereT, outCollisionNormal);
+}
+
+int TriangleBVH::SweepSphere(const Sphere& sphere, const Vector3& moveOffset, const Matrix4& toSphereSpace, uint32_t flagMask, float& outSphereT, Vector3& outCollisionNormal) const
+{
+    // Get bounds of the whole sweep, from the sphere's start position to its end position.
+    Vector3 radius(sphere.radius, sphere.radius, sphere.radius);
+    Vector3 sweepMin = sphere.center - radius;
+    Vector3 sweepMax = sphere.center + radius;
+    GrowBounds(sweepMin, sweepMax, sphere.center + moveOffset - radius);
+    GrowBounds(sweepMin, sweepMax, sphere.center + moveOffset + radius);
+
+    // Convert those bounds to the tree's space, by transforming all eight corners.
+    Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    Matrix4 toTreeSpace = Matrix4::InverseTransform(toSphereSpace);
+    for(int i = 0; i < 8; ++i)
+    {
+        Vector3 corner((i & 1) ? sweepMax.x : sweepMin.x, (i & 2) ? sweepMax.y : sweepMin.y, (i & 4) ? sweepMax.z : sweepMin.z);
+        GrowBounds(min, max, toTreeSpace.TransformPoint(corner));
+    }
+
+    // Any triangle the sphere might hit overlaps those bounds. Do the precise check in the sphere's space.
+    int hitIndex = -1;
+    QueryBounds(min, max, flagMask, [&](const Triangle& candidate) {
+        ::Triangle triangle(toSphereSpace.TransformPoint(candidate.p0),
+                            toSphereSpace.TransformPoint(candidate.p1),
+                            toSphereSpace.TransformPoint(candidate.p2));
+
+        float t = 0.0f;
+        Vector3 normal;
+        if(!Collide::SphereTriangle(sphere, triangle, moveOffset, t, normal) || t >= outSphereT) { return; }
+
+        // A negative t means the sphere is already overlapping the triangle's plane. It better actually be intersecting the triangle in that case.
+        Vector3 intersectPoint;
+        if(t < 0.0f && !Intersect::TestSphereTriangle(sphere, triangle, intersectPoint)) { return; }
+
+        outSphereT = t;
+        outCollisionNormal = normal;
+        hitIndex = static_cast<int>(candidate.index);
+    });
+    return hitIndex;
+}
+
+uint32_t TriangleBVH::BuildNode(uint32_t start, uint32_t end, uint32_t depth, std::vector<Vector3>& centroids)
+{
+    uint32_t nodeIndex = static_cast<uint32_t>(mNodes.size());
+    mNodes.emplace_back();
+
+    // Calculate bounds of all triangles, and of all centroids (used for binning).
+    Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    Vector3 centroidMin = min;
+    Vector3 centroidMax = max;
+    uint32_t flags = 0;
+    for(uint32_t i = start; i < end; ++i)
+    {
+        GrowBounds(min, max, mTriangles[i].p0);
+        GrowBounds(min, max, mTriangles[i].p1);
+        GrowBounds(min, max, mTriangles[i].p2);
+        GrowBounds(centroidMin, centroidMax, centroids[i]);
+        flags |= mTriangles[i].flags;
+    }
+    mNodes[nodeIndex].min = min;
+    mNodes[nodeIndex].max = max;
+    mNodes[nodeIndex].flags = flags;
+
+    // Find the cheapest split using binned SAH: bucket triangles by centroid along each axis,
+    // then evaluate the cost of splitting at each bucket boundary.
+    uint32_t count = end - start;
+    float leafCost = static_cast<float>(count);
+    float bestCost = FLT_MAX;
+    int bestAxis = -1;
+    int bestSplit = 0;
+    if(count > kMaxLeafTriangles && depth < kMaxDepth)
+    {
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            float axisMin = centroidMin[axis];
+            float axisExtent = centroidMax[axis] - axisMin;
+            if(axisExtent <= 0.0f) { continue; }
+
+            struct Bin
+            {
+                Vector3 min = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+                Vector3 max = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                uint32_t count = 0;
+            };
+            Bin bins[kBinCount];
+            float binScale = kBinCount / axisExtent;
+            for(uint32_t i = start; i < end; ++i)
+            {
+                int bin = std::min(kBinCount - 1, static_cast<int>((centroids[i][axis] - axisMin) * binScale));
+                GrowBounds(bins[bin].min, bins[bin].max, mTriangles[i].p0);
+                GrowBounds(bins[bin].min, bins[bin].max, mTriangles[i].p1);
+                GrowBounds(bins[bin].min, bins[bin].max, mTriangles[i].p2);
+                bins[bin].count++;
+            }
+
+            // Sweep from the right to get area/count of everything right of each split.
+            float rightAreas[kBinCount];
+            uint32_t rightCounts[kBinCount];
+            Vector3 sweepMin(FLT_MAX, FLT_MAX, FLT_MAX);
+            Vector3 sweepMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            uint32_t sweepCount = 0;
+            for(int i = kBinCount - 1; i > 0; --i)
+            {
+                if(bins[i].count > 0)
+                {
+                    GrowBounds(sweepMin, sweepMax, bins[i].min);
+                    GrowBounds(sweepMin, sweepMax, bins[i].max);
+                }
+                sweepCount += bins[i].count;
+                rightAreas[i] = GetSurfaceArea(sweepMin, sweepMax);
+                rightCounts[i] = sweepCount;
+            }
+
+            // Then sweep from the left, evaluating the cost of splitting between bin i - 1 and bin i.
+            sweepMin = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+            sweepMax = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            sweepCount = 0;
+            for(int i = 1; i < kBinCount; ++i)
+            {
+                if(bins[i - 1].count > 0)
+                {
+                    GrowBounds(sweepMin, sweepMax, bins[i - 1].min);
+                    GrowBounds(sweepMin, sweepMax, bins[i - 1].max);
+                }
+                sweepCount += bins[i - 1].count;
+                if(sweepCount == 0 || rightCounts[i] == 0) { continue; }
+
+                float cost = GetSurfaceArea(sweepMin, sweepMax) * sweepCount + rightAreas[i] * rightCounts[i];
+                if(cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        // Convert to the same units as the leaf cost.
+        float area = GetSurfaceArea(min, max);
+        if(area > 0.0f)
+        {
+            bestCost = kTraversalCost + bestCost / area;
+        }
+    }
+
+    // Make a leaf if splitting isn't possible or isn't worth it.
+    // Large nodes are always split, even if SAH says otherwise, to keep leaves small.
+    if(bestAxis < 0 || (bestCost >= leafCost && count <= kMaxLeafTriangles * 4))
+    {
+        mNodes[nodeIndex].offset = start;
+        mNodes[nodeIndex].triangleCount = count;
+        return nodeIndex;
+    }
+
+    // Partition triangles by which side of the split their centroids are on.
+    float axisMin = centroidMin[bestAxis];
+    float binScale = kBinCount / (centroidMax[bestAxis] - axisMin);
+    uint32_t mid = start;
+    for(uint32_t i = start; i < end; ++i)
+    {
+        int bin = std::min(kBinCount - 1, static_cast<int>((centroids[i][bestAxis] - axisMin) * binScale));
+        if(bin < bestSplit)
+        {
+            std::swap(mTriangles[i], mTriangles[mid]);
+            std::swap(centroids[i], centroids[mid]);
+            ++mid;
+        }
+    }
+
+    // First child immediately follows this node; second child's index is stored in the node.
+    BuildNode(start, mid, depth + 1, centroids);
+    uint32_t secondChildIndex = BuildNode(mid, end, depth + 1, centroids);
+    mNodes[nodeIndex].offset = secondChildIndex;
+    return nodeIndex;
+}
+
+uint32_t TriangleBVH::UpdateNodeFlags(uint32_t nodeIndex)
+{
+    const Node& node = mNodes[nodeIndex];
+    uint32_t flags = 0;
+    if(node.IsLeaf())
+    {
+        for(uint32_t i = node.offset; i < node.offset + node.triangleCount; ++i)
+        {
+            flags |= mTriangles[i].flags;
+        }
+    }
+    else
+    {
+        flags = UpdateNodeFlags(nodeIndex + 1) | UpdateNodeFlags(node.offset);
+    }
+    mNodes[nodeIndex].flags = flags;
+    return flags;
+}
+
+bool TriangleBVH::TestRayBounds(const Vector3& rayOrigin, const Vector3& invDirection, const Vector3& min, const Vector3& max, float maxT, float& outT)
+{
+    // Slab test: intersect the ray with the pair of planes on each axis, and see if the ranges overlap.
+    float t1 = (min.x - rayOrigin.x) * invDirection.x;
+    float t2 = (max.x - rayOrigin.x) * invDirection.x;
+    float tMin = std::min(t1, t2);
+    float tMax = std::max(t1, t2);
+
+    t1 = (min.y - rayOrigin.y) * invDirection.y;
+    t2 = (max.y - rayOrigin.y) * invDirection.y;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    t1 = (min.z - rayOrigin.z) * invDirection.z;
+    t2 = (max.z - rayOrigin.z) * invDirection.z;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    // Missed if ranges don't overlap, box is behind the ray, or box is farther than the nearest hit so far.
+    if(tMax < tMin || tMax < 0.0f || tMin > maxT) { return false; }
+    outT = std::max(tMin, 0.0f);
+    return true;
+}
@@ -0,0 +1,240 @@
+//
+// Clark Kromenaker
+//
+// A bounding volume hierarchy (BVH) over a set of triangles, for fast raycasts and sphere sweeps.
+//
+// Triangles are added, and then the tree is built once using the surface area heuristic (SAH).
+// If triangles move a bit afterwards (e.g. vertex animation), the tree can be refit rather than rebuilt.
+// Each triangle has flags, and raycasts only consider triangles with at least one of the requested flags.
+// Each node also stores the combined flags of all triangles below it, so filtered raycasts can skip whole subtrees.
+//
+#pragma once
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+#include "Collisions.h"
+#include "Ray.h"
+#include "Vector3.h"
+
+class Matrix4;
+class Sphere;
+
+class TriangleBVH
+{
+public:
+    // Adds a triangle. Returns the triangle's index, which is used to identify it in raycast results.
+    // Triangles added after Build aren't included in raycasts until Build is called again.
+    uint32_t AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2, uint32_t flags);
+    uint32_t GetTriangleCount() const { return static_cast<uint32_t>(mTriangles.size()); }
+
+    // Builds the tree from all added triangles.
+    void Build();
+    void Clear();
+
+    // Changes the flags of a triangle.
+    // After changing flags, call UpdateNodeFlags before doing more raycasts, or filtering may skip the triangle.
+    void SetFlags(uint32_t triangleIndex, uint32_t flags);
+    uint32_t GetFlags(uint32_t triangleIndex) const { return mTriangles[mTriangleSlots[triangleIndex]].flags; }
+    void UpdateNodeFlags();
+
+    // Moves a triangle. After moving triangles, call Refit before doing more queries, or queries may miss the triangle.
+    void SetTriangle(uint32_t triangleIndex, const Vector3& p0, const Vector3& p1, const Vector3& p2);
+
+    // Recalculates node bounds to fit the triangles' current positions, keeping the tree structure as-is.
+    // Much faster than rebuilding, but the tree gets less efficient the further triangles move from where they were at build time.
+    void Refit();
+
+    // Finds the nearest triangle hit by the ray, only considering triangles with any of the given flags.
+    // If "cullBackfaces" is set, triangles facing away from the ray are ignored.
+    //
+    // For each hit nearer than the nearest so far, "accept(triangleIndex, u, v)" is called with the barycentric coordinates of the hit.
+    // Returning false ignores that hit (useful for alpha testing, for example).
+    //
+    // Returns the index of the triangle hit, or -1 if none were hit. If hit, "outRayT" is set to the distance along the ray.
+    template<typename AcceptFunc>
+    int Raycast(const Ray& ray, uint32_t flagMask, bool cullBackfaces, float& outRayT, AcceptFunc accept) const;
+
+    // Same as above, but accepts all hits.
+    int Raycast(const Ray& ray, uint32_t flagMask, bool cullBackfaces, float& outRayT) const
+    {
+        return Raycast(ray, flagMask, cullBackfaces, outRayT, [](uint32_t, float, float) { return true; });
+    }
+
+    // Finds the first triangle hit by a sphere moving by "moveOffset", only considering triangles with any of the given flags.
+    // Uses Collide::SphereTriangle, so triangles are only hit by a sphere moving toward their front.
+    // A negative t (sphere already overlapping the triangle) only counts if the sphere actually intersects the triangle.
+    //
+    // Only hits with a t less than "outSphereT" are considered, so set it before calling (e.g. to 1 to check the full move).
+    // Returns the index of the triangle hit, or -1 if none were hit. If hit, "outSphereT" and "outCollisionNormal" are set.
+    int SweepSphere(const Sphere& sphere, const Vector3& moveOffset, uint32_t flagMask, float& outSphereT, Vector3& outCollisionNormal) const;
+
+    // Same as above, but the sphere is in a different space than the triangles; "toSphereSpace" transforms triangles into the sphere's space.
+    // Any affine transform works (including non-uniform scale), since only culling happens in the tree's space.
+    int SweepSphere(const Sphere& sphere, const Vector3& moveOffset, const Matrix4& toSphereSpace, uint32_t flagMask, float& outSphereT, Vector3& outCollisionNormal) const;
+
+private:
+    struct Triangle
+    {
+        Vector3 p0;
+        Vector3 p1;
+        Vector3 p2;
+        Vector3 normal;
+
+        // Index of this triangle, as returned by AddTriangle.
+        uint32_t index = 0;
+        uint32_t flags = 0;
+    };
+
+    struct Node
+    {
+        // Bounds of this node.
+        Vector3 min;
+        Vector3 max;
+
+        // For leaves, the first triangle in the triangles list. For interior nodes, the index of the second child.
+        // The first child of an interior node always immediately follows the node.
+        uint32_t offset = 0;
+
+        // Number of triangles in a leaf, or zero for interior nodes.
+        uint32_t triangleCount = 0;
+
+        // All flags of triangles in or below this node.
+        uint32_t flags = 0;
+
+        bool IsLeaf() const { return triangleCount > 0; }
+    };
+
+    // Triangles, ordered so that each leaf's triangles are contiguous.
+    std::vector<Triangle> mTriangles;
+
+    // Maps triangle index to position in the (reordered) triangles list.
+    std::vector<uint32_t> mTriangleSlots;
+
+    // Nodes in depth-first order. The first node is the root.
+    std::vector<Node> mNodes;
+
+    uint32_t BuildNode(uint32_t start, uint32_t end, uint32_t depth, std::vector<Vector3>& centroids);
+    uint32_t UpdateNodeFlags(uint32_t nodeIndex);
+
+    template<typename VisitFunc>
+    void QueryBounds(const Vector3& min, const Vector3& max, uint32_t flagMask, VisitFunc visit) const;
+
+    static bool TestRayBounds(const Vector3& rayOrigin, const Vector3& invDirection, const Vector3& min, const Vector3& max, float maxT, float& outT);
+};
+
+template<typename AcceptFunc>
+int TriangleBVH::Raycast(const Ray& ray, uint32_t flagMask, bool cullBackfaces, float& outRayT, AcceptFunc accept) const
+{
+    if(mNodes.empty() || (mNodes[0].flags & flagMask) == 0) { return -1; }
+
+    // Precalculate inverse direction for bounds tests.
+    // Division by zero produces infinities, which the slab test handles correctly.
+    Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    float nearestT = FLT_MAX;
+    int nearestIndex = -1;
+
+    // Traverse the tree with an explicit stack. Tree depth is bounded during build, so this can't overflow.
+    uint32_t stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize > 0)
+    {
+        uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = mNodes[nodeIndex];
+        if(node.IsLeaf())
+        {
+            for(uint32_t i = node.offset; i < node.offset + node.triangleCount; ++i)
+            {
+                const Triangle& triangle = mTriangles[i];
+                if((triangle.flags & flagMask) == 0) { continue; }
+                if(cullBackfaces && Vector3::Dot(ray.direction, triangle.normal) >= 0.0f) { continue; }
+
+                float t = 0.0f;
+                float u = 0.0f;
+                float v = 0.0f;
+                if(Intersect::TestRayTriangle(ray, triangle.p0, triangle.p1, triangle.p2, t, u, v) && t < nearestT)
+                {
+                    if(accept(triangle.index, u, v))
+                    {
+                        nearestT = t;
+                        nearestIndex = static_cast<int>(triangle.index);
+                    }
+                }
+            }
+        }
+        else
+        {
+            // Visit the nearer child first, so that farther subtrees are more likely to be skipped.
+            uint32_t children[2] = { nodeIndex + 1, node.offset };
+            float childT[2];
+            bool childHit[2];
+            for(int i = 0; i < 2; ++i)
+            {
+                const Node& child = mNodes[children[i]];
+                childHit[i] = (child.flags & flagMask) != 0 &&
+                              TestRayBounds(ray.origin, invDirection, child.min, child.max, nearestT, childT[i]);
+            }
+            if(childHit[0] && childHit[1])
+            {
+                // Push the farther child first, so the nearer one is popped next.
+                bool firstIsNearer = childT[0] <= childT[1];
+                stack[stackSize++] = firstIsNearer ? children[1] : children[0];
+                stack[stackSize++] = firstIsNearer ? children[0] : children[1];
+            }
+            else if(childHit[0])
+            {
+                stack[stackSize++] = children[0];
+            }
+            else if(childHit[1])
+            {
+                stack[stackSize++] = children[1];
+            }
+        }
+    }
+
+    if(nearestIndex >= 0)
+    {
+        outRayT = nearestT;
+    }
+    return nearestIndex;
+}
+
+template<typename VisitFunc>
+void TriangleBVH::QueryBounds(const Vector3& min, const Vector3& max, uint32_t flagMask, VisitFunc visit) const
+{
+    if(mNodes.empty()) { return; }
+
+    // Visit every triangle in every leaf whose bounds overlap the query bounds.
+    uint32_t stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize > 0)
+    {
+        uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = mNodes[nodeIndex];
+        if((node.flags & flagMask) == 0 ||
+           node.min.x > max.x || node.min.y > max.y || node.min.z > max.z ||
+           node.max.x < min.x || node.max.y < min.y || node.max.z < min.z)
+        {
+            continue;
+        }
+
+        if(node.IsLeaf())
+        {
+            for(uint32_t i = node.offset; i < node.offset + node.triangleCount; ++i)
+            {
+                if((mTriangles[i].flags & flagMask) != 0)
+                {
+                    visit(mTriangles[i]);
+                }
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+}
@@ -1,69 +1,97 @@
 #include "BSP.h"
 
+#include <algorithm>
 #include <bitset>
 #include <iostream>
 
+#include "AssetBuffer.h"
 #include "AssetManager.h"
 #include "BinaryReader.h"
 #include "BSPActor.h"
 #include "BSPLightmap.h"
 #include "Debug.h"
+#include "FileSystem.h"
+#include "Random.h"
 #include "ReportManager.h"
 #include "Shader.h"
 #include "StringUtil.h"
 #include "Texture.h"
+#include "Timers.h"
 #include "Triangle.h"
 #include "Vector2.h"
 #include "Vector3.h"
 
-void BSPSurface::Activate(const Material& material)
+namespace
 {
-    // Activate texture to use for diffuse color.
-    if(texture != nullptr)
-    {
-        texture->Activate(0);
-    }
-    else
-    {
-        Texture::Deactivate();
-    }
+    // Uniform slots for lightmap values, cached for the shader they were resolved against.
+    Shader* lightmapSlotShader = nullptr;
+    int lightmapMultiplierSlot = -1;
+    int lightmapScaleOffsetSlot = -1;
 
-    // Activate lightmap texture and multiplier.
-    if((flags & BSPSurface::kIgnoreLightmapFlag) != 0 ||
-       (flags & BSPSurface::kShadowTextureFlag)  != 0)
-    {
-        // Some surfaces ignore lightmaps.
-        // Just use "plain white" and multiplier of 1 to effectively "do nothing" in lightmap calcs.
-        Texture::White.Activate(1);
-        material.GetShader()->SetUniformFloat("uLightmapMultiplier", 1.0f);
-    }
-    else
+    void ActivateTextures(const Material& material, Texture* texture, Texture* lightmapTexture, bool ignoresLightmap, const Vector4& lightmapUvScaleOffset)
     {
-        // This surface DOES use lightmaps, so activate it!
-        // GK3 also implements a feature called "2x Lighting" - basically, just double lightmap colors to make the scene look brighter!
-        if(lightmapTexture != nullptr)
+        // Surfaces are activated many times per frame, so avoid looking up uniforms by name each time.
+        Shader* shader = material.GetShader();
+        if(shader != lightmapSlotShader)
         {
-            lightmapTexture->Activate(1);
+            lightmapMultiplierSlot = shader->GetUniformSlot("uLightmapMultiplier");
+            lightmapScaleOffsetSlot = shader->GetUniformSlot("uLightmapScaleOffset");
+            lightmapSlotShader = shader;
         }
-        material.GetShader()->SetUniformFloat("uLightmapMultiplier", 2.0f);
+
+        // Activate texture to use for diffuse color.
+        if(texture != nullptr)
+        {
+            texture->Activate(0);
+        }
+        else
+        {
+            Texture::Deactivate();
+        }
+
+        // Activate lightmap texture and multiplier.
+        if(ignoresLightmap)
+        {
+            // Some surfaces ignore lightmaps.
+            // Just use "plain white" and multiplier of 1 to effectively "do nothing" in lightmap calcs.
+            Texture::White.Activate(1);
+            shader->SetUniformFloat(lightmapMultiplierSlot, 1.0f);
+        }
+        else
+        {
+            // This surface DOES use lightmaps, so activate it!
+            // GK3 also implements a feature called "2x Lighting" - basically, just double lightmap colors to make the scene look brighter!
+            if(lightmapTexture != nullptr)
+            {
+                lightmapTexture->Activate(1);
+            }
+            shader->SetUniformFloat(lightmapMultiplierSlot, 2.0f);
+        }
+
+        // Lightmap scale/offsets are used in shaders to calculate proper lightmap UVs.
+        shader->SetUniformVector4(lightmapScaleOffsetSlot, lightmapUvScaleOffset);
     }
+}
 
-    // Lightmap scale/offsets are used in shaders to calculate proper lightmap UVs.
+#if defined(USE_TRUE_BSP_RENDERING)
+void BSPSurface::Activate(const Material& material)
+{
     Vector4 lightmapUvScaleOffset(lightmapUvScale.x,
                                   lightmapUvScale.y,
                                   lightmapUvOffset.x,
                                   lightmapUvOffset.y);
-    material.GetShader()->SetUniformVector4("uLightmapScaleOffset", lightmapUvScaleOffset);
+    ActivateTextures(material, texture, lightmapTexture, IgnoresLightmap(), lightmapUvScaleOffset);
 }
+#endif
 
 TYPEINFO_INIT(BSP, Asset, GENERATE_TYPE_ID)
 {
 
 }
 
-void BSP::Load(uint8_t* data, uint32_t dataLength)
+void BSP::Load(const AssetBuffer& buffer)
 {
-    ParseFromData(data, dataLength);
+    ParseFromData(buffer.GetData(), buffer.GetSize());
 
     // Use lightmap shader for BSP rendering.
     mMaterial.SetShader(gAssetManager.LoadShader("3D-Lightmap"));
@@ -124,40 +152,29 @@ BSPActor* BSP::CreateBSPActor(const std::string& objectName)
 
 bool BSP::RaycastNearest(const Ray& ray, RaycastHit& outHitInfo, bool forWalk)
 {
-    // Values for tracking closest found hit.
-    outHitInfo.t = FLT_MAX;
-    std::string* closest = nullptr;
-
-    // Iterate polygons and check each one for intersection with the ray.
-    // We must iterate ALL polygons (can't stop at first hit) in case a subsequent polygon is nearer to the start of the ray.
-    for(BSPPolygon& polygon : mPolygons)
+    // Only interactive surfaces can be hit, unless this is for walking, in which case walk hit test surfaces are also OK.
+    uint32_t flagMask = kRaycastInteractiveFlag;
+    if(forWalk)
     {
-        // Ignore polygons that are part of non-interactive surfaces.
-        BSPSurface& surface = mSurfaces[polygon.surfaceIndex];
-        if(surface.interactive || (forWalk && surface.walkHitTest))
-        {
-            // Do the raycast against the polygon.
-            RaycastHit hitInfo;
-            if(RaycastPolygon(ray, &polygon, hitInfo))
-            {
-                // Is it closer than any other polygon so far? Then it's our nearest hit.
-                if(hitInfo.t < outHitInfo.t)
-                {
-                    // Save closest distance.
-                    outHitInfo.t = hitInfo.t;
-
-                    // Track name of closest object hit.
-                    closest = &mObjectNames[surface.objectIndex];
-                }
-            }
-        }
+        flagMask |= kRaycastWalkHitTestFlag;
     }
 
-    // If no closest object was found, no hits occurred. Early out.
-    if(closest == nullptr) { return false; }
+    // Find the nearest triangle hit. The ray must hit the front side of a triangle for it to count.
+    // For hit test surfaces, the ray must also hit a visible pixel, so check that for any hits on those.
+    outHitInfo.t = FLT_MAX;
+    int triangleIndex = mRaycastBVH.Raycast(ray, flagMask, true, outHitInfo.t, [this](uint32_t index, float u, float v) {
+        if((mRaycastBVH.GetFlags(index) & kRaycastHitTestFlag) == 0) { return true; }
+        const RaycastTriangle& triangle = mRaycastTriangles[index];
+        return IsOpaqueAtHit(mPolygons[triangle.polygonIndex], triangle.fanIndex, u, v);
+    });
+
+    // If no triangle was hit, no hits occurred. Early out.
+    if(triangleIndex < 0) { return false; }
 
     // Otherwise, fill in out hit info and return.
-    outHitInfo.name = *closest;
+    const BSPSurface& surface = mSurfaces[mPolygons[mRaycastTriangles[triangleIndex].polygonIndex].surfaceIndex];
+    outHitInfo.name = mObjectNames[surface.objectIndex];
+    outHitInfo.index = static_cast<int>(surface.objectIndex);
     return true;
 }
 
@@ -182,28 +199,9 @@ bool BSP::RaycastPolygon(const Ray& ray, const BSPPolygon* polygon, RaycastHit&
             if(Intersect::TestRayTriangle(ray, p0, p1, p2, outHitInfo.t, u, v))
             {
                 // The ray definitely hit this polygon. But if this is a hit test, we need to do more work!
-                if(mSurfaces[polygon->surfaceIndex].hitTest && mSurfaces[polygon->surfaceIndex].texture->GetRenderType() != Texture::RenderType::Opaque)
+                if(mSurfaces[polygon->surfaceIndex].hitTest)
                 {
-                    // When we did the Ray/Triangle intersection test, we also calculated the barycentric coordinates as a byproduct of that test.
-                    // We can use those here to calculate the UV coordinates associated with the ray hit point.
-                    Vector2 uv0 = mUVs[mVertexIndices[polygon->vertexIndexOffset]];
-                    Vector2 uv1 = mUVs[mVertexIndices[polygon->vertexIndexOffset + i]];
-                    Vector2 uv2 = mUVs[mVertexIndices[polygon->vertexIndexOffset + i + 1]];
-
-                    //TODO: This math doesn't totally make sense to me, and I think it needs more scrutinizing.
-                    //TODO: Why do u/v/w not correlate to uv0/uv1/uv2 here? Why do we need to negate and flop the UVs?
-                    Vector2 pointUV = uv1 * u + uv2 * v + uv0 * (1.0f - u - v);
-                    pointUV.y *= -1.0f;
-                    pointUV.y = 1.0f - pointUV.y;
-
-                    // We got the UV, convert that into a specific pixel color from this polygon's surface texture.
-                    Vector2 pixelPos(pointUV.x * mSurfaces[polygon->surfaceIndex].texture->GetWidth(),
-                                     pointUV.y * mSurfaces[polygon->surfaceIndex].texture->GetHeight());
-                    Color32 color = mSurfaces[polygon->surfaceIndex].texture->GetPixelColor32(pixelPos.x, pixelPos.y);
-
-                    // If the color is transparent, this doesn't count as a hit - the ray "goes through" the transparent area.
-                    // But if at all opaque, we count this as a hit.
-                    if(color.a > 0)
+                    if(IsOpaqueAtHit(*polygon, i, u, v))
                     {
                         return true;
                     }
@@ -221,6 +219,25 @@ bool BSP::RaycastPolygon(const Ray& ray, const BSPPolygon* polygon, RaycastHit&
     return false;
 }
 
+void BSP::UpdateRaycastFlags()
+{
+    for(uint32_t i = 0; i < mRaycastTriangles.size(); ++i)
+    {
+        const BSPSurface& surface = mSurfaces[mPolygons[mRaycastTriangles[i].polygonIndex].surfaceIndex];
+        mRaycastBVH.SetFlags(i, GetRaycastFlags(surface));
+    }
+    mRaycastBVH.UpdateNodeFlags();
+}
+
+void BSP::UpdateRenderGroup(const BSPSurface& surface)
+{
+    // Refill the surface's render group before it is next drawn, so its range only includes visible surfaces.
+    #if !defined(USE_TRUE_BSP_RENDERING)
+    mRenderGroups[surface.renderGroupIndex].dirty = true;
+    mRenderGroupsDirty = true;
+    #endif
+}
+
 void BSP::SetFloorObjectName(const std::string& floorObjectName)
 {
     mFloorObjectIndex = GetObjectIndex(floorObjectName);
@@ -233,6 +250,7 @@ void BSP::SetFloorObjectName(const std::string& floorObjectName)
             surface.walkHitTest = true;
         }
     }
+    UpdateRaycastFlags();
 }
 
 bool BSP::GetFloorInfo(const Vector3& position, float& outHeight, Texture*& outTexture)
@@ -251,32 +269,14 @@ bool BSP::GetFloorInfo(const Vector3& position, float& outHeight, Texture*& outT
     // Create ray with origin high in the sky and pointing straight down.
     Ray ray(rayOrigin, -Vector3::UnitY);
 
-    // Iterate polygons.
-    float nearestT = FLT_MAX;
-    for(auto& polygon : mPolygons)
-    {
-        // Only consider polygons that are part of the floor object.
-        BSPSurface& surface = mSurfaces[polygon.surfaceIndex];
-        if(surface.objectIndex != mFloorObjectIndex) { continue; }
+    // Find the nearest floor triangle below the position.
+    float t = 0.0f;
+    int triangleIndex = mRaycastBVH.Raycast(ray, kRaycastFloorFlag, false, t);
+    if(triangleIndex < 0) { return false; }
 
-        // See if ray intersects any triangles in this polygon.
-        Vector3 p0 = mVertices[mVertexIndices[polygon.vertexIndexOffset]];
-        for(int i = 1; i < polygon.vertexIndexCount - 1; i++)
-        {
-            Vector3 p1 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i]];
-            Vector3 p2 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i + 1]];
-            float t = 0.0f;
-            if(Intersect::TestRayTriangle(ray, p0, p1, p2, t) && t < nearestT)
-            {
-                nearestT = t;
-                outHeight = ray.GetPoint(t).y;
-                outTexture = surface.texture;
-            }
-        }
-    }
-
-    // Return whether we hit anything.
-    return nearestT != FLT_MAX;
+    outHeight = ray.GetPoint(t).y;
+    outTexture = mSurfaces[mPolygons[mRaycastTriangles[triangleIndex].polygonIndex].surfaceIndex].texture;
+    return true;
 }
 
 void BSP::SetVisible(const std::string& objectName, bool visible)
@@ -291,6 +291,7 @@ void BSP::SetVisible(const std::string& objectName, bool visible)
         if(surface.objectIndex == index)
         {
             surface.visible = visible;
+            UpdateRenderGroup(surface);
         }
     }
 }
@@ -301,12 +302,19 @@ void BSP::SetTexture(const std::string& objectName, Texture* texture)
     uint32_t index = GetObjectIndex(objectName);
     if(index == UINT32_MAX) { return; }
 
-    // All surfaces belonging to this object will be hidden.
-    for(auto& surface : mSurfaces)
+    // All surfaces belonging to this object will use the new texture.
+    for(uint32_t i = 0; i < mSurfaces.size(); ++i)
     {
-        if(surface.objectIndex == index)
+        if(mSurfaces[i].objectIndex == index)
         {
-            surface.texture = texture;
+            // A different texture means a different render group.
+            #if !defined(USE_TRUE_BSP_RENDERING)
+            RemoveFromRenderGroup(i);
+            mSurfaces[i].texture = texture;
+            AddToRenderGroup(i);
+            #else
+            mSurfaces[i].texture = texture;
+            #endif
         }
     }
 }
@@ -325,6 +333,7 @@ void BSP::SetHitTest(const std::string& objectName, bool isHitTest)
             surface.hitTest = isHitTest;
         }
     }
+    UpdateRaycastFlags();
 }
 
 bool BSP::Exists(const std::string& objectName) const
@@ -389,40 +398,56 @@ Vector3 BSP::GetPosition(const std::string& objectName) const
 
 void BSP::ApplyLightmap(const BSPLightmap& lightmap)
 {
-    // Apply lightmap textures to each surface.
-    const std::vector<Texture*>& lightmapTextures = lightmap.GetLightmapTextures();
-    for(size_t i = 0; i < mSurfaces.size(); ++i)
+    // Apply lightmap atlas regions to each surface.
+    const std::vector<BSPLightmap::Region>& regions = lightmap.GetRegions();
+    for(size_t i = 0; i < mSurfaces.size() && i < regions.size(); ++i)
     {
-        mSurfaces[i].lightmapTexture = lightmapTextures[i];
+        BSPSurface& surface = mSurfaces[i];
+        const BSPLightmap::Region& region = regions[i];
+        surface.lightmapTexture = region.texture;
+
+        // The surface's lightmap UV is (uv + offset) * scale. To land in the atlas region, that result must then be scaled/offset by the region.
+        // Fold both into one offset/scale: (uv + offset + regionOffset / newScale) * newScale.
+        Vector2 scale = surface.fileLightmapUvScale * region.uvScale;
+        Vector2 offset = surface.fileLightmapUvOffset;
+        offset.x += Math::IsZero(scale.x) ? 0.0f : region.uvOffset.x / scale.x;
+        offset.y += Math::IsZero(scale.y) ? 0.0f : region.uvOffset.y / scale.y;
+        surface.lightmapUvScale = scale;
+        surface.lightmapUvOffset = offset;
     }
 
-    // Update light colors now that lightmap textures are populated.
+    // Update light colors now that lightmaps are populated.
     for(auto& light : mLights)
     {
-        if(mSurfaces[light.surfaceIndex].lightmapTexture != nullptr)
+        if(light.surfaceIndex >= regions.size()) { continue; }
+        const BSPLightmap::Region& region = regions[light.surfaceIndex];
+        if(region.texture != nullptr && region.width > 0 && region.height > 0)
         {
-            int width = mSurfaces[light.surfaceIndex].lightmapTexture->GetWidth();
-            int height = mSurfaces[light.surfaceIndex].lightmapTexture->GetHeight();
-
             // Use a single center point to calculate the color?
-            //light.color = mSurfaces[light.surfaceIndex].lightmapTexture->GetPixelColor32(width / 2, height / 2);
+            //light.color = region.texture->GetPixelColor32(region.x + region.width / 2, region.y + region.height / 2);
 
-            // Or sum and average all pixels in the lightmap?
+            // Or sum and average all pixels in the surface's region of the lightmap atlas?
             Vector3 sums;
-            for(int i = 0; i < width; ++i)
+            for(uint32_t i = 0; i < region.width; ++i)
             {
-                for(int j = 0; j < height; ++j)
+                for(uint32_t j = 0; j < region.height; ++j)
                 {
-                    Color32 color = mSurfaces[light.surfaceIndex].lightmapTexture->GetPixelColor32(i, j);
+                    Color32 color = region.texture->GetPixelColor32(region.x + i, region.y + j);
                     sums.x += color.GetR();
                     sums.y += color.GetG();
                     sums.z += color.GetB();
                 }
             }
-            sums /= static_cast<float>(width * height);
+            sums /= static_cast<float>(region.width * region.height);
             light.color = Color32(static_cast<int>(sums.x), static_cast<int>(sums.y), static_cast<int>(sums.z));
         }
     }
+
+    // Lightmap UVs and textures have changed, so rebuild render data.
+    // Surfaces that share an atlas can now be drawn together.
+    #if !defined(USE_TRUE_BSP_RENDERING)
+    BuildRenderData();
+    #endif
 }
 
 void BSP::DebugDrawAmbientLights(const Vector3& position)
@@ -480,10 +505,9 @@ Color32 BSP::CalculateAmbientLightColor(const Vector3& position)
     */
 }
 
-// For debugging BSP issues, helpful to track polygons rendered and tree depth.
+// For debugging BSP issues, helpful to track tree depth.
 namespace
 {
-    int renderedPolygonCount = 0;
     int treeDepth = 0;
 }
 
@@ -493,7 +517,7 @@ void BSP::RenderOpaque(const Vector3& cameraPosition, const Vector3& cameraDirec
     mMaterial.Activate(Matrix4::Identity);
 
     // Reset render stat values.
-    renderedPolygonCount = 0;
+    mDrawCallCount = 0;
     treeDepth = 0;
 
     #if defined(USE_TRUE_BSP_RENDERING)
@@ -503,26 +527,11 @@ void BSP::RenderOpaque(const Vector3& cameraPosition, const Vector3& cameraDirec
     RenderTree(mNodes[mRootNodeIndex], cameraPosition, cameraDirection);
     #else
     // ALTERNATIVE BSP RENDERING
-    // Just render every surface lol.
-    // Surprisingly more efficient than "correct" BSP rendering, since it's fewer draw calls.
-    for(BSPSurface& surface : mSurfaces)
-    {
-        if(!surface.visible) { continue; }
-        if(surface.IsTranslucent()) { continue; }
-
-        // Activate
-        surface.Activate(mMaterial);
-
-        // Draw
-        for(auto& polygon : surface.polygons)
-        {
-            mVertexArray.DrawTriangleFans(polygon.vertexIndexOffset, polygon.vertexIndexCount);
-            renderedPolygonCount++;
-        }
-    }
+    // Just render every visible surface lol, one draw call per render group.
+    // Surprisingly more efficient than "correct" BSP rendering, since it's far fewer draw calls.
+    UpdateRenderIndexes();
+    RenderGroups(false);
     #endif
-
-    //std::cout << "Rendered " << renderedPolygonCount << " polygons." << std::endl;
 }
 
 void BSP::RenderTranslucent()
@@ -539,20 +548,8 @@ void BSP::RenderTranslucent()
     }
     mAlphaPolygons = nullptr;
     #else
-    for(auto& surface : mSurfaces)
-    {
-        if(!surface.visible) { continue; }
-        if(!surface.IsTranslucent()) { continue; }
-
-        // Activate
-        surface.Activate(mMaterial);
-
-        // Draw
-        for(auto& polygon : surface.polygons)
-        {
-            mVertexArray.DrawTriangleFans(polygon.vertexIndexOffset, polygon.vertexIndexCount);
-        }
-    }
+    UpdateRenderIndexes();
+    RenderGroups(true);
     #endif
 }
 
@@ -569,7 +566,70 @@ uint32_t BSP::GetObjectIndex(const std::string& objectName) const
     return UINT32_MAX;
 }
 
-void BSP::ParseFromData(uint8_t* data, uint32_t dataLength)
+void BSP::BenchmarkRaycasts(int rayCount)
+{
+    if(rayCount <= 0 || mVertices.empty()) { return; }
+
+    // Generate random rays, starting inside the BSP's bounds, pointing in random directions.
+    AABB bounds(mVertices[0], mVertices[0]);
+    for(const Vector3& vertex : mVertices)
+    {
+        bounds.GrowToContain(vertex);
+    }
+    std::vector<Ray> rays(rayCount);
+    for(Ray& ray : rays)
+    {
+        Vector3 min = bounds.GetMin();
+        Vector3 max = bounds.GetMax();
+        ray.origin = Vector3(Random::Range(min.x, max.x), Random::Range(min.y, max.y), Random::Range(min.z, max.z));
+        ray.direction = Vector3(Random::Range(-1.0f, 1.0f), Random::Range(-1.0f, 1.0f), Random::Range(-1.0f, 1.0f));
+        if(ray.direction == Vector3::Zero)
+        {
+            ray.direction = Vector3::UnitZ;
+        }
+        ray.direction.Normalize();
+    }
+
+    // Fire all rays using the brute force path.
+    std::vector<RaycastHit> bruteForceHits(rayCount);
+    Stopwatch stopwatch;
+    for(int i = 0; i < rayCount; ++i)
+    {
+        RaycastNearestBruteForce(rays[i], bruteForceHits[i], false);
+    }
+    float bruteForceMs = stopwatch.GetMilliseconds();
+
+    // Fire them again using the BVH.
+    std::vector<RaycastHit> bvhHits(rayCount);
+    stopwatch.Reset();
+    for(int i = 0; i < rayCount; ++i)
+    {
+        RaycastNearest(rays[i], bvhHits[i], false);
+    }
+    float bvhMs = stopwatch.GetMilliseconds();
+
+    // Both paths should agree on what was hit (allowing for tiny differences where triangles meet).
+    int hitCount = 0;
+    int mismatchCount = 0;
+    for(int i = 0; i < rayCount; ++i)
+    {
+        bool bruteForceHit = bruteForceHits[i].t != FLT_MAX;
+        bool bvhHit = bvhHits[i].t != FLT_MAX;
+        if(bvhHit)
+        {
+            ++hitCount;
+        }
+        if(bruteForceHit != bvhHit || (bvhHit && !Math::AreEqual(bruteForceHits[i].t, bvhHits[i].t)))
+        {
+            ++mismatchCount;
+        }
+    }
+
+    gReportManager.Log("Dump", StringUtil::Format("BSP %s: %d rays, %d hits, %u triangles", GetName().c_str(), rayCount, hitCount, mRaycastBVH.GetTriangleCount()));
+    gReportManager.Log("Dump", StringUtil::Format("Brute force: %.3fms, BVH: %.3fms (%.1fx), %d mismatches", bruteForceMs, bvhMs, bvhMs > 0.0f ? bruteForceMs / bvhMs : 0.0f, mismatchCount));
+}
+
+void BSP::ParseFromData(const uint8_t* data, uint32_t dataLength)
 {
     BinaryReader reader(data, dataLength);
 
@@ -610,6 +670,23 @@ void BSP::ParseFromData(uint8_t* data, uint32_t dataLength)
     // We don't want to process a single texture more than once!
     std::vector<Texture*> processedShadowTextures;
 
+    // Scenes can use hundreds of textures. Before reading surfaces, preload all of them as a batch.
+    // Each surface is 60 bytes, with a 4-byte object index followed by the 32-byte texture name.
+    {
+        const uint32_t kSurfaceSize = 60;
+        uint32_t surfacesPosition = reader.GetPosition();
+        std::vector<std::string> textureNames;
+        textureNames.reserve(surfaceCount);
+        for(uint32_t i = 0; i < surfaceCount; ++i)
+        {
+            reader.Seek(surfacesPosition + i * kSurfaceSize + 4);
+            std::string textureName = reader.ReadString(32);
+            textureNames.push_back(Path::HasExtension(textureName) ? textureName : textureName + ".BMP");
+        }
+        reader.Seek(surfacesPosition);
+        gAssetManager.PreloadAssets(textureNames, GetScope());
+    }
+
     // Iterate and read surfaces.
     mSurfaces.resize(surfaceCount);
     for(uint32_t i = 0; i < surfaceCount; ++i)
@@ -619,8 +696,10 @@ void BSP::ParseFromData(uint8_t* data, uint32_t dataLength)
 
         surface.texture = gAssetManager.LoadSceneTexture(reader.ReadString(32), GetScope());
 
-        surface.lightmapUvOffset = reader.ReadVector2();
-        surface.lightmapUvScale = reader.ReadVector2();
+        surface.fileLightmapUvOffset = reader.ReadVector2();
+        surface.fileLightmapUvScale = reader.ReadVector2();
+        surface.lightmapUvOffset = surface.fileLightmapUvOffset;
+        surface.lightmapUvScale = surface.fileLightmapUvScale;
 
         reader.ReadFloat(); // Unknown - I had assumed this was a scale earlier, but I'm not sure.
 
@@ -635,6 +714,19 @@ void BSP::ParseFromData(uint8_t* data, uint32_t dataLength)
         */
     }
 
+    // Surface textures are done being modified (LoadSceneTexture applies fixes to them), so they can be uploaded to the GPU.
+    {
+        std::vector<Texture*> surfaceTextures;
+        for(const BSPSurface& surface : mSurfaces)
+        {
+            if(surface.texture != nullptr && std::find(surfaceTextures.begin(), surfaceTextures.end(), surface.texture) == surfaceTextures.end())
+            {
+                surfaceTextures.push_back(surface.texture);
+            }
+        }
+        gAssetManager.QueueTextureUploads(surfaceTextures);
+    }
+
     // Iterate and read nodes.
     mNodes.resize(nodeCount);
     for(uint32_t i = 0; i < nodeCount; ++i)
@@ -670,11 +762,6 @@ void BSP::ParseFromData(uint8_t* data, uint32_t dataLength)
         polygon.vertexIndexCount = reader.ReadUShort();
         polygon.surfaceIndex = reader.ReadUShort();
 
-        // With "true" BSP rendering, maintaining a list of polygons for a surface is not needed.
-        // But otherwise, it's handy to have.
-        #if !defined(USE_TRUE_BSP_RENDERING)
-        mSurfaces[polygon.surfaceIndex].polygons.push_back(polygon);
-        #endif
     }
 
     // Iterate and read planes.
@@ -759,26 +846,423 @@ void BSP::ParseFromData(uint8_t* data, uint32_t dataLength)
         }
     }
 
-    // Generate mesh definition.
-    MeshDefinition meshDefinition(MeshUsage::Static, mVertices.size());
+    // RC3 has a single notable surface that is stretched and z-fights pretty bad. It's even present in the original game.
+    // Force it invisible to fix that!
+    if(StringUtil::StartsWith(GetName(), "RC3") && mSurfaces.size() > 582)
+    {
+        mSurfaces[582].visible = false;
+    }
+
+    // Generate vertex/index data used for rendering.
+    BuildRenderData();
+
+    // With all geometry loaded, we can build the raycast BVH.
+    BuildRaycastBVH();
+}
+
+void BSP::BuildRaycastBVH()
+{
+    // Add each triangle of each polygon. Polygons are triangle fans, so the first vertex is shared by all triangles in the polygon.
+    mRaycastBVH.Clear();
+    mRaycastTriangles.clear();
+    for(uint32_t polygonIndex = 0; polygonIndex < mPolygons.size(); ++polygonIndex)
+    {
+        const BSPPolygon& polygon = mPolygons[polygonIndex];
+        uint32_t flags = GetRaycastFlags(mSurfaces[polygon.surfaceIndex]);
+
+        const Vector3& p0 = mVertices[mVertexIndices[polygon.vertexIndexOffset]];
+        for(int i = 1; i < polygon.vertexIndexCount - 1; ++i)
+        {
+            const Vector3& p1 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i]];
+            const Vector3& p2 = mVertices[mVertexIndices[polygon.vertexIndexOffset + i + 1]];
+            mRaycastBVH.AddTriangle(p0, p1, p2, flags);
+
+            mRaycastTriangles.emplace_back();
+            mRaycastTriangles.back().polygonIndex = polygonIndex;
+            mRaycastTriangles.back().fanIndex = i;
+        }
+    }
+    mRaycastBVH.Build();
+}
+
+uint32_t BSP::GetRaycastFlags(const BSPSurface& surface) const
+{
+    uint32_t flags = 0;
+    if(surface.interactive)
+    {
+        flags |= kRaycastInteractiveFlag;
+    }
+    if(surface.walkHitTest)
+    {
+        flags |= kRaycastWalkHitTestFlag;
+    }
+    if(surface.hitTest)
+    {
+        flags |= kRaycastHitTestFlag;
+    }
+    if(mFloorObjectIndex != UINT32_MAX && surface.objectIndex == mFloorObjectIndex)
+    {
+        flags |= kRaycastFloorFlag;
+    }
+    return flags;
+}
+
+bool BSP::RaycastNearestBruteForce(const Ray& ray, RaycastHit& outHitInfo, bool forWalk)
+{
+    // Values for tracking closest found hit.
+    outHitInfo.t = FLT_MAX;
+    std::string* closest = nullptr;
+
+    // Iterate polygons and check each one for intersection with the ray.
+    // We must iterate ALL polygons (can't stop at first hit) in case a subsequent polygon is nearer to the start of the ray.
+    for(BSPPolygon& polygon : mPolygons)
+    {
+        // Ignore polygons that are part of non-interactive surfaces.
+        BSPSurface& surface = mSurfaces[polygon.surfaceIndex];
+        if(surface.interactive || (forWalk && surface.walkHitTest))
+        {
+            // Do the raycast against the polygon.
+            RaycastHit hitInfo;
+            if(RaycastPolygon(ray, &polygon, hitInfo))
+            {
+                // Is it closer than any other polygon so far? Then it's our nearest hit.
+                if(hitInfo.t < outHitInfo.t)
+                {
+                    // Save closest distance.
+                    outHitInfo.t = hitInfo.t;
+
+                    // Track name of closest object hit.
+                    closest = &mObjectNames[surface.objectIndex];
+                }
+            }
+        }
+    }
+
+    // If no closest object was found, no hits occurred. Early out.
+    if(closest == nullptr) { return false; }
+
+    // Otherwise, fill in out hit info and return.
+    outHitInfo.name = *closest;
+    return true;
+}
+
+bool BSP::IsOpaqueAtHit(const BSPPolygon& polygon, int fanIndex, float u, float v)
+{
+    // Only textures with transparent pixels can let a ray through.
+    Texture* texture = mSurfaces[polygon.surfaceIndex].texture;
+    if(texture == nullptr || texture->GetRenderType() == Texture::RenderType::Opaque) { return true; }
+
+    // When we did the Ray/Triangle intersection test, we also calculated the barycentric coordinates as a byproduct of that test.
+    // We can use those here to calculate the UV coordinates associated with the ray hit point.
+    Vector2 uv0 = mUVs[mVertexIndices[polygon.vertexIndexOffset]];
+    Vector2 uv1 = mUVs[mVertexIndices[polygon.vertexIndexOffset + fanIndex]];
+    Vector2 uv2 = mUVs[mVertexIndices[polygon.vertexIndexOffset + fanIndex + 1]];
+
+    //TODO: This math doesn't totally make sense to me, and I think it needs more scrutinizing.
+    //TODO: Why do u/v/w not correlate to uv0/uv1/uv2 here? Why do we need to negate and flop the UVs?
+    Vector2 pointUV = uv1 * u + uv2 * v + uv0 * (1.0f - u - v);
+    pointUV.y *= -1.0f;
+    pointUV.y = 1.0f - pointUV.y;
+
+    // We got the UV, convert that into a specific pixel color from this polygon's surface texture.
+    // If the color is transparent, this doesn't count as a hit - the ray "goes through" the transparent area.
+    // But if at all opaque, we count this as a hit.
+    Vector2 pixelPos(pointUV.x * texture->GetWidth(), pointUV.y * texture->GetHeight());
+    Color32 color = texture->GetPixelColor32(pixelPos.x, pixelPos.y);
+    return color.a > 0;
+}
+
+void BSP::BuildRenderData()
+{
+    // Release any existing render data; it's about to be replaced.
+    mVertexArray = VertexArray();
+
+    // Vertex data used for rendering.
+    std::vector<Vector3> positions;
+    std::vector<Vector2> uvs;
+    std::vector<Vector2> lightmapUvs;
+
+    #if defined(USE_TRUE_BSP_RENDERING)
+    // Tree rendering draws each polygon as a triangle fan, straight from the BSP's vertices and vertex indexes.
+    // Lightmap UVs are calculated in the shader from the texture UVs, using per-surface offset/scale.
+    positions = mVertices;
+    uvs = mUVs;
+    lightmapUvs = mUVs;
+    std::vector<uint16_t> indexes = mVertexIndices;
+    #else
+    // Gather the polygons belonging to each surface.
+    std::vector<std::vector<uint32_t>> surfacePolygons(mSurfaces.size());
+    for(uint32_t i = 0; i < mPolygons.size(); ++i)
+    {
+        surfacePolygons[mPolygons[i].surfaceIndex].push_back(i);
+    }
+
+    // Each surface has its own lightmap UV offset/scale. Ideally, we bake that into the vertices, so surfaces with different values can be drawn together.
+    // But vertices shared by surfaces with different lightmap UVs must be duplicated, and 16-bit indexes limit how many vertices we can have.
+    // If baking needs too many vertices, fall back on the BSP's vertices and setting lightmap UV offset/scale per render group.
+    const size_t kMaxVertexCount = UINT16_MAX + 1;
+    for(int attempt = 0; attempt < 2; ++attempt)
+    {
+        mLightmapUvsBaked = (attempt == 0);
+        positions.clear();
+        uvs.clear();
+        lightmapUvs.clear();
+        mSurfaceTriangleIndexes.clear();
+
+        // When baking, each BSP vertex has a chain of render vertices created from it, each with different lightmap UVs.
+        std::vector<uint32_t> firstRenderVertex(mVertices.size(), UINT32_MAX);
+        std::vector<uint32_t> nextRenderVertex;
+
+        for(uint32_t surfaceIndex = 0; surfaceIndex < mSurfaces.size(); ++surfaceIndex)
+        {
+            BSPSurface& surface = mSurfaces[surfaceIndex];
+            surface.triangleIndexOffset = static_cast<uint32_t>(mSurfaceTriangleIndexes.size());
+            for(uint32_t polygonIndex : surfacePolygons[surfaceIndex])
+            {
+                // Polygons are triangle fans. Convert to a triangle list, keeping the same winding order.
+                const BSPPolygon& polygon = mPolygons[polygonIndex];
+                uint32_t firstIndex = 0;
+                uint32_t prevIndex = 0;
+                for(uint32_t i = 0; i < polygon.vertexIndexCount; ++i)
+                {
+                    uint16_t vertexIndex = mVertexIndices[polygon.vertexIndexOffset + i];
+                    uint32_t renderIndex = vertexIndex;
+                    if(mLightmapUvsBaked)
+                    {
+                        // Reuse a render vertex with matching lightmap UV, or create a new one.
+                        Vector2 lightmapUv = (mUVs[vertexIndex] + surface.lightmapUvOffset) * surface.lightmapUvScale;
+                        renderIndex = firstRenderVertex[vertexIndex];
+                        while(renderIndex != UINT32_MAX && lightmapUvs[renderIndex] != lightmapUv)
+                        {
+                            renderIndex = nextRenderVertex[renderIndex];
+                        }
+                        if(renderIndex == UINT32_MAX)
+                        {
+                            renderIndex = static_cast<uint32_t>(positions.size());
+                            positions.push_back(mVertices[vertexIndex]);
+                            uvs.push_back(mUVs[vertexIndex]);
+                            lightmapUvs.push_back(lightmapUv);
+                            nextRenderVertex.push_back(firstRenderVertex[vertexIndex]);
+                            firstRenderVertex[vertexIndex] = renderIndex;
+                        }
+                    }
+
+                    if(i == 0)
+                    {
+                        firstIndex = renderIndex;
+                    }
+                    else if(i >= 2)
+                    {
+                        mSurfaceTriangleIndexes.push_back(static_cast<uint16_t>(firstIndex));
+                        mSurfaceTriangleIndexes.push_back(static_cast<uint16_t>(prevIndex));
+                        mSurfaceTriangleIndexes.push_back(static_cast<uint16_t>(renderIndex));
+                    }
+                    prevIndex = renderIndex;
+                }
+            }
+            surface.triangleIndexCount = static_cast<uint32_t>(mSurfaceTriangleIndexes.size()) - surface.triangleIndexOffset;
+        }
+
+        // Without baking, the BSP's vertices are used as-is.
+        if(!mLightmapUvsBaked)
+        {
+            positions = mVertices;
+            uvs = mUVs;
+            lightmapUvs = mUVs;
+        }
+        if(positions.size() <= kMaxVertexCount) { break; }
+    }
+
+    // Group surfaces and fill the index buffer.
+    BuildRenderGroups();
+    UpdateRenderIndexes();
+    std::vector<uint16_t>& indexes = mRenderIndexes;
+    #endif
+
+    // Generate mesh definition. The vertex array takes ownership of copies of the data.
+    MeshDefinition meshDefinition(MeshUsage::Static, positions.size());
     meshDefinition.SetVertexLayout(VertexLayout::Packed);
 
-    meshDefinition.AddVertexData(VertexAttribute::Position, &mVertices[0]);
-    meshDefinition.AddVertexData(VertexAttribute::UV1, &mUVs[0]);
+    Vector3* positionData = new Vector3[positions.size()];
+    std::copy(positions.begin(), positions.end(), positionData);
+    meshDefinition.AddVertexData(VertexAttribute::Position, positionData);
+
+    Vector2* uvData = new Vector2[uvs.size()];
+    std::copy(uvs.begin(), uvs.end(), uvData);
+    meshDefinition.AddVertexData(VertexAttribute::UV1, uvData);
 
-    meshDefinition.SetIndexData(mVertexIndices.size(), &mVertexIndices[0]);
-    meshDefinition.ownsData = false;
+    Vector2* lightmapUvData = new Vector2[lightmapUvs.size()];
+    std::copy(lightmapUvs.begin(), lightmapUvs.end(), lightmapUvData);
+    meshDefinition.AddVertexData(VertexAttribute::UV2, lightmapUvData);
+
+    unsigned short* indexData = new unsigned short[indexes.size()];
+    std::copy(indexes.begin(), indexes.end(), indexData);
+    meshDefinition.SetIndexData(indexes.size(), indexData);
 
     // Create vertex array.
     mVertexArray = VertexArray(meshDefinition);
+}
 
-    // RC3 has a single notable surface that is stretched and z-fights pretty bad. It's even present in the original game.
-    // Force it invisible to fix that!
-    if(StringUtil::StartsWith(GetName(), "RC3") && mSurfaces.size() > 582)
+#if !defined(USE_TRUE_BSP_RENDERING)
+void BSP::BuildRenderGroups()
+{
+    // Assign every surface to a group, then give each group its own range of the index buffer.
+    mRenderGroups.clear();
+    for(uint32_t i = 0; i < mSurfaces.size(); ++i)
     {
-        mSurfaces[582].visible = false;
+        AddToRenderGroup(i);
+    }
+    LayoutRenderGroups();
+}
+
+void BSP::LayoutRenderGroups()
+{
+    // Lay out group ranges back-to-back, with enough space for all surfaces in the group (even if hidden).
+    uint32_t indexOffset = 0;
+    for(RenderGroup& group : mRenderGroups)
+    {
+        group.indexOffset = indexOffset;
+        group.indexCapacity = 0;
+        for(uint32_t surfaceIndex : group.surfaceIndexes)
+        {
+            group.indexCapacity += mSurfaces[surfaceIndex].triangleIndexCount;
+        }
+        group.dirty = true;
+        indexOffset += group.indexCapacity;
+    }
+    mRenderIndexes.resize(indexOffset);
+    mRenderGroupsDirty = true;
+}
+
+void BSP::AddToRenderGroup(uint32_t surfaceIndex)
+{
+    // Determine how this surface is rendered.
+    BSPSurface& surface = mSurfaces[surfaceIndex];
+    bool ignoresLightmap = surface.IgnoresLightmap();
+    Texture* lightmapTexture = ignoresLightmap ? nullptr : surface.lightmapTexture;
+    Vector4 lightmapUvScaleOffset(1.0f, 1.0f, 0.0f, 0.0f);
+    if(!mLightmapUvsBaked)
+    {
+        lightmapUvScaleOffset = Vector4(surface.lightmapUvScale.x, surface.lightmapUvScale.y,
+                                        surface.lightmapUvOffset.x, surface.lightmapUvOffset.y);
+    }
+
+    // Find a group that renders the same way, or create a new one.
+    uint32_t groupIndex = 0;
+    for(; groupIndex < mRenderGroups.size(); ++groupIndex)
+    {
+        const RenderGroup& group = mRenderGroups[groupIndex];
+        if(group.texture == surface.texture &&
+           group.lightmapTexture == lightmapTexture &&
+           group.ignoresLightmap == ignoresLightmap &&
+           group.translucent == surface.IsTranslucent() &&
+           group.lightmapUvScaleOffset == lightmapUvScaleOffset)
+        {
+            break;
+        }
+    }
+    if(groupIndex == mRenderGroups.size())
+    {
+        mRenderGroups.emplace_back();
+        RenderGroup& group = mRenderGroups.back();
+        group.texture = surface.texture;
+        group.lightmapTexture = lightmapTexture;
+        group.lightmapUvScaleOffset = lightmapUvScaleOffset;
+        group.ignoresLightmap = ignoresLightmap;
+        group.translucent = surface.IsTranslucent();
+        group.indexOffset = static_cast<uint32_t>(mRenderIndexes.size());
+    }
+
+    // Add surface to the group.
+    RenderGroup& group = mRenderGroups[groupIndex];
+    group.surfaceIndexes.push_back(surfaceIndex);
+    surface.renderGroupIndex = groupIndex;
+    group.dirty = true;
+    mRenderGroupsDirty = true;
+
+    // If the group's range is too small, move it to the end of the index buffer.
+    // Its old range is left unused; if too much of the buffer is unused, lay everything out again.
+    uint32_t requiredCapacity = 0;
+    for(uint32_t i : group.surfaceIndexes)
+    {
+        requiredCapacity += mSurfaces[i].triangleIndexCount;
+    }
+    if(requiredCapacity > group.indexCapacity)
+    {
+        group.indexOffset = static_cast<uint32_t>(mRenderIndexes.size());
+        group.indexCapacity = requiredCapacity;
+        mRenderIndexes.resize(mRenderIndexes.size() + requiredCapacity);
+
+        size_t usedCapacity = 0;
+        for(const RenderGroup& renderGroup : mRenderGroups)
+        {
+            usedCapacity += renderGroup.indexCapacity;
+        }
+        if(mRenderIndexes.size() > usedCapacity * 2)
+        {
+            LayoutRenderGroups();
+        }
+    }
+}
+
+void BSP::RemoveFromRenderGroup(uint32_t surfaceIndex)
+{
+    RenderGroup& group = mRenderGroups[mSurfaces[surfaceIndex].renderGroupIndex];
+    auto it = std::find(group.surfaceIndexes.begin(), group.surfaceIndexes.end(), surfaceIndex);
+    if(it != group.surfaceIndexes.end())
+    {
+        group.surfaceIndexes.erase(it);
+    }
+    group.dirty = true;
+    mRenderGroupsDirty = true;
+}
+
+void BSP::UpdateRenderIndexes()
+{
+    if(!mRenderGroupsDirty) { return; }
+
+    // Refill the range of each dirty group with the triangles of its visible surfaces.
+    for(RenderGroup& group : mRenderGroups)
+    {
+        if(!group.dirty) { continue; }
+        group.indexCount = 0;
+        for(uint32_t surfaceIndex : group.surfaceIndexes)
+        {
+            const BSPSurface& surface = mSurfaces[surfaceIndex];
+            if(!surface.visible) { continue; }
+
+            std::copy(mSurfaceTriangleIndexes.begin() + surface.triangleIndexOffset,
+                      mSurfaceTriangleIndexes.begin() + surface.triangleIndexOffset + surface.triangleIndexCount,
+                      mRenderIndexes.begin() + group.indexOffset + group.indexCount);
+            group.indexCount += surface.triangleIndexCount;
+        }
+        group.dirty = false;
+    }
+    mRenderGroupsDirty = false;
+
+    // Send updated indexes to the GPU (if the vertex array has been created yet - otherwise, it's created with these indexes).
+    if(mVertexArray.GetVertexCount() > 0 && !mRenderIndexes.empty())
+    {
+        mVertexArray.ChangeIndexData(mRenderIndexes.data(), static_cast<uint32_t>(mRenderIndexes.size()));
+    }
+}
+
+void BSP::RenderGroups(bool translucent)
+{
+    for(RenderGroup& group : mRenderGroups)
+    {
+        if(group.translucent != translucent) { continue; }
+        if(group.indexCount == 0) { continue; }
+
+        // Activate
+        ActivateTextures(mMaterial, group.texture, group.lightmapTexture, group.ignoresLightmap, group.lightmapUvScaleOffset);
+
+        // Draw
+        mVertexArray.DrawTriangles(group.indexOffset, group.indexCount);
+        ++mDrawCallCount;
     }
 }
+#endif
 
 #if defined(USE_TRUE_BSP_RENDERING)
 void BSP::RenderTree(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection)
@@ -896,6 +1380,6 @@ void BSP::RenderPolygon(BSPPolygon& polygon, bool translucent)
 
     // Draw the polygon.
     mVertexArray.DrawTriangleFans(polygon.vertexIndexOffset, polygon.vertexIndexCount);
-    ++renderedPolygonCount;
+    ++mDrawCallCount;
 }
 #endif
\ No newline at end of file
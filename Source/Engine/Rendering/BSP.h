@@ -15,9 +15,12 @@
 #include "Plane.h"
 #include "Ray.h"
 #include "Collisions.h"
+#include "TriangleBVH.h"
 #include "Vector2.h"
 #include "Vector3.h"
+#include "Vector4.h"
 
+class AssetBuffer;
 class BSPActor;
 class BSPLightmap;
 class Texture;
@@ -78,7 +81,7 @@ struct BSPSurface
     Texture* texture = nullptr;
 
     // An optional lightmap texture - applied from a lightmap asset.
-    //TODO: this works OK, but it'd be more efficient to use a lightmap atlas instead of many individual textures.
+    // This is an atlas shared by many surfaces; lightmap UV offset/scale map into this surface's region of it.
     Texture* lightmapTexture = nullptr;
 
     // UVs used for the lightmap are often different from the UVs used for diffuse textures.
@@ -86,6 +89,10 @@ struct BSPSurface
     Vector2 lightmapUvOffset;
     Vector2 lightmapUvScale;
 
+    // The lightmap UV offset/scale from the BSP file, before being adjusted to map into a lightmap atlas.
+    Vector2 fileLightmapUvOffset;
+    Vector2 fileLightmapUvScale;
+
     // Flags defining surface properties.
     uint32_t flags = 0;
     static const uint32_t kUnknownFlag1 = 1; // applied on certain walls, ceilings, and floors
@@ -109,12 +116,20 @@ struct BSPSurface
     // If true, this surface is a hit test for walking.
     bool walkHitTest = false;
 
-    // If not using true BSP rendering, it's efficient to store the polygons directly in the surface.
+    // If not using true BSP rendering, surfaces are drawn as part of a render group.
+    // The surface's polygons are stored as a triangle list (offset + count into the BSP's surface triangle indexes).
     #if !defined(USE_TRUE_BSP_RENDERING)
-    std::vector<BSPPolygon> polygons;
+    uint32_t triangleIndexOffset = 0;
+    uint32_t triangleIndexCount = 0;
+    uint32_t renderGroupIndex = 0;
+    #else
+    void Activate(const Material& material);
     #endif
 
-    void Activate(const Material& material);
+    bool IgnoresLightmap() const
+    {
+        return (flags & (kIgnoreLightmapFlag | kShadowTextureFlag)) != 0;
+    }
 
     bool IsTranslucent() const
     {
@@ -142,12 +157,18 @@ class BSP : public Asset
     TYPEINFO_SUB(BSP, Asset);
 public:
     BSP(const std::string& name, AssetScope scope) : Asset(name, scope) { }
-    void Load(uint8_t* data, uint32_t dataLength);
+    void Load(const AssetBuffer& buffer);
 
     // Raycasting
     bool RaycastNearest(const Ray& ray, RaycastHit& outHitInfo, bool forWalk = false);
     bool RaycastPolygon(const Ray& ray, const BSPPolygon* polygon, RaycastHit& outHitInfo);
 
+    // Must be called after changing surface raycast properties (interactive, hitTest, walkHitTest).
+    void UpdateRaycastFlags();
+
+    // Must be called after changing a surface's visibility.
+    void UpdateRenderGroup(const BSPSurface& surface);
+
     // Floors
     void SetFloorObjectName(const std::string& floorObjectName);
     bool GetFloorInfo(const Vector3& position, float& outHeight, Texture*& outTexture);
@@ -159,6 +180,7 @@ public:
     void SetHitTest(const std::string& objectName, bool isHitTest);
 
     // Object Queries
+    uint32_t GetObjectIndex(const std::string& objectName) const;
     bool Exists(const std::string& objectName) const;
     bool IsVisible(const std::string& objectName) const;
     Vector3 GetPosition(const std::string& objectName) const;
@@ -171,6 +193,10 @@ public:
     // Rendering
     void RenderOpaque(const Vector3& cameraPosition, const Vector3& cameraDirection);
     void RenderTranslucent();
+    uint32_t GetDrawCallCount() const { return mDrawCallCount; }
+
+    // Debugging
+    void BenchmarkRaycasts(int rayCount);
 
 private:
     // Identifies the root node in the node list.
@@ -208,8 +234,51 @@ private:
     std::vector<unsigned short> mVertexIndices;
 
     // Vertex array is loaded up with vertices/uvs/indices to perform rendering.
+    // Its vertices aren't necessarily the same as above - see BuildRenderData.
     VertexArray mVertexArray;
 
+    #if !defined(USE_TRUE_BSP_RENDERING)
+    // Surfaces that render identically (same textures and lightmap settings) are merged into a render group.
+    // Each group owns a range of the index buffer, which holds the triangles of its visible surfaces, so it can be drawn with one call.
+    struct RenderGroup
+    {
+        Texture* texture = nullptr;
+        Texture* lightmapTexture = nullptr;
+        Vector4 lightmapUvScaleOffset;
+        bool ignoresLightmap = false;
+        bool translucent = false;
+
+        // Surfaces in this group.
+        std::vector<uint32_t> surfaceIndexes;
+
+        // Range of the index buffer reserved for this group, and how much of it is currently filled.
+        uint32_t indexOffset = 0;
+        uint32_t indexCapacity = 0;
+        uint32_t indexCount = 0;
+
+        // If true, the group's index range is out-of-date and must be refilled before drawing.
+        bool dirty = true;
+    };
+    std::vector<RenderGroup> mRenderGroups;
+
+    // Each surface's polygons, converted from triangle fans to triangle lists.
+    // Render group index ranges are filled by copying from here.
+    std::vector<uint16_t> mSurfaceTriangleIndexes;
+
+    // CPU-side copy of the index buffer contents.
+    std::vector<uint16_t> mRenderIndexes;
+
+    // If true, per-surface lightmap UV offset/scale are baked into the UV2 vertex attribute.
+    // This allows surfaces with different lightmap UV transforms to be in the same render group.
+    bool mLightmapUvsBaked = false;
+
+    // If true, one or more render groups are dirty.
+    bool mRenderGroupsDirty = true;
+    #endif
+
+    // Number of draw calls made to render the BSP in the most recent frame.
+    uint32_t mDrawCallCount = 0;
+
     // Material for rendering BSP.
     Material mMaterial;
 
@@ -220,9 +289,38 @@ private:
     // Index of the object used for the floor in the BSP.
     uint32_t mFloorObjectIndex = UINT32_MAX;
 
-    uint32_t GetObjectIndex(const std::string& objectName) const;
+    // A BVH over all BSP triangles, to speed up raycasts.
+    // Each triangle's flags are derived from its surface's raycast properties.
+    TriangleBVH mRaycastBVH;
+    static const uint32_t kRaycastInteractiveFlag = 1;
+    static const uint32_t kRaycastWalkHitTestFlag = 2;
+    static const uint32_t kRaycastHitTestFlag = 4;
+    static const uint32_t kRaycastFloorFlag = 8;
+
+    // For each triangle in the BVH, the polygon it's from, and its index within that polygon's triangle fan.
+    struct RaycastTriangle
+    {
+        uint32_t polygonIndex = 0;
+        uint32_t fanIndex = 0;
+    };
+    std::vector<RaycastTriangle> mRaycastTriangles;
+
+    void ParseFromData(const uint8_t* data, uint32_t dataLength);
+    void BuildRenderData();
+
+    #if !defined(USE_TRUE_BSP_RENDERING)
+    void BuildRenderGroups();
+    void LayoutRenderGroups();
+    void AddToRenderGroup(uint32_t surfaceIndex);
+    void RemoveFromRenderGroup(uint32_t surfaceIndex);
+    void UpdateRenderIndexes();
+    void RenderGroups(bool translucent);
+    #endif
 
-    void ParseFromData(uint8_t* data, uint32_t dataLength);
+    void BuildRaycastBVH();
+    uint32_t GetRaycastFlags(const BSPSurface& surface) const;
+    bool RaycastNearestBruteForce(const Ray& ray, RaycastHit& outHitInfo, bool forWalk);
+    bool IsOpaqueAtHit(const BSPPolygon& polygon, int fanIndex, float u, float v);
 
     #if defined(USE_TRUE_BSP_RENDERING)
     void RenderTree(const BSPNode& node, const Vector3& cameraPosition, const Vector3& cameraDirection);
@@ -18,6 +18,7 @@ void BSPActor::SetVisible(bool visible)
     for(auto& surface : mSurfaces)
     {
         surface->visible = visible;
+        mBSP->UpdateRenderGroup(*surface);
     }
 }
 
@@ -27,6 +28,7 @@ void BSPActor::SetInteractive(bool interactive)
     {
         surface->interactive = interactive;
     }
+    mBSP->UpdateRaycastFlags();
 }
 
 bool BSPActor::Raycast(const Ray& ray, RaycastHit& hitInfo)
@@ -1,6 +1,10 @@
 #include "BSPLightmap.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "BinaryReader.h"
+#include "RectPacker.h"
 #include "Texture.h"
 
 TYPEINFO_INIT(BSPLightmap, Asset, GENERATE_TYPE_ID)
@@ -8,10 +12,20 @@ TYPEINFO_INIT(BSPLightmap, Asset, GENERATE_TYPE_ID)
 
 }
 
+namespace
+{
+    // Size of each atlas texture. A lightmap larger than this gets an atlas to itself.
+    const uint32_t kAtlasSize = 1024;
+
+    // Lightmaps are filtered bilinearly, so each is surrounded by a border of copied edge pixels.
+    // This keeps neighboring lightmaps in the atlas from bleeding into each other.
+    const uint32_t kAtlasPadding = 1;
+}
+
 BSPLightmap::~BSPLightmap()
 {
     // This class owns the textures created in the constructor, so we must delete them.
-    for(auto& texture : mLightmapTextures)
+    for(auto& texture : mAtlasTextures)
     {
         delete texture;
     }
@@ -34,22 +48,104 @@ void BSPLightmap::Load(uint8_t* data, uint32_t dataLength)
     unsigned int bitmapCount = reader.ReadUInt();
 
     // Iterate and read in each bitmap in turn.
+    std::vector<Texture*> lightmapTextures;
     for(unsigned int i = 0; i < bitmapCount; i++)
     {
         // The texture will be read in using the same reader object.
         // This should leave the reader ready to read in the NEXT texture (assuming no texture parsing bugs).
-        Texture* texture = new Texture(reader);
-        texture->SetFilterMode(Texture::FilterMode::Bilinear);
-        texture->SetWrapMode(Texture::WrapMode::Clamp);
-        mLightmapTextures.push_back(texture);
+        lightmapTextures.push_back(new Texture(reader));
+    }
+
+    // Pack lightmaps tallest-first, which packs them more tightly.
+    std::vector<uint32_t> packOrder(lightmapTextures.size());
+    for(uint32_t i = 0; i < packOrder.size(); ++i)
+    {
+        packOrder[i] = i;
+    }
+    std::stable_sort(packOrder.begin(), packOrder.end(), [&lightmapTextures](uint32_t a, uint32_t b) {
+        return lightmapTextures[a]->GetHeight() > lightmapTextures[b]->GetHeight();
+    });
+
+    // Find a spot for each lightmap, creating more atlases as needed.
+    std::vector<RectPacker> packers;
+    std::vector<uint32_t> regionAtlasIndexes(lightmapTextures.size(), UINT32_MAX);
+    mRegions.resize(lightmapTextures.size());
+    for(uint32_t index : packOrder)
+    {
+        Texture* lightmapTexture = lightmapTextures[index];
+        if(lightmapTexture->GetWidth() == 0 || lightmapTexture->GetHeight() == 0) { continue; }
+
+        uint32_t paddedWidth = lightmapTexture->GetWidth() + kAtlasPadding * 2;
+        uint32_t paddedHeight = lightmapTexture->GetHeight() + kAtlasPadding * 2;
+
+        Region& region = mRegions[index];
+        uint32_t atlasIndex = 0;
+        for(; atlasIndex < packers.size(); ++atlasIndex)
+        {
+            if(packers[atlasIndex].Pack(paddedWidth, paddedHeight, region.x, region.y)) { break; }
+        }
+        if(atlasIndex == packers.size())
+        {
+            packers.emplace_back(std::max(kAtlasSize, paddedWidth), std::max(kAtlasSize, paddedHeight));
+            packers.back().Pack(paddedWidth, paddedHeight, region.x, region.y);
+        }
+        region.x += kAtlasPadding;
+        region.y += kAtlasPadding;
+        region.width = lightmapTexture->GetWidth();
+        region.height = lightmapTexture->GetHeight();
+        regionAtlasIndexes[index] = atlasIndex;
+    }
+
+    // Create atlas textures. No need for the full height if it wasn't all used.
+    for(RectPacker& packer : packers)
+    {
+        Texture* atlasTexture = new Texture(packer.GetWidth(), packer.GetUsedHeight(), Color32::White);
+        atlasTexture->SetFilterMode(Texture::FilterMode::Bilinear);
+        atlasTexture->SetWrapMode(Texture::WrapMode::Clamp);
+        mAtlasTextures.push_back(atlasTexture);
+    }
+
+    // Copy each lightmap into its atlas, along with a border of repeated edge pixels.
+    for(uint32_t i = 0; i < lightmapTextures.size(); ++i)
+    {
+        if(regionAtlasIndexes[i] == UINT32_MAX) { continue; }
+
+        Region& region = mRegions[i];
+        region.texture = mAtlasTextures[regionAtlasIndexes[i]];
+
+        const uint8_t* srcPixels = lightmapTextures[i]->GetPixelData();
+        uint8_t* destPixels = region.texture->GetPixelData();
+        if(srcPixels == nullptr) { continue; }
+
+        uint32_t atlasWidth = region.texture->GetWidth();
+        uint32_t atlasHeight = region.texture->GetHeight();
+        int padding = static_cast<int>(kAtlasPadding);
+        for(int y = -padding; y < static_cast<int>(region.height) + padding; ++y)
+        {
+            int srcY = std::min(std::max(y, 0), static_cast<int>(region.height) - 1);
+            for(int x = -padding; x < static_cast<int>(region.width) + padding; ++x)
+            {
+                int srcX = std::min(std::max(x, 0), static_cast<int>(region.width) - 1);
+                memcpy(destPixels + ((region.y + y) * atlasWidth + (region.x + x)) * 4,
+                       srcPixels + (srcY * region.width + srcX) * 4, 4);
+            }
+        }
+
+        region.uvOffset = Vector2(static_cast<float>(region.x) / atlasWidth, static_cast<float>(region.y) / atlasHeight);
+        region.uvScale = Vector2(static_cast<float>(region.width) / atlasWidth, static_cast<float>(region.height) / atlasHeight);
+    }
+
+    // The individual lightmaps are no longer needed.
+    for(Texture* texture : lightmapTextures)
+    {
+        delete texture;
     }
 
     /*
     // Write out for debugging...
-    for(int i = 0; i < mLightmapTextures.size(); i++)
+    for(int i = 0; i < mAtlasTextures.size(); i++)
     {
-        mLightmapTextures[i]->WriteToFile(GetNameNoExtension() + "_lm_" + std::to_string(i) + ".bmp");
+        mAtlasTextures[i]->WriteToFile(GetNameNoExtension() + "_atlas_" + std::to_string(i) + ".bmp");
     }
     */
 }
-
@@ -10,28 +10,54 @@
 // In-memory representation of .MUL files. The MUL file format is basically
 // a blob containing one or more BMP files.
 //
+// Rather than keeping one small texture per surface, the lightmaps are packed into
+// one or a few atlas textures on load. Each surface's lightmap is a region of an atlas.
+//
 #pragma once
 #include "Asset.h"
 
 #include <string>
 #include <vector>
 
+#include "Vector2.h"
+
 class Texture;
 
 class BSPLightmap : public Asset
 {
     TYPEINFO_SUB(BSPLightmap, Asset);
 public:
+    // Where a surface's lightmap is located in the atlas.
+    struct Region
+    {
+        // The atlas texture containing the lightmap.
+        Texture* texture = nullptr;
+
+        // Pixel rect of the lightmap in the atlas texture.
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        // Converts a UV for the original lightmap to a UV in the atlas: (uv * uvScale) + uvOffset.
+        Vector2 uvOffset;
+        Vector2 uvScale;
+    };
+
     BSPLightmap(const std::string& name, AssetScope scope) : Asset(name, scope) { }
     ~BSPLightmap();
 
     void Load(uint8_t* data, uint32_t dataLength);
 
-    const std::vector<Texture*>& GetLightmapTextures() const { return mLightmapTextures; }
+    const std::vector<Region>& GetRegions() const { return mRegions; }
+    const std::vector<Texture*>& GetAtlasTextures() const { return mAtlasTextures; }
 
 private:
-    // Textures loaded from the MUL file.
-    // Order is important, and aligns with order of surfaces in BSP file.
+    // Atlas textures that all lightmaps are packed into.
     // Unlike most Textures, this asset owns these Textures, and is responsible for cleanup!
-    std::vector<Texture*> mLightmapTextures;
+    std::vector<Texture*> mAtlasTextures;
+
+    // Location of each lightmap in the atlas.
+    // Order is important, and aligns with order of surfaces in BSP file.
+    std::vector<Region> mRegions;
 };
@@ -7,9 +7,12 @@
 // This allows the game to use different graphics libraries while isolating the graphics code.
 //
 #pragma once
+#include <vector>
+
 #include "Color32.h"
 #include "MeshDefinition.h"
 #include "Rect.h"
+#include "Shader.h" // For Uniform
 #include "Texture.h" // For WrapMode/FilterMode
 #include "VertexDefinition.h"
 
@@ -111,10 +114,14 @@ public:
     virtual void SetBlendMode(BlendMode blendMode) = 0;
 
     // Textures
-    virtual TextureHandle CreateTexture(uint32_t width, uint32_t height, uint8_t* pixels) = 0;
+    virtual TextureHandle CreateTexture(uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels) = 0;
     virtual void DestroyTexture(TextureHandle handle) = 0;
 
-    virtual void SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, uint8_t* pixels) = 0;
+    virtual void SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels) = 0;
+
+    // Like SetTexturePixels, but meant for textures whose pixels change every frame (such as video).
+    // The source pixel rows are "rowStride" bytes apart, which may be more than the row size due to padding.
+    virtual void StreamTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, const uint8_t* pixels, uint32_t rowStride) = 0;
     virtual void GenerateMipmaps(TextureHandle handle) = 0;
     virtual void SetTextureWrapMode(TextureHandle handle, Texture::WrapMode wrapMode) = 0;
     virtual void SetTextureFilterMode(TextureHandle handle, Texture::FilterMode filterMode, bool useMipmaps) = 0;
@@ -142,6 +149,13 @@ public:
     virtual void DestroyCubemap(TextureHandle handle) = 0;
     virtual void ActivateCubemap(TextureHandle handle) = 0;
 
+    // Texture Buffers
+    // A texture buffer gives shaders read access to a large array of floats, which is read using texelFetch.
+    // Returns null if the buffer can't be created (for example, if it is larger than the graphics system supports).
+    virtual TextureHandle CreateTextureBuffer(uint32_t count, const float* data) = 0;
+    virtual void DestroyTextureBuffer(TextureHandle handle) = 0;
+    virtual void ActivateTextureBuffer(TextureHandle handle) = 0;
+
     // Vertex & Index Buffers
     virtual BufferHandle CreateVertexBuffer(uint32_t vertexCount, const VertexDefinition& vertexDefinition, void* data, MeshUsage usage) = 0;
     virtual void DestroyVertexBuffer(BufferHandle handle) = 0;
@@ -156,12 +170,24 @@ public:
     virtual void DestroyShader(ShaderHandle handle) = 0;
     virtual void ActivateShader(ShaderHandle handle) = 0;
 
-    virtual void SetShaderUniformInt(ShaderHandle handle, const char* name, int value) = 0;
-    virtual void SetShaderUniformFloat(ShaderHandle handle, const char* name, float value) = 0;
-    virtual void SetShaderUniformVector3(ShaderHandle handle, const char* name, const Vector3& value) = 0;
-    virtual void SetShaderUniformVector4(ShaderHandle handle, const char* name, const Vector4& value) = 0;
-    virtual void SetShaderUniformMatrix4(ShaderHandle handle, const char* name, const Matrix4& mat) = 0;
-    virtual void SetShaderUniformColor(ShaderHandle handle, const char* name, const Color32& color) = 0;
+    // Uniforms are reflected from a shader once, after it is created.
+    // Setting a uniform uses the location obtained during reflection, rather than looking it up by name each time.
+    virtual void GetShaderUniforms(ShaderHandle handle, std::vector<Uniform>& outUniforms) = 0;
+    virtual void SetShaderUniformBlockBinding(ShaderHandle handle, const char* blockName, uint32_t bindingIndex) = 0;
+
+    virtual void SetShaderUniformInt(ShaderHandle handle, int location, int value) = 0;
+    virtual void SetShaderUniformFloat(ShaderHandle handle, int location, float value) = 0;
+    virtual void SetShaderUniformVector3(ShaderHandle handle, int location, const Vector3& value) = 0;
+    virtual void SetShaderUniformVector4(ShaderHandle handle, int location, const Vector4& value) = 0;
+    virtual void SetShaderUniformMatrix4(ShaderHandle handle, int location, const Matrix4& mat) = 0;
+    virtual void SetShaderUniformColor(ShaderHandle handle, int location, const Color32& color) = 0;
+
+    // Uniform Buffers
+    // A uniform buffer is bound to a binding index, and provides values for any shader uniform block bound to the same index.
+    virtual BufferHandle CreateUniformBuffer(uint32_t size) = 0;
+    virtual void DestroyUniformBuffer(BufferHandle handle) = 0;
+    virtual void SetUniformBufferData(BufferHandle handle, uint32_t offset, uint32_t size, const void* data) = 0;
+    virtual void BindUniformBuffer(BufferHandle handle, uint32_t bindingIndex) = 0;
 
     // Drawing
     enum class Primitive
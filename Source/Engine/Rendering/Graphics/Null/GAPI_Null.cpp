@@ -0,0 +1,496 @@
+#include "GAPI_Null.h"
+
+#include <cctype>
+#include <cstring>
+
+#if !defined(TESTS)
+#include <imgui.h>
+
+#include "Window.h"
+#endif
+
+namespace
+{
+    // Every handle points to one of these.
+    // For vertex and index buffers, the count is needed to know how much a draw call submits.
+    // For shaders, the uniforms declared in the shader source are saved, so materials set them just like with a real graphics API.
+    struct Resource
+    {
+        uint32_t count = 0;
+        std::vector<Uniform> uniforms;
+    };
+
+    Resource* CreateResource(uint32_t& liveCount, uint32_t count = 0)
+    {
+        ++liveCount;
+        Resource* resource = new Resource();
+        resource->count = count;
+        return resource;
+    }
+
+    void DestroyResource(uint32_t& liveCount, void* handle)
+    {
+        if(handle == nullptr) { return; }
+        --liveCount;
+        delete static_cast<Resource*>(handle);
+    }
+
+    uint32_t GetCount(void* handle)
+    {
+        return handle != nullptr ? static_cast<Resource*>(handle)->count : 0;
+    }
+
+    UniformType GLSLTypeToUniformType(const std::string& type)
+    {
+        static const std::pair<const char*, UniformType> kTypes[] = {
+            { "float", UniformType::Float }, { "int", UniformType::Int }, { "uint", UniformType::Uint }, { "bool", UniformType::Bool },
+            { "vec2", UniformType::Vector2 }, { "vec3", UniformType::Vector3 }, { "vec4", UniformType::Vector4 },
+            { "mat2", UniformType::Matrix2 }, { "mat3", UniformType::Matrix3 }, { "mat4", UniformType::Matrix4 },
+            { "sampler2D", UniformType::Texture2D }, { "samplerCube", UniformType::TextureCube }, { "samplerBuffer", UniformType::TextureBuffer }
+        };
+        for(auto& entry : kTypes)
+        {
+            if(type == entry.first) { return entry.second; }
+        }
+        return UniformType::Unknown;
+    }
+
+    void ParseUniforms(const uint8_t* source, std::vector<Uniform>& uniforms)
+    {
+        // Without a compiler to reflect uniforms, find "uniform <type> <name>" declarations in the source instead.
+        // This is no GLSL parser, but it handles the declarations our shaders use. Uniform blocks are skipped, since their members have no location.
+        if(source == nullptr) { return; }
+        const char* text = reinterpret_cast<const char*>(source);
+
+        // Skips whitespace and comments.
+        auto skipSpace = [](const char*& pos) {
+            while(*pos != '\0')
+            {
+                if(std::isspace(static_cast<unsigned char>(*pos))) { ++pos; }
+                else if(pos[0] == '/' && pos[1] == '/') { while(*pos != '\0' && *pos != '\n') { ++pos; } }
+                else if(pos[0] == '/' && pos[1] == '*')
+                {
+                    const char* end = strstr(pos + 2, "*/");
+                    pos = end != nullptr ? end + 2 : pos + strlen(pos);
+                }
+                else { break; }
+            }
+        };
+        auto readWord = [](const char*& pos) {
+            const char* start = pos;
+            while(std::isalnum(static_cast<unsigned char>(*pos)) || *pos == '_') { ++pos; }
+            return std::string(start, pos);
+        };
+
+        const char* pos = text;
+        while(*pos != '\0')
+        {
+            skipSpace(pos);
+            std::string word = readWord(pos);
+            if(word.empty())
+            {
+                if(*pos != '\0') { ++pos; }
+                continue;
+            }
+            if(word != "uniform") { continue; }
+
+            // Type, possibly after a precision qualifier.
+            skipSpace(pos);
+            std::string type = readWord(pos);
+            if(type == "lowp" || type == "mediump" || type == "highp")
+            {
+                skipSpace(pos);
+                type = readWord(pos);
+            }
+
+            // A uniform block (e.g. "uniform FrameUniforms { ... }").
+            skipSpace(pos);
+            if(*pos == '{')
+            {
+                const char* end = strchr(pos, '}');
+                pos = end != nullptr ? end + 1 : pos + strlen(pos);
+                continue;
+            }
+
+            // Like OpenGL, arrays are reported by their first element.
+            std::string name = readWord(pos);
+            if(name.empty()) { continue; }
+            skipSpace(pos);
+            if(*pos == '[')
+            {
+                name += "[0]";
+            }
+
+            // Uniforms declared in both the vertex and fragment shader are the same uniform.
+            bool exists = false;
+            for(const Uniform& uniform : uniforms)
+            {
+                exists |= uniform.name == name;
+            }
+            if(!exists)
+            {
+                Uniform uniform;
+                uniform.type = GLSLTypeToUniformType(type);
+                uniform.name = name;
+                uniform.location = static_cast<int>(uniforms.size());
+                uniforms.push_back(uniform);
+            }
+        }
+    }
+}
+
+void GAPI_Null::ResetStats()
+{
+    mStats = Stats();
+    mFrameStartStats = Stats();
+    mLastFrameStats = Stats();
+}
+
+bool GAPI_Null::Init()
+{
+    // Nothing is drawn, so IMGUI doesn't get a platform backend either - it has no use for input or the display.
+    return true;
+}
+
+void GAPI_Null::Shutdown()
+{
+    // Nothing to shut down.
+}
+
+void GAPI_Null::ImGuiNewFrame()
+{
+    #if !defined(TESTS)
+    // Without a platform backend, IMGUI still needs to know the display size to lay out windows.
+    ImGui::GetIO().DisplaySize = ImVec2(static_cast<float>(Window::GetWidth()), static_cast<float>(Window::GetHeight()));
+
+    // A renderer backend would normally build the font atlas. Since nothing is rendered, just build it in memory.
+    ImFontAtlas* fonts = ImGui::GetIO().Fonts;
+    if(!fonts->IsBuilt())
+    {
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    }
+    #endif
+}
+
+void GAPI_Null::ImGuiRenderDrawData()
+{
+    // Nothing to render.
+}
+
+void GAPI_Null::Clear(Color32 clearColor)
+{
+    // Nothing to clear.
+}
+
+void GAPI_Null::Present()
+{
+    // Save stats for the frame that just ended.
+    mLastFrameStats.drawCalls = mStats.drawCalls - mFrameStartStats.drawCalls;
+    mLastFrameStats.verticesDrawn = mStats.verticesDrawn - mFrameStartStats.verticesDrawn;
+    mLastFrameStats.stateChanges = mStats.stateChanges - mFrameStartStats.stateChanges;
+    mLastFrameStats.uniformsSet = mStats.uniformsSet - mFrameStartStats.uniformsSet;
+    mLastFrameStats.bytesUploaded = mStats.bytesUploaded - mFrameStartStats.bytesUploaded;
+    mFrameStartStats = mStats;
+}
+
+void GAPI_Null::SetPolygonCullMode(CullMode cullMode)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetPolygonWindingOrder(WindingOrder windingOrder)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetPolygonFillMode(FillMode fillMode)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetViewSpaceHandedness(Handedness handedness)
+{
+    // This only affects projection matrices, which are calculated outside the GAPI.
+}
+
+void GAPI_Null::SetViewport(int32_t x, int32_t y, uint32_t width, uint32_t height)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetScissorRect(bool enabled, const Rect& rect)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::GetScreenPixels(uint32_t width, uint32_t height, uint8_t* pixels)
+{
+    // Nothing was rendered, so the screen is all black.
+    memset(pixels, 0, width * height * 4);
+}
+
+void GAPI_Null::SetDepthWriteEnabled(bool enabled)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetDepthTestEnabled(bool enabled)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetBlendEnabled(bool enabled)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetBlendMode(BlendMode blendMode)
+{
+    ++mStats.stateChanges;
+}
+
+TextureHandle GAPI_Null::CreateTexture(uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels)
+{
+    if(pixels != nullptr)
+    {
+        mStats.bytesUploaded += width * height * Texture::GetBytesPerPixel(format);
+    }
+    return CreateResource(mResources.textures);
+}
+
+void GAPI_Null::DestroyTexture(TextureHandle handle)
+{
+    DestroyResource(mResources.textures, handle);
+}
+
+void GAPI_Null::SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels)
+{
+    mStats.bytesUploaded += width * height * Texture::GetBytesPerPixel(format);
+}
+
+void GAPI_Null::StreamTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, const uint8_t* pixels, uint32_t rowStride)
+{
+    mStats.bytesUploaded += width * height * Texture::GetBytesPerPixel(format);
+}
+
+void GAPI_Null::GenerateMipmaps(TextureHandle handle)
+{
+    // Nothing to generate.
+}
+
+void GAPI_Null::SetTextureWrapMode(TextureHandle handle, Texture::WrapMode wrapMode)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetTextureFilterMode(TextureHandle handle, Texture::FilterMode filterMode, bool useMipmaps)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::SetTextureUnit(uint8_t textureUnit)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::ActivateTexture(TextureHandle handle)
+{
+    ++mStats.stateChanges;
+}
+
+TextureHandle GAPI_Null::CreateCubemap(const CubemapParams& params)
+{
+    const CubemapSide* sides[] = { &params.left, &params.right, &params.back, &params.front, &params.bottom, &params.top };
+    for(const CubemapSide* side : sides)
+    {
+        if(side->pixels != nullptr)
+        {
+            mStats.bytesUploaded += side->width * side->height * 4;
+        }
+    }
+    return CreateResource(mResources.cubemaps);
+}
+
+void GAPI_Null::DestroyCubemap(TextureHandle handle)
+{
+    DestroyResource(mResources.cubemaps, handle);
+}
+
+void GAPI_Null::ActivateCubemap(TextureHandle handle)
+{
+    ++mStats.stateChanges;
+}
+
+TextureHandle GAPI_Null::CreateTextureBuffer(uint32_t count, const float* data)
+{
+    // Match other graphics APIs, which can't create an empty texture buffer.
+    if(count == 0) { return nullptr; }
+
+    if(data != nullptr)
+    {
+        mStats.bytesUploaded += count * sizeof(float);
+    }
+    return CreateResource(mResources.textureBuffers, count);
+}
+
+void GAPI_Null::DestroyTextureBuffer(TextureHandle handle)
+{
+    DestroyResource(mResources.textureBuffers, handle);
+}
+
+void GAPI_Null::ActivateTextureBuffer(TextureHandle handle)
+{
+    ++mStats.stateChanges;
+}
+
+BufferHandle GAPI_Null::CreateVertexBuffer(uint32_t vertexCount, const VertexDefinition& vertexDefinition, void* data, MeshUsage usage)
+{
+    if(data != nullptr)
+    {
+        mStats.bytesUploaded += vertexCount * vertexDefinition.CalculateSize();
+    }
+    return CreateResource(mResources.vertexBuffers, vertexCount);
+}
+
+void GAPI_Null::DestroyVertexBuffer(BufferHandle handle)
+{
+    DestroyResource(mResources.vertexBuffers, handle);
+}
+
+void GAPI_Null::SetVertexBufferData(BufferHandle handle, uint32_t offset, uint32_t size, void* data)
+{
+    mStats.bytesUploaded += size;
+}
+
+BufferHandle GAPI_Null::CreateIndexBuffer(uint32_t indexCount, uint16_t* indexData, MeshUsage usage)
+{
+    if(indexData != nullptr)
+    {
+        mStats.bytesUploaded += indexCount * sizeof(uint16_t);
+    }
+    return CreateResource(mResources.indexBuffers, indexCount);
+}
+
+void GAPI_Null::DestroyIndexBuffer(BufferHandle handle)
+{
+    DestroyResource(mResources.indexBuffers, handle);
+}
+
+void GAPI_Null::SetIndexBufferData(BufferHandle handle, uint32_t indexCount, uint16_t* indexData)
+{
+    // As with other graphics APIs, setting index data can change the size of the buffer.
+    static_cast<Resource*>(handle)->count = indexCount;
+    mStats.bytesUploaded += indexCount * sizeof(uint16_t);
+}
+
+ShaderHandle GAPI_Null::CreateShader(const uint8_t* vertSource, const uint8_t* fragSource)
+{
+    // Shaders aren't compiled, so they always succeed.
+    Resource* shader = CreateResource(mResources.shaders);
+    ParseUniforms(vertSource, shader->uniforms);
+    ParseUniforms(fragSource, shader->uniforms);
+    return shader;
+}
+
+void GAPI_Null::DestroyShader(ShaderHandle handle)
+{
+    DestroyResource(mResources.shaders, handle);
+}
+
+void GAPI_Null::ActivateShader(ShaderHandle handle)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::GetShaderUniforms(ShaderHandle handle, std::vector<Uniform>& outUniforms)
+{
+    outUniforms.clear();
+    if(handle != nullptr)
+    {
+        outUniforms = static_cast<Resource*>(handle)->uniforms;
+    }
+}
+
+void GAPI_Null::SetShaderUniformBlockBinding(ShaderHandle handle, const char* blockName, uint32_t bindingIndex)
+{
+    // Nothing to bind.
+}
+
+void GAPI_Null::SetShaderUniformInt(ShaderHandle handle, int location, int value)
+{
+    ++mStats.uniformsSet;
+}
+
+void GAPI_Null::SetShaderUniformFloat(ShaderHandle handle, int location, float value)
+{
+    ++mStats.uniformsSet;
+}
+
+void GAPI_Null::SetShaderUniformVector3(ShaderHandle handle, int location, const Vector3& value)
+{
+    ++mStats.uniformsSet;
+}
+
+void GAPI_Null::SetShaderUniformVector4(ShaderHandle handle, int location, const Vector4& value)
+{
+    ++mStats.uniformsSet;
+}
+
+void GAPI_Null::SetShaderUniformMatrix4(ShaderHandle handle, int location, const Matrix4& mat)
+{
+    ++mStats.uniformsSet;
+}
+
+void GAPI_Null::SetShaderUniformColor(ShaderHandle handle, int location, const Color32& color)
+{
+    ++mStats.uniformsSet;
+}
+
+BufferHandle GAPI_Null::CreateUniformBuffer(uint32_t size)
+{
+    return CreateResource(mResources.uniformBuffers, size);
+}
+
+void GAPI_Null::DestroyUniformBuffer(BufferHandle handle)
+{
+    DestroyResource(mResources.uniformBuffers, handle);
+}
+
+void GAPI_Null::SetUniformBufferData(BufferHandle handle, uint32_t offset, uint32_t size, const void* data)
+{
+    mStats.bytesUploaded += size;
+}
+
+void GAPI_Null::BindUniformBuffer(BufferHandle handle, uint32_t bindingIndex)
+{
+    ++mStats.stateChanges;
+}
+
+void GAPI_Null::Draw(Primitive primitive, BufferHandle vertexBuffer)
+{
+    AddDraw(GetCount(vertexBuffer));
+}
+
+void GAPI_Null::Draw(Primitive primitive, BufferHandle vertexBuffer, uint32_t vertexOffset, uint32_t vertexCount)
+{
+    AddDraw(vertexCount);
+}
+
+void GAPI_Null::Draw(Primitive primitive, BufferHandle vertexBuffer, BufferHandle indexBuffer)
+{
+    AddDraw(GetCount(indexBuffer));
+}
+
+void GAPI_Null::Draw(Primitive primitive, BufferHandle vertexBuffer, BufferHandle indexBuffer, uint32_t indexOffset, uint32_t indexCount)
+{
+    AddDraw(indexCount);
+}
+
+void GAPI_Null::AddDraw(uint32_t vertexCount)
+{
+    ++mStats.drawCalls;
+    mStats.verticesDrawn += vertexCount;
+}
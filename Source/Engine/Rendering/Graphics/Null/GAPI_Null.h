@@ -0,0 +1,141 @@
+//
+// Clark Kromenaker
+//
+// A graphics API that doesn't render anything.
+//
+// Every call succeeds, but nothing is sent to a GPU. Instead, resources are tracked and calls are counted.
+// This makes it possible to run the game or benchmarks on machines without a GPU, and to check things like draw call counts.
+//
+#pragma once
+#include "GAPI.h"
+
+class GAPI_Null : public GAPI
+{
+public:
+    struct Stats
+    {
+        // Number of draw calls made, and number of vertices (or indexes, for indexed draws) they submitted.
+        uint32_t drawCalls = 0;
+        uint64_t verticesDrawn = 0;
+
+        // Number of calls that change render state (active shader/textures/buffers, blend/depth/cull settings, etc).
+        uint32_t stateChanges = 0;
+
+        // Number of shader uniform values that were set.
+        uint32_t uniformsSet = 0;
+
+        // Bytes of pixel, vertex, index, and uniform data uploaded.
+        uint64_t bytesUploaded = 0;
+    };
+
+    struct Resources
+    {
+        // Number of resources of each type that currently exist.
+        uint32_t textures = 0;
+        uint32_t cubemaps = 0;
+        uint32_t textureBuffers = 0;
+        uint32_t vertexBuffers = 0;
+        uint32_t indexBuffers = 0;
+        uint32_t uniformBuffers = 0;
+        uint32_t shaders = 0;
+    };
+
+    // Stats since this GAPI was created, or since the last call to ResetStats.
+    const Stats& GetStats() const { return mStats; }
+    void ResetStats();
+
+    // Stats for the most recently presented frame.
+    const Stats& GetLastFrameStats() const { return mLastFrameStats; }
+
+    // Resources that have been created, but not yet destroyed.
+    const Resources& GetResources() const { return mResources; }
+
+    bool Init() override;
+    void Shutdown() override;
+
+    void ImGuiNewFrame() override;
+    void ImGuiRenderDrawData() override;
+
+    void Clear(Color32 clearColor) override;
+    void Present() override;
+
+    void SetPolygonCullMode(CullMode cullMode) override;
+    void SetPolygonWindingOrder(WindingOrder windingOrder) override;
+    void SetPolygonFillMode(FillMode fillMode) override;
+
+    void SetViewSpaceHandedness(Handedness handedness) override;
+
+    void SetViewport(int32_t x, int32_t y, uint32_t width, uint32_t height) override;
+    void SetScissorRect(bool enabled, const Rect& rect) override;
+
+    void GetScreenPixels(uint32_t width, uint32_t height, uint8_t* pixels) override;
+
+    void SetDepthWriteEnabled(bool enabled) override;
+    void SetDepthTestEnabled(bool enabled) override;
+
+    void SetBlendEnabled(bool enabled) override;
+    void SetBlendMode(BlendMode blendMode) override;
+
+    TextureHandle CreateTexture(uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels) override;
+    void DestroyTexture(TextureHandle handle) override;
+    void SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels) override;
+    void StreamTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, const uint8_t* pixels, uint32_t rowStride) override;
+    void GenerateMipmaps(TextureHandle handle) override;
+    void SetTextureWrapMode(TextureHandle handle, Texture::WrapMode wrapMode) override;
+    void SetTextureFilterMode(TextureHandle handle, Texture::FilterMode filterMode, bool useMipmaps) override;
+    void SetTextureUnit(uint8_t textureUnit) override;
+    void ActivateTexture(TextureHandle handle) override;
+
+    TextureHandle CreateCubemap(const CubemapParams& params) override;
+    void DestroyCubemap(TextureHandle handle) override;
+    void ActivateCubemap(TextureHandle handle) override;
+
+    TextureHandle CreateTextureBuffer(uint32_t count, const float* data) override;
+    void DestroyTextureBuffer(TextureHandle handle) override;
+    void ActivateTextureBuffer(TextureHandle handle) override;
+
+    BufferHandle CreateVertexBuffer(uint32_t vertexCount, const VertexDefinition& vertexDefinition, void* data, MeshUsage usage) override;
+    void DestroyVertexBuffer(BufferHandle handle) override;
+    void SetVertexBufferData(BufferHandle handle, uint32_t offset, uint32_t size, void* data) override;
+
+    BufferHandle CreateIndexBuffer(uint32_t indexCount, uint16_t* indexData, MeshUsage usage) override;
+    void DestroyIndexBuffer(BufferHandle handle) override;
+    void SetIndexBufferData(BufferHandle handle, uint32_t indexCount, uint16_t* indexData) override;
+
+    ShaderHandle CreateShader(const uint8_t* vertSource, const uint8_t* fragSource) override;
+    void DestroyShader(ShaderHandle handle) override;
+    void ActivateShader(ShaderHandle handle) override;
+
+    void GetShaderUniforms(ShaderHandle handle, std::vector<Uniform>& outUniforms) override;
+    void SetShaderUniformBlockBinding(ShaderHandle handle, const char* blockName, uint32_t bindingIndex) override;
+
+    void SetShaderUniformInt(ShaderHandle handle, int location, int value) override;
+    void SetShaderUniformFloat(ShaderHandle handle, int location, float value) override;
+    void SetShaderUniformVector3(ShaderHandle handle, int location, const Vector3& value) override;
+    void SetShaderUniformVector4(ShaderHandle handle, int location, const Vector4& value) override;
+    void SetShaderUniformMatrix4(ShaderHandle handle, int location, const Matrix4& mat) override;
+    void SetShaderUniformColor(ShaderHandle handle, int location, const Color32& color) override;
+
+    BufferHandle CreateUniformBuffer(uint32_t size) override;
+    void DestroyUniformBuffer(BufferHandle handle) override;
+    void SetUniformBufferData(BufferHandle handle, uint32_t offset, uint32_t size, const void* data) override;
+    void BindUniformBuffer(BufferHandle handle, uint32_t bindingIndex) override;
+
+    void Draw(Primitive primitive, BufferHandle vertexBuffer) override;
+    void Draw(Primitive primitive, BufferHandle vertexBuffer, uint32_t vertexOffset, uint32_t vertexCount) override;
+    void Draw(Primitive primitive, BufferHandle vertexBuffer, BufferHandle indexBuffer) override;
+    void Draw(Primitive primitive, BufferHandle vertexBuffer, BufferHandle indexBuffer, uint32_t indexOffset, uint32_t indexCount) override;
+
+private:
+    // Running stats, and the stats when the current frame began.
+    Stats mStats;
+    Stats mFrameStartStats;
+
+    // Stats for the last presented frame.
+    Stats mLastFrameStats;
+
+    // Resources that currently exist.
+    Resources mResources;
+
+    void AddDraw(uint32_t vertexCount);
+};
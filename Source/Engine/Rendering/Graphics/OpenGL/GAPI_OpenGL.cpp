@@ -1,5 +1,7 @@
 #include "GAPI_OpenGL.h"
 
+#include <cstring>
+
 #include <GL/glew.h>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_sdl.h>
@@ -59,6 +61,44 @@ namespace GLState
             activeVertexArrayId = vertexArrayId;
         }
     }
+
+    GLuint activeProgramId = GL_NONE;
+    void UseProgram(GLuint programId)
+    {
+        if(activeProgramId != programId)
+        {
+            glUseProgram(programId);
+            activeProgramId = programId;
+        }
+    }
+
+    // Fixed-function state is tracked as -1 (unknown), 0 (disabled), or 1 (enabled).
+    // Starting as unknown ensures the first call always makes it to OpenGL.
+    void SetCapability(GLenum capability, bool enabled, int8_t& currentState)
+    {
+        int8_t state = enabled ? 1 : 0;
+        if(currentState != state)
+        {
+            if(enabled)
+            {
+                glEnable(capability);
+            }
+            else
+            {
+                glDisable(capability);
+            }
+            currentState = state;
+        }
+    }
+
+    int8_t blendEnabled = -1;
+    int8_t depthTestEnabled = -1;
+    int8_t depthWriteEnabled = -1;
+    int8_t cullFaceEnabled = -1;
+
+    // Currently set blend function and cull face, or -1 if unknown.
+    int blendMode = -1;
+    int cullFace = -1;
 }
 
 namespace
@@ -85,6 +125,25 @@ namespace
         uint32_t count = 0;
     };
 
+    struct TextureBuffer
+    {
+        // The buffer object holds the data.
+        GLuint buffer = GL_NONE;
+
+        // The texture object lets shaders read the buffer's data (as a samplerBuffer).
+        GLuint texture = GL_NONE;
+    };
+
+    GLenum TextureFormatToPixelFormat(Texture::Format format)
+    {
+        return format == Texture::Format::R8 ? GL_RED : GL_RGBA;
+    }
+
+    GLint TextureFormatToInternalFormat(Texture::Format format)
+    {
+        return format == Texture::Format::R8 ? GL_R8 : GL_RGBA;
+    }
+
     GLenum PrimitiveToDrawMode(GAPI::Primitive primitive)
     {
         switch(primitive)
@@ -179,6 +238,10 @@ bool GAPI_OpenGL::Init()
     ImGui_ImplSDL2_InitForOpenGL(Window::Get(), mContext);
     ImGui_ImplOpenGL3_Init("#version 150");
 
+    // By default, OpenGL expects each row of uploaded pixel data to start on a 4-byte boundary.
+    // That's always true for RGBA pixels, but single-channel textures can have rows of any size, so just use tightly packed rows.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     // Set a global size for GL_POINTS rendering.
     // This is tuned for the points used in Sidney's Map Analysis - will need to set elsewhere if we need different sizes.
     //TODO: it's considered a better practice to use gl_PointSize in a vertex shader.
@@ -192,6 +255,13 @@ bool GAPI_OpenGL::Init()
 
 void GAPI_OpenGL::Shutdown()
 {
+    // Delete any pixel buffers used for streaming texture uploads.
+    for(auto& entry : mPixelBufferRings)
+    {
+        glDeleteBuffers(PixelBufferRing::kBufferCount, entry.second.buffers);
+    }
+    mPixelBufferRings.clear();
+
     // Shutdown OpenGL for IMGUI.
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
@@ -226,24 +296,29 @@ void GAPI_OpenGL::Present()
 
 void GAPI_OpenGL::SetPolygonCullMode(CullMode cullMode)
 {
+    // Only call to OpenGL if the cull face actually changes.
+    GLenum face = GL_NONE;
     switch(cullMode)
     {
     case CullMode::None:
-        glDisable(GL_CULL_FACE);
-        break;
+        GLState::SetCapability(GL_CULL_FACE, false, GLState::cullFaceEnabled);
+        return;
     case CullMode::Back:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+        face = GL_BACK;
         break;
     case CullMode::Front:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
+        face = GL_FRONT;
         break;
     case CullMode::All:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT_AND_BACK);
+        face = GL_FRONT_AND_BACK;
         break;
     }
+    GLState::SetCapability(GL_CULL_FACE, true, GLState::cullFaceEnabled);
+    if(GLState::cullFace != static_cast<int>(face))
+    {
+        glCullFace(face);
+        GLState::cullFace = static_cast<int>(face);
+    }
 }
 
 void GAPI_OpenGL::SetPolygonWindingOrder(WindingOrder windingOrder)
@@ -322,35 +397,27 @@ void GAPI_OpenGL::GetScreenPixels(uint32_t width, uint32_t height, uint8_t* pixe
 
 void GAPI_OpenGL::SetDepthWriteEnabled(bool enabled)
 {
-    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    int8_t state = enabled ? 1 : 0;
+    if(GLState::depthWriteEnabled != state)
+    {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        GLState::depthWriteEnabled = state;
+    }
 }
 
 void GAPI_OpenGL::SetDepthTestEnabled(bool enabled)
 {
-    if(enabled)
-    {
-        glEnable(GL_DEPTH_TEST);
-    }
-    else
-    {
-        glDisable(GL_DEPTH_TEST);
-    }
+    GLState::SetCapability(GL_DEPTH_TEST, enabled, GLState::depthTestEnabled);
 }
 
 void GAPI_OpenGL::SetBlendEnabled(bool enabled)
 {
-    if(enabled)
-    {
-        glEnable(GL_BLEND);
-    }
-    else
-    {
-        glDisable(GL_BLEND);
-    }
+    GLState::SetCapability(GL_BLEND, enabled, GLState::blendEnabled);
 }
 
 void GAPI_OpenGL::SetBlendMode(BlendMode blendMode)
 {
+    if(GLState::blendMode == static_cast<int>(blendMode)) { return; }
     switch(blendMode)
     {
     case BlendMode::AlphaBlend:
@@ -360,9 +427,10 @@ void GAPI_OpenGL::SetBlendMode(BlendMode blendMode)
         glBlendFunc(GL_DST_COLOR, GL_ZERO);
         break;
     }
+    GLState::blendMode = static_cast<int>(blendMode);
 }
 
-TextureHandle GAPI_OpenGL::CreateTexture(uint32_t width, uint32_t height, uint8_t* pixels)
+TextureHandle GAPI_OpenGL::CreateTexture(uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels)
 {
     // Generate a texture ID.
     // Note that the texture ID is not guaranteed to be unique within the current run of the program!
@@ -379,7 +447,7 @@ TextureHandle GAPI_OpenGL::CreateTexture(uint32_t width, uint32_t height, uint8_
     //      OpenGL assumes the pixel data is from bottom-left, but GK3 pixel arrays are from top left!
     //      You'd think this would be a problem, but GK3 also uses DX style UVs (top-left).
     //      So...having both the texture and UVs upside down, two wrongs make a right!
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexImage2D(GL_TEXTURE_2D, 0, TextureFormatToInternalFormat(format), width, height, 0, TextureFormatToPixelFormat(format), GL_UNSIGNED_BYTE, pixels);
     return reinterpret_cast<TextureHandle>(textureId);
 }
 
@@ -387,12 +455,68 @@ void GAPI_OpenGL::DestroyTexture(TextureHandle handle)
 {
     GLuint textureId = reinterpret_cast<uintptr_t>(handle);
     glDeleteTextures(1, &textureId);
+
+    // Delete any pixel buffers used to stream to this texture. OpenGL can reuse the texture ID, so they mustn't outlive it.
+    auto it = mPixelBufferRings.find(handle);
+    if(it != mPixelBufferRings.end())
+    {
+        glDeleteBuffers(PixelBufferRing::kBufferCount, it->second.buffers);
+        mPixelBufferRings.erase(it);
+    }
 }
 
-void GAPI_OpenGL::SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, uint8_t* pixels)
+void GAPI_OpenGL::SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels)
 {
     GLState::BindTexture(reinterpret_cast<uintptr_t>(handle));
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, TextureFormatToPixelFormat(format), GL_UNSIGNED_BYTE, pixels);
+}
+
+void GAPI_OpenGL::StreamTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, const uint8_t* pixels, uint32_t rowStride)
+{
+    // Move on to this texture's next pixel buffer, creating it if needed.
+    PixelBufferRing& ring = mPixelBufferRings[handle];
+    ring.index = (ring.index + 1) % PixelBufferRing::kBufferCount;
+    if(ring.buffers[ring.index] == GL_NONE)
+    {
+        glGenBuffers(1, &ring.buffers[ring.index]);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.buffers[ring.index]);
+
+    // Only reallocate the buffer if it's too small. Otherwise, the existing storage is reused.
+    uint32_t rowSize = width * Texture::GetBytesPerPixel(format);
+    uint32_t size = rowSize * height;
+    if(ring.sizes[ring.index] < size)
+    {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        ring.sizes[ring.index] = size;
+    }
+
+    // Map the buffer and copy the pixels in, dropping any row padding.
+    // Invalidating the buffer says we don't care about its old contents, so the driver doesn't have to wait on a previous upload.
+    uint8_t* dest = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if(dest != nullptr)
+    {
+        if(rowStride == rowSize)
+        {
+            memcpy(dest, pixels, size);
+        }
+        else
+        {
+            for(uint32_t y = 0; y < height; ++y)
+            {
+                memcpy(dest + y * rowSize, pixels + y * rowStride, rowSize);
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        // With a pixel buffer bound, the last argument is an offset into the buffer.
+        // The copy from buffer to texture happens on the GPU, so this call returns without waiting for it.
+        GLState::BindTexture(reinterpret_cast<uintptr_t>(handle));
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, TextureFormatToPixelFormat(format), GL_UNSIGNED_BYTE, BUFFER_OFFSET(0));
+    }
+
+    // Unbind, or later texture uploads would try to read from the pixel buffer.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
 }
 
 void GAPI_OpenGL::GenerateMipmaps(TextureHandle handle)
@@ -495,6 +619,43 @@ void GAPI_OpenGL::ActivateCubemap(TextureHandle handle)
     glBindTexture(GL_TEXTURE_CUBE_MAP, reinterpret_cast<uintptr_t>(handle));
 }
 
+TextureHandle GAPI_OpenGL::CreateTextureBuffer(uint32_t count, const float* data)
+{
+    // Texture buffers have a maximum size, which can be fairly small on some hardware.
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if(count == 0 || count > static_cast<uint32_t>(maxTexels))
+    {
+        return nullptr;
+    }
+
+    // Create the buffer and fill it with data. It's only read by shaders, and isn't expected to change.
+    TextureBuffer* textureBuffer = new TextureBuffer();
+    glGenBuffers(1, &textureBuffer->buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, textureBuffer->buffer);
+    glBufferData(GL_TEXTURE_BUFFER, count * sizeof(float), data, GL_STATIC_DRAW);
+
+    // Create a texture that views the buffer as an array of single floats.
+    glGenTextures(1, &textureBuffer->texture);
+    glBindTexture(GL_TEXTURE_BUFFER, textureBuffer->texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, textureBuffer->buffer);
+    return textureBuffer;
+}
+
+void GAPI_OpenGL::DestroyTextureBuffer(TextureHandle handle)
+{
+    TextureBuffer* textureBuffer = static_cast<TextureBuffer*>(handle);
+    glDeleteTextures(1, &textureBuffer->texture);
+    glDeleteBuffers(1, &textureBuffer->buffer);
+    delete textureBuffer;
+}
+
+void GAPI_OpenGL::ActivateTextureBuffer(TextureHandle handle)
+{
+    // Buffer textures use their own binding target, so this doesn't disturb any 2D texture bound to the current texture unit.
+    glBindTexture(GL_TEXTURE_BUFFER, static_cast<TextureBuffer*>(handle)->texture);
+}
+
 BufferHandle GAPI_OpenGL::CreateVertexBuffer(uint32_t vertexCount, const VertexDefinition& vertexDefinition, void* data, MeshUsage usage)
 {
     // Create vertex buffer of appropriate size.
@@ -720,37 +881,23 @@ ShaderHandle GAPI_OpenGL::CreateShader(const uint8_t* vertSource, const uint8_t*
     // This is not *strictly* related to creating the shader program, but it is currently required.
     // For any 2D texture uniforms in the shader, we need to specify which "texture unit" that sampler should use.
     // To do that, we can use reflection on the shader data to see which texture uniforms exist.
+    if(program != GL_NONE)
     {
         // We must activate the program, since we may modify uniforms below.
-        glUseProgram(program);
-
-        // Info obtained about each uniform.
-        const GLsizei kMaxUniformNameLength = 32;
-        GLchar uniformNameBuffer[kMaxUniformNameLength];
-        GLsizei uniformNameLength = 0;
-        GLsizei uniformSize = 0;
-        GLenum uniformType = GL_NONE;
+        GLState::UseProgram(program);
 
-        // Determine count of uniforms in this shader program.
-        GLint uniformCount = 0;
-        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+        std::vector<Uniform> uniforms;
+        GetShaderUniforms(reinterpret_cast<ShaderHandle>(program), uniforms);
 
-        // Iterate uniforms and process each one.
+        // For texture samplers, you must tell OpenGL which "texture unit" to use.
+        // If the shader only uses one texture sampler, this works automatically.
+        // But you must manually specify the unit if more than one texture is used.
         int textureUnitCounter = 0;
-        for(GLint i = 0; i < uniformCount; ++i)
+        for(Uniform& uniform : uniforms)
         {
-            // Grab uniform i.
-            glGetActiveUniform(program, i, kMaxUniformNameLength, &uniformNameLength, &uniformSize, &uniformType, uniformNameBuffer);
-
-            // If returned name length is 0, that means the uniform is not valid (compile/link failed?).
-            if(uniformNameLength <= 0) { continue; }
-
-            // For texture samplers, you must tell OpenGL which "texture unit" to use.
-            // If the shader only uses one texture sampler, this works automatically.
-            // But you must manually specify the unit if more than one texture is used.
-            if(uniformType == GL_SAMPLER_2D)
+            if(uniform.type == UniformType::Texture2D)
             {
-                SetShaderUniformInt(reinterpret_cast<ShaderHandle>(program), uniformNameBuffer, textureUnitCounter);
+                glUniform1i(uniform.location, textureUnitCounter);
                 ++textureUnitCounter;
             }
         }
@@ -762,92 +909,185 @@ ShaderHandle GAPI_OpenGL::CreateShader(const uint8_t* vertSource, const uint8_t*
 
 void GAPI_OpenGL::DestroyShader(ShaderHandle handle)
 {
-    glDeleteProgram(reinterpret_cast<uintptr_t>(handle));
+    // If this program is in use, forget about it - the program id may be reused by a new program.
+    GLuint program = reinterpret_cast<uintptr_t>(handle);
+    if(GLState::activeProgramId == program)
+    {
+        GLState::UseProgram(GL_NONE);
+    }
+    glDeleteProgram(program);
 }
 
 void GAPI_OpenGL::ActivateShader(ShaderHandle handle)
 {
-    glUseProgram(reinterpret_cast<uintptr_t>(handle));
+    GLState::UseProgram(reinterpret_cast<uintptr_t>(handle));
 }
 
-void GAPI_OpenGL::SetShaderUniformInt(ShaderHandle handle, const char* name, int value)
+namespace
 {
-    GLuint program = reinterpret_cast<uintptr_t>(handle);
-    if(program != GL_NONE)
+    UniformType GLTypeToUniformType(GLenum type)
     {
-        GLint loc = glGetUniformLocation(program, name);
-        if(loc >= 0)
+        switch(type)
         {
-            glUniform1i(loc, value);
+        case GL_FLOAT:
+            return UniformType::Float;
+        case GL_INT:
+            return UniformType::Int;
+        case GL_UNSIGNED_INT:
+            return UniformType::Uint;
+        case GL_BOOL:
+            return UniformType::Bool;
+        case GL_FLOAT_VEC2:
+            return UniformType::Vector2;
+        case GL_FLOAT_VEC3:
+            return UniformType::Vector3;
+        case GL_FLOAT_VEC4:
+            return UniformType::Vector4;
+        case GL_FLOAT_MAT2:
+            return UniformType::Matrix2;
+        case GL_FLOAT_MAT3:
+            return UniformType::Matrix3;
+        case GL_FLOAT_MAT4:
+            return UniformType::Matrix4;
+        case GL_SAMPLER_2D:
+            return UniformType::Texture2D;
+        case GL_SAMPLER_CUBE:
+            return UniformType::TextureCube;
+        case GL_SAMPLER_BUFFER:
+            return UniformType::TextureBuffer;
+        default:
+            return UniformType::Unknown;
         }
     }
 }
 
-void GAPI_OpenGL::SetShaderUniformFloat(ShaderHandle handle, const char* name, float value)
+void GAPI_OpenGL::GetShaderUniforms(ShaderHandle handle, std::vector<Uniform>& outUniforms)
 {
+    outUniforms.clear();
     GLuint program = reinterpret_cast<uintptr_t>(handle);
-    if(program != GL_NONE)
+    if(program == GL_NONE) { return; }
+
+    // Info obtained about each uniform.
+    const GLsizei kMaxUniformNameLength = 64;
+    GLchar uniformNameBuffer[kMaxUniformNameLength];
+    GLsizei uniformNameLength = 0;
+    GLsizei uniformSize = 0;
+    GLenum uniformType = GL_NONE;
+
+    // Determine count of uniforms in this shader program.
+    GLint uniformCount = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    // Iterate uniforms and process each one.
+    for(GLint i = 0; i < uniformCount; ++i)
     {
-        GLint loc = glGetUniformLocation(program, name);
-        if(loc >= 0)
-        {
-            glUniform1f(loc, value);
-        }
+        // Grab uniform i.
+        glGetActiveUniform(program, i, kMaxUniformNameLength, &uniformNameLength, &uniformSize, &uniformType, uniformNameBuffer);
+
+        // If returned name length is 0, that means the uniform is not valid (compile/link failed?).
+        if(uniformNameLength <= 0) { continue; }
+
+        // Uniforms inside a uniform block have no location - they're set via uniform buffers instead.
+        GLint location = glGetUniformLocation(program, uniformNameBuffer);
+        if(location < 0) { continue; }
+
+        Uniform uniform;
+        uniform.type = GLTypeToUniformType(uniformType);
+        uniform.name = uniformNameBuffer;
+        uniform.location = location;
+        outUniforms.push_back(uniform);
     }
 }
 
-void GAPI_OpenGL::SetShaderUniformVector3(ShaderHandle handle, const char* name, const Vector3& value)
+void GAPI_OpenGL::SetShaderUniformBlockBinding(ShaderHandle handle, const char* blockName, uint32_t bindingIndex)
 {
     GLuint program = reinterpret_cast<uintptr_t>(handle);
     if(program != GL_NONE)
     {
-        GLint loc = glGetUniformLocation(program, name);
-        if(loc >= 0)
+        // Not all shaders use every block, so it's fine if the block doesn't exist.
+        GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
+        if(blockIndex != GL_INVALID_INDEX)
         {
-            glUniform3f(loc, value.x, value.y, value.z);
+            glUniformBlockBinding(program, blockIndex, bindingIndex);
         }
     }
 }
 
-void GAPI_OpenGL::SetShaderUniformVector4(ShaderHandle handle, const char* name, const Vector4& value)
+void GAPI_OpenGL::SetShaderUniformInt(ShaderHandle handle, int location, int value)
 {
-    GLuint program = reinterpret_cast<uintptr_t>(handle);
-    if(program != GL_NONE)
+    if(location >= 0)
     {
-        GLint loc = glGetUniformLocation(program, name);
-        if(loc >= 0)
-        {
-            glUniform4f(loc, value.x, value.y, value.z, value.w);
-        }
+        glUniform1i(location, value);
     }
 }
 
-void GAPI_OpenGL::SetShaderUniformMatrix4(ShaderHandle handle, const char* name, const Matrix4& mat)
+void GAPI_OpenGL::SetShaderUniformFloat(ShaderHandle handle, int location, float value)
 {
-    GLuint program = reinterpret_cast<uintptr_t>(handle);
-    if(program != GL_NONE)
+    if(location >= 0)
     {
-        GLint loc = glGetUniformLocation(program, name);
-        if(loc >= 0)
-        {
-            glUniformMatrix4fv(loc, 1, GL_FALSE, mat);
-        }
+        glUniform1f(location, value);
     }
 }
 
-void GAPI_OpenGL::SetShaderUniformColor(ShaderHandle handle, const char* name, const Color32& color)
+void GAPI_OpenGL::SetShaderUniformVector3(ShaderHandle handle, int location, const Vector3& value)
 {
-    GLuint program = reinterpret_cast<uintptr_t>(handle);
-    if(program != GL_NONE)
+    if(location >= 0)
     {
-        GLint loc = glGetUniformLocation(program, name);
-        if(loc >= 0)
-        {
-            glUniform4f(loc, color.GetR() / 255.0f, color.GetG() / 255.0f, color.GetB() / 255.0f, color.GetA() / 255.0f);
-        }
+        glUniform3f(location, value.x, value.y, value.z);
+    }
+}
+
+void GAPI_OpenGL::SetShaderUniformVector4(ShaderHandle handle, int location, const Vector4& value)
+{
+    if(location >= 0)
+    {
+        glUniform4f(location, value.x, value.y, value.z, value.w);
+    }
+}
+
+void GAPI_OpenGL::SetShaderUniformMatrix4(ShaderHandle handle, int location, const Matrix4& mat)
+{
+    if(location >= 0)
+    {
+        glUniformMatrix4fv(location, 1, GL_FALSE, mat);
     }
 }
 
+void GAPI_OpenGL::SetShaderUniformColor(ShaderHandle handle, int location, const Color32& color)
+{
+    if(location >= 0)
+    {
+        glUniform4f(location, color.GetR() / 255.0f, color.GetG() / 255.0f, color.GetB() / 255.0f, color.GetA() / 255.0f);
+    }
+}
+
+BufferHandle GAPI_OpenGL::CreateUniformBuffer(uint32_t size)
+{
+    // Create the buffer, with storage of the desired size. Contents are filled in later.
+    GLuint uniformBufferId = GL_NONE;
+    glGenBuffers(1, &uniformBufferId);
+    glBindBuffer(GL_UNIFORM_BUFFER, uniformBufferId);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    return reinterpret_cast<BufferHandle>(static_cast<uintptr_t>(uniformBufferId));
+}
+
+void GAPI_OpenGL::DestroyUniformBuffer(BufferHandle handle)
+{
+    GLuint uniformBufferId = static_cast<GLuint>(reinterpret_cast<uintptr_t>(handle));
+    glDeleteBuffers(1, &uniformBufferId);
+}
+
+void GAPI_OpenGL::SetUniformBufferData(BufferHandle handle, uint32_t offset, uint32_t size, const void* data)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, static_cast<GLuint>(reinterpret_cast<uintptr_t>(handle)));
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+}
+
+void GAPI_OpenGL::BindUniformBuffer(BufferHandle handle, uint32_t bindingIndex)
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingIndex, static_cast<GLuint>(reinterpret_cast<uintptr_t>(handle)));
+}
+
 void GAPI_OpenGL::Draw(Primitive primitive, BufferHandle vertexBuffer)
 {
     // Draw all vertices in the vertex buffer.
@@ -1,6 +1,8 @@
 #pragma once
 #include "GAPI.h"
 
+#include <unordered_map>
+
 #include <SDL.h>
 
 class GAPI_OpenGL : public GAPI
@@ -32,9 +34,10 @@ public:
     void SetBlendEnabled(bool enabled) override;
     void SetBlendMode(BlendMode blendMode) override;
 
-    TextureHandle CreateTexture(uint32_t width, uint32_t height, uint8_t* pixels) override;
+    TextureHandle CreateTexture(uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels) override;
     void DestroyTexture(TextureHandle handle) override;
-    void SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, uint8_t* pixels) override;
+    void SetTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, uint8_t* pixels) override;
+    void StreamTexturePixels(TextureHandle handle, uint32_t width, uint32_t height, Texture::Format format, const uint8_t* pixels, uint32_t rowStride) override;
     void GenerateMipmaps(TextureHandle handle) override;
     void SetTextureWrapMode(TextureHandle handle, Texture::WrapMode wrapMode) override;
     void SetTextureFilterMode(TextureHandle handle, Texture::FilterMode filterMode, bool useMipmaps) override;
@@ -45,6 +48,10 @@ public:
     void DestroyCubemap(TextureHandle handle) override;
     void ActivateCubemap(TextureHandle handle) override;
 
+    TextureHandle CreateTextureBuffer(uint32_t count, const float* data) override;
+    void DestroyTextureBuffer(TextureHandle handle) override;
+    void ActivateTextureBuffer(TextureHandle handle) override;
+
     BufferHandle CreateVertexBuffer(uint32_t vertexCount, const VertexDefinition& vertexDefinition, void* data, MeshUsage usage) override;
     void DestroyVertexBuffer(BufferHandle handle) override;
     void SetVertexBufferData(BufferHandle handle, uint32_t offset, uint32_t size, void* data) override;
@@ -57,12 +64,20 @@ public:
     void DestroyShader(ShaderHandle handle) override;
     void ActivateShader(ShaderHandle handle) override;
 
-    void SetShaderUniformInt(ShaderHandle handle, const char* name, int value) override;
-    void SetShaderUniformFloat(ShaderHandle handle, const char* name, float value) override;
-    void SetShaderUniformVector3(ShaderHandle handle, const char* name, const Vector3& value) override;
-    void SetShaderUniformVector4(ShaderHandle handle, const char* name, const Vector4& value) override;
-    void SetShaderUniformMatrix4(ShaderHandle handle, const char* name, const Matrix4& mat) override;
-    void SetShaderUniformColor(ShaderHandle handle, const char* name, const Color32& color) override;
+    void GetShaderUniforms(ShaderHandle handle, std::vector<Uniform>& outUniforms) override;
+    void SetShaderUniformBlockBinding(ShaderHandle handle, const char* blockName, uint32_t bindingIndex) override;
+
+    void SetShaderUniformInt(ShaderHandle handle, int location, int value) override;
+    void SetShaderUniformFloat(ShaderHandle handle, int location, float value) override;
+    void SetShaderUniformVector3(ShaderHandle handle, int location, const Vector3& value) override;
+    void SetShaderUniformVector4(ShaderHandle handle, int location, const Vector4& value) override;
+    void SetShaderUniformMatrix4(ShaderHandle handle, int location, const Matrix4& mat) override;
+    void SetShaderUniformColor(ShaderHandle handle, int location, const Color32& color) override;
+
+    BufferHandle CreateUniformBuffer(uint32_t size) override;
+    void DestroyUniformBuffer(BufferHandle handle) override;
+    void SetUniformBufferData(BufferHandle handle, uint32_t offset, uint32_t size, const void* data) override;
+    void BindUniformBuffer(BufferHandle handle, uint32_t bindingIndex) override;
 
     void Draw(Primitive primitive, BufferHandle vertexBuffer) override;
     void Draw(Primitive primitive, BufferHandle vertexBuffer, uint32_t vertexOffset, uint32_t vertexCount) override;
@@ -72,4 +87,16 @@ public:
 private:
     // Context handle for rendering in OpenGL.
     void* mContext = nullptr;
+
+    // Pixel buffers used to stream pixels to a texture. These persist and are reused for each upload to that texture.
+    // Each streamed texture takes turns between its own buffers, so consecutive uploads to one texture don't write to a buffer the GPU is still reading from.
+    // Giving each texture its own buffers matters when several textures are streamed every frame (e.g. the Y/U/V planes of a movie).
+    struct PixelBufferRing
+    {
+        static const int kBufferCount = 3;
+        uint32_t buffers[kBufferCount] = { 0 };
+        uint32_t sizes[kBufferCount] = { 0 };
+        int index = 0;
+    };
+    std::unordered_map<TextureHandle, PixelBufferRing> mPixelBufferRings;
 };
\ No newline at end of file
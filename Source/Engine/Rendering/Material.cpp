@@ -3,25 +3,13 @@
 #include "Matrix4.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "TextureBuffer.h"
 
 // This is set to a default shader during Renderer init.
 Shader* Material::sDefaultShader = nullptr;
 
-Matrix4 Material::sCurrentViewMatrix;
-Matrix4 Material::sCurrentProjMatrix;
-
 float Material::sAlphaTestValue = 0.0f;
 
-/*static*/ void Material::SetViewMatrix(const Matrix4& viewMatrix)
-{
-    sCurrentViewMatrix = viewMatrix;
-}
-
-/*static*/ void Material::SetProjMatrix(const Matrix4& projMatrix)
-{
-    sCurrentProjMatrix = projMatrix;
-}
-
 /*static*/ void Material::UseAlphaTest(bool use)
 {
     sAlphaTestValue = use ? 0.1f : 0.0f;
@@ -37,59 +25,108 @@ Material::Material(Shader* shader) : mShader(shader)
     SetColor(Color32::White);
 }
 
-void Material::Activate(const Matrix4& objectToWorldMatrix)
+void Material::Activate()
 {
     // Must activate shader BEFORE setting uniforms to get correct results.
     // See https://stackoverflow.com/questions/42357380/why-must-i-use-a-shader-program-before-i-can-set-its-uniforms
     mShader->Activate();
 
-    // Set built-in transform matrices.
-    mShader->SetUniformMatrix4("gObjectToWorldMatrix", objectToWorldMatrix);
-    mShader->SetUniformMatrix4("gWorldToObjectMatrix", Matrix4::Inverse(objectToWorldMatrix));
-
-    mShader->SetUniformMatrix4("gViewMatrix", sCurrentViewMatrix);
-    mShader->SetUniformMatrix4("gProjMatrix", sCurrentProjMatrix);
-    mShader->SetUniformMatrix4("gWorldToProjMatrix", sCurrentProjMatrix * sCurrentViewMatrix);
+    // Make sure uniform slots are valid for the current shader.
+    if(mSlotShader != mShader)
+    {
+        ResolveSlots();
+    }
 
     // Set built-in alpha test value.
-    mShader->SetUniformFloat("gAlphaTest", sAlphaTestValue);
+    mShader->SetUniformFloat(mShader->GetAlphaTestSlot(), sAlphaTestValue);
+
+    // Set built-in chroma key. Shaders treat a zero alpha as "no chroma key."
+    // This is set even if there's no chroma key, so a key used by a previous material with this shader doesn't stick around.
+    if(mShader->GetChromaKeySlot() >= 0)
+    {
+        Color32 chromaKey = mChromaKey;
+        chromaKey.SetA(mHasChromaKey ? 255 : 0);
+        mShader->SetUniformColor(mShader->GetChromaKeySlot(), chromaKey);
+    }
 
     // Set user-defined color values.
     for(auto& entry : mColors)
     {
-        mShader->SetUniformColor(entry.first.c_str(), entry.second);
+        mShader->SetUniformColor(entry.second.slot, entry.second.value);
     }
 
     // Set user-defined textures.
     uint8_t textureUnit = 0;
     for(auto& entry : mTextures)
     {
-        if(entry.second != nullptr)
+        if(entry.second.value != nullptr)
+        {
+            mShader->SetUniformInt(entry.second.slot, textureUnit);
+            entry.second.value->Activate(textureUnit);
+            ++textureUnit;
+        }
+    }
+    for(auto& entry : mTextureBuffers)
+    {
+        if(entry.second.value != nullptr)
         {
-            mShader->SetUniformInt(entry.first.c_str(), textureUnit);
-            entry.second->Activate(textureUnit);
+            mShader->SetUniformInt(entry.second.slot, textureUnit);
+            entry.second.value->Activate(textureUnit);
             ++textureUnit;
         }
     }
 
+    // Set user-defined int values.
+    for(auto& entry : mInts)
+    {
+        mShader->SetUniformInt(entry.second.slot, entry.second.value);
+    }
+
     // Set user-defined float values.
     for(auto& entry : mFloats)
     {
-        mShader->SetUniformFloat(entry.first.c_str(), entry.second);
+        mShader->SetUniformFloat(entry.second.slot, entry.second.value);
     }
 
     // Set user-defined vector values.
     for(auto& entry : mVectors)
     {
-        mShader->SetUniformVector4(entry.first.c_str(), entry.second);
+        mShader->SetUniformVector4(entry.second.slot, entry.second.value);
     }
 
     //TODO: May need to "deactivate" texture units if no texture is defined in material, but a texture sampler exists in the shader.
 }
 
+void Material::SetTransform(const Matrix4& objectToWorldMatrix)
+{
+    // Set built-in transform matrices.
+    // View/projection matrices come from the per-frame uniform buffer, so only per-object matrices are set here.
+    mShader->SetUniformMatrix4(mShader->GetObjectToWorldSlot(), objectToWorldMatrix);
+    if(mShader->GetWorldToObjectSlot() >= 0)
+    {
+        mShader->SetUniformMatrix4(mShader->GetWorldToObjectSlot(), Matrix4::Inverse(objectToWorldMatrix));
+    }
+}
+
+namespace
+{
+    template<typename Map, typename T>
+    void SetParam(Map& params, const std::string& name, const T& value, Shader*& slotShader)
+    {
+        // Adding a new property requires resolving its slot.
+        auto it = params.find(name);
+        if(it == params.end())
+        {
+            it = params.emplace(name, typename Map::mapped_type()).first;
+            slotShader = nullptr;
+        }
+        it->second.value = value;
+    }
+}
+
 void Material::SetColor(const std::string& name, const Color32& color)
 {
-    mColors[name] = color;
+    SetParam(mColors, name, color, mSlotShader);
 }
 
 const Color32* Material::GetColor(const std::string& name) const
@@ -97,14 +134,14 @@ const Color32* Material::GetColor(const std::string& name) const
     auto it = mColors.find(name);
     if(it != mColors.end())
     {
-        return &it->second;
+        return &it->second.value;
     }
     return nullptr;
 }
 
 void Material::SetTexture(const std::string& name, Texture* texture)
 {
-    mTextures[name] = texture;
+    SetParam(mTextures, name, texture, mSlotShader);
 }
 
 Texture* Material::GetTexture(const std::string& name) const
@@ -112,17 +149,56 @@ Texture* Material::GetTexture(const std::string& name) const
     auto it = mTextures.find(name);
     if(it != mTextures.end())
     {
-        return it->second;
+        return it->second.value;
     }
     return nullptr;
 }
 
+void Material::SetTextureBuffer(const std::string& name, TextureBuffer* textureBuffer)
+{
+    SetParam(mTextureBuffers, name, textureBuffer, mSlotShader);
+}
+
+void Material::SetInt(const std::string& name, int value)
+{
+    SetParam(mInts, name, value, mSlotShader);
+}
+
 void Material::SetFloat(const std::string& name, float value)
 {
-    mFloats[name] = value;
+    SetParam(mFloats, name, value, mSlotShader);
 }
 
 void Material::SetVector4(const std::string& name, const Vector4& vector)
 {
-    mVectors[name] = vector;
+    SetParam(mVectors, name, vector, mSlotShader);
+}
+
+void Material::ResolveSlots()
+{
+    for(auto& entry : mColors)
+    {
+        entry.second.slot = mShader->GetUniformSlot(entry.first.c_str());
+    }
+    for(auto& entry : mTextures)
+    {
+        entry.second.slot = mShader->GetUniformSlot(entry.first.c_str());
+    }
+    for(auto& entry : mTextureBuffers)
+    {
+        entry.second.slot = mShader->GetUniformSlot(entry.first.c_str());
+    }
+    for(auto& entry : mInts)
+    {
+        entry.second.slot = mShader->GetUniformSlot(entry.first.c_str());
+    }
+    for(auto& entry : mFloats)
+    {
+        entry.second.slot = mShader->GetUniformSlot(entry.first.c_str());
+    }
+    for(auto& entry : mVectors)
+    {
+        entry.second.slot = mShader->GetUniformSlot(entry.first.c_str());
+    }
+    mSlotShader = mShader;
 }
@@ -13,19 +13,26 @@
 
 class Shader;
 class Texture;
+class TextureBuffer;
 
 class Material
 {
 public:
     static Shader* sDefaultShader;
-    static void SetViewMatrix(const Matrix4& viewMatrix);
-    static void SetProjMatrix(const Matrix4& projMatrix);
     static void UseAlphaTest(bool use);
 
     Material();
     Material(Shader* shader);
 
-    void Activate(const Matrix4& objectToWorldMatrix);
+    // Activates the shader and sets all material properties, then sets transform uniforms.
+    void Activate(const Matrix4& objectToWorldMatrix) { Activate(); SetTransform(objectToWorldMatrix); }
+
+    // Activates the shader and sets all material properties, but not transform uniforms.
+    // When drawing several objects with the same material, this only needs to be done once.
+    void Activate();
+
+    // Sets per-object transform uniforms. The material must already be active.
+    void SetTransform(const Matrix4& objectToWorldMatrix);
 
     void SetShader(Shader* shader) { mShader = shader; }
     Shader* GetShader() const { return mShader; }
@@ -36,6 +43,9 @@ public:
     void SetTexture(const std::string& name, Texture* texture);
     Texture* GetTexture(const std::string& name) const;
 
+    void SetTextureBuffer(const std::string& name, TextureBuffer* textureBuffer);
+
+    void SetInt(const std::string& name, int value);
     void SetFloat(const std::string& name, float value);
     void SetVector4(const std::string& name, const Vector4& vector);
 
@@ -45,22 +55,41 @@ public:
     void SetDiffuseTexture(Texture* texture) { SetTexture("uDiffuse", texture); }
     Texture* GetDiffuseTexture() const { return GetTexture("uDiffuse"); }
 
+    // The first texture used by this material (usually the diffuse texture), or null if none.
+    Texture* GetPrimaryTexture() const { return mTextures.empty() ? nullptr : mTextures.begin()->second.value; }
+
+    // With a chroma key, texels matching the key color are discarded (if the shader supports it).
+    // This makes a color transparent without having to modify the texture's pixels.
+    void SetChromaKey(const Color32& color) { mChromaKey = color; mHasChromaKey = true; }
+    void ClearChromaKey() { mHasChromaKey = false; }
+
     void SetTranslucent(bool translucent) { mTranslucent = translucent; }
     bool IsTranslucent() const { return mTranslucent; }
 
 private:
-    static Matrix4 sCurrentViewMatrix;
-    static Matrix4 sCurrentProjMatrix;
     static float sAlphaTestValue;
 
+    // A material property, along with the shader uniform slot it is passed to.
+    template<typename T>
+    struct Param
+    {
+        T value;
+        int slot = -1;
+    };
+
     // Shader to use.
     Shader* mShader = nullptr;
 
+    // The shader that property slots were last resolved against.
+    // If the shader changes, or a property is added, slots are resolved again on next activate.
+    Shader* mSlotShader = nullptr;
+
     // Material properties/attributes. Maps a uniform variable name to a value.
     // These will be passed to the vertex/fragment shaders during rendering.
-    std::unordered_map<std::string, Color32> mColors;
-    std::unordered_map<std::string, Vector4> mVectors;
-    std::unordered_map<std::string, float> mFloats;
+    std::unordered_map<std::string, Param<Color32>> mColors;
+    std::unordered_map<std::string, Param<Vector4>> mVectors;
+    std::unordered_map<std::string, Param<int>> mInts;
+    std::unordered_map<std::string, Param<float>> mFloats;
 
     //TODO/HACK: This is a map instead of an unordered map to fix a bug with blob shadows on Mac.
     // On Mac, the textures used for blob shadow get mixed up: uDiffuse goes to texture unit 1 and uLightmap goes to texture unit 0.
@@ -68,8 +97,17 @@ private:
     // This shouldn't really be a problem - it should still work - but it doesn't! Swapping the texture units causes a bunch of graphical glitches.
     // An easy HACK fix is to use a map instead, since uDiffuse just so happens to sort before uLightmap.
     // BUT...it would be good to get to the root of WHY swapping texture units breaks this...because it shouldn't!
-    std::map<std::string, Texture*> mTextures;
+    std::map<std::string, Param<Texture*>> mTextures;
+
+    // Texture buffers are bound to the texture units after those used by textures.
+    std::unordered_map<std::string, Param<TextureBuffer*>> mTextureBuffers;
+
+    // Chroma key color, if any.
+    Color32 mChromaKey;
+    bool mHasChromaKey = false;
 
     // If true, this material renders as translucent.
     bool mTranslucent = false;
+
+    void ResolveSlots();
 };
@@ -1,5 +1,6 @@
 #include "Mesh.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "Collisions.h"
@@ -32,13 +33,49 @@ void Mesh::Render(unsigned int submeshIndex, unsigned int offset, unsigned int c
     mSubmeshes[submeshIndex]->Render(offset, count);
 }
 
+void Mesh::GrowAABB(const AABB& aabb)
+{
+    // Only count it as a change if the AABB actually got bigger, since this is done every time an animation is sampled.
+    if(mAABB.ContainsPoint(aabb.GetMin()) && mAABB.ContainsPoint(aabb.GetMax())) { return; }
+    mAABB.GrowToContain(aabb.GetMin());
+    mAABB.GrowToContain(aabb.GetMax());
+    ++mChangeCount;
+}
+
 Submesh* Mesh::AddSubmesh(const MeshDefinition& meshDefinition)
 {
     Submesh* submesh = new Submesh(meshDefinition);
     mSubmeshes.push_back(submesh);
+
+    // The triangle BVH no longer covers all submeshes.
+    mTriangleBVHBuilt = false;
     return submesh;
 }
 
+void Mesh::BuildTriangleBVH()
+{
+    mTriangleBVH.Clear();
+    mSubmeshFirstTriangles.clear();
+    mSubmeshPositionsChangeCounts.clear();
+    for(Submesh* submesh : mSubmeshes)
+    {
+        mSubmeshFirstTriangles.push_back(mTriangleBVH.GetTriangleCount());
+        mSubmeshPositionsChangeCounts.push_back(submesh->GetPositionsChangeCount());
+
+        // Submeshes with unsupported render modes have no triangles, so they're left out.
+        int triangleCount = submesh->GetTriangleCount();
+        for(int i = 0; i < triangleCount; ++i)
+        {
+            Vector3 p0, p1, p2;
+            submesh->GetTriangle(i, p0, p1, p2);
+            mTriangleBVH.AddTriangle(p0, p1, p2, 1);
+        }
+    }
+    mSubmeshFirstTriangles.push_back(mTriangleBVH.GetTriangleCount());
+    mTriangleBVH.Build();
+    mTriangleBVHBuilt = true;
+}
+
 bool Mesh::Raycast(const Ray& ray, float& outRayT, int& outSubmeshIndex, Vector2& outUV)
 {
     // Ensure t value is at default.
@@ -52,20 +89,66 @@ bool Mesh::Raycast(const Ray& ray, float& outRayT, int& outSubmeshIndex, Vector2
         // If hit the AABB, do a per-triangle check as well for more precise detection.
         // For example, Gabe's AABBs are pretty rough, so you can select him when clicking nowhere near him (a foot left of his arm).
         // This isn't how the original game works, so I think they must do a per-triangle check as well.
-        for(int i = 0; i < mSubmeshes.size(); ++i)
+        UpdateTriangleBVH();
+        float u = 0.0f;
+        float v = 0.0f;
+        int triangleIndex = mTriangleBVH.Raycast(ray, 1, false, outRayT, [&u, &v](uint32_t, float hitU, float hitV) {
+            u = hitU;
+            v = hitV;
+            return true;
+        });
+        if(triangleIndex >= 0)
         {
-            float submeshRayT = FLT_MAX;
-            if(mSubmeshes[i]->Raycast(ray, submeshRayT, outUV))
-            {
-                if(submeshRayT < outRayT)
-                {
-                    outRayT = submeshRayT;
-                    outSubmeshIndex = i;
-                }
-            }
+            // Figure out which submesh the triangle belongs to.
+            auto it = std::upper_bound(mSubmeshFirstTriangles.begin(), mSubmeshFirstTriangles.end(), static_cast<uint32_t>(triangleIndex));
+            outSubmeshIndex = static_cast<int>(it - mSubmeshFirstTriangles.begin()) - 1;
+
+            // The calling code sometimes needs to know the UV coordinate where the ray hit.
+            int submeshTriangleIndex = triangleIndex - static_cast<int>(mSubmeshFirstTriangles[outSubmeshIndex]);
+            outUV = mSubmeshes[outSubmeshIndex]->GetTriangleUV(submeshTriangleIndex, u, v);
         }
     }
 
     // Either didn't hit AABB or did hit AABB, but failed triangle test.
     return outRayT < FLT_MAX;
 }
+
+bool Mesh::SweepSphere(const Matrix4& meshToWorld, const Sphere& sphere, const Vector3& moveOffset, float& outSphereT, Vector3& outCollisionNormal)
+{
+    UpdateTriangleBVH();
+    return mTriangleBVH.SweepSphere(sphere, moveOffset, meshToWorld, 1, outSphereT, outCollisionNormal) >= 0;
+}
+
+void Mesh::UpdateTriangleBVH()
+{
+    if(!mTriangleBVHBuilt)
+    {
+        BuildTriangleBVH();
+        return;
+    }
+
+    // Update triangles of any submeshes whose positions changed since the BVH was built or last updated.
+    bool changed = false;
+    for(size_t i = 0; i < mSubmeshes.size(); ++i)
+    {
+        Submesh* submesh = mSubmeshes[i];
+        if(submesh->GetPositionsChangeCount() == mSubmeshPositionsChangeCounts[i]) { continue; }
+        mSubmeshPositionsChangeCounts[i] = submesh->GetPositionsChangeCount();
+
+        uint32_t firstTriangle = mSubmeshFirstTriangles[i];
+        uint32_t triangleCount = mSubmeshFirstTriangles[i + 1] - firstTriangle;
+        for(uint32_t j = 0; j < triangleCount; ++j)
+        {
+            Vector3 p0, p1, p2;
+            submesh->GetTriangle(static_cast<int>(j), p0, p1, p2);
+            mTriangleBVH.SetTriangle(firstTriangle + j, p0, p1, p2);
+        }
+        changed = true;
+    }
+
+    // Animated positions usually stay close to the original positions, so refitting is good enough (and much faster than rebuilding).
+    if(changed)
+    {
+        mTriangleBVH.Refit();
+    }
+}
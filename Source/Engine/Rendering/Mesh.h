@@ -4,17 +4,20 @@
 // Renderable 3D geometry. Consists of one or more Submeshes - each Submesh
 // contains the actual vertex data to be rendered.
 //
-// Also contains some data shared by all Submeshes.
+// Also contains some data shared by all Submeshes, such as a triangle BVH used to speed up raycasts and collision queries.
 //
 #pragma once
+#include <cstdint>
 #include <vector>
 
 #include "AABB.h"
 #include "Matrix4.h"
 #include "Submesh.h"
+#include "TriangleBVH.h"
 #include "Vector2.h"
 
 class Ray;
+class Sphere;
 
 class Mesh
 {
@@ -26,12 +29,18 @@ public:
     void Render(unsigned int submeshIndex);
     void Render(unsigned int submeshIndex, unsigned int offset, unsigned int count);
 
-    void SetMeshToLocalMatrix(const Matrix4& mat) { mMeshToLocalMatrix = mat; }
+    void SetMeshToLocalMatrix(const Matrix4& mat) { mMeshToLocalMatrix = mat; ++mChangeCount; }
     Matrix4& GetMeshToLocalMatrix() { return mMeshToLocalMatrix; }
 
+    // Incremented each time the mesh-to-local matrix is set (e.g. by animations), or the AABB grows.
+    uint32_t GetChangeCount() const { return mChangeCount; }
+
     void SetAABB(const AABB& aabb) { mAABB = aabb; }
     const AABB& GetAABB() const { return mAABB; }
 
+    // Grows the AABB to also contain another AABB (e.g. the bounds of an animation playing on the mesh).
+    void GrowAABB(const AABB& aabb);
+
     Submesh* AddSubmesh(const MeshDefinition& meshDefinition);
 
     Submesh* GetSubmesh(int index) const { return index >= 0 && index < static_cast<int>(mSubmeshes.size()) ? mSubmeshes[index] : nullptr; }
@@ -39,8 +48,18 @@ public:
 
     const std::vector<Submesh*>& GetSubmeshes() const { return mSubmeshes; }
 
+    // Builds a BVH of all submesh triangles, in mesh space. Call after all submeshes are added.
+    // Queries build it automatically if needed, but it's best done at load time.
+    void BuildTriangleBVH();
+
+    // Finds the nearest triangle hit by a ray in mesh space.
     bool Raycast(const Ray& ray, float& outRayT, int& outSubmeshIndex, Vector2& outUV);
 
+    // Finds the first triangle hit by a sphere moving by "moveOffset" (see TriangleBVH::SweepSphere).
+    // The sphere and offset are in world space; "meshToWorld" transforms the mesh into world space.
+    // Only hits with a t less than "outSphereT" are considered, so set it before calling (e.g. to 1 to check the full move).
+    bool SweepSphere(const Matrix4& meshToWorld, const Sphere& sphere, const Vector3& moveOffset, float& outSphereT, Vector3& outCollisionNormal);
+
 private:
     // A mesh is really just a container for one or more submeshes.
     std::vector<Submesh*> mSubmeshes;
@@ -49,7 +68,21 @@ private:
     // Each Mesh in GK3 has its own position/rotation/scale, and Submesh vertices are relative to the Mesh coordinate system.
     // This matrix represents the Mesh's coordinate system and can be used to transform from mesh space to parent space.
     Matrix4 mMeshToLocalMatrix = Matrix4::Identity;
+    uint32_t mChangeCount = 0;
 
     // An AABB for the mesh, in its own local space.
     AABB mAABB;
+
+    // A BVH of all submesh triangles, in mesh space.
+    TriangleBVH mTriangleBVH;
+    bool mTriangleBVHBuilt = false;
+
+    // For each submesh, the index of its first triangle in the BVH (plus a final entry for the total triangle count).
+    std::vector<uint32_t> mSubmeshFirstTriangles;
+
+    // For each submesh, its positions change count when its triangles were last put in the BVH.
+    // If a submesh's positions change (e.g. vertex animation), its triangles are updated and the BVH is refit before the next query.
+    std::vector<uint32_t> mSubmeshPositionsChangeCounts;
+
+    void UpdateTriangleBVH();
 };
@@ -7,6 +7,7 @@
 #include "Model.h"
 #include "Ray.h"
 #include "Renderer.h"
+#include "RenderQueue.h"
 #include "Texture.h"
 
 TYPEINFO_INIT(MeshRenderer, Component, 13)
@@ -24,7 +25,7 @@ MeshRenderer::~MeshRenderer()
     gRenderer.RemoveMeshRenderer(this);
 }
 
-void MeshRenderer::Render(bool opaque, bool translucent)
+void MeshRenderer::AddToRenderQueue(RenderQueue& queue, const Vector3& cameraPosition)
 {
     // Don't render if actor is inactive or component is disabled.
     if(!IsActiveAndEnabled()) { return; }
@@ -37,13 +38,17 @@ void MeshRenderer::Render(bool opaque, bool translucent)
     // If so, any additional submeshes just use the last material.
     int maxMaterialIndex = static_cast<int>(mMaterials.size()) - 1;
 
-    // Iterate meshes and render each in turn.
+    // Iterate meshes and queue each in turn.
     Matrix4 localToWorldMatrix = GetOwner()->GetTransform()->GetLocalToWorldMatrix();
     for(size_t i = 0; i < mMeshes.size(); i++)
     {
         // Mesh vertices are in "mesh space". Create matrix to convert to world space.
         Matrix4 meshToWorldMatrix = localToWorldMatrix * mMeshes[i]->GetMeshToLocalMatrix();
 
+        // Distance from the camera is used to sort draws. Use the mesh's center, so nearby meshes sort sensibly.
+        Vector3 meshCenter = meshToWorldMatrix.TransformPoint(mMeshes[i]->GetAABB().GetCenter());
+        float depth = (meshCenter - cameraPosition).GetLengthSq();
+
         // Iterate each submesh.
         const std::vector<Submesh*>& submeshes = mMeshes[i]->GetSubmeshes();
         for(size_t j = 0; j < submeshes.size(); j++)
@@ -57,46 +62,36 @@ void MeshRenderer::Render(bool opaque, bool translucent)
             {
                 int materialIndex = Math::Min(submeshIndex, maxMaterialIndex);
                 Material& material = mMaterials[materialIndex];
+                RenderQueue::Pass pass = material.IsTranslucent() ? RenderQueue::Pass::Translucent : RenderQueue::Pass::Opaque;
+                queue.Add(pass, &material, submeshes[j], meshToWorldMatrix, depth);
 
-                // If this is translucent, only render if want to render translucent stuff.
-                // Or if this is opaque, only render if want to render opaque.
-                if((opaque && !material.IsTranslucent()) ||
-                   (translucent && material.IsTranslucent()))
+                // Draw debug axes if desired.
+                if(Debug::RenderSubmeshLocalAxes())
                 {
-                    // Activate material.
-                    material.Activate(meshToWorldMatrix);
-
-                    // Render the submesh!
-                    submeshes[j]->Render();
-
-                    // Draw debug axes if desired.
-                    if(Debug::RenderSubmeshLocalAxes())
-                    {
-                        Debug::DrawAxes(meshToWorldMatrix);
-                    }
-
-                    /*
-                    // Uncomment to visualize normals.
-                    int vcount = submeshes[j]->GetVertexCount();
-                    for(int k = 0; k < vcount; ++k)
-                    {
-                        Matrix4 worldToMeshMatrix = Matrix4::Inverse(meshToWorldMatrix);
-                        Vector3 lightPos = worldToMeshMatrix.TransformPoint(gSceneManager.GetScene()->GetSceneData()->GetGlobalLightPosition());
-                        Vector3 lightDir = Vector3::Normalize(lightPos - submeshes[j]->GetVertexPosition(k));
-                        float dot = Vector3::Dot(submeshes[j]->GetVertexNormal(k), lightDir);
-                        Color32 color(static_cast<int>(dot * 255), 0, 0);
-
-                        Vector3 pos = submeshes[j]->GetVertexPosition(k);
-                        pos = meshToWorldMatrix.TransformPoint(pos);
-
-                        Vector3 normal = submeshes[j]->GetVertexNormal(k);
-                        normal = meshToWorldMatrix.TransformNormal(normal);
-
-                        Debug::DrawLine(pos, pos + normal, color);
-                        //Debug::DrawLine(pos, pos + lightDir, Color32::Yellow);
-                    }
-                    */
+                    Debug::DrawAxes(meshToWorldMatrix);
                 }
+
+                /*
+                // Uncomment to visualize normals.
+                int vcount = submeshes[j]->GetVertexCount();
+                for(int k = 0; k < vcount; ++k)
+                {
+                    Matrix4 worldToMeshMatrix = Matrix4::Inverse(meshToWorldMatrix);
+                    Vector3 lightPos = worldToMeshMatrix.TransformPoint(gSceneManager.GetScene()->GetSceneData()->GetGlobalLightPosition());
+                    Vector3 lightDir = Vector3::Normalize(lightPos - submeshes[j]->GetVertexPosition(k));
+                    float dot = Vector3::Dot(submeshes[j]->GetVertexNormal(k), lightDir);
+                    Color32 color(static_cast<int>(dot * 255), 0, 0);
+
+                    Vector3 pos = submeshes[j]->GetVertexPosition(k);
+                    pos = meshToWorldMatrix.TransformPoint(pos);
+
+                    Vector3 normal = submeshes[j]->GetVertexNormal(k);
+                    normal = meshToWorldMatrix.TransformNormal(normal);
+
+                    Debug::DrawLine(pos, pos + normal, color);
+                    //Debug::DrawLine(pos, pos + lightDir, Color32::Yellow);
+                }
+                */
             }
 
             // Increase submesh index.
@@ -117,6 +112,7 @@ void MeshRenderer::SetModel(Model* model)
 
     // Clear any existing.
     mMeshes.clear();
+    ++mMeshesChangeCount;
     mMaterials.clear();
 
     // Add each mesh.
@@ -137,6 +133,7 @@ std::string MeshRenderer::GetModelName() const
 void MeshRenderer::SetMesh(Mesh* mesh)
 {
     mMeshes.clear();
+    ++mMeshesChangeCount;
     mMaterials.clear();
     AddMesh(mesh);
 }
@@ -151,6 +148,7 @@ void MeshRenderer::AddMesh(Mesh* mesh)
 
     // Add mesh to array.
     mMeshes.push_back(mesh);
+    ++mMeshesChangeCount;
 
     // Create a material for each submesh.
     const std::vector<Submesh*>& submeshes = mesh->GetSubmeshes();
@@ -292,27 +290,48 @@ AABB MeshRenderer::GetAABB() const
 
     // Calculate AABB that contains all meshes in the mesh renderer.
     AABB toReturn;
+    Matrix4 localToWorldMatrix = GetOwner()->GetTransform()->GetLocalToWorldMatrix();
     for(size_t i = 0; i < mMeshes.size(); ++i)
     {
-        Matrix4 meshToWorldMatrix = GetOwner()->GetTransform()->GetLocalToWorldMatrix() * mMeshes[i]->GetMeshToLocalMatrix();
+        Matrix4 meshToWorldMatrix = localToWorldMatrix * mMeshes[i]->GetMeshToLocalMatrix();
 
+        // Transforming just the min/max points isn't enough if the mesh is rotated - the box must be transformed as a whole.
+        // The world-space extents are the mesh-space extents projected onto each world axis.
         const AABB& meshAABB = mMeshes[i]->GetAABB();
-        Vector3 worldMin = meshToWorldMatrix.TransformPoint(meshAABB.GetMin());
-        Vector3 worldMax = meshToWorldMatrix.TransformPoint(meshAABB.GetMax());
+        Vector3 center = meshToWorldMatrix.TransformPoint(meshAABB.GetCenter());
+        Vector3 meshExtents = meshAABB.GetExtents();
+        Vector3 extents;
+        for(int row = 0; row < 3; ++row)
+        {
+            extents[row] = Math::Abs(meshToWorldMatrix(row, 0)) * meshExtents.x +
+                           Math::Abs(meshToWorldMatrix(row, 1)) * meshExtents.y +
+                           Math::Abs(meshToWorldMatrix(row, 2)) * meshExtents.z;
+        }
 
         if(i == 0)
         {
-            toReturn = AABB(worldMin, worldMax);
+            toReturn = AABB(center - extents, center + extents);
         }
         else
         {
-            toReturn.GrowToContain(worldMin);
-            toReturn.GrowToContain(worldMax);
+            toReturn.GrowToContain(center - extents);
+            toReturn.GrowToContain(center + extents);
         }
     }
     return toReturn;
 }
 
+uint32_t MeshRenderer::GetAABBChangeCount() const
+{
+    // Each count only ever goes up, so the sum changes whenever any of them do.
+    uint32_t changeCount = GetOwner()->GetTransform()->GetChangeCount() + mMeshesChangeCount;
+    for(Mesh* mesh : mMeshes)
+    {
+        changeCount += mesh->GetChangeCount();
+    }
+    return changeCount;
+}
+
 void MeshRenderer::DebugDrawAABBs(const Color32& color, const Color32& meshColor)
 {
     // The local-to-world matrix for this Actor is required for all meshes.
@@ -16,6 +16,7 @@
 class Model;
 class Ray;
 struct RaycastHit;
+class RenderQueue;
 class Texture;
 
 class MeshRenderer : public Component
@@ -25,7 +26,8 @@ public:
     MeshRenderer(Actor* actor);
     ~MeshRenderer();
 
-    void Render(bool opaque = true, bool translucent = true);
+    // Adds a draw item to the queue for each visible submesh.
+    void AddToRenderQueue(RenderQueue& queue, const Vector3& cameraPosition);
 
     void SetShader(Shader* shader) { mShader = shader; }
 
@@ -48,6 +50,10 @@ public:
     bool Raycast(const Ray& ray, RaycastHit& hitInfo);
 
     AABB GetAABB() const;
+
+    // Changes whenever anything that affects the world-space AABB changes (the owner's transform, meshes, or mesh-to-local matrices).
+    // Checking this is a lot cheaper than calculating the AABB.
+    uint32_t GetAABBChangeCount() const;
     void DebugDrawAABBs(const Color32& color = Color32::White, const Color32& meshColor = Color32(255, 255, 132));
 
 private:
@@ -63,6 +69,9 @@ private:
     // If more than one is specified, they will be rendered in order.
     std::vector<Mesh*> mMeshes;
 
+    // Incremented when meshes are added or removed.
+    uint32_t mMeshesChangeCount = 0;
+
     // A material describes how to render a mesh.
     // Each mesh *must have* a material!
     // If a mesh has multiple submeshes, each submesh *must have* a material!
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <bitset>
 
+#include "AssetBuffer.h"
 #include "BinaryReader.h"
 #include "Mesh.h"
 #include "Submesh.h"
@@ -32,9 +33,9 @@ Model::~Model()
     }
 }
 
-void Model::Load(uint8_t* data, uint32_t dataLength)
+void Model::Load(const AssetBuffer& buffer)
 {
-    ParseFromData(data, dataLength);
+    ParseFromData(buffer.GetData(), buffer.GetSize());
 }
 
 void Model::WriteToObjFile(const std::string& filePath)
@@ -144,7 +145,7 @@ void Model::WriteToObjFile(const std::string& filePath)
     }
 }
 
-void Model::ParseFromData(uint8_t* data, uint32_t dataLength)
+void Model::ParseFromData(const uint8_t* data, uint32_t dataLength)
 {
     #ifdef DEBUG_MODEL_OUTPUT
     std::cout << "MOD " << mName << std::endl;
@@ -462,6 +463,12 @@ void Model::ParseFromData(uint8_t* data, uint32_t dataLength)
         }
     }
 
+    // With all submeshes loaded, build each mesh's triangle BVH up front, rather than on the first raycast or collision check.
+    for(Mesh* mesh : mMeshes)
+    {
+        mesh->BuildTriangleBVH();
+    }
+
     // After all meshes and mesh groups, there is some additional data.
     // 4 bytes: identifier "XDOM" (MODX backwards).
     identifier = reader.ReadString(4);
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+class AssetBuffer;
 class Mesh;
 
 class Model : public Asset
@@ -25,7 +26,7 @@ public:
     Model(const std::string& name, AssetScope scope) : Asset(name, scope) { }
     ~Model();
 
-    void Load(uint8_t* data, uint32_t dataLength);
+    void Load(const AssetBuffer& buffer);
 
     const std::vector<Mesh*>& GetMeshes() const { return mMeshes; }
 
@@ -40,5 +41,5 @@ private:
     // If true, the model should be rendered as a billboard.
     bool mBillboard = false;
 
-    void ParseFromData(uint8_t* data, uint32_t dataLength);
+    void ParseFromData(const uint8_t* data, uint32_t dataLength);
 };
@@ -0,0 +1,98 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Material.h"
+#include "Submesh.h"
+
+namespace
+{
+    // Bit layout of sort keys, from most significant to least:
+    // Opaque:      [pass:2][shader:14][texture:16][depth:32]
+    // Translucent: [pass:2][inverted depth:32][shader:14][texture:16]
+    const int kPassShift = 62;
+
+    uint64_t GetPointerBits(const void* ptr, uint64_t mask)
+    {
+        // Only grouping identical shaders/textures matters, not the order between different ones.
+        // Allocations are at least 16-byte aligned, so the low bits carry no information.
+        return (reinterpret_cast<uintptr_t>(ptr) >> 4) & mask;
+    }
+
+    uint64_t MakeSortKey(RenderQueue::Pass pass, const Material* material, float depth)
+    {
+        // For non-negative floats, the bit pattern sorts the same as the value.
+        depth = std::max(depth, 0.0f);
+        uint32_t depthBits = 0;
+        memcpy(&depthBits, &depth, sizeof(depthBits));
+
+        uint64_t shaderBits = GetPointerBits(material->GetShader(), 0x3FFF);
+        uint64_t textureBits = GetPointerBits(material->GetPrimaryTexture(), 0xFFFF);
+        uint64_t key = static_cast<uint64_t>(pass) << kPassShift;
+        if(pass == RenderQueue::Pass::Opaque)
+        {
+            key |= (shaderBits << 48) | (textureBits << 32) | depthBits;
+        }
+        else
+        {
+            // Inverting depth makes the farthest items sort first.
+            key |= (static_cast<uint64_t>(~depthBits) << 30) | (shaderBits << 16) | textureBits;
+        }
+        return key;
+    }
+}
+
+void RenderQueue::Clear()
+{
+    mItems.clear();
+    mSortedItems.clear();
+    mMaterialChangeCount = 0;
+}
+
+void RenderQueue::Add(Pass pass, Material* material, Submesh* submesh, const Matrix4& objectToWorldMatrix, float depth)
+{
+    SortEntry entry;
+    entry.key = MakeSortKey(pass, material, depth);
+    entry.index = static_cast<uint32_t>(mItems.size());
+    mSortedItems.push_back(entry);
+
+    mItems.emplace_back();
+    Item& item = mItems.back();
+    item.material = material;
+    item.submesh = submesh;
+    item.objectToWorldMatrix = objectToWorldMatrix;
+}
+
+void RenderQueue::Sort()
+{
+    // Stable sort keeps items with identical keys in the order they were added.
+    std::stable_sort(mSortedItems.begin(), mSortedItems.end(), [](const SortEntry& a, const SortEntry& b) {
+        return a.key < b.key;
+    });
+}
+
+void RenderQueue::Render(Pass pass)
+{
+    // Items in a pass are contiguous after sorting, since pass is the most significant part of the key.
+    uint64_t passBits = static_cast<uint64_t>(pass) << kPassShift;
+    auto it = std::lower_bound(mSortedItems.begin(), mSortedItems.end(), passBits, [](const SortEntry& entry, uint64_t key) {
+        return entry.key < key;
+    });
+
+    // Consecutive items using the same material only need their transform updated.
+    // Shader and texture binds are also skipped by the graphics API when they don't change.
+    Material* activeMaterial = nullptr;
+    for(; it != mSortedItems.end() && (it->key >> kPassShift) == static_cast<uint64_t>(pass); ++it)
+    {
+        Item& item = mItems[it->index];
+        if(item.material != activeMaterial)
+        {
+            item.material->Activate();
+            activeMaterial = item.material;
+            ++mMaterialChangeCount;
+        }
+        item.material->SetTransform(item.objectToWorldMatrix);
+        item.submesh->Render();
+    }
+}
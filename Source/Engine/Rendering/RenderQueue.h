@@ -0,0 +1,65 @@
+//
+// Clark Kromenaker
+//
+// Collects draw items for a frame, sorts them, and renders them with as few state changes as possible.
+//
+// Each item has a sort key built from its pass, shader, texture, and depth:
+// - Opaque items are grouped by shader, then texture, then sorted front-to-back (to reduce overdraw).
+// - Translucent items are sorted back-to-front (for correct blending), then by shader and texture.
+//
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Matrix4.h"
+
+class Material;
+class Submesh;
+
+class RenderQueue
+{
+public:
+    enum class Pass : uint8_t
+    {
+        Opaque,
+        Translucent
+    };
+
+    void Clear();
+
+    // Adds an item to draw. Depth is the (non-negative) distance from the camera, used for sorting.
+    // The material and submesh must remain valid until the queue is rendered.
+    void Add(Pass pass, Material* material, Submesh* submesh, const Matrix4& objectToWorldMatrix, float depth);
+
+    // Sorts all items. Call after adding items and before rendering.
+    void Sort();
+
+    // Renders all items in a pass. Any render state specific to the pass (blending, depth writes, etc) should be set beforehand.
+    void Render(Pass pass);
+
+    // Stats about the most recent render.
+    uint32_t GetItemCount() const { return static_cast<uint32_t>(mItems.size()); }
+    uint32_t GetMaterialChangeCount() const { return mMaterialChangeCount; }
+
+private:
+    struct Item
+    {
+        Material* material = nullptr;
+        Submesh* submesh = nullptr;
+        Matrix4 objectToWorldMatrix;
+    };
+
+    // Items in the order they were added.
+    std::vector<Item> mItems;
+
+    // Sort key and index for each item. This is what gets sorted, since it's much smaller than an item.
+    struct SortEntry
+    {
+        uint64_t key = 0;
+        uint32_t index = 0;
+    };
+    std::vector<SortEntry> mSortedItems;
+
+    // Number of times a material was activated, across all passes rendered since the last clear.
+    uint32_t mMaterialChangeCount = 0;
+};
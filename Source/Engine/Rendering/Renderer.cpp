@@ -18,11 +18,14 @@
 #include "SaveManager.h"
 #include "SceneManager.h"
 #include "SequentialFilePathGenerator.h"
+#include "Shader.h"
 #include "Skybox.h"
+#include "StringUtil.h"
 #include "Texture.h"
 #include "UICanvas.h"
 #include "UIWidget.h"
 
+#include "Null/GAPI_Null.h"
 #include "OpenGL/GAPI_OpenGL.h"
 
 // Line
@@ -88,14 +91,27 @@ float ui_quad_uvs[] = {
 };
 Mesh* uiQuad = nullptr;
 
+// Layout of the per-frame uniform buffer. Must match the "FrameUniforms" block declared in shaders (std140 layout).
+struct FrameUniforms
+{
+    Matrix4 viewMatrix;
+    Matrix4 projMatrix;
+    Matrix4 worldToProjMatrix;
+};
+
 Renderer gRenderer;
 
 bool Renderer::Initialize()
 {
     TIMER_SCOPED("Renderer::Initialize");
 
+    // Determine which graphics API to use.
+    // The "Null" API doesn't render anything, which is useful for benchmarking on machines without a GPU.
+    std::string graphicsAPI = gSaveManager.GetPrefs()->GetString(PREFS_HARDWARE_RENDERER, PREFS_GRAPHICS_API, "OpenGL");
+    bool useNullGAPI = StringUtil::EqualsIgnoreCase(graphicsAPI, "Null");
+
     // Create the game window.
-    Window::Create("Gabriel Knight 3");
+    Window::Create("Gabriel Knight 3", useNullGAPI ? 0 : SDL_WINDOW_OPENGL);
     if(Window::Get() == nullptr)
     {
         printf("Failed to create game window!\n");
@@ -103,7 +119,8 @@ bool Renderer::Initialize()
     }
 
     // Set which graphics API to use.
-    if(!GAPI::Set<GAPI_OpenGL>())
+    bool gapiSet = useNullGAPI ? GAPI::Set<GAPI_Null>() : GAPI::Set<GAPI_OpenGL>();
+    if(!gapiSet)
     {
         return false;
     }
@@ -123,6 +140,10 @@ bool Renderer::Initialize()
     // However, note that *indexes* are counter-clockwise...but that doesn't seem to affect how the data is interpreted?
     GAPI::Get()->SetPolygonWindingOrder(GAPI::WindingOrder::Clockwise);
 
+    // Create a uniform buffer for per-frame values. All shaders read view/projection matrices from this buffer.
+    mFrameUniformBuffer = GAPI::Get()->CreateUniformBuffer(sizeof(FrameUniforms));
+    GAPI::Get()->BindUniformBuffer(mFrameUniformBuffer, Shader::kFrameUniformsBinding);
+
     // Load default shader.
     Shader* defaultShader = gAssetManager.LoadShader("3D-Tex");
     if(defaultShader == nullptr) { return false; }
@@ -143,6 +164,8 @@ bool Renderer::Initialize()
     }
     gAssetManager.LoadShader("3D-Tex", "UI-Text-ColorReplace");
     gAssetManager.LoadShader("3D-Tex", "UI-Point-Circle");
+    gAssetManager.LoadShader("3D-Tex", "UI-Video-YUV");
+    gAssetManager.LoadShader("3D-Tex-Lit-VertexAnim", "3D-Tex-Lit");
 
     // Create simple shapes (useful for debugging/visualization).
     // Line
@@ -178,11 +201,17 @@ bool Renderer::Initialize()
 
         meshDefinition.AddVertexData(VertexAttribute::Position, quad_vertices);
         meshDefinition.AddVertexData(VertexAttribute::UV1, quad_uvs);
+
+        // Shadows render the quad with the lightmap shader, which reads lightmap UVs from UV2.
+        meshDefinition.AddVertexData(VertexAttribute::UV2, quad_uvs);
         meshDefinition.SetIndexData(6, quad_indices);
 
         quad = new Mesh();
         Submesh* quadSubmesh = quad->AddSubmesh(meshDefinition);
         quadSubmesh->SetRenderMode(RenderMode::Triangles);
+
+        // The quad is used by some mesh renderers (e.g. shadows), so it needs bounds for visibility checks.
+        quad->SetAABB(AABB(Vector3(-0.5f, -0.5f, 0.0f), Vector3(0.5f, 0.5f, 0.0f)));
     }
 
     // UI Quad
@@ -215,6 +244,11 @@ void Renderer::Shutdown()
 {
     if(GAPI::Get() != nullptr)
     {
+        if(mFrameUniformBuffer != nullptr)
+        {
+            GAPI::Get()->DestroyUniformBuffer(mFrameUniformBuffer);
+            mFrameUniformBuffer = nullptr;
+        }
         GAPI::Get()->Shutdown();
     }
     Window::Destroy();
@@ -250,6 +284,26 @@ void Renderer::Render()
         }
         PROFILER_END_SAMPLE();
 
+        PROFILER_BEGIN_SAMPLE("Renderer Cull");
+        {
+            // Figure out which mesh renderers are visible once, rather than in each pass below.
+            CullMeshRenderers();
+        }
+        PROFILER_END_SAMPLE();
+
+        PROFILER_BEGIN_SAMPLE("Renderer Build Queue");
+        {
+            // Queue up draws for visible mesh renderers, then sort them to minimize state changes (and get correct translucency).
+            mRenderQueue.Clear();
+            Vector3 cameraPosition = mCamera->GetOwner()->GetPosition();
+            for(MeshRenderer* meshRenderer : mVisibleMeshRenderers)
+            {
+                meshRenderer->AddToRenderQueue(mRenderQueue, cameraPosition);
+            }
+            mRenderQueue.Sort();
+        }
+        PROFILER_END_SAMPLE();
+
         PROFILER_BEGIN_SAMPLE("Render Skybox");
         {
             // SKYBOX RENDERING
@@ -260,8 +314,7 @@ void Renderer::Render()
             {
                 // To get the "infinite distance" skybox effect, we need to use a look-at
                 // matrix that doesn't take the camera's position into account.
-                Material::SetViewMatrix(mCamera->GetLookAtMatrixNoTranslate());
-                Material::SetProjMatrix(projectionMatrix);
+                SetViewProjMatrices(mCamera->GetLookAtMatrixNoTranslate(), projectionMatrix);
                 mSkybox->Render();
             }
             GAPI::Get()->SetDepthWriteEnabled(true);
@@ -275,8 +328,7 @@ void Renderer::Render()
             GAPI::Get()->SetPolygonCullMode(GAPI::CullMode::Back);
 
             // Set the view & projection matrices for normal 3D camera-oriented rendering.
-            Material::SetViewMatrix(viewMatrix);
-            Material::SetProjMatrix(projectionMatrix);
+            SetViewProjMatrices(viewMatrix, projectionMatrix);
 
             PROFILER_BEGIN_SAMPLE("Render Opaque BSP");
             // Render BSP before normal mesh renderers, since it has a tendency to completely cover most of the screen.
@@ -288,13 +340,9 @@ void Renderer::Render()
             PROFILER_END_SAMPLE();
 
             PROFILER_BEGIN_SAMPLE("Render Opaque Meshes");
-            // Render opaque meshes (no particular order).
-            // Sorting is probably not worthwhile b/c BSP likely mostly filled the z-buffer at this point.
-            // And with the z-buffer, we can render opaque meshed correctly regardless of order.
-            for(MeshRenderer* meshRenderer : mMeshRenderers)
-            {
-                meshRenderer->Render(true, false);
-            }
+            // Opaque meshes are sorted by shader and texture, then front-to-back.
+            // The BSP has likely filled most of the z-buffer at this point, so front-to-back mostly helps with overdraw between meshes.
+            mRenderQueue.Render(RenderQueue::Pass::Opaque);
             PROFILER_END_SAMPLE();
         }
         PROFILER_END_SAMPLE();
@@ -319,16 +367,16 @@ void Renderer::Render()
             if(mBSP != nullptr)
             {
                 mBSP->RenderTranslucent();
+                mStats.bspDrawCalls = mBSP->GetDrawCallCount();
             }
             PROFILER_END_SAMPLE();
 
             PROFILER_BEGIN_SAMPLE("Render Translucent Meshes");
-            // Render all translucent meshes.
-            //TODO: Probably about 99% of these meshes are opaque only; it seems a bit wasteful to iterate them again. But maybe it's OK?
-            for(MeshRenderer* meshRenderer : mMeshRenderers)
-            {
-                meshRenderer->Render(false, true);
-            }
+            // Translucent meshes are sorted back-to-front.
+            mRenderQueue.Render(RenderQueue::Pass::Translucent);
+
+            mStats.drawItems = mRenderQueue.GetItemCount();
+            mStats.materialChanges = mRenderQueue.GetMaterialChangeCount();
             PROFILER_END_SAMPLE();
         }
         PROFILER_END_SAMPLE();
@@ -346,8 +394,7 @@ void Renderer::Render()
 
         // UI uses a view/proj setup for now - world space for UI maps to pixel size of screen.
         // Bottom-left corner of screen is origin, +x is right, +y is up.
-        Material::SetViewMatrix(Matrix4::Identity);
-        Material::SetProjMatrix(RenderTransforms::MakeOrthoBottomLeft(static_cast<float>(Window::GetWidth()), static_cast<float>(Window::GetHeight())));
+        SetViewProjMatrices(Matrix4::Identity, RenderTransforms::MakeOrthoBottomLeft(static_cast<float>(Window::GetWidth()), static_cast<float>(Window::GetHeight())));
 
         // Render UI elements.
         // Any renderable UI element is contained within a Canvas.
@@ -369,8 +416,7 @@ void Renderer::Render()
         // Gotta reset view/proj again...
         if(mCamera != nullptr)
         {
-            Material::SetViewMatrix(viewMatrix);
-            Material::SetProjMatrix(projectionMatrix);
+            SetViewProjMatrices(viewMatrix, projectionMatrix);
         }
 
         #if defined(_DEBUG)
@@ -400,6 +446,13 @@ void Renderer::AddMeshRenderer(MeshRenderer* mr)
 
 void Renderer::RemoveMeshRenderer(MeshRenderer* mr)
 {
+    // Also remove from the visible list, in case a mesh renderer is destroyed mid-frame.
+    auto visibleIt = std::find(mVisibleMeshRenderers.begin(), mVisibleMeshRenderers.end(), mr);
+    if(visibleIt != mVisibleMeshRenderers.end())
+    {
+        mVisibleMeshRenderers.erase(visibleIt);
+    }
+
     auto it = std::find(mMeshRenderers.begin(), mMeshRenderers.end(), mr);
     if(it != mMeshRenderers.end())
     {
@@ -502,4 +555,38 @@ void Renderer::TakeScreenshotToFile() const
 
     // No longer need the texture - delete it.
     delete screenshot;
-}
\ No newline at end of file
+}
+
+void Renderer::SetViewProjMatrices(const Matrix4& viewMatrix, const Matrix4& projMatrix)
+{
+    // Upload once whenever view/projection change, rather than setting these uniforms for every draw.
+    FrameUniforms frameUniforms;
+    frameUniforms.viewMatrix = viewMatrix;
+    frameUniforms.projMatrix = projMatrix;
+    frameUniforms.worldToProjMatrix = projMatrix * viewMatrix;
+    GAPI::Get()->SetUniformBufferData(mFrameUniformBuffer, 0, sizeof(FrameUniforms), &frameUniforms);
+}
+
+void Renderer::CullMeshRenderers()
+{
+    mVisibleMeshRenderers.clear();
+    mStats.meshRenderersDrawn = 0;
+    mStats.meshRenderersCulled = 0;
+
+    // Culling can be disabled for debugging (e.g. to check whether something is incorrectly culled).
+    bool cullingEnabled = !Debug::GetFlag("DisableFrustumCulling");
+    Frustum frustum = mCamera->GetWorldSpaceViewFrustum();
+    for(MeshRenderer* meshRenderer : mMeshRenderers)
+    {
+        // Inactive mesh renderers don't render anyway, so don't count them as drawn or culled.
+        if(!meshRenderer->IsActiveAndEnabled()) { continue; }
+
+        if(cullingEnabled && !frustum.IntersectsAABB(meshRenderer->GetAABB()))
+        {
+            ++mStats.meshRenderersCulled;
+            continue;
+        }
+        mVisibleMeshRenderers.push_back(meshRenderer);
+        ++mStats.meshRenderersDrawn;
+    }
+}
@@ -5,18 +5,35 @@
 // Actual rendering commands are delegated to the underlying "graphics API" (GAPI) implementation.
 //
 #pragma once
+#include <cstdint>
 #include <vector>
 
+#include "RenderQueue.h"
 #include "Window.h"
 
 class BSP;
 class Camera;
+class Matrix4;
 class MeshRenderer;
 class Model;
 class Shader;
 class Skybox;
 class Texture;
 
+// Counts of what was drawn or culled in the most recent frame.
+struct RenderStats
+{
+    uint32_t meshRenderersDrawn = 0;
+    uint32_t meshRenderersCulled = 0;
+
+    // Number of submeshes drawn from the render queue, and how many material changes that required.
+    uint32_t drawItems = 0;
+    uint32_t materialChanges = 0;
+
+    // Number of draw calls used to render the BSP.
+    uint32_t bspDrawCalls = 0;
+};
+
 class Renderer
 {
 public:
@@ -48,6 +65,8 @@ public:
     Texture* TakeScreenshotToTexture() const;
     void TakeScreenshotToFile() const;
 
+    const RenderStats& GetStats() const { return mStats; }
+
 private:
     // Our camera in the scene - we currently only support one.
     Camera* mCamera = nullptr;
@@ -55,6 +74,16 @@ private:
     // List of mesh components to render.
     std::vector<MeshRenderer*> mMeshRenderers;
 
+    // Mesh components that passed visibility checks this frame.
+    // Built once per frame and used by both opaque and translucent passes.
+    std::vector<MeshRenderer*> mVisibleMeshRenderers;
+
+    // Draws for visible mesh renderers, sorted to minimize state changes.
+    RenderQueue mRenderQueue;
+
+    // Stats about the most recent frame.
+    RenderStats mStats;
+
     // A BSP to render.
     BSP* mBSP = nullptr;
 
@@ -64,6 +93,12 @@ private:
     // Global texture settings.
     bool mUseMipmaps = true;
     bool mUseTrilinearFiltering = true;
+
+    // A uniform buffer containing per-frame shader values (view & projection matrices).
+    void* mFrameUniformBuffer = nullptr;
+
+    void SetViewProjMatrices(const Matrix4& viewMatrix, const Matrix4& projMatrix);
+    void CullMeshRenderers();
 };
 
 extern Renderer gRenderer;
\ No newline at end of file
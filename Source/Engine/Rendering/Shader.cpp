@@ -1,5 +1,7 @@
 #include "Shader.h"
 
+#include <cstring>
+
 #include "GAPI.h"
 #include "TextAsset.h"
 
@@ -8,10 +10,24 @@ TYPEINFO_INIT(Shader, Asset, GENERATE_TYPE_ID)
 
 }
 
+const char* Shader::kFrameUniformsBlockName = "FrameUniforms";
+
 Shader::Shader(const std::string& name, TextAsset* vertShaderBytes, TextAsset* fragShaderBytes) : Asset(name, AssetScope::Manual)
 {
     mShaderHandle = GAPI::Get()->CreateShader(vertShaderBytes->GetText(),
                                               fragShaderBytes->GetText());
+    if(mShaderHandle != nullptr)
+    {
+        // Reflect uniforms once, so they can be set by slot rather than by name.
+        GAPI::Get()->GetShaderUniforms(mShaderHandle, mUniforms);
+        mObjectToWorldSlot = GetUniformSlot("gObjectToWorldMatrix");
+        mWorldToObjectSlot = GetUniformSlot("gWorldToObjectMatrix");
+        mAlphaTestSlot = GetUniformSlot("gAlphaTest");
+        mChromaKeySlot = GetUniformSlot("gChromaKey");
+
+        // Per-frame values come from a uniform buffer, which is bound by the renderer.
+        GAPI::Get()->SetShaderUniformBlockBinding(mShaderHandle, kFrameUniformsBlockName, kFrameUniformsBinding);
+    }
 }
 
 Shader::~Shader()
@@ -24,32 +40,50 @@ void Shader::Activate()
     GAPI::Get()->ActivateShader(mShaderHandle);
 }
 
-void Shader::SetUniformInt(const char* name, int value)
+int Shader::GetUniformSlot(const char* name) const
+{
+    for(size_t i = 0; i < mUniforms.size(); ++i)
+    {
+        if(strcmp(mUniforms[i].name.c_str(), name) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void Shader::SetUniformInt(int slot, int value)
 {
-    GAPI::Get()->SetShaderUniformInt(mShaderHandle, name, value);
+    if(slot < 0) { return; }
+    GAPI::Get()->SetShaderUniformInt(mShaderHandle, mUniforms[slot].location, value);
 }
 
-void Shader::SetUniformFloat(const char* name, float value)
+void Shader::SetUniformFloat(int slot, float value)
 {
-    GAPI::Get()->SetShaderUniformFloat(mShaderHandle, name, value);
+    if(slot < 0) { return; }
+    GAPI::Get()->SetShaderUniformFloat(mShaderHandle, mUniforms[slot].location, value);
 }
 
-void Shader::SetUniformVector3(const char* name, const Vector3& vector)
+void Shader::SetUniformVector3(int slot, const Vector3& vector)
 {
-    GAPI::Get()->SetShaderUniformVector3(mShaderHandle, name, vector);
+    if(slot < 0) { return; }
+    GAPI::Get()->SetShaderUniformVector3(mShaderHandle, mUniforms[slot].location, vector);
 }
 
-void Shader::SetUniformVector4(const char *name, const Vector4& vector)
+void Shader::SetUniformVector4(int slot, const Vector4& vector)
 {
-    GAPI::Get()->SetShaderUniformVector4(mShaderHandle, name, vector);
+    if(slot < 0) { return; }
+    GAPI::Get()->SetShaderUniformVector4(mShaderHandle, mUniforms[slot].location, vector);
 }
 
-void Shader::SetUniformMatrix4(const char* name, const Matrix4& mat)
+void Shader::SetUniformMatrix4(int slot, const Matrix4& mat)
 {
-    GAPI::Get()->SetShaderUniformMatrix4(mShaderHandle, name, mat);
+    if(slot < 0) { return; }
+    GAPI::Get()->SetShaderUniformMatrix4(mShaderHandle, mUniforms[slot].location, mat);
 }
 
-void Shader::SetUniformColor(const char* name, const Color32& color)
+void Shader::SetUniformColor(int slot, const Color32& color)
 {
-    GAPI::Get()->SetShaderUniformColor(mShaderHandle, name, color);
+    if(slot < 0) { return; }
+    GAPI::Get()->SetShaderUniformColor(mShaderHandle, mUniforms[slot].location, color);
 }
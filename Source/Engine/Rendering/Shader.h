@@ -6,7 +6,9 @@
 #pragma once
 #include "Asset.h"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 class Color32;
 class Matrix4;
@@ -32,7 +34,8 @@ enum class UniformType
     Matrix4,
 
     Texture2D,
-    TextureCube
+    TextureCube,
+    TextureBuffer
     //TODO: Add more as needed
 };
 
@@ -43,6 +46,9 @@ struct Uniform
 
     // Uniform name.
     std::string name;
+
+    // Location of the uniform in the underlying graphics system.
+    int location = -1;
 };
 
 class Shader : public Asset
@@ -54,19 +60,48 @@ public:
 
     void Activate();
 
-    void SetUniformInt(const char* name, int value);
-    void SetUniformFloat(const char* name, float value);
-
-    void SetUniformVector3(const char* name, const Vector3& vector);
-    void SetUniformVector4(const char* name, const Vector4& vector);
-
-    void SetUniformMatrix4(const char* name, const Matrix4& mat);
-
-    void SetUniformColor(const char* name, const Color32& color);
+    // Uniforms are reflected when the shader is created. A slot identifies a uniform, and can be cached to avoid name lookups.
+    // Returns -1 if the shader has no uniform with the given name.
+    int GetUniformSlot(const char* name) const;
+    const std::vector<Uniform>& GetUniforms() const { return mUniforms; }
+
+    // Slots for built-in uniforms that are set on every draw.
+    int GetObjectToWorldSlot() const { return mObjectToWorldSlot; }
+    int GetWorldToObjectSlot() const { return mWorldToObjectSlot; }
+    int GetAlphaTestSlot() const { return mAlphaTestSlot; }
+    int GetChromaKeySlot() const { return mChromaKeySlot; }
+
+    void SetUniformInt(int slot, int value);
+    void SetUniformFloat(int slot, float value);
+    void SetUniformVector3(int slot, const Vector3& vector);
+    void SetUniformVector4(int slot, const Vector4& vector);
+    void SetUniformMatrix4(int slot, const Matrix4& mat);
+    void SetUniformColor(int slot, const Color32& color);
+
+    // Same as above, but looks up the slot by name.
+    void SetUniformInt(const char* name, int value) { SetUniformInt(GetUniformSlot(name), value); }
+    void SetUniformFloat(const char* name, float value) { SetUniformFloat(GetUniformSlot(name), value); }
+    void SetUniformVector3(const char* name, const Vector3& vector) { SetUniformVector3(GetUniformSlot(name), vector); }
+    void SetUniformVector4(const char* name, const Vector4& vector) { SetUniformVector4(GetUniformSlot(name), vector); }
+    void SetUniformMatrix4(const char* name, const Matrix4& mat) { SetUniformMatrix4(GetUniformSlot(name), mat); }
+    void SetUniformColor(const char* name, const Color32& color) { SetUniformColor(GetUniformSlot(name), color); }
 
     bool IsGood() const { return mShaderHandle != nullptr; }
 
+    // Name of the uniform block containing per-frame values (view/projection matrices), and the binding index it uses.
+    static const char* kFrameUniformsBlockName;
+    static const uint32_t kFrameUniformsBinding = 0;
+
 private:
     // Handle to shader in underlying graphics system.
     void* mShaderHandle = nullptr;
+
+    // Uniforms in this shader. A uniform's slot is its index in this list.
+    std::vector<Uniform> mUniforms;
+
+    // Cached built-in uniform slots.
+    int mObjectToWorldSlot = -1;
+    int mWorldToObjectSlot = -1;
+    int mAlphaTestSlot = -1;
+    int mChromaKeySlot = -1;
 };
@@ -65,10 +65,18 @@ void Submesh::Render(unsigned int offset, unsigned int count)
 
 Vector3 Submesh::GetVertexPosition(int index) const
 {
-    if(mPositions == nullptr) { return Vector3::Zero; }
     if(index < 0 || index >= mVertexArray.GetVertexCount()) { return Vector3::Zero; }
 
+    // Blended positions take priority over the positions in the vertex data.
     int offset = index * 3;
+    if(mBlendFromPositions != nullptr)
+    {
+        Vector3 from(mBlendFromPositions[offset], mBlendFromPositions[offset + 1], mBlendFromPositions[offset + 2]);
+        Vector3 to(mBlendToPositions[offset], mBlendToPositions[offset + 1], mBlendToPositions[offset + 2]);
+        return Vector3::Lerp(from, to, mBlendT);
+    }
+
+    if(mPositions == nullptr) { return Vector3::Zero; }
     return Vector3(mPositions[offset], mPositions[offset + 1], mPositions[offset + 2]);
 }
 
@@ -106,21 +114,58 @@ bool Submesh::GetTriangle(int index, Vector3& p0, Vector3& p1, Vector3& p2) cons
 {
     if(mRenderMode == RenderMode::Triangles)
     {
+        int offset = index * 3;
         if(mIndexes != nullptr)
         {
-            int offset = index * 3;
             p0 = GetVertexPosition(mIndexes[offset]);
             p1 = GetVertexPosition(mIndexes[offset + 1]);
             p2 = GetVertexPosition(mIndexes[offset + 2]);
-            return true;
         }
-        //TODO: Add support if no indexes present
+        else
+        {
+            p0 = GetVertexPosition(offset);
+            p1 = GetVertexPosition(offset + 1);
+            p2 = GetVertexPosition(offset + 2);
+        }
+        return true;
     }
     //TODO: Add support for triangle fans/strips.
 
     return false;
 }
 
+Vector2 Submesh::GetTriangleUV(int index, float u, float v) const
+{
+    if(mRenderMode != RenderMode::Triangles) { return Vector2::Zero; }
+
+    // First, get the three UVs that correspond to the three triangle vertices.
+    //TODO: There is similar code to this here, in skybox, and in BSP. Probably they can be consolidated!
+    int offset = index * 3;
+    Vector2 uv0;
+    Vector2 uv1;
+    Vector2 uv2;
+    if(mIndexes != nullptr)
+    {
+        uv0 = GetVertexUV(mIndexes[offset]);
+        uv1 = GetVertexUV(mIndexes[offset + 1]);
+        uv2 = GetVertexUV(mIndexes[offset + 2]);
+    }
+    else
+    {
+        uv0 = GetVertexUV(offset);
+        uv1 = GetVertexUV(offset + 1);
+        uv2 = GetVertexUV(offset + 2);
+    }
+
+    // Calculate the point UV.
+    //TODO: This math doesn't totally make sense to me, and I think it needs more scrutinizing.
+    //TODO: Why do u/v/w not correlate to uv0/uv1/uv2 here? Why do we need to negate and flop the UVs?
+    Vector2 pointUV = uv1 * u + uv2 * v + uv0 * (1.0f - u - v);
+    pointUV.y *= -1.0f;
+    pointUV.y = 1.0f - pointUV.y;
+    return pointUV;
+}
+
 bool Submesh::Raycast(const Ray& ray, float& outRayT, Vector2& outUV)
 {
     // Ensure out value is at default.
@@ -135,24 +180,13 @@ bool Submesh::Raycast(const Ray& ray, float& outRayT, Vector2& outUV)
 
     // Check whether the ray hits any triangles in this submesh.
     // Even if hit occurs, can't early out! Must check all triangles in case a closer one (lower t value) is found.
-    int elementCount = mIndexes != nullptr ? mVertexArray.GetIndexCount() : mVertexArray.GetVertexCount();
+    int triangleCount = GetTriangleCount();
     Vector3 vert1;
     Vector3 vert2;
     Vector3 vert3;
-    for(uint32_t i = 0; i < elementCount; i += 3)
+    for(int i = 0; i < triangleCount; ++i)
     {
-        if(mIndexes != nullptr)
-        {
-            vert1 = GetVertexPosition(mIndexes[i]);
-            vert2 = GetVertexPosition(mIndexes[i + 1]);
-            vert3 = GetVertexPosition(mIndexes[i + 2]);
-        }
-        else
-        {
-            vert1 = GetVertexPosition(i);
-            vert2 = GetVertexPosition(i + 1);
-            vert3 = GetVertexPosition(i + 2);
-        }
+        GetTriangle(i, vert1, vert2, vert3);
 
         float t = FLT_MAX;
         float u = 0.0f;
@@ -161,34 +195,9 @@ bool Submesh::Raycast(const Ray& ray, float& outRayT, Vector2& outUV)
         {
             if(t < outRayT)
             {
-                outRayT = t;
-
                 // The calling code sometimes needs to know the UV coordinate where the ray hit.
-                // First, get the three UVs that correspond to these three triangle vertices.
-                //TODO: There is similar code to this here, in skybox, and in BSP. Probably they can be consolidated!
-                Vector2 uv0;
-                Vector2 uv1;
-                Vector2 uv2;
-                if(mIndexes != nullptr)
-                {
-                    uv0 = GetVertexUV(mIndexes[i]);
-                    uv1 = GetVertexUV(mIndexes[i + 1]);
-                    uv2 = GetVertexUV(mIndexes[i + 2]);
-                }
-                else
-                {
-                    uv0 = GetVertexUV(i);
-                    uv1 = GetVertexUV(i + 1);
-                    uv2 = GetVertexUV(i + 2);
-                }
-
-                // Calculate the point UV.
-                //TODO: This math doesn't totally make sense to me, and I think it needs more scrutinizing.
-                //TODO: Why do u/v/w not correlate to uv0/uv1/uv2 here? Why do we need to negate and flop the UVs?
-                Vector2 pointUV = uv1 * u + uv2 * v + uv0 * (1.0f - u - v);
-                pointUV.y *= -1.0f;
-                pointUV.y = 1.0f - pointUV.y;
-                outUV = pointUV;
+                outRayT = t;
+                outUV = GetTriangleUV(i, u, v);
             }
         }
     }
@@ -199,7 +208,18 @@ bool Submesh::Raycast(const Ray& ray, float& outRayT, Vector2& outUV)
 
 void Submesh::SetPositions(float* positions)
 {
+    mBlendFromPositions = nullptr;
+    mBlendToPositions = nullptr;
     mVertexArray.ChangeVertexData(VertexAttribute::Semantic::Position, positions);
+    ++mPositionsChangeCount;
+}
+
+void Submesh::SetBlendedPositions(const float* fromPositions, const float* toPositions, float t)
+{
+    mBlendFromPositions = fromPositions;
+    mBlendToPositions = toPositions;
+    mBlendT = t;
+    ++mPositionsChangeCount;
 }
 
 void Submesh::SetNormals(float* normals)
@@ -5,6 +5,7 @@
 // For the most part, it is a wrapper around a VertexArray, with some extra functionality (raycasting, data querying, etc).
 //
 #pragma once
+#include <cstdint>
 #include <string>
 
 #include "Color32.h"
@@ -43,11 +44,23 @@ public:
     int GetTriangleCount() const;
     bool GetTriangle(int index, Vector3& p0, Vector3& p1, Vector3& p2) const;
 
+    // Gets the UV at a point on a triangle, given the point's barycentric coordinates (as calculated by ray/triangle tests).
+    Vector2 GetTriangleUV(int index, float u, float v) const;
+
     bool Raycast(const Ray& ray, float& outRayT, Vector2& outUV);
 
     void SetPositions(float* positions);
     float* GetPositions() { return mPositions; }
 
+    // Positions can also be a blend between two sets of positions, such as two keyframes of a vertex animation.
+    // The blend is expected to be done when rendering (in the vertex shader), so the vertex data is left alone.
+    // But position queries (GetVertexPosition, raycasts) return blended positions. Calling SetPositions clears the blend.
+    // The two position arrays must have one position per vertex, and must remain valid until the blend is cleared.
+    void SetBlendedPositions(const float* fromPositions, const float* toPositions, float t);
+
+    // Incremented each time positions change (via SetPositions or SetBlendedPositions).
+    uint32_t GetPositionsChangeCount() const { return mPositionsChangeCount; }
+
     void SetNormals(float* normals);
     float* GetNormals() { return mNormals; }
 
@@ -82,6 +95,13 @@ private:
     float* mUV1 = nullptr;
     unsigned short* mIndexes = nullptr;
 
+    // If set, positions are a blend between these two position arrays, rather than the positions in the vertex data.
+    const float* mBlendFromPositions = nullptr;
+    const float* mBlendToPositions = nullptr;
+    float mBlendT = 0.0f;
+
+    uint32_t mPositionsChangeCount = 0;
+
     // Vertex array that actually renders using the underlying rendering system.
     VertexArray mVertexArray;
 
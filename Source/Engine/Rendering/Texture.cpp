@@ -2,6 +2,7 @@
 
 #include <stb_image_resize.h>
 
+#include "AssetBuffer.h"
 #include "BinaryReader.h"
 #include "BinaryWriter.h"
 #include "FileSystem.h"
@@ -19,12 +20,13 @@ TYPEINFO_INIT(Texture, Asset, GENERATE_TYPE_ID)
 Texture Texture::White(1, 1, Color32::White);
 Texture Texture::Black(1, 1, Color32::Black);
 
-Texture::Texture(uint32_t width, uint32_t height) : Asset("", AssetScope::Manual),
+Texture::Texture(uint32_t width, uint32_t height, Format format) : Asset("", AssetScope::Manual),
     mWidth(width),
-    mHeight(height)
+    mHeight(height),
+    mFormat(format)
 {
     // Create pixel array of desired size.
-    size_t pixelsSize = mWidth * mHeight * 4;
+    size_t pixelsSize = mWidth * mHeight * GetBytesPerPixel(mFormat);
     mPixels = new uint8_t[pixelsSize];
 }
 
@@ -77,9 +79,9 @@ Texture::~Texture()
     }
 }
 
-void Texture::Load(uint8_t* data, uint32_t dataLength)
+void Texture::Load(const AssetBuffer& buffer)
 {
-    BinaryReader reader(data, dataLength);
+    BinaryReader reader(buffer.GetData(), buffer.GetSize());
     ParseFromData(reader);
 }
 
@@ -479,7 +481,7 @@ void Texture::UploadToGPU()
     if(mTextureHandle == nullptr)
     {
         // Create a texture and set pixels.
-        mTextureHandle = GAPI::Get()->CreateTexture(mWidth, mHeight, mPixels);
+        mTextureHandle = GAPI::Get()->CreateTexture(mWidth, mHeight, mFormat, mPixels);
 
         // We must upload properties when texture is first generated too.
         mDirtyFlags |= DirtyFlags::Properties;
@@ -489,7 +491,7 @@ void Texture::UploadToGPU()
         // If pixel data is dirty, upload new pixel data.
         if((mDirtyFlags & DirtyFlags::Pixels) != DirtyFlags::None)
         {
-            GAPI::Get()->SetTexturePixels(mTextureHandle, mWidth, mHeight, mPixels);
+            GAPI::Get()->SetTexturePixels(mTextureHandle, mWidth, mHeight, mFormat, mPixels);
 
             // If using mipmaps, we must regenerate mipmaps for this texture after changing its pixels.
             if(mMipmaps)
@@ -530,6 +532,21 @@ void Texture::UploadToGPU()
     mDirtyFlags = DirtyFlags::None;
 }
 
+void Texture::StreamPixels(const uint8_t* pixels, uint32_t rowStride)
+{
+    // Make sure the texture exists on the GPU and its properties are up to date.
+    UploadToGPU();
+
+    // Stream the new pixels into the texture.
+    GAPI::Get()->StreamTexturePixels(mTextureHandle, mWidth, mHeight, mFormat, pixels, rowStride);
+
+    // As with any pixel change, mipmaps must be regenerated.
+    if(mMipmaps)
+    {
+        GAPI::Get()->GenerateMipmaps(mTextureHandle);
+    }
+}
+
 void Texture::WriteToFile(const std::string& filePath)
 {
     if(Path::HasExtension(filePath, "png"))
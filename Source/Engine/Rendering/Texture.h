@@ -12,6 +12,7 @@
 #include "Color32.h"
 #include "EnumClassFlags.h"
 
+class AssetBuffer;
 class BinaryReader;
 
 class Texture : public Asset
@@ -25,6 +26,14 @@ public:
         Translucent	// Texture has pixels that are partially transparent
     };
 
+    // Dictates how pixel data is laid out in memory.
+    enum class Format
+    {
+        RGBA,   // Four bytes per pixel (red, green, blue, alpha).
+        R8      // One byte per pixel. Shaders read this value from the red channel.
+    };
+    static uint32_t GetBytesPerPixel(Format format) { return format == Format::R8 ? 1 : 4; }
+
     // Dictates how the texture acts when it is magnified or minified.
     enum class FilterMode
     {
@@ -52,13 +61,13 @@ public:
     static Texture White;
     static Texture Black;
 
-    Texture(uint32_t width, uint32_t height);
+    Texture(uint32_t width, uint32_t height, Format format = Format::RGBA);
     Texture(uint32_t width, uint32_t height, Color32 color);
     Texture(const std::string& name, AssetScope scope) : Asset(name, scope) { }
     Texture(BinaryReader& reader);
     ~Texture();
 
-    void Load(uint8_t* data, uint32_t dataLength);
+    void Load(const AssetBuffer& buffer);
 
     // Activates the texture in the graphics library.
     void Activate(uint8_t textureUnit);
@@ -67,6 +76,7 @@ public:
     uint32_t GetWidth() const { return mWidth; }
     uint32_t GetHeight() const { return mHeight; }
     uint8_t* GetPixelData() const { return mPixels; }
+    Format GetFormat() const { return mFormat; }
 
     RenderType GetRenderType() const { return mRenderType; }
 
@@ -78,6 +88,7 @@ public:
 
     void SetMipmaps(bool useMipmaps);
 
+    // Pixel functions below assume the texture uses the RGBA format.
     // Coordinates are from top-left corner of texture.
     void SetPixelColor32(int x, int y, const Color32& color);
     Color32 GetPixelColor32(int x, int y) const;
@@ -110,6 +121,11 @@ public:
     void AddDirtyFlags(DirtyFlags flags);
     void UploadToGPU();
 
+    // Uploads pixels directly to the GPU, without copying them into this texture's pixel data.
+    // Meant for textures that are replaced every frame (like video), where this avoids a copy and an upload stall.
+    // Rows in the pixel data are "rowStride" bytes apart, which may be more than the texture's row size.
+    void StreamPixels(const uint8_t* pixels, uint32_t rowStride);
+
     // Export/save
     void WriteToFile(const std::string& filePath);
 
@@ -118,6 +134,9 @@ private:
     uint32_t mWidth = 0;
     uint32_t mHeight = 0;
 
+    // Layout of the pixel data.
+    Format mFormat = Format::RGBA;
+
     // Some textures have palettes.
     uint8_t* mPalette = nullptr;
     uint32_t mPaletteSize = 0;
@@ -0,0 +1,23 @@
+#include "TextureBuffer.h"
+
+#include "GAPI.h"
+
+TextureBuffer::TextureBuffer(const float* data, uint32_t count) :
+    mCount(count)
+{
+    mHandle = GAPI::Get()->CreateTextureBuffer(count, data);
+}
+
+TextureBuffer::~TextureBuffer()
+{
+    if(mHandle != nullptr)
+    {
+        GAPI::Get()->DestroyTextureBuffer(mHandle);
+    }
+}
+
+void TextureBuffer::Activate(uint8_t textureUnit)
+{
+    GAPI::Get()->SetTextureUnit(textureUnit);
+    GAPI::Get()->ActivateTextureBuffer(mHandle);
+}
@@ -0,0 +1,33 @@
+//
+// Clark Kromenaker
+//
+// A large, read-only array of floats that shaders can read from (declared as a "samplerBuffer" and read with texelFetch).
+// This is useful for data that is too big to pass as uniforms, such as every keyframe pose of a vertex animation.
+//
+#pragma once
+#include <cstdint>
+
+class TextureBuffer
+{
+public:
+    TextureBuffer(const float* data, uint32_t count);
+    ~TextureBuffer();
+
+    // Texture buffers own a GPU resource, so copying is not allowed.
+    TextureBuffer(const TextureBuffer&) = delete;
+    TextureBuffer& operator=(const TextureBuffer&) = delete;
+
+    void Activate(uint8_t textureUnit);
+
+    // False if the buffer couldn't be created on the GPU (e.g. it was too big).
+    bool IsGood() const { return mHandle != nullptr; }
+
+    uint32_t GetCount() const { return mCount; }
+
+private:
+    // Handle to the buffer in the underlying graphics system.
+    void* mHandle = nullptr;
+
+    // Number of floats in the buffer.
+    uint32_t mCount = 0;
+};
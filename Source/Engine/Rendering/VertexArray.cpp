@@ -2,6 +2,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <utility>
 
 #include "ThreadUtil.h"
 
@@ -39,13 +40,10 @@ VertexArray::VertexArray(VertexArray&& other) noexcept
 
 VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
 {
-    mData = other.mData;
-    mVertexBuffer = other.mVertexBuffer;
-    mIndexBuffer = other.mIndexBuffer;
-
-    other.mData = MeshDefinition();
-    other.mVertexBuffer = nullptr;
-    other.mIndexBuffer = nullptr;
+    // Swap, rather than overwrite, so any data/resources we already had are released when "other" is destroyed.
+    std::swap(mData, other.mData);
+    std::swap(mVertexBuffer, other.mVertexBuffer);
+    std::swap(mIndexBuffer, other.mIndexBuffer);
     return *this;
 }
 
@@ -173,7 +173,7 @@ namespace Window
     }
 }
 
-void Window::Create(const char* title)
+void Window::Create(const char* title, Uint32 graphicsFlags)
 {
     // Determine whether window should be fullscreen.
     bool fullscreen = gSaveManager.GetPrefs()->GetBool(PREFS_ENGINE, PREF_FULLSCREEN, false);
@@ -206,8 +206,8 @@ void Window::Create(const char* title)
 
     // These flags are just about the only thing tying window creation to specific graphics APIs.
     // They don't *seem* necessary on all platforms...but just pass them in case I suppose.
-    flags |= SDL_WINDOW_OPENGL; //TODO: is this flag even needed for OGL to work? Doesn't seem like it.
-    //flags |= SDL_WINDOW_VULKAN; // doesn't work on Mac
+    // Usually this is SDL_WINDOW_OPENGL (SDL_WINDOW_VULKAN doesn't work on Mac). A GAPI that doesn't render passes none.
+    flags |= graphicsFlags;
 
     // Create window from preferences.
     Window::Create(title, xPos, yPos, currentResolution.width, currentResolution.height, flags);
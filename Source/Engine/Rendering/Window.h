@@ -23,7 +23,7 @@ namespace Window
         uint32_t height = 0;
     };
 
-    void Create(const char* title);
+    void Create(const char* title, Uint32 graphicsFlags = SDL_WINDOW_OPENGL);
     void Create(const char* title, int x, int y, int w, int h, Uint32 flags);
     void Destroy();
 
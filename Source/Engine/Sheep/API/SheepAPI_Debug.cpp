@@ -1,10 +1,53 @@
 #include "SheepAPI_Debug.h"
 
+#include "AssetManager.h"
+#include "BSP.h"
 #include "Debug.h"
 #include "LayerManager.h"
+#include "LocationManager.h"
+#include "ReportManager.h"
+#include "SceneData.h"
+#include "SceneInitFile.h"
+#include "SceneManager.h"
+#include "SheepScript.h"
+#include "StringUtil.h"
+#include "Texture.h"
+#include "VertexAnimation.h"
+#include "WalkerBoundary.h"
 
 using namespace std;
 
+namespace
+{
+    // Benchmarks can run on a specific asset, or on all loaded assets of a type if no name is given.
+    // Returns false if a specific asset was asked for, but it couldn't be loaded.
+    template<typename T>
+    bool GetAssetsToBenchmark(const std::string& name, T* (AssetManager::*loadFunc)(const std::string&, AssetScope), std::vector<T*>& outAssets)
+    {
+        if(!name.empty())
+        {
+            T* asset = (gAssetManager.*loadFunc)(name, AssetScope::Scene);
+            if(asset == nullptr)
+            {
+                gReportManager.Log("Error", StringUtil::Format("Error: unable to find file `%s`", name.c_str()));
+                return false;
+            }
+            outAssets.push_back(asset);
+            return true;
+        }
+
+        const std::string_map_ci<T*>* loadedAssets = gAssetManager.GetLoadedAssets<T>();
+        if(loadedAssets != nullptr)
+        {
+            for(auto& entry : *loadedAssets)
+            {
+                outAssets.push_back(entry.second);
+            }
+        }
+        return true;
+    }
+}
+
 int GetDebugFlag(const std::string& flagName)
 {
     return Debug::GetFlag(flagName);
@@ -44,4 +87,99 @@ shpvoid DumpLayerStack()
     gLayerManager.DumpLayerStack();
     return 0;
 }
-RegFunc0(DumpLayerStack, void, IMMEDIATE, DEV_FUNC);
\ No newline at end of file
+RegFunc0(DumpLayerStack, void, IMMEDIATE, DEV_FUNC);
+
+shpvoid BenchmarkBSPRaycasts(int rayCount)
+{
+    Scene* scene = gSceneManager.GetScene();
+    if(scene == nullptr || scene->GetSceneData() == nullptr || scene->GetSceneData()->GetBSP() == nullptr)
+    {
+        ExecError();
+        return 0;
+    }
+    scene->GetSceneData()->GetBSP()->BenchmarkRaycasts(rayCount);
+    return 0;
+}
+RegFunc1(BenchmarkBSPRaycasts, void, int, IMMEDIATE, DEV_FUNC);
+
+shpvoid BenchmarkSheep(const std::string& sheepName, int iterations)
+{
+    std::vector<SheepScript*> scripts;
+    if(!GetAssetsToBenchmark(sheepName, &AssetManager::LoadSheep, scripts))
+    {
+        ExecError();
+        return 0;
+    }
+
+    // Sheep are decoded into an instruction array once at load time, so the VM doesn't decode bytecode as it executes.
+    // This measures that up-front cost. Executing scripts isn't benchmarked, since most scripts call SysFuncs with side effects.
+    for(SheepScript* script : scripts)
+    {
+        script->BenchmarkDecoding(iterations);
+    }
+    return 0;
+}
+RegFunc2(BenchmarkSheep, void, string, int, IMMEDIATE, DEV_FUNC);
+
+shpvoid BenchmarkVertexAnimations(const std::string& animName, int iterations)
+{
+    std::vector<VertexAnimation*> animations;
+    if(!GetAssetsToBenchmark(animName, &AssetManager::LoadVertexAnimation, animations))
+    {
+        ExecError();
+        return 0;
+    }
+
+    // GK3 vertex animations almost always play at 15 frames per second.
+    for(VertexAnimation* animation : animations)
+    {
+        animation->BenchmarkSampling(iterations, 15);
+    }
+    return 0;
+}
+RegFunc2(BenchmarkVertexAnimations, void, string, int, IMMEDIATE, DEV_FUNC);
+
+shpvoid BenchmarkWalkerBoundaries(int queryCount)
+{
+    // Each location's general SIF specifies the walker boundaries used there.
+    // Several locations can share a walker boundary, so keep track of which ones were already done.
+    std::string_set_ci benchmarkedTextureNames;
+    for(auto& entry : gLocationManager.GetLocationCodes())
+    {
+        // Load SIFs and textures with manual scope, so each one can be freed as soon as it has been benchmarked.
+        SceneInitFile* sif = gAssetManager.LoadSIF(entry.first, AssetScope::Manual);
+        if(sif == nullptr) { continue; }
+
+        // A SIF can have several general blocks (e.g. for different timeblocks), and each may use a different walker boundary.
+        // Blocks without a condition always apply, and conditional blocks override them.
+        GeneralBlock baseBlock;
+        for(const GeneralBlock& block : sif->GetGeneralBlocks())
+        {
+            if(block.condition == nullptr)
+            {
+                baseBlock.TakeOverridesFrom(block);
+            }
+        }
+        for(const GeneralBlock& block : sif->GetGeneralBlocks())
+        {
+            GeneralBlock general = baseBlock;
+            general.TakeOverridesFrom(block);
+            if(general.walkerBoundaryTextureName.empty()) { continue; }
+            if(!benchmarkedTextureNames.insert(general.walkerBoundaryTextureName).second) { continue; }
+
+            Texture* texture = gAssetManager.LoadTexture(general.walkerBoundaryTextureName, AssetScope::Manual);
+            if(texture == nullptr) { continue; }
+            {
+                WalkerBoundary walkerBoundary;
+                walkerBoundary.SetTexture(texture);
+                walkerBoundary.SetSize(general.walkerBoundarySize);
+                walkerBoundary.SetOffset(general.walkerBoundaryOffset);
+                walkerBoundary.BenchmarkPathfinding(queryCount);
+            }
+            delete texture;
+        }
+        delete sif;
+    }
+    return 0;
+}
+RegFunc1(BenchmarkWalkerBoundaries, void, int, IMMEDIATE, DEV_FUNC);
\ No newline at end of file
@@ -24,6 +24,11 @@ shpvoid DumpUsedFiles();
 shpvoid DumpLayerStack(); // DEV
 shpvoid DumpBuildInfo(); // DEV
 
+shpvoid BenchmarkBSPRaycasts(int rayCount); // DEV
+shpvoid BenchmarkSheep(const std::string& sheepName, int iterations); // DEV
+shpvoid BenchmarkVertexAnimations(const std::string& animName, int iterations); // DEV
+shpvoid BenchmarkWalkerBoundaries(int queryCount); // DEV
+
 shpvoid ReportMemoryUsage();
 shpvoid ReportSurfaceMemoryUsage();
 
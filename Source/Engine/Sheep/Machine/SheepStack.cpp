@@ -37,6 +37,7 @@ void SheepStack::PushStringOffset(int val)
 
     mStack[mStackSize - 1].type = SheepValueType::String;
     mStack[mStackSize - 1].intValue = val;
+    mStack[mStackSize - 1].stringRef = nullptr;
 
     #ifdef SHEEP_DEBUG
     std::cout << "SHEEP STACK: Push 1 (Stack Size = " << mStackSize << ")" << std::endl;
@@ -50,6 +51,33 @@ void SheepStack::PushString(const char* str)
 
     mStack[mStackSize - 1].type = SheepValueType::String;
     mStack[mStackSize - 1].stringValue = str;
+    mStack[mStackSize - 1].stringRef = nullptr;
+
+    #ifdef SHEEP_DEBUG
+    std::cout << "SHEEP STACK: Push 1 (Stack Size = " << mStackSize << ")" << std::endl;
+    #endif
+}
+
+void SheepStack::PushString(const std::string* str)
+{
+    mStackSize++;
+    assert(mStackSize < kMaxStackSize);
+
+    mStack[mStackSize - 1].type = SheepValueType::String;
+    mStack[mStackSize - 1].stringValue = str->c_str();
+    mStack[mStackSize - 1].stringRef = str;
+
+    #ifdef SHEEP_DEBUG
+    std::cout << "SHEEP STACK: Push 1 (Stack Size = " << mStackSize << ")" << std::endl;
+    #endif
+}
+
+void SheepStack::Push(const SheepValue& value)
+{
+    mStackSize++;
+    assert(mStackSize < kMaxStackSize);
+
+    mStack[mStackSize - 1] = value;
 
     #ifdef SHEEP_DEBUG
     std::cout << "SHEEP STACK: Push 1 (Stack Size = " << mStackSize << ")" << std::endl;
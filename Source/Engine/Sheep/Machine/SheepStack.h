@@ -15,6 +15,8 @@ public:
     void PushFloat(float val);
     void PushStringOffset(int val);
     void PushString(const char* str);
+    void PushString(const std::string* str);
+    void Push(const SheepValue& value);
 
     SheepValue& Peek() { assert(mStackSize > 0); return mStack[mStackSize - 1]; }
     SheepValue& Peek(int index) { assert(mStackSize > 0 && index < mStackSize); return mStack[mStackSize - 1 - index]; }
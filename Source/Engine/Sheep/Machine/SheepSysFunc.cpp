@@ -29,6 +29,16 @@ size_t CalcHashForSysFunc(const SysFuncImport& sysImport)
     return res;
 }
 
+namespace
+{
+    template<typename FuncPtr>
+    SysFuncPtr FindSysFuncPtr(const std::map<std::string, FuncPtr>& map, const std::string& name)
+    {
+        auto it = map.find(name);
+        return it != map.end() ? reinterpret_cast<SysFuncPtr>(it->second) : nullptr;
+    }
+}
+
 void AddSysFunc(const std::string& name, char retType, std::initializer_list<char> argTypes, bool waitable, bool dev)
 {
     SysFunc sysFunc;
@@ -41,7 +51,40 @@ void AddSysFunc(const std::string& name, char retType, std::initializer_list<cha
     sysFunc.waitable = waitable;
     sysFunc.devOnly = dev;
 
+    // The registration macros add the function to the map for its argument count before calling this.
+    // Save the function pointer, so calls can skip the map lookup.
     SysFuncs& sysFuncs = GetSysFuncs();
+    switch(sysFunc.argumentTypes.size())
+    {
+    case 0:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map0, name);
+        break;
+    case 1:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map1, name);
+        break;
+    case 2:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map2, name);
+        break;
+    case 3:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map3, name);
+        break;
+    case 4:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map4, name);
+        break;
+    case 5:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map5, name);
+        break;
+    case 6:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map6, name);
+        break;
+    case 7:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map7, name);
+        break;
+    case 8:
+        sysFunc.function = FindSysFuncPtr(sysFuncs.map8, name);
+        break;
+    }
+
     sysFuncs.sysFuncs.push_back(sysFunc);
 
     // Store a mapping from name and hash to index in the vector of system functions.
@@ -177,6 +220,43 @@ Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, con
     }
 }
 
+Value CallSysFunc(const SysFunc& sysFunc, const Value* args)
+{
+    if(sysFunc.function == nullptr)
+    {
+        std::cout << "Couldn't find SysFunc" << sysFunc.argumentTypes.size() << " " << sysFunc.name << std::endl;
+        return Value(0);
+    }
+
+    // Cast the function pointer back to its actual type, based on argument count.
+    // Note that zero-arg functions take a dummy argument (see RegFunc0).
+    typedef const Value& V;
+    switch(sysFunc.argumentTypes.size())
+    {
+    case 0:
+        return reinterpret_cast<Value(*)(V)>(sysFunc.function)(0);
+    case 1:
+        return reinterpret_cast<Value(*)(V)>(sysFunc.function)(args[0]);
+    case 2:
+        return reinterpret_cast<Value(*)(V, V)>(sysFunc.function)(args[0], args[1]);
+    case 3:
+        return reinterpret_cast<Value(*)(V, V, V)>(sysFunc.function)(args[0], args[1], args[2]);
+    case 4:
+        return reinterpret_cast<Value(*)(V, V, V, V)>(sysFunc.function)(args[0], args[1], args[2], args[3]);
+    case 5:
+        return reinterpret_cast<Value(*)(V, V, V, V, V)>(sysFunc.function)(args[0], args[1], args[2], args[3], args[4]);
+    case 6:
+        return reinterpret_cast<Value(*)(V, V, V, V, V, V)>(sysFunc.function)(args[0], args[1], args[2], args[3], args[4], args[5]);
+    case 7:
+        return reinterpret_cast<Value(*)(V, V, V, V, V, V, V)>(sysFunc.function)(args[0], args[1], args[2], args[3], args[4], args[5], args[6]);
+    case 8:
+        return reinterpret_cast<Value(*)(V, V, V, V, V, V, V, V)>(sysFunc.function)(args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7]);
+    default:
+        std::cout << "SheepVM: Unimplemented arg count: " << sysFunc.argumentTypes.size() << std::endl;
+        return Value(0);
+    }
+}
+
 void ExecError()
 {
     gSheepManager.FlagExecutionError();
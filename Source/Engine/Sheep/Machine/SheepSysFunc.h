@@ -30,6 +30,13 @@ struct SysFuncImport
     std::vector<char> argumentTypes;
 };
 
+// A pointer to a SysFunc's generic function, cast to a common type so it can be stored regardless of argument count.
+// Must be cast back to the signature matching the argument count before calling (see SysFuncs maps).
+typedef void (*SysFuncPtr)();
+
+// Max number of arguments a SysFunc can take.
+const int kMaxSysFuncArgs = 8;
+
 // "Full" info about a SysFunc.
 // Contains extra metadata that doesn't need to be stored in a compiled SheepScript, but is useful at runtime.
 struct SysFunc : public SysFuncImport
@@ -41,6 +48,9 @@ struct SysFunc : public SysFuncImport
     // If true, this function can only work in dev builds.
     bool devOnly = false;
 
+    // The generic function to call, so calls don't need to look up the function by name.
+    SysFuncPtr function = nullptr;
+
     // Text that's output to explain this function when using HelpCommand.
     //std::string helpText;
 
@@ -95,6 +105,9 @@ Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, con
 Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3, const Value& x4, const Value& x5);
 Value CallSysFunc(const std::string& name, const Value& x1, const Value& x2, const Value& x3, const Value& x4, const Value& x5, const Value& x6);
 
+// Calls a SysFunc directly, with no lookup. Args must contain one value per argument, already of the expected types.
+Value CallSysFunc(const SysFunc& sysFunc, const Value* args);
+
 // Flags execution error in a SysFunc.
 void ExecError();
 
@@ -1,8 +1,8 @@
 #include "SheepVM.h"
 
 #include <iostream>
+#include <new>
 
-#include "BinaryReader.h"
 #include "GMath.h"
 #include "ReportManager.h"
 #include "SheepScript.h"
@@ -105,46 +105,22 @@ SheepThreadId SheepVM::Execute(SheepScript* script, const std::string& functionN
 
 bool SheepVM::Evaluate(SheepScript* script, int n, int v)
 {
-    // Get an execution context.
-    SheepInstance* instance = GetInstance(script);
-
-    // For NVC evaluation logic, scripts can use built-in variables $n and $v.
-    // These variables refer to whatever the current noun and current verb are, using an int identifier.
-    // Pass these values in, but only if the context can support them.
-    if(instance->mVariables.size() > 0 && instance->mVariables[0].type == SheepValueType::Int)
+    // Most evaluations are simple expressions that can't block or yield - they always run to completion right away.
+    // These can skip the thread/instance bookkeeping of normal execution and run on a dedicated evaluation thread instead.
+    // The evaluation thread may already be in use if a SysFunc called during evaluation triggers another evaluation - use the normal path then.
+    if(script != nullptr && !script->CanYield() && !mEvalThread.mRunning)
     {
-        instance->mVariables[0].intValue = n;
-    }
-    if(instance->mVariables.size() > 1 && instance->mVariables[1].type == SheepValueType::Int)
-    {
-        instance->mVariables[1].intValue = v;
+        return EvaluateImmediate(script, n, v);
     }
 
+    // Get an execution context.
+    SheepInstance* instance = GetInstance(script);
+    SetEvaluationVariables(instance, n, v);
+
     //std::cout << "SHEEP EVALUATE START - Stack size is " << mStackSize << std::endl;
     // Execute the script, per usual.
     SheepThread* thread = StartExecution(instance, 0, "X$", nullptr, "");
-
-    // If stack is empty, return false.
-    if(thread->mStack.Size() == 0) { return false; }
-
-    // Check the top item on the stack and return true or false based on that.
-    SheepValue& result = thread->mStack.Pop();
-    if(result.type == SheepValueType::Int)
-    {
-        return result.intValue != 0;
-    }
-    else if(result.type == SheepValueType::Float)
-    {
-        return !Math::AreEqual(result.floatValue, 0.0f);
-    }
-    else if(result.type == SheepValueType::String)
-    {
-        std::string str(result.stringValue);
-        return !str.empty();
-    }
-
-    // Default to false.
-    return false;
+    return GetEvaluationResult(thread);
 }
 
 void SheepVM::StopExecution(const std::string& tag)
@@ -248,6 +224,9 @@ SheepInstance* SheepVM::GetInstance(SheepScript* script)
     // Create NEW variables for assignment during execution.
     // This is VERY important so the SheepScript has correct vars with correct initial values.
     context->mVariables = script->GetVariables();
+
+    // Strings returned during the instance's previous use are no longer referenced.
+    context->mReturnedStrings.clear();
     return context;
 }
 
@@ -301,11 +280,10 @@ NotifyLink* SheepVM::GetNotifyLink()
     return toUse;
 }
 
-Value SheepVM::CallSysFunc(SheepThread* thread, SysFuncImport* sysImport)
+Value SheepVM::CallSysFunc(SheepThread* thread, SysFuncImport* sysImport, SysFunc* sysFunc)
 {
-    // Retrieve system function declaration for the system function import.
+    // The system function declaration for the import was resolved when the script loaded.
     // We need the full declaration to know whether this is a waitable function!
-    SysFunc* sysFunc = GetSysFunc(sysImport);
     if(sysFunc == nullptr)
     {
         std::cout << "Sheep uses undeclared function " << sysImport->name << std::endl;
@@ -316,9 +294,17 @@ Value SheepVM::CallSysFunc(SheepThread* thread, SysFuncImport* sysImport)
     // Make sure it matches the argument count from the system function declaration.
     int argCount = thread->mStack.Pop().intValue;
     assert(argCount == sysFunc->argumentTypes.size());
+    if(argCount > kMaxSysFuncArgs)
+    {
+        std::cout << "SheepVM: Unimplemented arg count: " << argCount << std::endl;
+        thread->mStack.Pop(argCount);
+        return Value(0);
+    }
 
     // Retrieve the arguments, of the expected types, from the stack.
-    std::vector<Value> args;
+    // Args are constructed in a fixed-size buffer on the stack, rather than a heap-allocated vector.
+    alignas(Value) unsigned char argStorage[kMaxSysFuncArgs * sizeof(Value)];
+    Value* args = reinterpret_cast<Value*>(argStorage);
     for(int i = 0; i < argCount; i++)
     {
         SheepValue& sheepValue = thread->mStack.Peek(argCount - 1 - i);
@@ -326,16 +312,25 @@ Value SheepVM::CallSysFunc(SheepThread* thread, SysFuncImport* sysImport)
         switch(argType)
         {
         case 1:
-            args.push_back(sheepValue.GetInt());
+            new(&args[i]) Value(sheepValue.GetInt());
             break;
         case 2:
-            args.push_back(sheepValue.GetFloat());
+            new(&args[i]) Value(sheepValue.GetFloat());
             break;
         case 3:
-            args.push_back(sheepValue.GetString());
+            // Interned strings are passed by reference; only other values need to be converted to a new string.
+            if(sheepValue.type == SheepValueType::String && sheepValue.stringRef != nullptr)
+            {
+                new(&args[i]) Value(*sheepValue.stringRef, ValueRef());
+            }
+            else
+            {
+                new(&args[i]) Value(sheepValue.GetString());
+            }
             break;
         default:
             std::cout << "Invalid arg type: " << argType << std::endl;
+            new(&args[i]) Value(0);
             break;
         }
     }
@@ -369,34 +364,11 @@ Value SheepVM::CallSysFunc(SheepThread* thread, SysFuncImport* sysImport)
     }
     #endif
 
-    // Based on argument count, call the appropriate function variant.
-    Value v = Value(0);
-    switch(argCount)
+    // Call the function directly through its resolved pointer.
+    Value v = ::CallSysFunc(*sysFunc, args);
+    for(int i = 0; i < argCount; i++)
     {
-    case 0:
-        v = ::CallSysFunc(sysFunc->name);
-        break;
-    case 1:
-        v = ::CallSysFunc(sysFunc->name, args[0]);
-        break;
-    case 2:
-        v = ::CallSysFunc(sysFunc->name, args[0], args[1]);
-        break;
-    case 3:
-        v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2]);
-        break;
-    case 4:
-        v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2], args[3]);
-        break;
-    case 5:
-        v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2], args[3], args[4]);
-        break;
-    case 6:
-        v = ::CallSysFunc(sysFunc->name, args[0], args[1], args[2], args[3], args[4], args[5]);
-        break;
-    default:
-        std::cout << "SheepVM: Unimplemented arg count: " << argCount << std::endl;
-        break;
+        args[i].~Value();
     }
 
     // Output a general execution exception if we encountered a problem in the sys func call.
@@ -410,6 +382,75 @@ Value SheepVM::CallSysFunc(SheepThread* thread, SysFuncImport* sysImport)
     return v;
 }
 
+bool SheepVM::EvaluateImmediate(SheepScript* script, int n, int v)
+{
+    // Set up the evaluation instance with fresh variables.
+    // Assigning reuses the vector's memory, so this doesn't allocate after the first few evaluations.
+    mEvalInstance.mSheepScript = script;
+    mEvalInstance.mVariables = script->GetVariables();
+    mEvalInstance.mReturnedStrings.clear();
+    SetEvaluationVariables(&mEvalInstance, n, v);
+
+    // Set up the evaluation thread to run from the start of the script.
+    mEvalThread.mVirtualMachine = this;
+    mEvalThread.mContext = &mEvalInstance;
+    mEvalThread.mStack.Clear();
+    mEvalThread.mCodeOffset = 0;
+    mEvalThread.mFunctionName = "X$";
+    mEvalThread.mRunning = true;
+
+    // Execute with the evaluation thread as the current thread, so SysFuncs that query the current thread still work.
+    SheepThread* prevThread = mCurrentThread;
+    mCurrentThread = &mEvalThread;
+    ExecuteInstructions(&mEvalThread);
+    mCurrentThread = prevThread;
+
+    // The script can't yield, so it must be done running by now.
+    mEvalThread.mRunning = false;
+    return GetEvaluationResult(&mEvalThread);
+}
+
+void SheepVM::SetEvaluationVariables(SheepInstance* instance, int n, int v)
+{
+    if(instance == nullptr) { return; }
+
+    // For NVC evaluation logic, scripts can use built-in variables $n and $v.
+    // These variables refer to whatever the current noun and current verb are, using an int identifier.
+    // Pass these values in, but only if the context can support them.
+    if(instance->mVariables.size() > 0 && instance->mVariables[0].type == SheepValueType::Int)
+    {
+        instance->mVariables[0].intValue = n;
+    }
+    if(instance->mVariables.size() > 1 && instance->mVariables[1].type == SheepValueType::Int)
+    {
+        instance->mVariables[1].intValue = v;
+    }
+}
+
+bool SheepVM::GetEvaluationResult(SheepThread* thread)
+{
+    // If stack is empty, return false.
+    if(thread == nullptr || thread->mStack.Size() == 0) { return false; }
+
+    // Check the top item on the stack and return true or false based on that.
+    SheepValue& result = thread->mStack.Pop();
+    if(result.type == SheepValueType::Int)
+    {
+        return result.intValue != 0;
+    }
+    else if(result.type == SheepValueType::Float)
+    {
+        return !Math::AreEqual(result.floatValue, 0.0f);
+    }
+    else if(result.type == SheepValueType::String)
+    {
+        return result.stringValue != nullptr && result.stringValue[0] != '\0';
+    }
+
+    // Default to false.
+    return false;
+}
+
 SheepThread* SheepVM::StartExecution(SheepInstance* instance, int bytecodeOffset, const std::string& functionName, std::function<void()> finishCallback, const std::string& tag)
 {
     // A valid execution context is required.
@@ -466,33 +507,66 @@ void SheepVM::ContinueExecution(SheepThread* thread)
         gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " released at line -1");
     }
 
+    // Run until the thread finishes or blocks.
+    ExecuteInstructions(thread);
+
+    // If thread is no longer running, notify anyone who was waiting for the thread to finish.
+    // If we get here and the thread IS running, it means the thread was blocked due to a wait!
+    if(!thread->mRunning)
+    {
+        gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " is exiting");
+
+        // Thread is no longer using execution context.
+        thread->mContext->mReferenceCount--;
+
+        // Call my wait callback - someone might have been waiting for this thread to finish.
+        if(thread->mWaitCallback)
+        {
+            thread->mWaitCallback();
+        }
+    }
+    else if(thread->mInWaitBlock)
+    {
+        gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " is blocked at line -1");
+    }
+    else
+    {
+        gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " is in some weird unexpected state!");
+    }
+
+    // Restore previously executing thread.
+    mCurrentThread = prevThread;
+}
+
+void SheepVM::ExecuteInstructions(SheepThread* thread)
+{
     // Get instance/script we'll be using.
     SheepInstance* instance = thread->mContext;
     SheepScript* script = instance->mSheepScript;
 
-    // Get bytecode and generate a binary reader for easier parsing.
-    char* bytecode = script->GetBytecode();
-    int bytecodeLength = script->GetBytecodeLength();
+    // Get the script's instructions, which were decoded from bytecode when the script was loaded.
+    const DecodedSheepInstruction* instructions = script->GetInstructions();
+    int instructionCount = script->GetInstructionCount();
 
-    // Create reader for the bytecode.
-    BinaryReader reader(bytecode, bytecodeLength);
-    if(!reader.OK()) { return; }
+    // Start at the instruction at the desired bytecode offset.
+    int instructionIndex = script->GetInstructionIndex(thread->mCodeOffset);
 
-    // Skip ahead to desired offset.
-    reader.Skip(thread->mCodeOffset);
-
-    // Read each byte in turn, interpret and execute the instruction.
+    // Execute each instruction in turn.
     bool stopReading = false;
+    bool reachedEnd = false;
     while(!stopReading)
     {
-        // Read instruction.
-        char instruction = reader.ReadByte();
-
-        // Break when read instruction fails (perhaps due to reading past end of file/mem stream).
-        if(!reader.OK()) { break; }
+        // Stop when we run out of instructions.
+        if(instructionIndex >= instructionCount)
+        {
+            reachedEnd = true;
+            break;
+        }
+        const DecodedSheepInstruction& instruction = instructions[instructionIndex];
+        ++instructionIndex;
 
         // Perform the action associated with each instruction.
-        switch((SheepInstruction)instruction)
+        switch(instruction.instruction)
         {
             case SheepInstruction::SitnSpin:
             {
@@ -514,7 +588,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::CallSysFunctionV:
             {
-                int functionIndex = reader.ReadInt();
+                int functionIndex = instruction.intOperand;
                 SysFuncImport* sysFunc = script->GetSysImport(functionIndex);
                 if(sysFunc == nullptr)
                 {
@@ -527,7 +601,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 #endif
 
                 // Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                Value value = CallSysFunc(thread, sysFunc, script->GetSysFunc(functionIndex));
 
                 // Though this is void return, we still push type of "shpvoid" onto stack.
                 // The compiler generates an extra "Pop" instruction after a CallSysFunctionV.
@@ -537,7 +611,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::CallSysFunctionI:
             {
-                int functionIndex = reader.ReadInt();
+                int functionIndex = instruction.intOperand;
                 SysFuncImport* sysFunc = script->GetSysImport(functionIndex);
                 if(sysFunc == nullptr)
                 {
@@ -550,7 +624,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 #endif
 
                 // Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                Value value = CallSysFunc(thread, sysFunc, script->GetSysFunc(functionIndex));
 
                 // Push the int result onto the stack.
                 thread->mStack.PushInt(value.To<int>());
@@ -558,7 +632,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::CallSysFunctionF:
             {
-                int functionIndex = reader.ReadInt();
+                int functionIndex = instruction.intOperand;
                 SysFuncImport* sysFunc = script->GetSysImport(functionIndex);
                 if(sysFunc == nullptr)
                 {
@@ -571,7 +645,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 #endif
 
                 // Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                Value value = CallSysFunc(thread, sysFunc, script->GetSysFunc(functionIndex));
 
                 // Push the float result onto the stack.
                 thread->mStack.PushFloat(value.To<float>());
@@ -579,7 +653,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::CallSysFunctionS:
             {
-                int functionIndex = reader.ReadInt();
+                int functionIndex = instruction.intOperand;
                 SysFuncImport* sysFunc = script->GetSysImport(functionIndex);
                 if(sysFunc == nullptr)
                 {
@@ -592,10 +666,19 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 #endif
 
                 // Execute the system function.
-                Value value = CallSysFunc(thread, sysFunc);
+                Value value = CallSysFunc(thread, sysFunc, script->GetSysFunc(functionIndex));
 
                 // Push the string result onto the stack.
-                thread->mStack.PushString(value.To<std::string>().c_str()); //TODO: Seems like this could cause problems? Where is value's string coming from? What if it is deallocated???
+                // The result is interned, since the returned value is deallocated after this, but the string may be used for some time.
+                // The executing instance owns the interned string, so it lives as long as any stack or variable that could use it.
+                const std::string& result = value.To<std::string>();
+                std::unordered_set<std::string>& returnedStrings = thread->mContext->mReturnedStrings;
+                auto it = returnedStrings.find(result);
+                if(it == returnedStrings.end())
+                {
+                    it = returnedStrings.insert(result).first;
+                }
+                thread->mStack.PushString(&(*it));
                 break;
             }
             case SheepInstruction::Branch:
@@ -603,8 +686,8 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 #ifdef SHEEP_DEBUG
                 std::cout << "Branch" << std::endl;
                 #endif
-                int branchAddress = reader.ReadInt();
-                reader.Seek(branchAddress);
+                int branchIndex = instruction.intOperand;
+                instructionIndex = branchIndex;
                 break;
             }
             case SheepInstruction::BranchGoto:
@@ -612,15 +695,15 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 #ifdef SHEEP_DEBUG
                 std::cout << "BranchGoto" << std::endl;
                 #endif
-                int branchAddress = reader.ReadInt();
-                reader.Seek(branchAddress);
+                int branchIndex = instruction.intOperand;
+                instructionIndex = branchIndex;
                 break;
             }
             case SheepInstruction::BranchIfZero:
             {
                 // Regardless of whether we do branch, we need to pull
-                // the branch address from the reader.
-                int branchAddress = reader.ReadInt();
+                // the branch target from the instruction.
+                int branchIndex = instruction.intOperand;
 
                 #ifdef SHEEP_DEBUG
                 std::cout << "BranchIfZero" << std::endl;
@@ -631,7 +714,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                 SheepValue& result = thread->mStack.Pop();
                 if(result.intValue == 0)
                 {
-                    reader.Seek(branchAddress);
+                    instructionIndex = branchIndex;
                 }
                 break;
             }
@@ -674,7 +757,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::StoreI:
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = instruction.intOperand;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
                     #ifdef SHEEP_DEBUG
@@ -689,7 +772,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::StoreF:
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = instruction.intOperand;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
                     #ifdef SHEEP_DEBUG
@@ -704,7 +787,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::StoreS:
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = instruction.intOperand;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
                     #ifdef SHEEP_DEBUG
@@ -714,12 +797,13 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                     assert(instance->mVariables[varIndex].type == SheepValueType::String);
                     SheepValue& value = thread->mStack.Pop();
                     instance->mVariables[varIndex].stringValue = value.stringValue;
+                    instance->mVariables[varIndex].stringRef = value.stringRef;
                 }
                 break;
             }
             case SheepInstruction::LoadI:
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = instruction.intOperand;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
                     #ifdef SHEEP_DEBUG
@@ -733,7 +817,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::LoadF:
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = instruction.intOperand;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
                     #ifdef SHEEP_DEBUG
@@ -747,7 +831,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::LoadS:
             {
-                int varIndex = reader.ReadInt();
+                int varIndex = instruction.intOperand;
                 if(varIndex >= 0 && varIndex < instance->mVariables.size())
                 {
                     #ifdef SHEEP_DEBUG
@@ -755,13 +839,13 @@ void SheepVM::ContinueExecution(SheepThread* thread)
                     #endif
 
                     assert(instance->mVariables[varIndex].type == SheepValueType::String);
-                    thread->mStack.PushString(instance->mVariables[varIndex].stringValue);
+                    thread->mStack.Push(instance->mVariables[varIndex]);
                 }
                 break;
             }
             case SheepInstruction::PushI:
             {
-                int int1 = reader.ReadInt();
+                int int1 = instruction.intOperand;
                 #ifdef SHEEP_DEBUG
                 std::cout << "PushI " << int1 << std::endl;
                 #endif
@@ -770,7 +854,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::PushF:
             {
-                float float1 = reader.ReadFloat();
+                float float1 = instruction.floatOperand;
                 #ifdef SHEEP_DEBUG
                 std::cout << "PushF " << float1 << std::endl;
                 #endif
@@ -779,20 +863,21 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::PushS:
             {
-                int stringConstOffset = reader.ReadInt();
+                // Operand was converted from a string const offset to a strings table index at load time.
+                int stringIndex = instruction.intOperand;
                 #ifdef SHEEP_DEBUG
-                std::cout << "PushS " << stringConstOffset << std::endl;
+                std::cout << "PushS " << stringIndex << std::endl;
                 #endif
-                thread->mStack.PushStringOffset(stringConstOffset);
+                thread->mStack.PushStringOffset(stringIndex);
                 break;
             }
             case SheepInstruction::GetString:
             {
-                SheepValue& offsetValue = thread->mStack.Pop();
-                std::string* stringPtr = script->GetStringConst(offsetValue.intValue);
+                SheepValue& indexValue = thread->mStack.Pop();
+                const std::string* stringPtr = script->GetString(indexValue.intValue);
                 if(stringPtr != nullptr)
                 {
-                    thread->mStack.PushString(stringPtr->c_str());
+                    thread->mStack.PushString(stringPtr);
                 }
                 #ifdef SHEEP_DEBUG
                 std::cout << "GetString " << thread->mStack.Peek().stringValue << std::endl;
@@ -1107,7 +1192,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::IToF:
             {
-                int index = reader.ReadInt();
+                int index = instruction.intOperand;
                 SheepValue& value = thread->mStack.Peek(index);
 
                 #ifdef SHEEP_DEBUG
@@ -1119,7 +1204,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             case SheepInstruction::FToI:
             {
-                int index = reader.ReadInt();
+                int index = instruction.intOperand;
                 SheepValue& value = thread->mStack.Peek(index);
 
                 #ifdef SHEEP_DEBUG
@@ -1189,7 +1274,7 @@ void SheepVM::ContinueExecution(SheepThread* thread)
             }
             default:
             {
-                std::cout << "Unaccounted for Sheep Instruction: " << (int)instruction << std::endl;
+                std::cout << "Unaccounted for Sheep Instruction: " << (int)instruction.instruction << std::endl;
                 break;
             }
         }
@@ -1202,38 +1287,11 @@ void SheepVM::ContinueExecution(SheepThread* thread)
     }
 
     // Update thread's code offset value.
-    thread->mCodeOffset = reader.GetPosition();
+    thread->mCodeOffset = script->GetBytecodeOffset(instructionIndex);
 
-    // If reached end of file, assume the thread is no longer running.
-    if(!reader.OK())
+    // If reached end of the code, assume the thread is no longer running.
+    if(reachedEnd)
     {
         thread->mRunning = false;
     }
-
-    // If thread is no longer running, notify anyone who was waiting for the thread to finish.
-    // If we get here and the thread IS running, it means the thread was blocked due to a wait!
-    if(!thread->mRunning)
-    {
-        gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " is exiting");
-
-        // Thread is no longer using execution context.
-        thread->mContext->mReferenceCount--;
-
-        // Call my wait callback - someone might have been waiting for this thread to finish.
-        if(thread->mWaitCallback)
-        {
-            thread->mWaitCallback();
-        }
-    }
-    else if(thread->mInWaitBlock)
-    {
-        gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " is blocked at line -1");
-    }
-    else
-    {
-        gReportManager.Log("SheepMachine", "Sheep " + thread->GetName() + " is in some weird unexpected state!");
-    }
-
-    // Restore previously executing thread.
-    mCurrentThread = prevThread;
 }
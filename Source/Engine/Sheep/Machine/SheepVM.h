@@ -6,6 +6,7 @@
 #pragma once
 #include <functional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <iostream>
 
@@ -15,6 +16,7 @@
 #include "Value.h"
 
 class SheepScript;
+struct SysFunc;
 struct SysFuncImport;
 
 // GK3 calls these "Object Code" instances.
@@ -28,6 +30,11 @@ struct SheepInstance
     // These'll likely be modified during execution.
     std::vector<SheepValue> mVariables;
 
+    // Strings returned by SysFuncs, interned so they stay valid while on the stack or stored in variables.
+    // Set elements are never moved, so pointers to them remain valid.
+    // Anything using these strings belongs to this instance, so they're cleared when the instance is reused.
+    std::unordered_set<std::string> mReturnedStrings;
+
     // For debugging, the last time this object was in use during a sheep thread execution.
     uint32_t mLastUsedTimeMs = 0;
 
@@ -116,6 +123,48 @@ enum class SheepInstruction
     DebugBreakpoint     = 0x34
 };
 
+// In bytecode, some instructions are followed by a 4-byte (int or float) operand.
+inline bool SheepInstructionHasOperand(SheepInstruction instruction)
+{
+    switch(instruction)
+    {
+    case SheepInstruction::CallSysFunctionV:
+    case SheepInstruction::CallSysFunctionI:
+    case SheepInstruction::CallSysFunctionF:
+    case SheepInstruction::CallSysFunctionS:
+    case SheepInstruction::Branch:
+    case SheepInstruction::BranchGoto:
+    case SheepInstruction::BranchIfZero:
+    case SheepInstruction::StoreI:
+    case SheepInstruction::StoreF:
+    case SheepInstruction::StoreS:
+    case SheepInstruction::LoadI:
+    case SheepInstruction::LoadF:
+    case SheepInstruction::LoadS:
+    case SheepInstruction::PushI:
+    case SheepInstruction::PushF:
+    case SheepInstruction::PushS:
+    case SheepInstruction::IToF:
+    case SheepInstruction::FToI:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// An instruction decoded from bytecode ahead of time, so the VM doesn't need to parse bytecode as it executes.
+// For branch instructions, the operand is converted from a bytecode offset to an index in the decoded instruction array.
+// For PushS, the operand is converted from a string const offset to an index in the script's strings table.
+struct DecodedSheepInstruction
+{
+    SheepInstruction instruction = SheepInstruction::SitnSpin;
+    union
+    {
+        int intOperand = 0;
+        float floatOperand;
+    };
+};
+
 class SheepVM
 {
     friend struct SheepThread;
@@ -156,12 +205,21 @@ private:
     // If true, the current Sheep thread has encountered an execution error.
     bool mExecutionError = false;
 
+    // A thread and instance reserved for evaluating scripts that can't yield.
+    SheepThread mEvalThread;
+    SheepInstance mEvalInstance;
+
     SheepInstance* GetInstance(SheepScript* script);
     SheepThread* GetIdleThread();
     NotifyLink* GetNotifyLink();
 
-    Value CallSysFunc(SheepThread* thread, SysFuncImport* sysImport);
+    Value CallSysFunc(SheepThread* thread, SysFuncImport* sysImport, SysFunc* sysFunc);
+
+    bool EvaluateImmediate(SheepScript* script, int n, int v);
+    void SetEvaluationVariables(SheepInstance* instance, int n, int v);
+    bool GetEvaluationResult(SheepThread* thread);
 
     SheepThread* StartExecution(SheepInstance* instance, int bytecodeOffset, const std::string& functionName, std::function<void()> finishCallback, const std::string& tag);
     void ContinueExecution(SheepThread* thread);
+    void ExecuteInstructions(SheepThread* thread);
 };
@@ -24,6 +24,10 @@ struct SheepValue
         const char* stringValue;
     };
 
+    // For strings, the interned std::string that stringValue points into (or null if not interned).
+    // Allows passing the string to SysFuncs without copying it.
+    const std::string* stringRef = nullptr;
+
     SheepValue() { intValue = 0; }
     explicit SheepValue(SheepValueType t) { type = t; intValue = 0; }
     explicit SheepValue(int i) { type = SheepValueType::Int; intValue = i; }
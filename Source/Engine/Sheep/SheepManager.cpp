@@ -5,6 +5,14 @@
 
 SheepManager gSheepManager;
 
+SheepManager::~SheepManager()
+{
+    for(auto& entry : mCompiledScripts)
+    {
+        delete entry.second;
+    }
+}
+
 SheepScript* SheepManager::Compile(const char* filePath)
 {
     SheepCompiler compiler;
@@ -23,6 +31,31 @@ SheepScript* SheepManager::Compile(const std::string& name, std::istream& stream
     return compiler.CompileToAsset(name, stream);
 }
 
+SheepScript* SheepManager::CompileCached(const std::string& name, const std::string& sheep)
+{
+    // If this sheep was already compiled, return the existing script.
+    {
+        std::lock_guard<std::mutex> lock(mCompiledScriptsMutex);
+        auto it = mCompiledScripts.find(sheep);
+        if(it != mCompiledScripts.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Compile outside the lock, so other threads can use the cache in the meantime.
+    SheepScript* script = Compile(name, sheep);
+
+    // Another thread may have compiled the same sheep in the meantime. If so, use that one, so everyone shares the same script.
+    std::lock_guard<std::mutex> lock(mCompiledScriptsMutex);
+    auto result = mCompiledScripts.insert(std::make_pair(sheep, script));
+    if(!result.second)
+    {
+        delete script;
+    }
+    return result.first->second;
+}
+
 SheepThreadId SheepManager::Execute(SheepScript* script, std::function<void()> finishCallback, const std::string& tag)
 {
     // If no tag is provided, fall back on using the current layer's name.
@@ -47,9 +80,7 @@ SheepScript* SheepManager::CompileEval(const std::string& sheep)
     // The passed in Sheep is the body of function X$
     const char* kEvalHusk = "symbols { int n$ = 0; int v$ = 0; } code { X$() %s }";
     std::string fullSheep = StringUtil::Format(kEvalHusk, sheep.c_str());
-
-    SheepCompiler compiler;
-    return compiler.CompileToAsset("Case Evaluation", fullSheep);
+    return CompileCached("Case Evaluation", fullSheep);
 }
 
 bool SheepManager::Evaluate(SheepScript* script)
@@ -5,22 +5,34 @@
 // Handles complexities of async callbacks, waiting, multithreading, etc.
 //
 #pragma once
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "SheepCompiler.h"
 #include "SheepVM.h"
 
 class SheepManager
 {
 public:
+    ~SheepManager();
+
     // Compilation - convert text-based SheepScript to a compiled SheepScript.
     SheepScript* Compile(const char* filePath);
     SheepScript* Compile(const std::string& name, const std::string& sheep);
     SheepScript* Compile(const std::string& name, std::istream& stream);
 
+    // Cached compilation - the same sheep text is only ever compiled once, and the same SheepScript is returned each time.
+    // Useful for the many small snippets and conditions in SIF/NVC assets, which are often duplicated and compiled again on each load.
+    // The SheepManager owns cached scripts - do not delete them!
+    SheepScript* CompileCached(const std::string& name, const std::string& sheep);
+
     // Execution - execute a compiled SheepScript.
     SheepThreadId Execute(SheepScript* script, std::function<void()> finishCallback, const std::string& tag = "");
     SheepThreadId Execute(SheepScript* script, const std::string& functionName, std::function<void()> finishCallback, const std::string& tag = "");
 
     // Evaluation - special form of SheepScript; only boolean logic is allowed, must evaluate to true or false. Waiting/callbacks are not allowed.
+    // Eval scripts are cached, same as CompileCached.
     SheepScript* CompileEval(const std::string& sheep);
     bool Evaluate(SheepScript* script);
     bool Evaluate(SheepScript* script, int n, int v);
@@ -37,6 +49,11 @@ public:
 private:
     // Executes binary bytecode sheep scripts.
     SheepVM mVirtualMachine;
+
+    // Compiled scripts, keyed by sheep text. Failed compiles are cached too (as null), so they aren't attempted again.
+    // Assets containing sheep are loaded on background threads, so access to the cache is guarded.
+    std::unordered_map<std::string, SheepScript*> mCompiledScripts;
+    std::mutex mCompiledScriptsMutex;
 };
 
 extern SheepManager gSheepManager;
@@ -1,11 +1,15 @@
 #include "SheepScript.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <fstream>
 
+#include "AssetBuffer.h"
 #include "BinaryReader.h"
 #include "mstream.h"
+#include "Profiler.h"
+#include "ReportManager.h"
 #include "SheepManager.h"
 #include "SheepScriptBuilder.h"
 #include "StringUtil.h"
@@ -15,7 +19,7 @@ TYPEINFO_INIT(SheepScript, Asset, GENERATE_TYPE_ID)
 
 }
 
-/*static*/ bool SheepScript::IsSheepDataCompiled(uint8_t* data, uint32_t dataLength)
+/*static*/ bool SheepScript::IsSheepDataCompiled(const uint8_t* data, uint32_t dataLength)
 {
     // If the first 8 bytes of the data is GK3Sheep, we'll assume this is valid compiled Sheepscript data.
     // Otherwise, it may be a text-based (uncompiled) Sheepscript, or some other data entirely.
@@ -32,18 +36,18 @@ SheepScript::~SheepScript()
     delete[] mBytecode;
 }
 
-void SheepScript::Load(uint8_t* data, uint32_t dataLength)
+void SheepScript::Load(const AssetBuffer& buffer)
 {
     // If the data is already compiled, we can just parse it directly.
-    if(IsSheepDataCompiled(data, dataLength))
+    if(IsSheepDataCompiled(buffer.GetData(), buffer.GetSize()))
     {
-        ParseFromData(data, dataLength);
+        ParseFromData(buffer.GetData(), buffer.GetSize());
         return;
     }
 
     // If the data is in uncompiled text format, we must compile it!
     SheepCompiler compiler;
-    imstream stream(reinterpret_cast<char*>(data), dataLength);
+    imstream stream(reinterpret_cast<const char*>(buffer.GetData()), buffer.GetSize());
     if(compiler.Compile(GetNameNoExtension(), stream))
     {
         Load(compiler.GetCompiledBuilder());
@@ -54,7 +58,10 @@ void SheepScript::Load(const SheepScriptBuilder& builder)
 {
     // Just copy these directly.
     mSysImports = builder.GetSysImports();
-    mStringConsts = builder.GetStringConsts();
+    for(auto& entry : builder.GetStringConsts())
+    {
+        AddStringConst(entry.first, entry.second);
+    }
     mVariables = builder.GetVariables();
     mFunctions = builder.GetFunctions();
 
@@ -62,6 +69,9 @@ void SheepScript::Load(const SheepScriptBuilder& builder)
     mBytecodeLength = builder.GetBytecode().size();
     mBytecode = new char[mBytecodeLength];
     std::copy(builder.GetBytecode().begin(), builder.GetBytecode().end(), mBytecode);
+
+    ResolveSysFuncs();
+    DecodeBytecode();
 }
 
 SysFuncImport* SheepScript::GetSysImport(int index)
@@ -70,16 +80,36 @@ SysFuncImport* SheepScript::GetSysImport(int index)
     return &mSysImports[index];
 }
 
+SysFunc* SheepScript::GetSysFunc(int index) const
+{
+    if(index < 0 || index >= mSysFuncs.size()) { return nullptr; }
+    return mSysFuncs[index];
+}
+
 std::string* SheepScript::GetStringConst(int offset)
 {
-    auto it = mStringConsts.find(offset);
-    if(it != mStringConsts.end())
+    auto it = mStringConstIndexes.find(offset);
+    if(it != mStringConstIndexes.end())
     {
-        return &it->second;
+        return &mStrings[it->second];
     }
     return nullptr;
 }
 
+int SheepScript::GetInstructionIndex(int bytecodeOffset) const
+{
+    // Offsets are sorted, so binary search for the first instruction at or after the offset.
+    auto it = std::lower_bound(mInstructionOffsets.begin(), mInstructionOffsets.end(), bytecodeOffset);
+    return static_cast<int>(it - mInstructionOffsets.begin());
+}
+
+int SheepScript::GetBytecodeOffset(int instructionIndex) const
+{
+    if(instructionIndex < 0) { return 0; }
+    if(instructionIndex >= mInstructionOffsets.size()) { return mBytecodeLength; }
+    return mInstructionOffsets[instructionIndex];
+}
+
 int SheepScript::GetFunctionOffset(const std::string& functionName)
 {
     // Find it and return it, or fail with -1 offset.
@@ -111,7 +141,7 @@ void SheepScript::Dump()
     std::cout << "--------------------------------------------------------------------------" << std::endl;
 }
 
-void SheepScript::ParseFromData(uint8_t* data, uint32_t dataLength)
+void SheepScript::ParseFromData(const uint8_t* data, uint32_t dataLength)
 {
     BinaryReader reader(data, dataLength);
 
@@ -172,6 +202,9 @@ void SheepScript::ParseFromData(uint8_t* data, uint32_t dataLength)
             std::cout << "Unknown component: " << section << std::endl;
         }
     }
+
+    ResolveSysFuncs();
+    DecodeBytecode();
 }
 
 void SheepScript::ParseSysImportsSection(BinaryReader& reader)
@@ -237,7 +270,7 @@ void SheepScript::ParseStringConstsSection(BinaryReader& reader)
             endOffset = dataBaseOffset + contentSize;
         }
         std::string str = reader.ReadString(endOffset - startOffset);
-        mStringConsts[startOffset - dataBaseOffset] = str;
+        AddStringConst(startOffset - dataBaseOffset, str);
     }
 }
 
@@ -903,3 +936,122 @@ void SheepScript::Decompile(const std::string& filePath)
         WriteOut(out, "}", indentLevel);
     }
 }
+
+void SheepScript::AddStringConst(int offset, const std::string& str)
+{
+    // Each offset in the string consts section is a different string, so each gets its own entry in the strings table.
+    mStringConstIndexes[offset] = static_cast<int>(mStrings.size());
+    mStrings.push_back(str);
+}
+
+void SheepScript::ResolveSysFuncs()
+{
+    mSysFuncs.clear();
+    mSysFuncs.reserve(mSysImports.size());
+    for(SysFuncImport& sysImport : mSysImports)
+    {
+        mSysFuncs.push_back(::GetSysFunc(&sysImport));
+    }
+}
+
+void SheepScript::BenchmarkDecoding(int iterations) const
+{
+    if(iterations <= 0) { return; }
+
+    // Decode into separate buffers, so this can't disturb the script if it's running.
+    std::vector<DecodedSheepInstruction> instructions;
+    std::vector<int> instructionOffsets;
+    Stopwatch stopwatch;
+    for(int i = 0; i < iterations; ++i)
+    {
+        DecodeBytecode(instructions, instructionOffsets);
+    }
+    float ms = stopwatch.GetMilliseconds();
+
+    gReportManager.Log("Dump", StringUtil::Format("Sheep %s: %d bytes of bytecode, %d instructions, decode %.3fms (%.4fms avg)", GetName().c_str(),
+                                                  mBytecodeLength, static_cast<int>(instructions.size()), ms, ms / iterations));
+}
+
+void SheepScript::DecodeBytecode()
+{
+    DecodeBytecode(mInstructions, mInstructionOffsets);
+
+    // Determine whether this script could ever block or yield during execution.
+    mCanYield = false;
+    for(const DecodedSheepInstruction& decoded : mInstructions)
+    {
+        switch(decoded.instruction)
+        {
+        case SheepInstruction::Yield:
+        case SheepInstruction::BeginWait:
+        case SheepInstruction::EndWait:
+            mCanYield = true;
+            break;
+        case SheepInstruction::CallSysFunctionV:
+        case SheepInstruction::CallSysFunctionI:
+        case SheepInstruction::CallSysFunctionF:
+        case SheepInstruction::CallSysFunctionS:
+        {
+            SysFunc* sysFunc = GetSysFunc(decoded.intOperand);
+            if(sysFunc != nullptr && sysFunc->waitable)
+            {
+                mCanYield = true;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void SheepScript::DecodeBytecode(std::vector<DecodedSheepInstruction>& outInstructions, std::vector<int>& outInstructionOffsets) const
+{
+    outInstructions.clear();
+    outInstructionOffsets.clear();
+
+    // Decode each instruction and its operand (if any).
+    BinaryReader reader(mBytecode, mBytecodeLength);
+    while(reader.GetPosition() < mBytecodeLength)
+    {
+        int offset = reader.GetPosition();
+
+        DecodedSheepInstruction decoded;
+        decoded.instruction = static_cast<SheepInstruction>(reader.ReadByte());
+        if(SheepInstructionHasOperand(decoded.instruction))
+        {
+            if(decoded.instruction == SheepInstruction::PushF)
+            {
+                decoded.floatOperand = reader.ReadFloat();
+            }
+            else
+            {
+                decoded.intOperand = reader.ReadInt();
+            }
+        }
+
+        // If the bytecode ends partway through an instruction, it's as if the instruction doesn't exist.
+        if(!reader.OK()) { break; }
+        outInstructions.push_back(decoded);
+        outInstructionOffsets.push_back(offset);
+    }
+
+    // Convert branch addresses to instruction indexes, so the VM can jump directly to the target instruction.
+    // Compiled bytecode only ever branches to the start of an instruction.
+    for(DecodedSheepInstruction& decoded : outInstructions)
+    {
+        if(decoded.instruction == SheepInstruction::Branch ||
+           decoded.instruction == SheepInstruction::BranchGoto ||
+           decoded.instruction == SheepInstruction::BranchIfZero)
+        {
+            auto it = std::lower_bound(outInstructionOffsets.begin(), outInstructionOffsets.end(), decoded.intOperand);
+            decoded.intOperand = static_cast<int>(it - outInstructionOffsets.begin());
+        }
+        else if(decoded.instruction == SheepInstruction::PushS)
+        {
+            // Convert string const offsets to indexes in the strings table, so the VM needn't look strings up by offset.
+            auto it = mStringConstIndexes.find(decoded.intOperand);
+            decoded.intOperand = it != mStringConstIndexes.end() ? it->second : -1;
+        }
+    }
+}
@@ -14,6 +14,7 @@
 #include "SheepVM.h"
 #include "StringUtil.h"
 
+class AssetBuffer;
 class BinaryReader;
 class SheepScriptBuilder;
 
@@ -21,20 +22,28 @@ class SheepScript : public Asset
 {
     TYPEINFO_SUB(SheepScript, Asset);
 public:
-    static bool IsSheepDataCompiled(uint8_t* data, uint32_t dataLength);
+    static bool IsSheepDataCompiled(const uint8_t* data, uint32_t dataLength);
 
     SheepScript(const std::string& name, AssetScope scope) : Asset(name, scope) { }
     SheepScript(const std::string& name, SheepScriptBuilder& builder);
     ~SheepScript() override;
 
-    void Load(uint8_t* data, uint32_t dataLength);
+    void Load(const AssetBuffer& buffer);
     void Load(const SheepScriptBuilder& builder);
 
     SysFuncImport* GetSysImport(int index);
+    SysFunc* GetSysFunc(int index) const;
 
     std::string* GetStringConst(int offset);
 
-    std::vector<SheepValue> GetVariables() { return mVariables; }
+    // String constants are interned at load time. During execution, PushS refers to strings by index in this table.
+    const std::string* GetString(int index) const
+    {
+        if(index < 0 || index >= mStrings.size()) { return nullptr; }
+        return &mStrings[index];
+    }
+
+    const std::vector<SheepValue>& GetVariables() const { return mVariables; }
 
     int GetFunctionOffset(const std::string& functionName);
     const std::string* GetFunctionAtOffset(int offset) const;
@@ -42,6 +51,21 @@ public:
     char* GetBytecode() { return mBytecode; }
     int GetBytecodeLength() const { return mBytecodeLength; }
 
+    // The bytecode, decoded into an instruction array at load time. This is what the VM actually executes.
+    const DecodedSheepInstruction* GetInstructions() const { return mInstructions.data(); }
+    int GetInstructionCount() const { return static_cast<int>(mInstructions.size()); }
+
+    // Convert between bytecode offsets and instruction indexes.
+    int GetInstructionIndex(int bytecodeOffset) const;
+    int GetBytecodeOffset(int instructionIndex) const;
+
+    // If false, executing this script can never block or yield (no wait blocks, no waitable SysFuncs).
+    // Such scripts always run to completion immediately, which allows some shortcuts during evaluation.
+    bool CanYield() const { return mCanYield; }
+
+    // Logs how long it takes to decode this script's bytecode, which is done once at load time.
+    void BenchmarkDecoding(int iterations) const;
+
     void Dump();
     void Decompile();
     void Decompile(const std::string& filePath);
@@ -50,8 +74,16 @@ private:
     // List of SysFuncs this script uses.
     std::vector<SysFuncImport> mSysImports;
 
-    // String constants, keyed by data offset, since that's how bytecode identifies them.
-    std::unordered_map<int, std::string> mStringConsts;
+    // Each SysFunc import, resolved to the actual SysFunc (or null if no such SysFunc exists).
+    // Resolved once at load time, so the VM doesn't need to look up SysFuncs by name during execution.
+    std::vector<SysFunc*> mSysFuncs;
+
+    // String constants used by this script, one per data offset.
+    // This isn't modified after load, so pointers to these strings remain valid for the lifetime of the script.
+    std::vector<std::string> mStrings;
+
+    // Maps a string constant's data offset (which is how bytecode identifies it) to its index in the strings table.
+    std::unordered_map<int, int> mStringConstIndexes;
 
     // Represents variable ordering, types, and default values.
     // Bytecode only cares about the index of the variable.
@@ -65,10 +97,22 @@ private:
     char* mBytecode = nullptr;
     int mBytecodeLength = 0;
 
-    void ParseFromData(uint8_t* data, uint32_t dataLength);
+    // Decoded bytecode instructions, and the bytecode offset of each instruction.
+    std::vector<DecodedSheepInstruction> mInstructions;
+    std::vector<int> mInstructionOffsets;
+
+    // Whether any instruction might cause execution to block or yield.
+    bool mCanYield = true;
+
+    void ParseFromData(const uint8_t* data, uint32_t dataLength);
     void ParseSysImportsSection(BinaryReader& reader);
     void ParseStringConstsSection(BinaryReader& reader);
     void ParseVariablesSection(BinaryReader& reader);
     void ParseFunctionsSection(BinaryReader& reader);
     void ParseCodeSection(BinaryReader& reader);
+
+    void AddStringConst(int offset, const std::string& str);
+    void ResolveSysFuncs();
+    void DecodeBytecode();
+    void DecodeBytecode(std::vector<DecodedSheepInstruction>& outInstructions, std::vector<int>& outInstructionOffsets) const;
 };
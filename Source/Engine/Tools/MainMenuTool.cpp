@@ -3,6 +3,7 @@
 #include <imgui.h>
 
 #include "Debug.h"
+#include "Renderer.h"
 #include "SceneManager.h"
 #include "SceneConstruction.h"
 #include "Tools.h"
@@ -61,6 +62,27 @@ void MainMenuTool::Render()
             {
                 Debug::ToggleFlag("ShowWalkerPaths");
             }
+            ImGui::Separator();
+            if(ImGui::MenuItem("Frustum Culling", nullptr, !Debug::GetFlag("DisableFrustumCulling")))
+            {
+                Debug::ToggleFlag("DisableFrustumCulling");
+            }
+            if(ImGui::MenuItem("GPU Vertex Animation", nullptr, !Debug::GetFlag("DisableGPUVertexAnimation")))
+            {
+                Debug::ToggleFlag("DisableGPUVertexAnimation");
+            }
+            ImGui::EndMenu();
+        }
+
+        // STATS menu
+        if(ImGui::BeginMenu("Stats"))
+        {
+            const RenderStats& stats = gRenderer.GetStats();
+            ImGui::Text("Mesh Renderers Drawn: %u", stats.meshRenderersDrawn);
+            ImGui::Text("Mesh Renderers Culled: %u", stats.meshRenderersCulled);
+            ImGui::Text("Draw Items: %u", stats.drawItems);
+            ImGui::Text("Material Changes: %u", stats.materialChanges);
+            ImGui::Text("BSP Draw Calls: %u", stats.bspDrawCalls);
             ImGui::EndMenu();
         }
 
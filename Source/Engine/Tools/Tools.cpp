@@ -74,8 +74,12 @@ void Tools::Render()
     }
 
     // Start a new frame.
+    // Not every GAPI sets up the SDL platform backend (e.g. the null GAPI has no use for it).
     GAPI::Get()->ImGuiNewFrame();
-    ImGui_ImplSDL2_NewFrame();
+    if(ImGui::GetIO().BackendPlatformUserData != nullptr)
+    {
+        ImGui_ImplSDL2_NewFrame();
+    }
     ImGui::NewFrame();
 
     // Render any tools.
@@ -106,7 +110,10 @@ bool Tools::Active()
 
 void Tools::ProcessEvent(const SDL_Event& event)
 {
-    ImGui_ImplSDL2_ProcessEvent(&event);
+    if(ImGui::GetIO().BackendPlatformUserData != nullptr)
+    {
+        ImGui_ImplSDL2_ProcessEvent(&event);
+    }
 }
 
 bool Tools::EatingMouseInputs()
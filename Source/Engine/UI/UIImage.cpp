@@ -1,6 +1,7 @@
 #include "UIImage.h"
 
 #include "Actor.h"
+#include "AssetManager.h"
 #include "Debug.h"
 #include "Mesh.h"
 #include "Texture.h"
@@ -81,6 +82,16 @@ void UIImage::SetColor(const Color32& color)
 
 void UIImage::SetTexture(Texture* texture, bool resizeImage)
 {
+    // If previously showing a YUV image, go back to the default shader.
+    // Chroma textures must also be cleared, since the material activates every texture it has.
+    if(mYUV)
+    {
+        mMaterial.SetShader(Material::sDefaultShader);
+        mMaterial.SetTexture("uChromaU", nullptr);
+        mMaterial.SetTexture("uChromaV", nullptr);
+        mYUV = false;
+    }
+
     // Setting a null texture is actually an error (the system just renders garbage or whatever was leftover from last render).
     // So if no texture was set, go back to the default of white.
     if(texture != nullptr)
@@ -99,6 +110,21 @@ void UIImage::SetTexture(Texture* texture, bool resizeImage)
     }
 }
 
+void UIImage::SetTextureYUV(Texture* textureY, Texture* textureU, Texture* textureV)
+{
+    // Switch to the shader that converts YUV to RGB.
+    if(!mYUV)
+    {
+        mMaterial.SetShader(gAssetManager.LoadShader("3D-Tex", "UI-Video-YUV"));
+        mYUV = true;
+    }
+
+    // The Y plane is full size, so it doubles as the diffuse texture (which is used for sizing).
+    mMaterial.SetDiffuseTexture(textureY);
+    mMaterial.SetTexture("uChromaU", textureU);
+    mMaterial.SetTexture("uChromaV", textureV);
+}
+
 void UIImage::ResizeToTexture()
 {
     // Need a texture to do this!
@@ -27,8 +27,16 @@ public:
     void SetColor(const Color32& color);
 
     void SetTexture(Texture* texture, bool resizeImage = false);
+
+    // Displays a YUV 4:2:0 image (like a video frame), stored as one single-channel texture per plane.
+    // The image is converted to RGB in a shader. Calling SetTexture switches back to a normal texture.
+    void SetTextureYUV(Texture* textureY, Texture* textureU, Texture* textureV);
     Texture* GetTexture() const { return mMaterial.GetDiffuseTexture(); }
 
+    // Makes pixels of the given color transparent. This is done while rendering, so the texture isn't modified.
+    void SetChromaKey(const Color32& color) { mMaterial.SetChromaKey(color); }
+    void ClearChromaKey() { mMaterial.ClearChromaKey(); }
+
     void SetRenderMode(RenderMode mode) { mRenderMode = mode; }
 
     void ResizeToTexture();
@@ -37,4 +45,7 @@ public:
 private:
     Material mMaterial;
     RenderMode mRenderMode = RenderMode::Normal;
+
+    // If true, the material is set up to display YUV textures.
+    bool mYUV = false;
 };
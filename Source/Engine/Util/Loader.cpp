@@ -1,16 +1,15 @@
 #include "Loader.h"
 
-#include "ThreadPool.h"
-
-// Loader uses a single background thread, for now.
-ThreadedTaskQueue Loader::sLoadingTasks(1);
+// Each loading task depends on the previous one, so loading tasks run one at a time, in order.
+JobHandle Loader::sLastLoadingTask;
 
 int Loader::sLoadingCount = 0;
 std::function<void()> Loader::sLoadingFinishedCallback;
 
 void Loader::Shutdown()
 {
-    sLoadingTasks.Shutdown();
+    // Loading tasks run on the thread pool, which finishes up any in-progress task when it shuts down.
+    sLastLoadingTask = JobHandle();
 }
 
 void Loader::Load(std::function<void()> loadFunc)
@@ -18,7 +17,7 @@ void Loader::Load(std::function<void()> loadFunc)
     if(loadFunc != nullptr)
     {
         sLoadingCount++;
-        sLoadingTasks.AddTask(loadFunc, []() {
+        sLastLoadingTask = ThreadPool::AddContinuation(sLastLoadingTask, loadFunc, []() {
             sLoadingCount--;
             if(sLoadingCount == 0)
             {
@@ -1,7 +1,7 @@
 //
 // Clark Kromenaker
 //
-// Loader tracks outstanding background tasks and performs them on background threads.
+// Loader tracks outstanding background tasks and performs them on the thread pool.
 // Ideally, any loading work the game does that can go through the loader probably should!
 //
 // Keep in mind: when the loader is running, the game is not playable. A spinning loading cursor is displayed.
@@ -25,8 +25,8 @@ public:
     static bool IsLoading() { return sLoadingCount > 0; }
 
 private:
-    // Threads devoted to loading tasks.
-    static ThreadedTaskQueue sLoadingTasks;
+    // The most recently added loading task. New loading tasks wait for this one to complete.
+    static JobHandle sLastLoadingTask;
 
     // Number of loading tasks.
     static int sLoadingCount;
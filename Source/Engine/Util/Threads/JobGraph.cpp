@@ -0,0 +1,78 @@
+#include "JobGraph.h"
+
+#include <iostream>
+
+uint32_t JobGraph::AddJob(TaskFunction task, std::initializer_list<uint32_t> dependencies)
+{
+    uint32_t id = static_cast<uint32_t>(mNodes.size());
+    if(mRunning)
+    {
+        std::cout << "Can't add job to a job graph that's already running!" << std::endl;
+        return id;
+    }
+
+    mNodes.emplace_back();
+    Node& node = mNodes.back();
+    node.task = std::move(task);
+    for(uint32_t dependency : dependencies)
+    {
+        // Only allowing dependencies on earlier jobs guarantees there are no cycles.
+        if(dependency < id)
+        {
+            node.dependencies.push_back(dependency);
+        }
+        else
+        {
+            std::cout << "Job graph job " << id << " can't depend on job " << dependency << " - it doesn't exist yet." << std::endl;
+        }
+    }
+    return id;
+}
+
+void JobGraph::Run()
+{
+    if(mRunning) { return; }
+    mRunning = true;
+
+    // Since dependencies always come earlier in the list, each node's dependencies already have handles.
+    std::vector<JobHandle> dependencyHandles;
+    for(Node& node : mNodes)
+    {
+        dependencyHandles.clear();
+        for(uint32_t dependency : node.dependencies)
+        {
+            dependencyHandles.push_back(mNodes[dependency].handle);
+        }
+        node.handle = ThreadPool::AddTask(std::move(node.task), dependencyHandles.data(), dependencyHandles.size());
+    }
+}
+
+void JobGraph::Wait()
+{
+    // Wait on all jobs at once, so this thread can run whichever of them are ready (but no jobs from outside the graph).
+    std::vector<JobHandle> handles;
+    handles.reserve(mNodes.size());
+    for(const Node& node : mNodes)
+    {
+        handles.push_back(node.handle);
+    }
+    ThreadPool::WaitFor(handles.data(), handles.size());
+}
+
+void JobGraph::RunAndWait()
+{
+    Run();
+    Wait();
+}
+
+bool JobGraph::IsComplete() const
+{
+    for(const Node& node : mNodes)
+    {
+        if(!ThreadPool::IsComplete(node.handle))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+//
+// Clark Kromenaker
+//
+// A set of tasks with dependencies between them, run together on the thread pool.
+//
+// Build the graph up front (each job can only depend on jobs added before it), then Run it.
+// Jobs start as soon as their dependencies are done, so independent branches run in parallel.
+//
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "ThreadPool.h"
+
+class JobGraph
+{
+public:
+    // Adds a job to the graph, which won't start until all its dependencies are done.
+    // Returns an ID that later jobs can use to depend on this one.
+    uint32_t AddJob(TaskFunction task, std::initializer_list<uint32_t> dependencies = { });
+
+    // Starts all jobs in the graph. A graph can only be run once.
+    void Run();
+
+    // Waits for all jobs in the graph to complete. In the meantime, this thread helps out with jobs from this graph (and only this graph).
+    void Wait();
+
+    // Convenience for Run then Wait.
+    void RunAndWait();
+
+    bool IsComplete() const;
+    size_t GetJobCount() const { return mNodes.size(); }
+
+private:
+    struct Node
+    {
+        TaskFunction task;
+        std::vector<uint32_t> dependencies;
+
+        // Valid once the graph is run.
+        JobHandle handle;
+    };
+    std::vector<Node> mNodes;
+
+    // Has the graph been run yet?
+    bool mRunning = false;
+};
@@ -0,0 +1,157 @@
+//
+// Clark Kromenaker
+//
+// A move-only "void()" callable, similar to std::function.
+//
+// Unlike std::function, small callables (most lambdas) are stored inline, so creating a task doesn't allocate.
+// Only callables that are too big for the inline buffer fall back on a heap allocation.
+//
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+class TaskFunction
+{
+public:
+    // Callables up to this size (in bytes) are stored inline.
+    static const size_t kInlineSize = 64;
+
+    TaskFunction() = default;
+    TaskFunction(std::nullptr_t) { }
+    ~TaskFunction() { Reset(); }
+
+    // An empty std::function results in an empty task.
+    TaskFunction(const std::function<void()>& func)
+    {
+        if(func != nullptr)
+        {
+            Set(func);
+        }
+    }
+
+    template<typename F, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, TaskFunction>::value &&
+        !std::is_same<typename std::decay<F>::type, std::function<void()>>::value>::type>
+    TaskFunction(F&& func)
+    {
+        Set(std::forward<F>(func));
+    }
+
+    // Move only - callables may capture move-only things.
+    TaskFunction(const TaskFunction&) = delete;
+    TaskFunction& operator=(const TaskFunction&) = delete;
+    TaskFunction(TaskFunction&& other) noexcept { MoveFrom(other); }
+    TaskFunction& operator=(TaskFunction&& other) noexcept
+    {
+        if(this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    void operator()() { mOps->invoke(mTarget); }
+    explicit operator bool() const { return mOps != nullptr; }
+
+    void Reset()
+    {
+        if(mOps != nullptr)
+        {
+            mOps->destroy(mTarget);
+            mOps = nullptr;
+            mTarget = nullptr;
+        }
+    }
+
+private:
+    // Type-specific operations on the stored callable, so no virtual functions or RTTI are needed.
+    struct Ops
+    {
+        void (*invoke)(void* target);
+        void (*destroy)(void* target);
+
+        // Moves an inline callable from one buffer to another. Null for heap-allocated callables.
+        void (*move)(void* fromTarget, void* toStorage);
+    };
+
+    // Inline storage for small callables.
+    alignas(std::max_align_t) unsigned char mStorage[kInlineSize];
+
+    // Points to the callable - either within mStorage or on the heap.
+    void* mTarget = nullptr;
+    const Ops* mOps = nullptr;
+
+    template<typename T>
+    struct InlineOps
+    {
+        static void Invoke(void* target) { (*static_cast<T*>(target))(); }
+        static void Destroy(void* target) { static_cast<T*>(target)->~T(); }
+        static void Move(void* fromTarget, void* toStorage)
+        {
+            new(toStorage) T(std::move(*static_cast<T*>(fromTarget)));
+            static_cast<T*>(fromTarget)->~T();
+        }
+        static const Ops ops;
+    };
+
+    template<typename T>
+    struct HeapOps
+    {
+        static void Invoke(void* target) { (*static_cast<T*>(target))(); }
+        static void Destroy(void* target) { delete static_cast<T*>(target); }
+        static const Ops ops;
+    };
+
+    template<typename F>
+    void Set(F&& func)
+    {
+        using T = typename std::decay<F>::type;
+        std::integral_constant<bool, sizeof(T) <= kInlineSize &&
+                                     alignof(T) <= alignof(std::max_align_t) &&
+                                     std::is_nothrow_move_constructible<T>::value> fitsInline;
+        Set<T>(std::forward<F>(func), fitsInline);
+    }
+
+    template<typename T, typename F>
+    void Set(F&& func, std::true_type /*fitsInline*/)
+    {
+        mTarget = new(mStorage) T(std::forward<F>(func));
+        mOps = &InlineOps<T>::ops;
+    }
+
+    template<typename T, typename F>
+    void Set(F&& func, std::false_type /*fitsInline*/)
+    {
+        mTarget = new T(std::forward<F>(func));
+        mOps = &HeapOps<T>::ops;
+    }
+
+    void MoveFrom(TaskFunction& other)
+    {
+        if(other.mOps == nullptr) { return; }
+
+        // Inline callables must be moved into our own buffer. Heap callables just change owner.
+        mOps = other.mOps;
+        if(mOps->move != nullptr)
+        {
+            mOps->move(other.mTarget, mStorage);
+            mTarget = mStorage;
+        }
+        else
+        {
+            mTarget = other.mTarget;
+        }
+        other.mOps = nullptr;
+        other.mTarget = nullptr;
+    }
+};
+
+template<typename T>
+const TaskFunction::Ops TaskFunction::InlineOps<T>::ops = { &Invoke, &Destroy, &Move };
+
+template<typename T>
+const TaskFunction::Ops TaskFunction::HeapOps<T>::ops = { &Invoke, &Destroy, nullptr };
@@ -1,113 +1,519 @@
 #include "ThreadPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "ThreadUtil.h"
 
-ThreadedTaskQueue::ThreadedTaskQueue(int threadCount)
+namespace
 {
-    AddThreads(threadCount);
-}
+    // A task in the pool. Jobs are stored in a fixed array and reused, so adding a task doesn't allocate.
+    struct Job
+    {
+        // The work to do, and an optional callback to run on the main thread afterwards.
+        TaskFunction task;
+        std::function<void()> callback;
 
-ThreadedTaskQueue::~ThreadedTaskQueue()
-{
-    Shutdown();
-}
+        // If true, the job goes in the priority queue when it's queued.
+        bool highPriority = false;
 
-void ThreadedTaskQueue::AddThreads(int count)
-{
-    for(int i = 0; i < count; i++)
+        // Number of dependencies that must complete before this job can be queued.
+        std::atomic<int> unmetDependencies { 0 };
+
+        // Incremented each time the job completes. A handle with an older generation refers to a completed job.
+        std::atomic<uint32_t> generation { 0 };
+
+        // Jobs to notify when this job completes.
+        // The vector is reused along with the job, so after a short warmup, this doesn't allocate either.
+        std::vector<uint32_t> continuations;
+
+        // Guards completing the job vs. adding continuations.
+        std::mutex mutex;
+    };
+
+    // Max jobs in flight at once. If exceeded, threads adding jobs wait until a slot frees up.
+    const uint32_t kMaxJobs = 4096;
+    Job sJobs[kMaxJobs];
+
+    // Job slots that are available for reuse. Slots past the "next unused" index have never been used.
+    std::vector<uint32_t> sFreeJobs;
+    uint32_t sNextUnusedJob = 0;
+    std::mutex sFreeJobsMutex;
+
+    // A queue of job indexes.
+    struct JobQueue
     {
-        mThreads.emplace_back([this] { TaskThread(); });
+        std::deque<uint32_t> jobs;
+        std::mutex mutex;
+    };
+
+    // Each worker has its own queue. Jobs added from other threads (e.g. main thread) go in a shared queue.
+    // Priority jobs go in their own queue no matter which thread adds them.
+    std::vector<std::unique_ptr<JobQueue>> sWorkerQueues;
+    JobQueue sSharedQueue;
+    JobQueue sPriorityQueue;
+
+    // Worker threads, and the index of the current thread's worker queue (or -1 if not a worker thread).
+    std::vector<std::thread> sWorkerThreads;
+    thread_local int tWorkerIndex = -1;
+
+    // Total number of queued jobs, across all queues.
+    std::atomic<int> sQueuedJobCount { 0 };
+
+    // Incremented each time a job is queued. Lets waiting threads tell whether anything was queued while they looked for a job.
+    std::atomic<uint32_t> sEnqueueCount { 0 };
+
+    // Idle workers sleep until a job is queued. Threads in WaitFor sleep until a job is queued or completes.
+    std::mutex sSleepMutex;
+    std::condition_variable sWorkCondVar;
+    std::condition_variable sWaitCondVar;
+    std::atomic<int> sWaitingThreadCount { 0 };
+    std::atomic<bool> sShutdown { false };
+
+    void WakeWaitingThreads()
+    {
+        if(sWaitingThreadCount > 0)
+        {
+            std::lock_guard<std::mutex> lock(sSleepMutex);
+            sWaitCondVar.notify_all();
+        }
     }
-}
 
-void ThreadedTaskQueue::Shutdown()
-{
-    mMutex.lock();
-    mShutdown = true;
-    mMutex.unlock();
+    bool TryAllocateJob(uint32_t& outIndex)
+    {
+        std::lock_guard<std::mutex> lock(sFreeJobsMutex);
+        if(!sFreeJobs.empty())
+        {
+            outIndex = sFreeJobs.back();
+            sFreeJobs.pop_back();
+            return true;
+        }
+        if(sNextUnusedJob < kMaxJobs)
+        {
+            outIndex = sNextUnusedJob++;
+            return true;
+        }
+        return false;
+    }
 
-    mCondVar.notify_all();
+    void FreeJob(uint32_t index)
+    {
+        std::lock_guard<std::mutex> lock(sFreeJobsMutex);
+        sFreeJobs.push_back(index);
+    }
 
-    for(auto& thread : mThreads)
+    void EnqueueJob(uint32_t index)
     {
-        if(thread.joinable())
+        JobQueue& queue = sJobs[index].highPriority ? sPriorityQueue : (tWorkerIndex >= 0 ? *sWorkerQueues[tWorkerIndex] : sSharedQueue);
         {
-            thread.join();
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(index);
         }
+        ++sQueuedJobCount;
+        ++sEnqueueCount;
+
+        // Wake up a worker to do the job.
+        {
+            std::lock_guard<std::mutex> lock(sSleepMutex);
+            sWorkCondVar.notify_one();
+        }
+        WakeWaitingThreads();
     }
-}
 
-void ThreadedTaskQueue::AddTask(const std::function<void()>& task, const std::function<void()>& callback)
-{
-    // Wrap the task in a void(void*) lambda so it can be stored in the list successfully.
-    AddTask([task](void* arg) {
-        task();
-    }, nullptr, callback);
+    bool TryPopJob(JobQueue& queue, bool newest, uint32_t& outIndex)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.jobs.empty()) { return false; }
+        if(newest)
+        {
+            outIndex = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            outIndex = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        --sQueuedJobCount;
+        return true;
+    }
+
+    bool TryTakeJob(JobQueue& queue, JobHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        auto it = std::find(queue.jobs.begin(), queue.jobs.end(), handle.index);
+        if(it == queue.jobs.end()) { return false; }
+
+        // A queued job hasn't completed, so its generation can't have changed since the handle was created.
+        // If the generation doesn't match, the handle's job already completed and this is a new job reusing the slot.
+        if(sJobs[handle.index].generation != handle.generation) { return false; }
+        queue.jobs.erase(it);
+        --sQueuedJobCount;
+        return true;
+    }
+
+    bool TryTakeJob(JobHandle handle)
+    {
+        // Removes a specific job from whichever queue it's in, so the calling thread can run it.
+        if(sQueuedJobCount <= 0) { return false; }
+        if(TryTakeJob(sPriorityQueue, handle)) { return true; }
+        if(TryTakeJob(sSharedQueue, handle)) { return true; }
+        for(auto& queue : sWorkerQueues)
+        {
+            if(TryTakeJob(*queue, handle)) { return true; }
+        }
+        return false;
+    }
+
+    bool FindJob(uint32_t& outIndex)
+    {
+        // Nothing queued anywhere? Don't bother checking each queue.
+        if(sQueuedJobCount <= 0) { return false; }
+
+        // Priority jobs always come first, oldest first.
+        if(TryPopJob(sPriorityQueue, false, outIndex))
+        {
+            return true;
+        }
+
+        // Then workers prefer the newest job in their own queue.
+        if(tWorkerIndex >= 0 && TryPopJob(*sWorkerQueues[tWorkerIndex], true, outIndex))
+        {
+            return true;
+        }
+
+        // Then jobs added from outside the pool.
+        if(TryPopJob(sSharedQueue, false, outIndex))
+        {
+            return true;
+        }
+
+        // Finally, steal the oldest job from another worker. Start with the next worker over, so thieves spread out.
+        int workerCount = static_cast<int>(sWorkerQueues.size());
+        for(int i = 1; i <= workerCount; ++i)
+        {
+            int victim = (std::max(tWorkerIndex, 0) + i) % workerCount;
+            if(victim != tWorkerIndex && TryPopJob(*sWorkerQueues[victim], false, outIndex))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void CompleteJob(uint32_t index)
+    {
+        Job& job = sJobs[index];
+
+        // Get rid of the task now, since it may be holding onto resources (captured by value).
+        job.task.Reset();
+        job.highPriority = false;
+        std::function<void()> callback = std::move(job.callback);
+        job.callback = nullptr;
+
+        // Mark the job complete and take its continuations.
+        // Swapping with a per-thread vector keeps allocated capacity in circulation.
+        thread_local std::vector<uint32_t> continuations;
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            ++job.generation;
+            continuations.swap(job.continuations);
+        }
+        FreeJob(index);
+
+        // Any continuations with no other unmet dependencies can now be queued.
+        for(uint32_t continuation : continuations)
+        {
+            if(--sJobs[continuation].unmetDependencies == 0)
+            {
+                EnqueueJob(continuation);
+            }
+        }
+        continuations.clear();
+
+        // Only post callbacks to the main thread if there actually is one.
+        if(callback != nullptr)
+        {
+            ThreadUtil::RunOnMainThread(callback);
+        }
+        WakeWaitingThreads();
+    }
+
+    void RunJob(uint32_t index)
+    {
+        sJobs[index].task();
+        CompleteJob(index);
+    }
+
+    bool RunOneJob()
+    {
+        uint32_t index = 0;
+        if(!FindJob(index)) { return false; }
+        RunJob(index);
+        return true;
+    }
+
+    bool HasFreeJob()
+    {
+        std::lock_guard<std::mutex> lock(sFreeJobsMutex);
+        return !sFreeJobs.empty() || sNextUnusedJob < kMaxJobs;
+    }
+
+    void WorkerThread(int workerIndex)
+    {
+        tWorkerIndex = workerIndex;
+        while(true)
+        {
+            // If shutting down, just return.
+            if(sShutdown) { return; }
+
+            // Do a job, if there is one.
+            if(RunOneJob()) { continue; }
+
+            // No jobs available - wait for one to be queued.
+            std::unique_lock<std::mutex> lock(sSleepMutex);
+            sWorkCondVar.wait(lock, []() { return sShutdown || sQueuedJobCount > 0; });
+        }
+    }
+
+    JobHandle AddJob(TaskFunction task, const JobHandle* dependencies, size_t dependencyCount, const std::function<void()>& callback, bool highPriority)
+    {
+        if(!task) { return JobHandle(); }
+
+        // Get a job slot. If all slots are in use, wait until one frees up.
+        uint32_t index = 0;
+        while(!TryAllocateJob(index))
+        {
+            // Worker threads help out, since if every worker were waiting for a slot, nothing would ever free one up.
+            // Other threads (e.g. main thread) just wait, so they don't get stuck in some unrelated long-running job.
+            if(tWorkerIndex >= 0 && RunOneJob()) { continue; }
+
+            ++sWaitingThreadCount;
+            {
+                std::unique_lock<std::mutex> lock(sSleepMutex);
+                sWaitCondVar.wait(lock, []() { return HasFreeJob(); });
+            }
+            --sWaitingThreadCount;
+        }
+
+        Job& job = sJobs[index];
+        job.task = std::move(task);
+        job.callback = callback;
+        job.highPriority = highPriority;
+
+        JobHandle handle;
+        handle.index = index;
+        handle.generation = job.generation;
+
+        // Register as a continuation of each incomplete dependency.
+        // The extra "dependency" keeps the job from being queued by a dependency that completes during this loop.
+        job.unmetDependencies = 1;
+        for(size_t i = 0; i < dependencyCount; ++i)
+        {
+            const JobHandle& dependency = dependencies[i];
+            if(!dependency.IsValid()) { continue; }
+
+            Job& dependencyJob = sJobs[dependency.index];
+            std::lock_guard<std::mutex> lock(dependencyJob.mutex);
+            if(dependencyJob.generation == dependency.generation)
+            {
+                ++job.unmetDependencies;
+                dependencyJob.continuations.push_back(index);
+            }
+        }
+        if(--job.unmetDependencies == 0)
+        {
+            EnqueueJob(index);
+        }
+        return handle;
+    }
 }
 
-void ThreadedTaskQueue::AddTask(const std::function<void(void*)>& task, void* context, const std::function<void()>& callback)
+void ThreadPool::Init(int threadCount)
 {
-    if(task != nullptr)
+    // Leave one hardware thread for the main thread. But always have at least two workers,
+    // so a long-running task (e.g. loading a scene) can't hold up all other background work.
+    if(threadCount <= 0)
     {
-        mMutex.lock();
-        mTasks.emplace(task, context, callback);
-        mMutex.unlock();
+        int hardwareThreadCount = static_cast<int>(std::thread::hardware_concurrency());
+        threadCount = std::max(hardwareThreadCount - 1, 2);
+    }
 
-        mCondVar.notify_one();
+    // All queues must exist before any worker starts stealing from them.
+    int firstWorkerIndex = static_cast<int>(sWorkerQueues.size());
+    for(int i = 0; i < threadCount; ++i)
+    {
+        sWorkerQueues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+    }
+    for(int i = 0; i < threadCount; ++i)
+    {
+        sWorkerThreads.emplace_back(WorkerThread, firstWorkerIndex + i);
     }
 }
 
-void ThreadedTaskQueue::TaskThread()
+void ThreadPool::Shutdown()
 {
-    while(true)
     {
-        // Lock mutex to check task list.
-        std::unique_lock<std::mutex> lock(mMutex);
+        std::lock_guard<std::mutex> lock(sSleepMutex);
+        sShutdown = true;
+        sWorkCondVar.notify_all();
+    }
+    for(auto& thread : sWorkerThreads)
+    {
+        if(thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    sWorkerThreads.clear();
 
-        // If task queue is empty (and not shutting down), wait.
-        while(mTasks.empty() && !mShutdown)
+    // Anything still queued never runs - but it must still be completed, so nobody waits on it forever.
+    // Callbacks are dropped, since the work they follow up on was never done.
+    auto dropJob = [](uint32_t index) {
+        sJobs[index].callback = nullptr;
+        CompleteJob(index);
+    };
+    uint32_t index = 0;
+    for(auto& queue : sWorkerQueues)
+    {
+        while(TryPopJob(*queue, false, index))
         {
-            mCondVar.wait(lock);
+            dropJob(index);
         }
+    }
+    while(TryPopJob(sSharedQueue, false, index))
+    {
+        dropJob(index);
+    }
+    while(TryPopJob(sPriorityQueue, false, index))
+    {
+        dropJob(index);
+    }
+    sWorkerQueues.clear();
 
-        // If shutting down, just return.
-        if(mShutdown) { return; }
+    std::lock_guard<std::mutex> lock(sSleepMutex);
+    sShutdown = false;
+}
 
-        // Grab a task off the list.
-        Task task = mTasks.front();
-        mTasks.pop();
+int ThreadPool::GetThreadCount()
+{
+    return static_cast<int>(sWorkerThreads.size());
+}
 
-        // Done with task list for now.
-        lock.unlock();
+JobHandle ThreadPool::AddTask(TaskFunction task, const std::function<void()>& callback)
+{
+    return AddTask(std::move(task), { }, callback);
+}
 
-        // Do the task.
-        task.task(task.context);
+JobHandle ThreadPool::AddTask(TaskFunction task, std::initializer_list<JobHandle> dependencies, const std::function<void()>& callback)
+{
+    return AddTask(std::move(task), dependencies.begin(), dependencies.size(), callback);
+}
 
-        // After the task is done, run callback on main thread.
-        ThreadUtil::RunOnMainThread(task.callback);
-    }
+JobHandle ThreadPool::AddTask(TaskFunction task, const JobHandle* dependencies, size_t dependencyCount, const std::function<void()>& callback)
+{
+    return AddJob(std::move(task), dependencies, dependencyCount, callback, false);
 }
 
-ThreadedTaskQueue ThreadPool::sTaskQueue;
+JobHandle ThreadPool::AddPriorityTask(TaskFunction task, const std::function<void()>& callback)
+{
+    return AddJob(std::move(task), nullptr, 0, callback, true);
+}
 
-void ThreadPool::Init(int threadCount)
+JobHandle ThreadPool::AddContinuation(JobHandle handle, TaskFunction task, const std::function<void()>& callback)
 {
-    sTaskQueue.AddThreads(threadCount);
+    return AddTask(std::move(task), { handle }, callback);
 }
 
-void ThreadPool::Shutdown()
+bool ThreadPool::IsComplete(JobHandle handle)
 {
-    sTaskQueue.Shutdown();
+    return !handle.IsValid() || sJobs[handle.index].generation != handle.generation;
 }
 
-void ThreadPool::AddTask(const std::function<void()>& task, const std::function<void()>& callback)
+void ThreadPool::WaitFor(JobHandle handle)
 {
-    sTaskQueue.AddTask(task, callback);
+    WaitFor(&handle, 1);
 }
 
-void ThreadPool::AddTask(const std::function<void(void*)>& task, void* context, const std::function<void()>& callback)
+void ThreadPool::WaitFor(const JobHandle* handles, size_t count)
 {
-    sTaskQueue.AddTask(task, context, callback);
-}
\ No newline at end of file
+    while(true)
+    {
+        // If any of the jobs haven't started yet, just do them on this thread.
+        // Other queued jobs are left alone: they may take much longer than the jobs we're waiting for (e.g. loading).
+        uint32_t enqueueCount = sEnqueueCount;
+        size_t firstIncomplete = count;
+        bool ranJob = false;
+        for(size_t i = 0; i < count; ++i)
+        {
+            if(IsComplete(handles[i])) { continue; }
+            if(firstIncomplete == count)
+            {
+                firstIncomplete = i;
+            }
+            if(TryTakeJob(handles[i]))
+            {
+                RunJob(handles[i].index);
+                ranJob = true;
+            }
+        }
+        if(firstIncomplete == count) { return; }
+        if(ranJob) { continue; }
+
+        // Otherwise, the remaining jobs are running elsewhere or waiting on dependencies.
+        // Sleep until the first of them completes, or a job is queued (which may be one of ours, now that its dependencies are done).
+        const JobHandle& handle = handles[firstIncomplete];
+        ++sWaitingThreadCount;
+        {
+            std::unique_lock<std::mutex> lock(sSleepMutex);
+            sWaitCondVar.wait(lock, [&handle, enqueueCount]() { return IsComplete(handle) || sEnqueueCount != enqueueCount; });
+        }
+        --sWaitingThreadCount;
+    }
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& func)
+{
+    if(end <= begin || func == nullptr) { return; }
+    if(grainSize == 0) { grainSize = 1; }
+
+    // If it all fits in one chunk, no need to involve any other threads.
+    size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+    if(chunkCount == 1)
+    {
+        func(begin, end);
+        return;
+    }
+
+    // Each participating thread grabs the next chunk until none remain.
+    // Since chunks are claimed dynamically, threads that get fast chunks just do more of them.
+    std::atomic<size_t> nextChunk { 0 };
+    auto doChunks = [begin, end, grainSize, chunkCount, &nextChunk, &func]() {
+        size_t chunk = 0;
+        while((chunk = nextChunk++) < chunkCount)
+        {
+            size_t chunkBegin = begin + chunk * grainSize;
+            func(chunkBegin, std::min(chunkBegin + grainSize, end));
+        }
+    };
+
+    // Enlist help from the pool (one helper per worker at most), then pitch in on this thread.
+    const size_t kMaxHelpers = 64;
+    JobHandle helpers[kMaxHelpers];
+    size_t helperCount = std::min(std::min(chunkCount - 1, static_cast<size_t>(GetThreadCount())), kMaxHelpers);
+    for(size_t i = 0; i < helperCount; ++i)
+    {
+        helpers[i] = AddTask(doChunks);
+    }
+    doChunks();
+
+    // Helpers reference stack variables, so they must all be done before returning.
+    // Any helper that hasn't started by now finds no chunks left, and finishes immediately.
+    WaitFor(helpers, helperCount);
+}
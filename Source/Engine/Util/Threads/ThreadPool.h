@@ -4,73 +4,64 @@
 // A thread pool provides a generalized/simple way to run code on background threads.
 // Just add a task and the next available thread will do the work.
 //
+// Internally, this is a work-stealing job system: each worker thread has its own queue of tasks.
+// Workers run their own tasks first (newest first, since its data is likely still in cache) and steal from others when out of work.
+// Tasks can depend on other tasks, and won't be queued until all their dependencies are complete.
+// Priority tasks go in their own queue, which every worker checks before any other - use these for small, latency sensitive work.
+//
 #pragma once
-#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <mutex>
-#include <queue>
-#include <thread>
-#include <utility>
-#include <vector>
+#include <initializer_list>
 
-class ThreadedTaskQueue
-{
-public:
-    ThreadedTaskQueue(int threadCount = 0);
-    ~ThreadedTaskQueue();
+#include "TaskFunction.h"
 
-    void AddThreads(int count);
-    void Shutdown();
+// Identifies a task that was added to the thread pool.
+// Handles are cheap to copy, and remain valid to query after the task completes.
+struct JobHandle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
 
-    void AddTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
-    void AddTask(const std::function<void(void*)>& task, void* context = nullptr, const std::function<void()>& callback = nullptr);
+    bool IsValid() const { return index != UINT32_MAX; }
+};
 
-private:
-    struct Task
-    {
-        // The task and task context.
-        std::function<void(void*)> task;
-        void* context = nullptr;
+class ThreadPool
+{
+public:
+    // Starts worker threads. If count is zero, a count is chosen based on the number of hardware threads available.
+    static void Init(int threadCount = 0);
+    static void Shutdown();
 
-        // A callback for when the task completes.
-        std::function<void()> callback;
+    static int GetThreadCount();
 
-        Task(std::function<void(void*)> task, void* context, std::function<void()> callback) :
-            task(std::move(task)),
-            context(context),
-            callback(std::move(callback))
-        {
+    // Adds a task to the pool. If a callback is provided, it is run on the main thread after the task completes.
+    // The task won't start until all dependencies have completed.
+    static JobHandle AddTask(TaskFunction task, const std::function<void()>& callback = nullptr);
+    static JobHandle AddTask(TaskFunction task, std::initializer_list<JobHandle> dependencies, const std::function<void()>& callback = nullptr);
+    static JobHandle AddTask(TaskFunction task, const JobHandle* dependencies, size_t dependencyCount, const std::function<void()>& callback = nullptr);
 
-        }
-    };
+    // Adds a task that is run before any normal tasks, as soon as a worker is free.
+    // This can't jump ahead of tasks that are already running, so if the result is needed by a deadline, be ready to WaitFor it.
+    static JobHandle AddPriorityTask(TaskFunction task, const std::function<void()>& callback = nullptr);
 
-    // Tasks waiting to be completed.
-    std::queue<Task> mTasks;
+    // Adds a task that runs once another task has completed.
+    static JobHandle AddContinuation(JobHandle handle, TaskFunction task, const std::function<void()>& callback = nullptr);
 
-    // If true, task queue is shutting down. Worker threads will exit.
-    bool mShutdown = false;
+    // Returns true if the task has completed. Invalid handles are always complete.
+    static bool IsComplete(JobHandle handle);
 
-    // Mutex/condition variable to deal with multi-threaded access to shared data.
-    std::mutex mMutex;
-    std::condition_variable mCondVar;
+    // Blocks until the task has completed. If the task hasn't started yet, the calling thread runs it.
+    // No other tasks are run while waiting, so a wait never gets stuck behind some unrelated long task.
+    static void WaitFor(JobHandle handle);
 
-    // Threads spawned for this task queue.
-    std::vector<std::thread> mThreads;
+    // Blocks until all the tasks have completed. Like above, the calling thread runs any of them that haven't started yet, but nothing else.
+    static void WaitFor(const JobHandle* handles, size_t count);
 
-    void TaskThread();
+    // Splits the range [begin, end) into chunks of at most grainSize elements, and calls func(chunkBegin, chunkEnd) for each chunk.
+    // Chunks are spread across the thread pool, and the calling thread does chunks too. Returns once all chunks are done.
+    // While waiting on other threads to finish their chunks, the calling thread doesn't pick up any unrelated tasks.
+    // Pick a grain size big enough that each chunk is worth the overhead of a task (at least a few microseconds of work).
+    static void ParallelFor(size_t begin, size_t end, size_t grainSize, const std::function<void(size_t, size_t)>& func);
 };
-
-class ThreadPool
-{
-public:
-    static void Init(int threadCount);
-    static void Shutdown();
-
-    static void AddTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
-    static void AddTask(const std::function<void(void*)>& task, void* context = nullptr, const std::function<void()>& callback = nullptr);
-
-private:
-    // Just uses a threaded task queue internally.
-    // The thread pool is really just a static instance of a task queue!
-    static ThreadedTaskQueue sTaskQueue;
-};
\ No newline at end of file
@@ -73,6 +73,9 @@ struct BasicValue
     }
 };
 
+// Tag to construct a Value that refers to an existing object, rather than holding a copy of it.
+struct ValueRef { };
+
 // Similar to BasicValue, but handles lifecycle of data when copied/destructed.
 struct Value
 {
@@ -81,18 +84,26 @@ struct Value
     TypeHandler* typeHandler;
     void* data;
 
+    // If false, data is borrowed from elsewhere, and this value must not delete it.
+    bool owned = true;
+
     template<typename T> Value(const T& x) : typeHandler(GetTypeHandler<T>()), data(new T(x)) { }
     Value(const Value& other) : typeHandler(other.typeHandler), data(typeHandler->copyFrom(other.data)) { }
-    ~Value() { typeHandler->destroy(data); }
+    ~Value() { if(owned) { typeHandler->destroy(data); } }
+
+    // Refers to an existing object without copying it. The object must outlive this value.
+    // Copies of this value are normal (owning) values.
+    template<typename T> Value(const T& x, ValueRef) : typeHandler(GetTypeHandler<T>()), data(const_cast<T*>(&x)), owned(false) { }
 
     // Assignment between Value objects.
     Value& operator=(const Value& other)
     {
         if(this != &other)
         {
-            typeHandler->destroy(data);
+            if(owned) { typeHandler->destroy(data); }
             typeHandler = other.typeHandler;
             data = typeHandler->copyFrom(other.data);
+            owned = true;
         }
         return *this;
     }
@@ -101,9 +112,10 @@ struct Value
     template<typename T>
     Value& operator=(const T& other)
     {
-        typeHandler->destroy(data);
+        if(owned) { typeHandler->destroy(data); }
         typeHandler = GetTypeHandler<T>();
         data = new T(other);
+        owned = true;
         return *this;
     }
 
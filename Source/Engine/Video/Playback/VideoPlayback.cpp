@@ -17,11 +17,10 @@ VideoPlayback::~VideoPlayback()
     sws_freeContext(mRGBAConvertContext);
     //sws_freeContext(sub_convert_ctx);
 
-    // Free texture.
-    if(mVideoTexture != nullptr)
-    {
-        delete mVideoTexture;
-    }
+    // Free textures.
+    delete mVideoTexture;
+    delete mVideoChromaTextureU;
+    delete mVideoChromaTextureV;
 }
 
 void VideoPlayback::Update(VideoState* is)
@@ -173,26 +172,78 @@ retry:
     }
 }
 
+namespace
+{
+    // Makes sure the texture exists and has the given size/format, recreating it if not.
+    // Returns true if a new texture was created.
+    bool PrepareTexture(Texture*& texture, uint32_t width, uint32_t height, Texture::Format format)
+    {
+        if(texture == nullptr || texture->GetWidth() != width || texture->GetHeight() != height || texture->GetFormat() != format)
+        {
+            delete texture;
+            texture = new Texture(width, height, format);
+            return true;
+        }
+        return false;
+    }
+}
+
 bool VideoPlayback::UpdateVideoTexture(Frame* videoFrame)
 {
     // Already uploaded video texture to GPU - don't do it again.
     if(videoFrame->uploaded) { return true; }
 
+    // YUV420 frames (used by Bink and most other codecs) can be uploaded as-is, with conversion to RGB done in a shader.
+    // This requires positive line sizes (negative means the image is stored bottom-up).
     AVFrame* avFrame = videoFrame->frame;
+    bool useYUV = avFrame->format == AV_PIX_FMT_YUV420P &&
+                  avFrame->linesize[0] > 0 && avFrame->linesize[1] > 0 && avFrame->linesize[2] > 0;
 
-    // Make sure we have a properly sized video texture.
-    if(mVideoTexture == nullptr || mVideoTexture->GetWidth() != avFrame->width || mVideoTexture->GetHeight() != avFrame->height)
+    // Upload to the appropriate texture(s).
+    bool success = useYUV ? UpdateVideoTextureYUV(avFrame) : UpdateVideoTextureRGBA(avFrame);
+    if(success)
     {
-        if(mVideoTexture != nullptr)
-        {
-            delete mVideoTexture;
-        }
-        mVideoTexture = new Texture(avFrame->width, avFrame->height);
+        mVideoTextureYUV = useYUV;
+
+        // Yep, we are uploaded.
+        videoFrame->uploaded = true;
+        //videoFrame->flipVertical = avFrame->linesize[0] < 0; //TODO: Deal with vertical flip if needed
+    }
+    return success;
+}
+
+bool VideoPlayback::UpdateVideoTextureYUV(AVFrame* avFrame)
+{
+    // Y plane is full size, but U/V planes are half size (rounded up) in each dimension.
+    uint32_t width = avFrame->width;
+    uint32_t height = avFrame->height;
+    uint32_t chromaWidth = (width + 1) / 2;
+    uint32_t chromaHeight = (height + 1) / 2;
+    PrepareTexture(mVideoTexture, width, height, Texture::Format::R8);
+
+    // Chroma planes are sampled at lower resolution, so filter them to avoid blocky color edges.
+    if(PrepareTexture(mVideoChromaTextureU, chromaWidth, chromaHeight, Texture::Format::R8))
+    {
+        mVideoChromaTextureU->SetFilterMode(Texture::FilterMode::Bilinear);
+    }
+    if(PrepareTexture(mVideoChromaTextureV, chromaWidth, chromaHeight, Texture::Format::R8))
+    {
+        mVideoChromaTextureV->SetFilterMode(Texture::FilterMode::Bilinear);
     }
 
-    // Create conversion context to go from input frame format to BGRA format.
-    //TODO: There may be more efficient options for displaying a video frame. Ex: YUV420 data can be loaded into texture and rendered with special shader.
-    //TODO: But for now, just convert all formats to RGBA for simplicity.
+    // Stream each plane directly from the decoded frame to the GPU.
+    mVideoTexture->StreamPixels(avFrame->data[0], avFrame->linesize[0]);
+    mVideoChromaTextureU->StreamPixels(avFrame->data[1], avFrame->linesize[1]);
+    mVideoChromaTextureV->StreamPixels(avFrame->data[2], avFrame->linesize[2]);
+    return true;
+}
+
+bool VideoPlayback::UpdateVideoTextureRGBA(AVFrame* avFrame)
+{
+    // Make sure we have a properly sized video texture.
+    PrepareTexture(mVideoTexture, avFrame->width, avFrame->height, Texture::Format::RGBA);
+
+    // Create conversion context to go from input frame format to RGBA format.
     mRGBAConvertContext = sws_getCachedContext(mRGBAConvertContext,
         avFrame->width, avFrame->height, (AVPixelFormat)avFrame->format,    // from format
         avFrame->width, avFrame->height, AV_PIX_FMT_RGBA,                   // to format
@@ -210,13 +261,8 @@ bool VideoPlayback::UpdateVideoTexture(Frame* videoFrame)
               avFrame->data, avFrame->linesize, 0, avFrame->height, // source
               dest, dest_linesize); // dest
 
-    // Upload texture data to GPU.
-    mVideoTexture->AddDirtyFlags(Texture::DirtyFlags::Pixels);
-    mVideoTexture->UploadToGPU();
-
-    // Yep, we are uploaded.
-    videoFrame->uploaded = true;
-    //videoFrame->flipVertical = avFrame->linesize[0] < 0; //TODO: Deal with vertical flip if needed
+    // Stream texture data to GPU.
+    mVideoTexture->StreamPixels(mVideoTexture->GetPixelData(), dest_linesize[0]);
     return true;
 }
 
@@ -31,18 +31,29 @@ public:
 
     Texture* GetVideoTexture() { return mVideoTexture; }
 
+    // If true, the video texture holds only the Y plane of a YUV frame, and the U/V planes are in the chroma textures.
+    bool IsVideoTextureYUV() const { return mVideoTextureYUV; }
+    Texture* GetVideoChromaTextureU() { return mVideoChromaTextureU; }
+    Texture* GetVideoChromaTextureV() { return mVideoChromaTextureV; }
+
 private:
     // ffmpeg provides a helper library for converting between formats.
-    // For ease of use, all formats are converted to RGBA for display.
+    // Formats that can't be displayed directly are converted to RGBA.
     SwsContext* mRGBAConvertContext = nullptr;
 
     // If true, playback is in "step" mode, where each frame is viewed one at a time.
     bool mStep = false;
 
     // Texture that current video frame will be written to.
+    // For YUV frames, this holds the Y plane, and the chroma textures hold the U/V planes.
     Texture* mVideoTexture = nullptr;
+    Texture* mVideoChromaTextureU = nullptr;
+    Texture* mVideoChromaTextureV = nullptr;
+    bool mVideoTextureYUV = false;
 
     bool UpdateVideoTexture(Frame* videoFrame);
+    bool UpdateVideoTextureYUV(AVFrame* avFrame);
+    bool UpdateVideoTextureRGBA(AVFrame* avFrame);
 
     void UpdateSubtitles(VideoState* is);
 
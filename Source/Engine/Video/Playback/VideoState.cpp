@@ -246,6 +246,21 @@ Texture* VideoState::GetVideoTexture()
     return videoPlayback != nullptr ? videoPlayback->GetVideoTexture() : nullptr;
 }
 
+bool VideoState::IsVideoTextureYUV()
+{
+    return videoPlayback != nullptr && videoPlayback->IsVideoTextureYUV();
+}
+
+Texture* VideoState::GetVideoChromaTextureU()
+{
+    return videoPlayback != nullptr ? videoPlayback->GetVideoChromaTextureU() : nullptr;
+}
+
+Texture* VideoState::GetVideoChromaTextureV()
+{
+    return videoPlayback != nullptr ? videoPlayback->GetVideoChromaTextureV() : nullptr;
+}
+
 int VideoState::OpenStream(int streamIndex)
 {
     // Make sure stream index is in valid range.
@@ -91,6 +91,9 @@ struct VideoState
     double GetMasterClock();
 
     Texture* GetVideoTexture();
+    bool IsVideoTextureYUV();
+    Texture* GetVideoChromaTextureU();
+    Texture* GetVideoChromaTextureV();
 
 private:
     // Name of video file playing.
@@ -58,17 +58,14 @@ void VideoPlayer::Update()
 
         // Apply video texture.
         Texture* videoTexture = mVideo->GetVideoTexture();
-        if(mHasTransparentColor && videoTexture != nullptr)
+        UIImage* videoImage = GetVideoImage();
+        if(mVideo->IsVideoTextureYUV())
         {
-            videoTexture->SetTransparentColor(mTransparentColor);
-        }
-        if(mOverrideVideoImage != nullptr)
-        {
-            mOverrideVideoImage->SetTexture(videoTexture);
+            videoImage->SetTextureYUV(videoTexture, mVideo->GetVideoChromaTextureU(), mVideo->GetVideoChromaTextureV());
         }
         else
         {
-            mVideoImage->SetTexture(videoTexture);
+            videoImage->SetTexture(videoTexture);
         }
 
         // A lot of this logic only applies to the "theater viewing experience".
@@ -179,6 +176,9 @@ void VideoPlayer::Play(const std::string& name, bool fullscreen, bool autoclose,
     // This video will use the built-in video image, so null out any override.
     mOverrideVideoImage = nullptr;
 
+    // Videos played this way have no transparent color.
+    mHasTransparentColor = false;
+
     // If fullscreen, background is 100% opaque.
     // If not fullscreen, background is alpha'd a bit.
     if(fullscreen)
@@ -238,6 +238,12 @@ void VideoPlayer::Play(const std::string& name, Color32* transparentColor, UIIma
     // Save override video image.
     mOverrideVideoImage = image;
 
+    // The transparent color is applied as a chroma key when the video image renders, so video frames don't need to be modified.
+    if(mHasTransparentColor)
+    {
+        GetVideoImage()->SetChromaKey(mTransparentColor);
+    }
+
     // Save stop callback.
     mStopCallback = callback;
 
@@ -272,6 +278,12 @@ void VideoPlayer::Stop()
         delete mVideo;
         mVideo = nullptr;
 
+        // Remove any chroma key that was applied to the video image for this video.
+        if(mHasTransparentColor)
+        {
+            GetVideoImage()->ClearChromaKey();
+        }
+
         // Unlock mouse on movie end. TODO: Maybe do this in the video layer?
         gInputManager.UnlockMouse();
     }
@@ -285,3 +297,7 @@ void VideoPlayer::Stop()
     }
 }
 
+UIImage* VideoPlayer::GetVideoImage() const
+{
+    return mOverrideVideoImage != nullptr ? mOverrideVideoImage : mVideoImage;
+}
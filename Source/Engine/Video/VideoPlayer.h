@@ -81,6 +81,8 @@ private:
 
     // Callback that is fired when video playback stops (either due to EOF or skip).
     std::function<void()> mStopCallback = nullptr;
+
+    UIImage* GetVideoImage() const;
 };
 
 extern VideoPlayer gVideoPlayer;
\ No newline at end of file
@@ -46,15 +46,6 @@ namespace
 
 ActionManager gActionManager;
 
-ActionManager::~ActionManager()
-{
-    // Clean up any leftover script in the custom action.
-    if(mCustomAction.script.script != nullptr)
-    {
-        delete mCustomAction.script.script;
-    }
-}
-
 void ActionManager::Init()
 {
     // Create action bar, which will be used to choose nouns/verbs by the player.
@@ -239,21 +230,14 @@ void ActionManager::ExecuteCustomAction(const std::string& noun, const std::stri
         return;
     }
 
-    // Clean up any leftover script from last run.
-    if(mCustomAction.script.script != nullptr)
-    {
-        delete mCustomAction.script.script;
-        mCustomAction.script.script = nullptr;
-    }
-
     // Populate action.
     mCustomAction.noun = noun;
     mCustomAction.verb = verb;
     mCustomAction.caseLabel = caseLabel;
 
-    // Compile script.
+    // Compile script. The same few custom actions tend to be used again and again, so use the cache to avoid recompiling each time.
     mCustomAction.script.text = sheepScriptText;
-    mCustomAction.script.script = gSheepManager.Compile("ActionSheep", "{ " + sheepScriptText + " }");
+    mCustomAction.script.script = gSheepManager.CompileCached("ActionSheep", "{ " + sheepScriptText + " }");
 
     // Use normal action flow from here.
     ExecuteAction(&mCustomAction, finishCallback);
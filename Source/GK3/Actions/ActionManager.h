@@ -30,8 +30,6 @@ enum class VerbType
 class ActionManager
 {
 public:
-    ~ActionManager();
-
     void Init();
 
     // Action Set Population
@@ -197,7 +197,7 @@ void NVC::ParseFromData(uint8_t* data, uint32_t dataLength)
                 }
 
                 // Compile and save script.
-                action.script.script = gSheepManager.Compile("Case Evaluation", action.script.text);
+                action.script.script = gSheepManager.CompileCached("Case Evaluation", action.script.text);
             }
         }
 
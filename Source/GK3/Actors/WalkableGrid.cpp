@@ -0,0 +1,381 @@
+#include "WalkableGrid.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+namespace
+{
+    // Orders the open set heap so the lowest estimated total cost is on top.
+    typedef std::pair<float, uint32_t> CostAndIndex;
+    const std::greater<CostAndIndex> kOpenSetOrder;
+
+    int32_t Sign(int32_t value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    void SquaredDistanceTransform1D(const float* f, int count, float* outDistances, int* parabolaCells, float* parabolaBounds)
+    {
+        // One dimensional squared distance transform (Felzenszwalb & Huttenlocher).
+        // Each cell defines a parabola rooted at f[cell]. The result for each cell is the lowest of all parabolas at that cell.
+        // First, find the lower envelope of all the parabolas, and the ranges where each one is lowest.
+        int envelopeIndex = 0;
+        parabolaCells[0] = 0;
+        parabolaBounds[0] = -FLT_MAX;
+        parabolaBounds[1] = FLT_MAX;
+        for(int q = 1; q < count; ++q)
+        {
+            // Where does this parabola intersect the rightmost one in the envelope?
+            // If it's left of where that one starts being lowest, that one is never lowest - remove it and try again.
+            // The first parabola's range starts at -infinity, so it's never removed.
+            int v = parabolaCells[envelopeIndex];
+            float intersection = ((f[q] + q * q) - (f[v] + v * v)) / (2.0f * (q - v));
+            while(intersection <= parabolaBounds[envelopeIndex])
+            {
+                --envelopeIndex;
+                v = parabolaCells[envelopeIndex];
+                intersection = ((f[q] + q * q) - (f[v] + v * v)) / (2.0f * (q - v));
+            }
+
+            ++envelopeIndex;
+            parabolaCells[envelopeIndex] = q;
+            parabolaBounds[envelopeIndex] = intersection;
+            parabolaBounds[envelopeIndex + 1] = FLT_MAX;
+        }
+
+        // Then, fill in each cell from whichever parabola is lowest there.
+        envelopeIndex = 0;
+        for(int q = 0; q < count; ++q)
+        {
+            while(parabolaBounds[envelopeIndex + 1] < q)
+            {
+                ++envelopeIndex;
+            }
+            int v = parabolaCells[envelopeIndex];
+            outDistances[q] = (q - v) * (q - v) + f[v];
+        }
+    }
+
+    float OctileDistance(int32_t fromX, int32_t fromY, int32_t toX, int32_t toY)
+    {
+        // Cost of moving between two cells if only straight and diagonal moves are allowed.
+        const float kDiagonalCost = 1.41421356f;
+        int32_t dx = std::abs(toX - fromX);
+        int32_t dy = std::abs(toY - fromY);
+        int32_t diagonal = std::min(dx, dy);
+        int32_t straight = std::max(dx, dy) - diagonal;
+        return straight + diagonal * kDiagonalCost;
+    }
+}
+
+void WalkableGrid::Resize(uint32_t width, uint32_t height)
+{
+    mWidth = width;
+    mHeight = height;
+    mBits.assign((static_cast<size_t>(width) * height + 63) / 64, 0);
+}
+
+void WalkableGrid::SetWalkable(uint32_t x, uint32_t y, bool walkable)
+{
+    if(x >= mWidth || y >= mHeight) { return; }
+    uint32_t index = y * mWidth + x;
+    if(walkable)
+    {
+        mBits[index >> 6] |= (1ULL << (index & 63));
+    }
+    else
+    {
+        mBits[index >> 6] &= ~(1ULL << (index & 63));
+    }
+}
+
+void WalkableGrid::CalculateWallDistances(std::vector<float>& outDistances) const
+{
+    outDistances.assign(static_cast<size_t>(mWidth) * mHeight, 0.0f);
+    if(outDistances.empty()) { return; }
+
+    // Work on a grid with a border of unwalkable cells, so that the edges of the grid count as walls.
+    // Since there's always a wall somewhere, every distance is less than this "far" value, which is used in place of infinity.
+    int paddedWidth = static_cast<int>(mWidth) + 2;
+    int paddedHeight = static_cast<int>(mHeight) + 2;
+    float far = static_cast<float>(paddedWidth * paddedWidth + paddedHeight * paddedHeight);
+    std::vector<float> squaredDistances(static_cast<size_t>(paddedWidth) * paddedHeight);
+
+    // Working memory for each 1D transform.
+    int maxCount = std::max(paddedWidth, paddedHeight);
+    std::vector<float> f(maxCount);
+    std::vector<float> distances(maxCount);
+    std::vector<int> parabolaCells(maxCount);
+    std::vector<float> parabolaBounds(maxCount + 1);
+
+    // Transform each column: distance to the nearest wall in the same column.
+    for(int x = 0; x < paddedWidth; ++x)
+    {
+        for(int y = 0; y < paddedHeight; ++y)
+        {
+            f[y] = IsWalkable(x - 1, y - 1) ? far : 0.0f;
+        }
+        SquaredDistanceTransform1D(f.data(), paddedHeight, distances.data(), parabolaCells.data(), parabolaBounds.data());
+        for(int y = 0; y < paddedHeight; ++y)
+        {
+            squaredDistances[y * paddedWidth + x] = distances[y];
+        }
+    }
+
+    // Transform each row of the column results, which gives the distance to the nearest wall anywhere.
+    for(int y = 1; y < paddedHeight - 1; ++y)
+    {
+        SquaredDistanceTransform1D(&squaredDistances[y * paddedWidth], paddedWidth, distances.data(), parabolaCells.data(), parabolaBounds.data());
+        for(int x = 1; x < paddedWidth - 1; ++x)
+        {
+            outDistances[(y - 1) * mWidth + (x - 1)] = std::sqrt(distances[x]);
+        }
+    }
+}
+
+bool WalkableGrid::FindPath(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, SearchScratch& scratch) const
+{
+    outPath.clear();
+    uint32_t nodeCount = mWidth * mHeight;
+    if(nodeCount == 0) { return false; }
+
+    // Start and goal must be in the grid. The start doesn't need to be walkable, but the goal does.
+    int32_t startX = static_cast<int32_t>(start.x);
+    int32_t startY = static_cast<int32_t>(start.y);
+    int32_t goalX = static_cast<int32_t>(goal.x);
+    int32_t goalY = static_cast<int32_t>(goal.y);
+    if(startX < 0 || startY < 0 || startX >= static_cast<int32_t>(mWidth) || startY >= static_cast<int32_t>(mHeight)) { return false; }
+    if(!IsWalkable(goalX, goalY)) { return false; }
+
+    // If start and goal are the same point, we technically found a path.
+    uint32_t startIndex = startY * mWidth + startX;
+    uint32_t goalIndex = goalY * mWidth + goalX;
+    if(startIndex == goalIndex) { return true; }
+
+    // Make sure node set is the right size. Resizing doesn't reduce capacity, so this only allocates for the largest grid seen.
+    std::vector<SearchScratch::Node>& nodes = scratch.nodes;
+    if(nodes.size() < nodeCount)
+    {
+        nodes.resize(nodeCount);
+    }
+
+    // Start a new search. On the rare occasion the id wraps around, old state must be cleared for real.
+    ++scratch.searchId;
+    if(scratch.searchId == 0)
+    {
+        for(SearchScratch::Node& node : nodes)
+        {
+            node.searchId = 0;
+        }
+        scratch.searchId = 1;
+    }
+    std::vector<CostAndIndex>& openSet = scratch.openSet;
+    openSet.clear();
+
+    // Put the start node on the open set.
+    SearchScratch::Node& startNode = nodes[startIndex];
+    startNode.cost = 0.0f;
+    startNode.parentIndex = startIndex;
+    startNode.searchId = scratch.searchId;
+    startNode.closed = false;
+    openSet.emplace_back(OctileDistance(startX, startY, goalX, goalY), startIndex);
+
+    bool foundPath = false;
+    int32_t directions[8][2];
+    while(!openSet.empty())
+    {
+        std::pop_heap(openSet.begin(), openSet.end(), kOpenSetOrder);
+        uint32_t currentIndex = openSet.back().second;
+        openSet.pop_back();
+
+        // The same node can be on the open set several times if a cheaper route was found - only the first one popped counts.
+        SearchScratch::Node& current = nodes[currentIndex];
+        if(current.closed) { continue; }
+        current.closed = true;
+
+        if(currentIndex == goalIndex)
+        {
+            foundPath = true;
+            break;
+        }
+
+        // Figure out which directions to search from this node.
+        int32_t x = currentIndex % mWidth;
+        int32_t y = currentIndex / mWidth;
+        int directionCount = 0;
+        if(currentIndex == startIndex)
+        {
+            // The start node has no parent, so search in all directions.
+            for(int32_t dy = -1; dy <= 1; ++dy)
+            {
+                for(int32_t dx = -1; dx <= 1; ++dx)
+                {
+                    if(dx == 0 && dy == 0) { continue; }
+                    directions[directionCount][0] = dx;
+                    directions[directionCount][1] = dy;
+                    ++directionCount;
+                }
+            }
+        }
+        else
+        {
+            // Otherwise, only continue in the direction of travel, plus any directions made necessary by nearby obstacles.
+            // Anything else can be reached at least as cheaply by a path that doesn't pass through this node.
+            int32_t dx = Sign(x - static_cast<int32_t>(current.parentIndex % mWidth));
+            int32_t dy = Sign(y - static_cast<int32_t>(current.parentIndex / mWidth));
+            if(dx != 0 && dy != 0)
+            {
+                directions[directionCount][0] = dx;
+                directions[directionCount][1] = 0;
+                ++directionCount;
+                directions[directionCount][0] = 0;
+                directions[directionCount][1] = dy;
+                ++directionCount;
+                directions[directionCount][0] = dx;
+                directions[directionCount][1] = dy;
+                ++directionCount;
+                if(!IsWalkable(x - dx, y) && IsWalkable(x - dx, y + dy))
+                {
+                    directions[directionCount][0] = -dx;
+                    directions[directionCount][1] = dy;
+                    ++directionCount;
+                }
+                if(!IsWalkable(x, y - dy) && IsWalkable(x + dx, y - dy))
+                {
+                    directions[directionCount][0] = dx;
+                    directions[directionCount][1] = -dy;
+                    ++directionCount;
+                }
+            }
+            else if(dx != 0)
+            {
+                directions[directionCount][0] = dx;
+                directions[directionCount][1] = 0;
+                ++directionCount;
+                if(!IsWalkable(x, y + 1) && IsWalkable(x + dx, y + 1))
+                {
+                    directions[directionCount][0] = dx;
+                    directions[directionCount][1] = 1;
+                    ++directionCount;
+                }
+                if(!IsWalkable(x, y - 1) && IsWalkable(x + dx, y - 1))
+                {
+                    directions[directionCount][0] = dx;
+                    directions[directionCount][1] = -1;
+                    ++directionCount;
+                }
+            }
+            else
+            {
+                directions[directionCount][0] = 0;
+                directions[directionCount][1] = dy;
+                ++directionCount;
+                if(!IsWalkable(x + 1, y) && IsWalkable(x + 1, y + dy))
+                {
+                    directions[directionCount][0] = 1;
+                    directions[directionCount][1] = dy;
+                    ++directionCount;
+                }
+                if(!IsWalkable(x - 1, y) && IsWalkable(x - 1, y + dy))
+                {
+                    directions[directionCount][0] = -1;
+                    directions[directionCount][1] = dy;
+                    ++directionCount;
+                }
+            }
+        }
+
+        // Jump in each direction. Any jump point found is added to the open set.
+        float currentCost = current.cost;
+        for(int i = 0; i < directionCount; ++i)
+        {
+            int32_t jumpX = x;
+            int32_t jumpY = y;
+            if(!Jump(jumpX, jumpY, directions[i][0], directions[i][1], goalX, goalY)) { continue; }
+
+            uint32_t jumpIndex = jumpY * mWidth + jumpX;
+            SearchScratch::Node& jumpNode = nodes[jumpIndex];
+            if(jumpNode.searchId != scratch.searchId)
+            {
+                jumpNode.cost = FLT_MAX;
+                jumpNode.searchId = scratch.searchId;
+                jumpNode.closed = false;
+            }
+            if(jumpNode.closed) { continue; }
+
+            // Jumps are always in a straight line, so the octile distance is the exact cost of the jump.
+            float newCost = currentCost + OctileDistance(x, y, jumpX, jumpY);
+            if(newCost < jumpNode.cost)
+            {
+                jumpNode.cost = newCost;
+                jumpNode.parentIndex = currentIndex;
+                openSet.emplace_back(newCost + OctileDistance(jumpX, jumpY, goalX, goalY), jumpIndex);
+                std::push_heap(openSet.begin(), openSet.end(), kOpenSetOrder);
+            }
+        }
+    }
+    if(!foundPath) { return false; }
+
+    // Iterate back to start, pushing each jump point onto our path.
+    // This leaves the path with start node at back, goal node at front - caller can traverse back-to-front.
+    uint32_t currentIndex = goalIndex;
+    while(currentIndex != startIndex)
+    {
+        outPath.push_back(Vector2(currentIndex % mWidth, currentIndex / mWidth));
+        currentIndex = nodes[currentIndex].parentIndex;
+    }
+    outPath.push_back(Vector2(startX, startY));
+    return true;
+}
+
+bool WalkableGrid::Jump(int32_t& x, int32_t& y, int32_t dx, int32_t dy, int32_t goalX, int32_t goalY) const
+{
+    // Step in the given direction until we hit something unwalkable (no jump point) or find a jump point.
+    while(true)
+    {
+        x += dx;
+        y += dy;
+        if(!IsWalkable(x, y)) { return false; }
+
+        // The goal is always a jump point.
+        if(x == goalX && y == goalY) { return true; }
+
+        // Any cell with a forced neighbor is a jump point - the path may need to turn here to get around an obstacle.
+        if(HasForcedNeighbor(x, y, dx, dy)) { return true; }
+
+        // When moving diagonally, this is also a jump point if a horizontal or vertical jump from here finds one.
+        if(dx != 0 && dy != 0)
+        {
+            int32_t jumpX = x;
+            int32_t jumpY = y;
+            if(Jump(jumpX, jumpY, dx, 0, goalX, goalY)) { return true; }
+
+            jumpX = x;
+            jumpY = y;
+            if(Jump(jumpX, jumpY, 0, dy, goalX, goalY)) { return true; }
+        }
+    }
+}
+
+bool WalkableGrid::HasForcedNeighbor(int32_t x, int32_t y, int32_t dx, int32_t dy) const
+{
+    // A neighbor is "forced" if an obstacle next to this cell means the shortest path to that neighbor must go through this cell.
+    if(dx != 0 && dy != 0)
+    {
+        return (!IsWalkable(x - dx, y) && IsWalkable(x - dx, y + dy)) ||
+               (!IsWalkable(x, y - dy) && IsWalkable(x + dx, y - dy));
+    }
+    else if(dx != 0)
+    {
+        return (!IsWalkable(x, y + 1) && IsWalkable(x + dx, y + 1)) ||
+               (!IsWalkable(x, y - 1) && IsWalkable(x + dx, y - 1));
+    }
+    else
+    {
+        return (!IsWalkable(x + 1, y) && IsWalkable(x + 1, y + dy)) ||
+               (!IsWalkable(x - 1, y) && IsWalkable(x - 1, y + dy));
+    }
+}
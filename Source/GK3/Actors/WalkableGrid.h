@@ -0,0 +1,85 @@
+//
+// Clark Kromenaker
+//
+// A grid of walkable/unwalkable cells, packed one bit per cell.
+//
+// Also provides pathfinding over the grid using "jump point search" (JPS).
+// JPS is A* on a uniform cost grid, but it skips over runs of cells that can't affect the result.
+// It only adds "jump points" (where the path may need to turn) to the open set, so even long paths only touch a handful of nodes.
+//
+// Cells are connected to all 8 neighbors. A diagonal move is allowed as long as the destination cell is walkable.
+//
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Vector2.h"
+
+class WalkableGrid
+{
+public:
+    // Working memory for a path search.
+    // Since this lives outside the grid, any number of searches can run on the same grid at once (e.g. on different threads), each with its own scratch.
+    // Reusing a scratch for many searches avoids allocating for each search.
+    struct SearchScratch
+    {
+        struct Node
+        {
+            // Cost from the start to this node.
+            float cost = 0.0f;
+
+            // Index (in nodes list) of parent of this node.
+            uint32_t parentIndex = 0;
+
+            // The search this node's state belongs to. If it doesn't match the current search, the node is unvisited.
+            // This avoids resetting every node at the start of every search.
+            uint32_t searchId = 0;
+
+            // Is this node closed/explored in the current search?
+            bool closed = false;
+        };
+        std::vector<Node> nodes;
+        uint32_t searchId = 0;
+
+        // The open set, as a heap of estimated total cost and node index.
+        std::vector<std::pair<float, uint32_t>> openSet;
+    };
+
+    // Resizes the grid. All cells are unwalkable after a resize.
+    void Resize(uint32_t width, uint32_t height);
+
+    uint32_t GetWidth() const { return mWidth; }
+    uint32_t GetHeight() const { return mHeight; }
+
+    void SetWalkable(uint32_t x, uint32_t y, bool walkable);
+    bool IsWalkable(int32_t x, int32_t y) const
+    {
+        // Anything outside the grid is unwalkable.
+        if(x < 0 || y < 0 || x >= static_cast<int32_t>(mWidth) || y >= static_cast<int32_t>(mHeight)) { return false; }
+        uint32_t index = static_cast<uint32_t>(y) * mWidth + static_cast<uint32_t>(x);
+        return (mBits[index >> 6] & (1ULL << (index & 63))) != 0;
+    }
+
+    // Calculates, for every cell, the distance to the nearest unwalkable cell (anything outside the grid counts as unwalkable).
+    // Unwalkable cells have a distance of zero. Distances are measured between cell centers, so a walkable cell next to a wall has a distance of one.
+    // This is an exact Euclidean distance transform that runs in linear time.
+    void CalculateWallDistances(std::vector<float>& outDistances) const;
+
+    // Finds the shortest path from start to goal.
+    // The path is made up of jump points, with goal at the front and start at the back.
+    // Each point is connected to the next by a straight horizontal, vertical, or diagonal line of walkable cells.
+    // Returns false if no path exists, in which case the path is empty.
+    bool FindPath(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, SearchScratch& scratch) const;
+
+private:
+    // Size of the grid, in cells.
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+
+    // One bit per cell, set if the cell is walkable.
+    std::vector<uint64_t> mBits;
+
+    bool Jump(int32_t& x, int32_t& y, int32_t dx, int32_t dy, int32_t goalX, int32_t goalY) const;
+    bool HasForcedNeighbor(int32_t x, int32_t y, int32_t dx, int32_t dy) const;
+};
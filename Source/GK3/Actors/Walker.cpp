@@ -90,8 +90,9 @@ void Walker::WalkToSee(GKObject* target, const std::function<void()>& finishCall
     {
         WalkOp currentWalkOp = GetCurrentWalkOp();
 
-        // Time to create a new walk plan.
+        // Time to create a new walk plan. This replaces any walk that is still waiting on a path.
         mWalkActions.clear();
+        CancelPathQuery();
 
         // We don't need the item to be *exactly* in front of our face.
         // We only need to turn if the item is fairly far from our current facing direction.
@@ -162,6 +163,12 @@ void Walker::WalkOutOfRegion(int regionIndex, const Vector3& exitPosition, const
 
 void Walker::SkipToEnd(bool alsoSkipWalkEndAnim)
 {
+    // If still waiting on a path, we need it now to know where the walk ends.
+    if(mPathQuery != nullptr)
+    {
+        OnPathQueryDone();
+    }
+
     // If not walking, or at the end of the walk, nothing to skip.
     WalkOp currentWalkOp = GetCurrentWalkOp();
     if(currentWalkOp == WalkOp::None)
@@ -285,6 +292,9 @@ void Walker::StopWalk()
     mWalkActions.clear();
     mPrevWalkOp = WalkOp::None;
 
+    // If we were waiting on a path, we don't need it anymore.
+    CancelPathQuery();
+
     // No more finish callback needed
     mFinishedPathCallback = nullptr;
 
@@ -292,6 +302,16 @@ void Walker::StopWalk()
     StopAllWalkAnimations();
 }
 
+Vector3 Walker::GetDestination() const
+{
+    // If waiting on a path, the destination is wherever that walk is going.
+    if(mPathQuery != nullptr)
+    {
+        return mPendingWalk.position;
+    }
+    return mPath.size() > 0 ? mPath.front() : Vector3::Zero;
+}
+
 bool Walker::AtPosition(const Vector3& position, float maxDistance)
 {
     Vector3 myPosition = mGKOwner->GetPosition();
@@ -321,8 +341,30 @@ bool Walker::IsWalkAnimation(VertexAnimation* vertexAnim) const
     return false;
 }
 
+void Walker::OnDisable()
+{
+    // A disabled walker isn't updated, so it would never notice the path query is done, and would be "walking" forever.
+    // Finish the query now, so the walk plan is in place the same as if the path had been found right away.
+    if(mPathQuery != nullptr)
+    {
+        OnPathQueryDone();
+    }
+}
+
 void Walker::OnUpdate(float deltaTime)
 {
+    // Once the path for a walk request has been found, we can start the walk.
+    // If action skipping, we can't afford to wait a frame - the walk will be skipped to the end right away.
+    // And if the thread pool is too busy to get to the query in a reasonable time, stop waiting - OnPathQueryDone finds the path on this thread.
+    if(mPathQuery != nullptr)
+    {
+        mPathQueryTimer += deltaTime;
+        if(mPathQuery->IsDone() || mPathQueryTimer >= kMaxPathQueryWait || gActionManager.IsSkippingCurrentAction())
+        {
+            OnPathQueryDone();
+        }
+    }
+
     // Debug draw the path if desired.
     if(mPath.size() > 0 && Debug::GetFlag("ShowWalkerPaths"))
     {
@@ -486,6 +528,58 @@ void Walker::OnUpdate(float deltaTime)
 }
 
 void Walker::WalkToInternal(const Vector3& position, const Heading& heading, const std::function<void()>& finishCallback, bool fromAutoscript, bool mustReachDestination)
+{
+    // A new walk replaces any walk that is still waiting on a path.
+    CancelPathQuery();
+
+    // If we need to walk somewhere, find a path on a background thread.
+    // The walk plan is created once the path is found - see OnPathQueryDone. When action skipping, there's no need for a path at all.
+    if(mWalkerBoundary != nullptr && !gActionManager.IsSkippingCurrentAction())
+    {
+        Vector3 walkPosition = position;
+        walkPosition.y = gSceneManager.GetScene()->GetFloorY(position);
+        if(!AtPosition(walkPosition))
+        {
+            // Any walk already in progress keeps going until the new plan is ready, but its finish callback is no longer wanted.
+            mFinishedPathCallback = nullptr;
+
+            mPendingWalk.position = position;
+            mPendingWalk.heading = heading;
+            mPendingWalk.finishCallback = finishCallback;
+            mPendingWalk.fromAutoscript = fromAutoscript;
+            mPendingWalk.mustReachDestination = mustReachDestination;
+            mPathQuery = mWalkerBoundary->FindPathAsync(GetOwner()->GetPosition(), walkPosition);
+            mPathQueryTimer = 0.0f;
+            return;
+        }
+    }
+
+    // No path needed, so the walk plan can be created right away.
+    CreateWalkPlan(position, heading, finishCallback, fromAutoscript, mustReachDestination, nullptr);
+}
+
+void Walker::OnPathQueryDone()
+{
+    // Make sure the query is actually done - when skipping, we may not have been able to wait until it was.
+    // Take the query and request first, in case creating the walk plan causes another walk request.
+    std::shared_ptr<WalkerBoundary::PathQuery> pathQuery = std::move(mPathQuery);
+    mPathQuery = nullptr;
+    pathQuery->Wait();
+
+    WalkRequest walk = std::move(mPendingWalk);
+    mPendingWalk = WalkRequest();
+    CreateWalkPlan(walk.position, walk.heading, walk.finishCallback, walk.fromAutoscript, walk.mustReachDestination, pathQuery.get());
+}
+
+void Walker::CancelPathQuery()
+{
+    // The query may still be running, but it holds its own reference to the results, so it's safe to just let it go.
+    mPathQuery = nullptr;
+    mPendingWalk = WalkRequest();
+}
+
+void Walker::CreateWalkPlan(const Vector3& position, const Heading& heading, const std::function<void()>& finishCallback, bool fromAutoscript, bool mustReachDestination,
+                            WalkerBoundary::PathQuery* pathQuery)
 {
     // Save if from autoscript.
     mFromAutoscript = fromAutoscript;
@@ -530,12 +624,26 @@ void Walker::WalkToInternal(const Vector3& position, const Heading& heading, con
     {
         mPath.clear();
 
-        // Attempt to find a path between current position and walk position.
+        // Use the path between current position and walk position, if one was found.
         Vector3 startPos = GetOwner()->GetPosition();
         Vector3 endPos = walkPosition;
-        if(mWalkerBoundary != nullptr)
+        if(pathQuery != nullptr)
         {
-            mWalkerBoundary->FindPath(startPos, endPos, mPath);
+            mPath.swap(pathQuery->path);
+
+            // The path starts from wherever we were when the query started. If we kept walking since then, that start is out of date.
+            // Start from here instead, as long as we can walk straight from here to the next node. Otherwise, find a new path from here.
+            if(mWalkerBoundary != nullptr && !AtPosition(pathQuery->fromWorldPos, 1.0f))
+            {
+                if(mPath.size() >= 2 && mWalkerBoundary->IsWalkableLine(startPos, mPath[mPath.size() - 2]))
+                {
+                    mPath.back() = startPos;
+                }
+                else
+                {
+                    mWalkerBoundary->FindPath(startPos, endPos, mPath);
+                }
+            }
         }
 
         // Whether a path was found or not actually isn't that important here - even when a path isn't found, mPath contains a "best effort" to get close to the goal.
@@ -953,6 +1061,30 @@ bool Walker::SkipPathNodesOutsideFrustum()
         mPath.pop_back();
     }
 
+    // Path nodes are only placed where the path turns, so they can be far apart - the last needed node may be well outside the view.
+    // So, also skip along the path from that node toward the first node in view, up until the point where the character would come into view.
+    if(firstInFrustumIndex >= 0)
+    {
+        Vector3 fromPos = mPath.back();
+        Vector3 toNext = mPath[mPath.size() - 2] - fromPos;
+        float distToNext = toNext.GetLength();
+        if(distToNext > 0.0f)
+        {
+            const float kStepDist = 10.0f;
+            Vector3 dirToNext = toNext / distToNext;
+            for(float dist = kStepDist; dist < distToNext; dist += kStepDist)
+            {
+                Vector3 pos = fromPos + dirToNext * dist;
+                if(frustum.ContainsPoint(pos) || frustum.ContainsPoint(pos + Vector3::UnitY * mCharConfig->walkerHeight))
+                {
+                    break;
+                }
+                mPath.back() = pos;
+            }
+            dirFromLastPoppedNode = dirToNext;
+        }
+    }
+
     // Calculate skip heading.
     Heading warpHeading = Heading::FromDirection(dirFromLastPoppedNode);
 
@@ -969,30 +1101,6 @@ bool Walker::SkipPathNodesOutsideFrustum()
     return true;
 }
 
-void Walker::RemoveExcessPathNodes()
-{
-    // If path is long enough, attempt to remove nodes that are too close to one another.
-    if(mPath.size() > 2)
-    {
-        const float kCloseDist = 5.0f;
-        Vector3 prev = mPath[0];
-        for(auto it = mPath.begin() + 1; it != mPath.end() - 1;)
-        {
-            // If this node is too close to the previous node, remove it.
-            Vector3 curr = *it;
-            if((curr - prev).GetLengthSq() < kCloseDist * kCloseDist)
-            {
-                it = mPath.erase(it);
-            }
-            else
-            {
-                prev = curr;
-                ++it;
-            }
-        }
-    }
-}
-
 bool Walker::AdvancePath()
 {
     if(!mPath.empty())
@@ -10,19 +10,20 @@
 #include "Component.h"
 
 #include <functional>
+#include <memory>
 #include <vector>
 
+#include "Heading.h"
 #include "Vector3.h"
+#include "WalkerBoundary.h"
 
 class Animation;
 struct CharacterConfig;
 class GKActor;
 class GKObject;
 class GKProp;
-class Heading;
 class Texture;
 class VertexAnimation;
-class WalkerBoundary;
 
 class Walker : public Component
 {
@@ -46,13 +47,14 @@ public:
     void StopWalk();
 
     bool AtPosition(const Vector3& position, float maxDistance = kAtNodeDist);
-    bool IsWalking() const { return mWalkActions.size() > 0; }
-    bool IsWalkingExceptTurn() const { return IsWalking() && mWalkActions.back() != WalkOp::TurnToFace; }
-    Vector3 GetDestination() const { return mPath.size() > 0 ? mPath.front() : Vector3::Zero; }
+    bool IsWalking() const { return mWalkActions.size() > 0 || mPathQuery != nullptr; }
+    bool IsWalkingExceptTurn() const { return mPathQuery != nullptr || (IsWalking() && mWalkActions.back() != WalkOp::TurnToFace); }
+    Vector3 GetDestination() const;
 
     bool IsWalkAnimation(VertexAnimation* vertexAnim) const;
 
 protected:
+    void OnDisable() override;
     void OnUpdate(float deltaTime) override;
 
 private:
@@ -67,6 +69,9 @@ private:
     static constexpr float kWalkTurnSpeedMax = Math::k2Pi;
     static constexpr float kTurnSpeed = Math::k2Pi;
 
+    // How long to wait for a path query before giving up on the thread pool and finding the path on the main thread.
+    static constexpr float kMaxPathQueryWait = 0.1f;
+
     // CONFIG
     // Walker's owner, as a GKActor.
     GKActor* mGKOwner = nullptr;
@@ -129,12 +134,31 @@ private:
     // If true, need to continue walk anim during next update loop.
     bool mNeedContinueWalkAnim = false;
 
+    // PATH QUERIES
+    // Paths are found on a background thread, so a walk plan can't be created until the path query is done.
+    // In the meantime, the walk request is saved here. Any previous walk plan keeps going until the new one is ready.
+    struct WalkRequest
+    {
+        Vector3 position;
+        Heading heading = Heading::None;
+        std::function<void()> finishCallback;
+        bool fromAutoscript = false;
+        bool mustReachDestination = false;
+    };
+    WalkRequest mPendingWalk;
+    std::shared_ptr<WalkerBoundary::PathQuery> mPathQuery;
+    float mPathQueryTimer = 0.0f;
+
     // REGION SUPPORT
     // A callback for exiting a region.
     int mExitRegionIndex = -1;
     std::function<void()> mExitRegionCallback = nullptr;
 
     void WalkToInternal(const Vector3& position, const Heading& heading, const std::function<void()>& finishCallback, bool fromAutoscript, bool mustReachDestination);
+    void OnPathQueryDone();
+    void CancelPathQuery();
+    void CreateWalkPlan(const Vector3& position, const Heading& heading, const std::function<void()>& finishCallback, bool fromAutoscript, bool mustReachDestination,
+                        WalkerBoundary::PathQuery* pathQuery);
 
     void PopAndNextAction();
     void NextAction();
@@ -146,7 +170,6 @@ private:
     bool IsWalkToSeeTargetInView(const Vector3& headPosition, Vector3& outTurnToFaceDir) const;
 
     bool SkipPathNodesOutsideFrustum();
-    void RemoveExcessPathNodes();
 
     bool AdvancePath();
     void UpdateNextNodesYPos();
@@ -1,11 +1,16 @@
 #include "WalkerBoundary.h"
 
+#include <algorithm>
+#include <mutex>
 #include <queue>
 
 #include "Debug.h"
 #include "GMath.h"
+#include "Random.h"
+#include "ReportManager.h"
 #include "ResizableQueue.h"
 #include "Texture.h"
+#include "Timers.h"
 
 namespace
 {
@@ -31,8 +36,95 @@ namespace
     }
 }
 
-bool WalkerBoundary::FindPath(const Vector3& fromWorldPos, const Vector3& toWorldPos, std::vector<Vector3>& outPath)
+namespace
 {
+    // The nodes used to track state during BFS pathfinding search.
+    struct BFSNode
+    {
+        // Index (in nodes list) of parent of this node.
+        size_t parentIndex = 0;
+
+        // Is this node closed/explored in the current search?
+        bool closed = false;
+    };
+
+    // A subclass of the built-in priority queue that provides a "clear" function, and orders elements appropriately for A*
+    typedef std::pair<uint32_t, size_t> CostAndIndex;
+    class AStarPriorityQueue : public std::priority_queue<CostAndIndex, std::vector<CostAndIndex>, std::greater<CostAndIndex>>
+    {
+    public:
+        void clear()
+        {
+            this->c.clear();
+        }
+    };
+}
+
+struct WalkerBoundary::PathScratch
+{
+    // For jump point search.
+    WalkableGrid::SearchScratch gridScratch;
+
+    // For BFS search.
+    std::vector<BFSNode> nodes;
+    ResizableQueue<size_t> openSet;
+
+    // For A* search: the open set, each node's parent, and the g(x) cost and f(x) priority for each node.
+    AStarPriorityQueue openSetAS;
+    std::vector<size_t> parents;
+    std::vector<uint32_t> g;
+    std::vector<uint32_t> f;
+};
+
+// Takes a scratch from the pool (or creates one, if the pool is empty), and returns it to the pool when done.
+class WalkerBoundary::ScopedPathScratch
+{
+public:
+    ScopedPathScratch()
+    {
+        std::lock_guard<std::mutex> lock(sPoolMutex);
+        if(!sPool.empty())
+        {
+            mScratch = std::move(sPool.back());
+            sPool.pop_back();
+        }
+        else
+        {
+            mScratch.reset(new PathScratch());
+        }
+    }
+
+    ~ScopedPathScratch()
+    {
+        std::lock_guard<std::mutex> lock(sPoolMutex);
+        sPool.push_back(std::move(mScratch));
+    }
+
+    PathScratch& Get() { return *mScratch; }
+
+private:
+    // Each path query needs its own scratch memory, so that queries can run on several threads at once.
+    // But scratch memory for large walker boundaries is big, so rather than allocate it per query, it's pooled.
+    // The pool grows to the number of queries that have run at the same time, and memory is reused after that.
+    static std::mutex sPoolMutex;
+    static std::vector<std::unique_ptr<PathScratch>> sPool;
+
+    std::unique_ptr<PathScratch> mScratch;
+};
+std::mutex WalkerBoundary::ScopedPathScratch::sPoolMutex;
+std::vector<std::unique_ptr<WalkerBoundary::PathScratch>> WalkerBoundary::ScopedPathScratch::sPool;
+
+WalkerBoundary::~WalkerBoundary()
+{
+    // Queries in progress are using this boundary, so they must finish first.
+    WaitForPathQueries();
+}
+
+bool WalkerBoundary::FindPath(const Vector3& fromWorldPos, const Vector3& toWorldPos, std::vector<Vector3>& outPath) const
+{
+    // Get scratch memory for this query.
+    ScopedPathScratch scratch;
+
     // Make sure path vector is empty.
     outPath.clear();
 
@@ -62,171 +154,28 @@ bool WalkerBoundary::FindPath(const Vector3& fromWorldPos, const Vector3& toWorl
         start = FindNearestWalkableTexturePosToWorldPos(fromWorldPos);
     }
 
-    // Use BFS to find a path.
-    // I have implementations of both BFS and A* below - I've consistently found BFS to have better performance and results than A*.
-    // In hindsight, I think this is because: a) the graph has a ton of nodes, and b) edges between nodes _aren't really_ weighted.
-
-    // The loop here is to try using sparser graphs (and save a lot of time) if we can.
-    // In a complex scene with a large walker boundary texture, the number of grid nodes is very large (170k in one case).
-    // Usually, the system can successfully find a path when skipping a lot of those nodes. But worst case, we can use all nodes.
-    bool foundPath = false;
+    // Use jump point search (A* that skips over straight runs of the grid) to find a path.
+    // This works on the full resolution walkable grid, but only visits the points where the path might turn, so it is fast even in large scenes.
+    // The path only contains the jump points, which are usually far apart. The smoothing below works on those directly.
     std::vector<Vector2> path;
-    while(!foundPath)
+    bool foundPath = mWalkableGrid.FindPath(start, goal, path, scratch.Get().gridScratch);
+    if(!foundPath)
     {
-        foundPath = FindPathBFS(start, goal, path, mPathfindingNodeSkip);
-        if(!foundPath)
-        {
-            if(mPathfindingNodeSkip > 1)
-            {
-                printf("Failed to find path - trying again with higher fidelity\n");
-                mPathfindingNodeSkip /= 2;
-            }
-            else
-            {
-                // If skip interval is already 1, we can't get any higher fidelity - the path just doesn't exist.
-                break;
-            }
-        }
+        // No path to the goal exists. In that case, BFS can generate a "best effort" path that gets as close to the goal as possible.
+        // This is slower, but it should be rare.
+        FindPathBFS(start, goal, path, scratch.Get());
     }
 
     // If a path was generated, do some conditioning on it to make it look more intelligent.
     // Note that a path can be generated, even if "foundPath" is false. In that case, the path is a "best effort" to get close to the goal.
     if(!path.empty())
     {
-        // Ok, we found a path, but it's probably too close to walls and such.
-        // So, let's try to condition it a little bit to fix that.
-        for(int i = path.size() - 1; i >= 0; --i)
-        {
-            // We should ignore the first few nodes and last few nodes when doing conditioning.
-            // This is because start/end nodes are _exact_ destinations (i.e. character starts here and wants to get there - don't mess with it).
-            const int kFuzzyIgnore = 1;
-            if(i >= path.size() - kFuzzyIgnore) { continue; }
-            if(i < kFuzzyIgnore) { break; }
-
-            // Palette indexes on walker boundary textures provide some indication of how "walkable" the current position is.
-            // Palette index 255 (black) is completely unwalkable, and should already have been discarded by the BFS.
-            // Palette indexes 127 or less are walkable, but a lower index is preferrable if available.
-            // Palette indexes 128 or greater are conditionally walkable (the game can turn them on or off). But if walkable, they should be considered walkable as-is (BFS figures that out).
-
-            // ANYWAY, here's the idea: if the current index is less than 128, see if a neighbor is a lower palette index.
-            // If so, we will want to walk there instead. If no, this is a less than ideal place to walk, but at least it is walkable.
-            int index = mTexture->GetPaletteIndex(path[i].x, path[i].y);
-            if(index < 128)
-            {
-                while(true)
-                {
-                    // If any up/down/left/right has a lower palette index, go there!
-                    if(mTexture->GetPaletteIndex(path[i].x + 1, path[i].y) < index)
-                    {
-                        path[i].x += 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x - 1, path[i].y) < index)
-                    {
-                        path[i].x -= 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x, path[i].y + 1) < index)
-                    {
-                        path[i].y += 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x, path[i].y - 1) < index)
-                    {
-                        path[i].y -= 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x + 1, path[i].y + 1) < index)
-                    {
-                        path[i].x += 1;
-                        path[i].y += 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x + 1, path[i].y - 1) < index)
-                    {
-                        path[i].x += 1;
-                        path[i].y -= 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x - 1, path[i].y - 1) < index)
-                    {
-                        path[i].x -= 1;
-                        path[i].y -= 1;
-                    }
-                    else if(mTexture->GetPaletteIndex(path[i].x - 1, path[i].y + 1) < index)
-                    {
-                        path[i].x -= 1;
-                        path[i].y += 1;
-                    }
-                    else
-                    {
-                        // No neighbor is more walkable, so break out of this loop.
-                        break;
-                    }
-
-                    // Update index being considered for next run through loop.
-                    index = mTexture->GetPaletteIndex(path[i].x, path[i].y);
-
-                    // If the palette index is below some threshold, we're in an "acceptably walkable" zone, so we can stop iterating.
-                    if(index < 4)
-                    {
-                        break;
-                    }
-                }
-            }
-        }
-
-        // This is a sort of "string pulling" algorithm:
-        // Given three points, if we can walk directly between the first and third point, we can get rid of the second point.
-        if(path.size() > 2)
-        {
-            int startNodeIndex = 0;
-            int endNodeIndex = startNodeIndex + 2;
-            int erasedNodeCount = 0;
-
-            while(endNodeIndex < path.size())
-            {
-                Vector2 current = path[startNodeIndex];
-                Vector2 end = path[endNodeIndex];
-
-                bool canWalk = true;
-                while(current != end)
-                {
-                    MoveToward(current, end);
-
-                    if(!IsTexturePosWalkable(current))
-                    {
-                        canWalk = false;
-                        break;
-                    }
-                    else
-                    {
-                        int paletteIndex = mTexture->GetPaletteIndex(current.x, current.y);
-                        if(paletteIndex > 6 && paletteIndex < 128)
-                        {
-                            canWalk = false;
-                            break;
-                        }
-                    }
-                }
-
-                if(canWalk)
-                {
-                    // In this case, we erase the intermediate node.
-                    // "endNodeIndex" stays the same, and we try again with the next three positions in the path.
-                    path.erase(path.begin() + startNodeIndex + 1);
-                    ++erasedNodeCount;
-                }
+        // Only keep the nodes where the walker actually needs to turn.
+        RemoveUnneededPathNodes(path);
 
-                // In this case, there wasn't a straight line between start/end, so the middle node was important for the path.
-                // Move up to that middle node, and do checks from there now.
-                if(!canWalk)
-                {
-                    ++startNodeIndex;
-                    endNodeIndex = startNodeIndex + 2;
-                }
-                else if(erasedNodeCount > 3) // don't erase TOO many points - set a limit before moving on
-                {
-                    ++startNodeIndex;
-                    endNodeIndex = startNodeIndex + 2;
-                    erasedNodeCount = 0;
-                }
-            }
-        }
+        // The shortest path hugs walls and cuts corners as tightly as possible, which doesn't look natural.
+        // So, move the remaining waypoints away from walls where there's room to do so.
+        MovePathAwayFromWalls(path);
 
         // Convert texture-space path to world-space path.
         for(auto& node : path)
@@ -240,6 +189,72 @@ bool WalkerBoundary::FindPath(const Vector3& fromWorldPos, const Vector3& toWorl
     return foundPath;
 }
 
+void WalkerBoundary::SetTexture(Texture* texture)
+{
+    WaitForPathQueries();
+    mTexture = texture;
+
+    // Find the area of the texture covered by each region.
+    for(RegionBounds& bounds : mRegionBounds)
+    {
+        bounds = RegionBounds();
+    }
+    if(mTexture == nullptr)
+    {
+        mWalkableGrid.Resize(0, 0);
+        mWallDistances.clear();
+        return;
+    }
+    int width = static_cast<int>(mTexture->GetWidth());
+    int height = static_cast<int>(mTexture->GetHeight());
+    for(int y = 0; y < height; ++y)
+    {
+        for(int x = 0; x < width; ++x)
+        {
+            RegionBounds& bounds = mRegionBounds[mTexture->GetPaletteIndex(x, y)];
+            bounds.minX = Math::Min(bounds.minX, x);
+            bounds.minY = Math::Min(bounds.minY, y);
+            bounds.maxX = Math::Max(bounds.maxX, x);
+            bounds.maxY = Math::Max(bounds.maxY, y);
+        }
+    }
+
+    // Build the walkable grid for the whole texture.
+    mWalkableGrid.Resize(width, height);
+    UpdateWalkableGrid(0, 0, width - 1, height - 1);
+    UpdateWallDistances();
+}
+
+std::shared_ptr<WalkerBoundary::PathQuery> WalkerBoundary::FindPathAsync(const Vector3& fromWorldPos, const Vector3& toWorldPos)
+{
+    // Forget about any queries that have already finished.
+    mPathQueryJobs.erase(std::remove_if(mPathQueryJobs.begin(), mPathQueryJobs.end(), [](JobHandle job) {
+        return ThreadPool::IsComplete(job);
+    }), mPathQueryJobs.end());
+
+    // The query is shared between the caller and the job, so it stays valid even if the caller loses interest before the job is done.
+    // The walker is waiting on the path to start walking, so don't let it queue up behind other background work (e.g. loading).
+    std::shared_ptr<PathQuery> query = std::make_shared<PathQuery>();
+    query->fromWorldPos = fromWorldPos;
+    query->job = ThreadPool::AddPriorityTask([this, query, fromWorldPos, toWorldPos]() {
+        query->foundPath = FindPath(fromWorldPos, toWorldPos, query->path);
+    });
+    mPathQueryJobs.push_back(query->job);
+    return query;
+}
+
+void WalkerBoundary::SetSize(const Vector2& size)
+{
+    WaitForPathQueries();
+    mSize = size;
+}
+
+void WalkerBoundary::SetOffset(const Vector2& offset)
+{
+    WaitForPathQueries();
+    mOffset = offset;
+}
+
 Vector3 WalkerBoundary::FindNearestWalkablePosition(const Vector3& worldPos) const
 {
     // Easy case: the position provided is already walkable.
@@ -250,17 +265,44 @@ Vector3 WalkerBoundary::FindNearestWalkablePosition(const Vector3& worldPos) con
     return TexturePosToWorldPos(walkableTexturePos);
 }
 
+bool WalkerBoundary::IsWalkableLine(const Vector3& fromWorldPos, const Vector3& toWorldPos) const
+{
+    // Both ends and everything in between must be walkable.
+    if(!IsWorldPosWalkable(fromWorldPos) || !IsWorldPosWalkable(toWorldPos)) { return false; }
+    return IsLineClear(WorldPosToTexturePos(fromWorldPos), WorldPosToTexturePos(toWorldPos), 1.0f);
+}
+
 void WalkerBoundary::SetRegionBlocked(int regionIndex, int regionBoundaryIndex, bool blocked)
 {
+    WaitForPathQueries();
+    bool changed = false;
     if(blocked)
     {
-        mUnwalkableRegions.insert(regionIndex);
-        mUnwalkableRegions.insert(regionBoundaryIndex);
+        changed |= mUnwalkableRegions.insert(regionIndex).second;
+        changed |= mUnwalkableRegions.insert(regionBoundaryIndex).second;
     }
     else
     {
-        mUnwalkableRegions.erase(regionIndex);
-        mUnwalkableRegions.erase(regionBoundaryIndex);
+        changed |= mUnwalkableRegions.erase(regionIndex) > 0;
+        changed |= mUnwalkableRegions.erase(regionBoundaryIndex) > 0;
+    }
+
+    // Update the walkable grid, but only in the areas covered by these regions.
+    if(changed)
+    {
+        bool gridChanged = false;
+        for(int index : { regionIndex, regionBoundaryIndex })
+        {
+            if(index >= 0 && index < 256)
+            {
+                const RegionBounds& bounds = mRegionBounds[index];
+                gridChanged |= UpdateWalkableGrid(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+            }
+        }
+        if(gridChanged)
+        {
+            UpdateWallDistances();
+        }
     }
 }
 
@@ -271,6 +313,8 @@ int WalkerBoundary::GetRegionIndex(const Vector3& worldPos)
 
 void WalkerBoundary::SetUnwalkableRect(const std::string& name, const Rect& worldRect)
 {
+    WaitForPathQueries();
+
     // If this name already exists, we'll update instead of add.
     int index = -1;
     for(size_t i = 0; i < mUnwalkableRects.size(); ++i)
@@ -290,24 +334,41 @@ void WalkerBoundary::SetUnwalkableRect(const std::string& name, const Rect& worl
     Vector2 textureMax = WorldPosToTexturePos(Vector3(worldMax.x, 0.0f, worldMax.y));
 
     // Add or replace unwalkable rect.
+    Rect textureRect(textureMin, textureMax);
+    bool gridChanged = false;
     if(index == -1)
     {
-        mUnwalkableRects.emplace_back(std::make_pair(name, Rect(textureMin, textureMax)));
+        mUnwalkableRects.emplace_back(std::make_pair(name, textureRect));
     }
     else
     {
-        mUnwalkableRects[index].second = Rect(textureMin, textureMax);
+        // The area covered by the old rect may be walkable again.
+        Rect oldTextureRect = mUnwalkableRects[index].second;
+        mUnwalkableRects[index].second = textureRect;
+        gridChanged |= UpdateWalkableGrid(oldTextureRect);
+    }
+    gridChanged |= UpdateWalkableGrid(textureRect);
+    if(gridChanged)
+    {
+        UpdateWallDistances();
     }
 }
 
 void WalkerBoundary::ClearUnwalkableRect(const std::string& name)
 {
+    WaitForPathQueries();
+
     // Find and erase by name.
     for(size_t i = 0; i < mUnwalkableRects.size(); ++i)
     {
         if(StringUtil::EqualsIgnoreCase(mUnwalkableRects[i].first, name))
         {
+            Rect textureRect = mUnwalkableRects[i].second;
             mUnwalkableRects.erase(mUnwalkableRects.begin() + i);
+            if(UpdateWalkableGrid(textureRect))
+            {
+                UpdateWallDistances();
+            }
             return;
         }
     }
@@ -323,6 +384,67 @@ void WalkerBoundary::DrawUnwalkableRects()
     }
 }
 
+void WalkerBoundary::BenchmarkPathfinding(int queryCount)
+{
+    if(queryCount <= 0 || mTexture == nullptr) { return; }
+
+    // Generate random start/goal positions within the walker boundary.
+    std::vector<std::pair<Vector3, Vector3>> queries(queryCount);
+    for(auto& query : queries)
+    {
+        query.first = TexturePosToWorldPos(Vector2(Random::Range(0, mTexture->GetWidth()), Random::Range(0, mTexture->GetHeight())));
+        query.second = TexturePosToWorldPos(Vector2(Random::Range(0, mTexture->GetWidth()), Random::Range(0, mTexture->GetHeight())));
+    }
+
+    // Run the queries one at a time on this thread, tracking the slowest one.
+    int foundCount = 0;
+    float slowestMs = 0.0f;
+    std::vector<Vector3> path;
+    Stopwatch stopwatch;
+    for(auto& query : queries)
+    {
+        Stopwatch queryStopwatch;
+        if(FindPath(query.first, query.second, path))
+        {
+            ++foundCount;
+        }
+        slowestMs = Math::Max(slowestMs, queryStopwatch.GetMilliseconds());
+    }
+    float syncMs = stopwatch.GetMilliseconds();
+
+    // Run them again, all at once, on the thread pool.
+    stopwatch.Reset();
+    std::vector<std::shared_ptr<PathQuery>> asyncQueries;
+    for(auto& query : queries)
+    {
+        asyncQueries.push_back(FindPathAsync(query.first, query.second));
+    }
+    int asyncFoundCount = 0;
+    for(auto& asyncQuery : asyncQueries)
+    {
+        asyncQuery->Wait();
+        if(asyncQuery->foundPath)
+        {
+            ++asyncFoundCount;
+        }
+    }
+    float asyncMs = stopwatch.GetMilliseconds();
+
+    gReportManager.Log("Dump", StringUtil::Format("Walker boundary %s (%ux%u): %d queries, %d paths found", mTexture->GetName().c_str(),
+                                                  mTexture->GetWidth(), mTexture->GetHeight(), queryCount, foundCount));
+    gReportManager.Log("Dump", StringUtil::Format("Sync: %.3fms (%.3fms avg, %.3fms max), async: %.3fms, %d async paths found",
+                                                  syncMs, syncMs / queryCount, slowestMs, asyncMs, asyncFoundCount));
+}
+
+void WalkerBoundary::WaitForPathQueries()
+{
+    for(JobHandle job : mPathQueryJobs)
+    {
+        ThreadPool::WaitFor(job);
+    }
+    mPathQueryJobs.clear();
+}
+
 bool WalkerBoundary::IsWorldPosWalkable(const Vector3& worldPos) const
 {
     // Convert to texture position and check that.
@@ -330,6 +452,16 @@ bool WalkerBoundary::IsWorldPosWalkable(const Vector3& worldPos) const
 }
 
 bool WalkerBoundary::IsTexturePosWalkable(const Vector2& texturePos) const
+{
+    // Without a texture, there's no walkable grid. Just check regions/rects directly.
+    if(mTexture == nullptr)
+    {
+        return CalcTexturePosWalkable(texturePos);
+    }
+    return mWalkableGrid.IsWalkable(static_cast<int32_t>(texturePos.x), static_cast<int32_t>(texturePos.y));
+}
+
+bool WalkerBoundary::CalcTexturePosWalkable(const Vector2& texturePos) const
 {
     // Unwalkable if region associated with this texture pos is in the unwalkable regions set.
     if(mUnwalkableRegions.count(GetRegionForTexturePos(texturePos)) > 0)
@@ -350,6 +482,168 @@ bool WalkerBoundary::IsTexturePosWalkable(const Vector2& texturePos) const
     return true;
 }
 
+bool WalkerBoundary::UpdateWalkableGrid(int minX, int minY, int maxX, int maxY)
+{
+    // Clamp to the grid. If the area is empty or entirely outside the grid, there's nothing to do.
+    minX = Math::Max(minX, 0);
+    minY = Math::Max(minY, 0);
+    maxX = Math::Min(maxX, static_cast<int>(mWalkableGrid.GetWidth()) - 1);
+    maxY = Math::Min(maxY, static_cast<int>(mWalkableGrid.GetHeight()) - 1);
+    bool changed = false;
+    for(int y = minY; y <= maxY; ++y)
+    {
+        for(int x = minX; x <= maxX; ++x)
+        {
+            bool walkable = CalcTexturePosWalkable(Vector2(x, y));
+            if(walkable != mWalkableGrid.IsWalkable(x, y))
+            {
+                mWalkableGrid.SetWalkable(x, y, walkable);
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+bool WalkerBoundary::UpdateWalkableGrid(const Rect& textureRect)
+{
+    // Update all pixels that fall within the rect (edges included).
+    Vector2 min = textureRect.GetMin();
+    Vector2 max = textureRect.GetMax();
+    return UpdateWalkableGrid(static_cast<int>(Math::Ceil(min.x)), static_cast<int>(Math::Ceil(min.y)),
+                       static_cast<int>(Math::Floor(max.x)), static_cast<int>(Math::Floor(max.y)));
+}
+
+void WalkerBoundary::UpdateWallDistances()
+{
+    // Unlike the walkable grid, this can't be updated just in the changed area - a change can affect distances anywhere.
+    // The distance transform is linear time, but that's still a couple milliseconds for a 320x240 boundary, and several times that for larger ones.
+    // That's acceptable since walkable areas rarely change, and callers skip this if the grid didn't actually change.
+    mWalkableGrid.CalculateWallDistances(mWallDistances);
+}
+
+float WalkerBoundary::GetWallDistance(int x, int y) const
+{
+    // Anything outside the grid counts as a wall.
+    if(x < 0 || y < 0 || x >= static_cast<int>(mWalkableGrid.GetWidth()) || y >= static_cast<int>(mWalkableGrid.GetHeight())) { return 0.0f; }
+    return mWallDistances[y * mWalkableGrid.GetWidth() + x];
+}
+
+bool WalkerBoundary::IsLineClear(const Vector2& from, const Vector2& to, float minWallDistance) const
+{
+    // Checks every pixel along the line from/to, and each must be at least a certain distance from any wall.
+    // Since distances are in pixels, checking every half pixel or so catches any pixel the line passes through.
+    // But when a pixel is far from any wall, it's safe to skip ahead - nothing within (distance - minWallDistance) can be too close to a wall.
+    Vector2 toEnd = to - from;
+    float length = toEnd.GetLength();
+    if(length <= 0.0f)
+    {
+        return GetWallDistance(static_cast<int>(from.x), static_cast<int>(from.y)) >= minWallDistance;
+    }
+
+    Vector2 dir = toEnd / length;
+    float distance = 0.0f;
+    while(true)
+    {
+        Vector2 pos = from + dir * distance;
+        float wallDistance = GetWallDistance(static_cast<int>(pos.x + 0.5f), static_cast<int>(pos.y + 0.5f));
+        if(wallDistance < minWallDistance) { return false; }
+        if(distance >= length) { return true; }
+        distance = Math::Min(distance + Math::Max(wallDistance - minWallDistance, 0.5f), length);
+    }
+}
+
+void WalkerBoundary::MovePathAwayFromWalls(std::vector<Vector2>& path) const
+{
+    // Don't move the first/last node - those are _exact_ start/end positions (i.e. character starts here and wants to get there - don't mess with it).
+    for(size_t i = 1; i + 1 < path.size(); ++i)
+    {
+        // Move toward open space (up the wall distance field) until far enough from walls, or no neighbor is any further from walls.
+        float wallDistance = GetWallDistance(static_cast<int>(path[i].x), static_cast<int>(path[i].y));
+        while(wallDistance < kPreferredWallDistance)
+        {
+            Vector2 best = path[i];
+            float bestWallDistance = wallDistance;
+            for(int dy = -1; dy <= 1; ++dy)
+            {
+                for(int dx = -1; dx <= 1; ++dx)
+                {
+                    float neighborWallDistance = GetWallDistance(static_cast<int>(path[i].x) + dx, static_cast<int>(path[i].y) + dy);
+                    if(neighborWallDistance > bestWallDistance)
+                    {
+                        best = Vector2(path[i].x + dx, path[i].y + dy);
+                        bestWallDistance = neighborWallDistance;
+                    }
+                }
+            }
+
+            // Moving the node must not disconnect it from the nodes before and after it.
+            if(bestWallDistance <= wallDistance || !IsLineClear(path[i - 1], best, 1.0f) || !IsLineClear(best, path[i + 1], 1.0f))
+            {
+                break;
+            }
+            path[i] = best;
+            wallDistance = bestWallDistance;
+        }
+    }
+}
+
+void WalkerBoundary::RemoveUnneededPathNodes(std::vector<Vector2>& path) const
+{
+    // This is a "string pulling" algorithm: starting at the start, find the furthest node we can walk to in a straight line.
+    // That's the next waypoint - all nodes before it can be removed. Repeat from there until reaching the goal.
+    if(path.size() <= 2) { return; }
+
+    // Path is from goal (front) to start (back), so work backwards.
+    std::vector<Vector2> waypoints;
+    int current = static_cast<int>(path.size()) - 1;
+    waypoints.push_back(path[current]);
+    while(current > 0)
+    {
+        // Staying away from walls looks better, so prefer lines with some space around them.
+        // But near a wall, we have no choice - don't require more space than the ends of the line have.
+        auto canWalkTo = [this, &path, current](int index) {
+            float minWallDistance = Math::Min(kPreferredWallDistance, GetWallDistance(static_cast<int>(path[current].x), static_cast<int>(path[current].y)));
+            minWallDistance = Math::Min(minWallDistance, GetWallDistance(static_cast<int>(path[index].x), static_cast<int>(path[index].y)));
+            return IsLineClear(path[current], path[index], Math::Max(minWallDistance, 1.0f));
+        };
+
+        // The next node is always reachable. Look further ahead in growing steps until a node can't be reached...
+        int reachable = current - 1;
+        int unreachable = -1;
+        for(int step = 2; reachable > 0; step *= 2)
+        {
+            int index = Math::Max(current - step, 0);
+            if(!canWalkTo(index))
+            {
+                unreachable = index;
+                break;
+            }
+            reachable = index;
+        }
+
+        // ...and then narrow down to the furthest reachable node between the last reachable and first unreachable ones.
+        while(reachable - unreachable > 1)
+        {
+            int index = (reachable + unreachable) / 2;
+            if(canWalkTo(index))
+            {
+                reachable = index;
+            }
+            else
+            {
+                unreachable = index;
+            }
+        }
+
+        current = reachable;
+        waypoints.push_back(path[current]);
+    }
+
+    // Put back in goal-to-start order.
+    path.assign(waypoints.rbegin(), waypoints.rend());
+}
+
 Vector2 WalkerBoundary::WorldPosToTexturePos(const Vector3& worldPos) const
 {
     // If no texture, the end result is going to be zero.
@@ -465,25 +759,7 @@ int WalkerBoundary::GetRegionForTexturePos(const Vector2& texturePos) const
     return mTexture->GetPaletteIndex(texturePos.x, texturePos.y);
 }
 
-namespace
-{
-    // The nodes used to track state during pathfinding search.
-    struct Node
-    {
-        // Index (in nodes list) of parent of this node.
-        size_t parentIndex = 0;
-
-        // Is this node closed/explored in the current search?
-        bool closed = false;
-    };
-    std::vector<Node> nodes;
-
-    // The open set when doing a pathfinding search.
-    // Each element is an index into the nodes array.
-    ResizableQueue<size_t> openSet;
-}
-
-bool WalkerBoundary::FindPathBFS(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, int nodeSkipInterval) const
+bool WalkerBoundary::FindPathBFS(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, PathScratch& scratch, int nodeSkipInterval) const
 {
     //TIMER_SCOPED("BFS");
 
@@ -496,6 +772,7 @@ bool WalkerBoundary::FindPathBFS(const Vector2& start, const Vector2& goal, std:
 
     // Make sure node set is the right size. When entering a new scene, a resize up or down will likely be needed.
     // Note that resizing doesn't ever reduce capacity, so this will eventually be the size of the largest texture in the current play session.
+    std::vector<BFSNode>& nodes = scratch.nodes;
     if(nodes.size() != nodeCount)
     {
         nodes.resize(nodeCount);
@@ -505,6 +782,7 @@ bool WalkerBoundary::FindPathBFS(const Vector2& start, const Vector2& goal, std:
     memset(&nodes[0], 0, sizeof(nodes[0]) * nodes.size());
 
     // Make sure open set is empty.
+    ResizableQueue<size_t>& openSet = scratch.openSet;
     openSet.Clear();
 
     // Make sure out path is clear.
@@ -596,7 +874,7 @@ bool WalkerBoundary::FindPathBFS(const Vector2& start, const Vector2& goal, std:
 
             // Ignore closed/explored neighbors.
             int neighborNodeIndex = static_cast<int>(neighbor.y * width + neighbor.x);
-            Node& neighborNode = nodes[neighborNodeIndex];
+            BFSNode& neighborNode = nodes[neighborNodeIndex];
             if(neighborNode.closed) { continue; }
 
             // Ignore any neighbor that is not walkable.
@@ -670,29 +948,7 @@ bool WalkerBoundary::FindPathBFS(const Vector2& start, const Vector2& goal, std:
     }
 }
 
-namespace
-{
-    // A subclass of the built-in priority queue that provides a "clear" function, and orders elements appropriately for A*
-    typedef std::pair<uint32_t, size_t> CostAndIndex;
-    class AStarPriorityQueue : public std::priority_queue<CostAndIndex, std::vector<CostAndIndex>, std::greater<CostAndIndex>>
-    {
-    public:
-        void clear()
-        {
-            this->c.clear();
-        }
-    };
-    AStarPriorityQueue openSetAS;
-
-    // Maps each node index to its parent.
-    std::vector<size_t> parents;
-
-    // The g(x) cost to each node, and the f(x) priority for each node.
-    std::vector<uint32_t> g;
-    std::vector<uint32_t> f;
-}
-
-bool WalkerBoundary::FindPathAStar(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath) const
+bool WalkerBoundary::FindPathAStar(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, PathScratch& scratch) const
 {
     //TIMER_SCOPED("A*");
 
@@ -704,6 +960,9 @@ bool WalkerBoundary::FindPathAStar(const Vector2& start, const Vector2& goal, st
 
     // Make sure node set is the right size. When entering a new scene, a resize up or down will likely be needed.
     // Note that resizing doesn't ever reduce capacity, so this will eventually be the size of the largest texture in the current play session.
+    std::vector<size_t>& parents = scratch.parents;
+    std::vector<uint32_t>& g = scratch.g;
+    std::vector<uint32_t>& f = scratch.f;
     if(parents.size() != nodeCount)
     {
         parents.resize(nodeCount);
@@ -717,6 +976,7 @@ bool WalkerBoundary::FindPathAStar(const Vector2& start, const Vector2& goal, st
     memset(&f[0], 0, sizeof(f[0]) * f.size());
 
     // Make sure open set is empty.
+    AStarPriorityQueue& openSetAS = scratch.openSetAS;
     openSetAS.clear();
 
     // Cache goal index to quickly check if we reached the goal.
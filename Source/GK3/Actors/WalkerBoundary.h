@@ -4,29 +4,59 @@
 // Encapsulates logic related to determining where a walker can walk in a scene,
 // the path it should take, and any debug/rendering helpers.
 //
+// Path queries can run on background threads. While any are in progress, changes to the boundary wait for them to finish.
+//
 #pragma once
+#include <climits>
+#include <memory>
 #include <vector>
 #include <unordered_set>
 
 #include "Rect.h"
+#include "ThreadPool.h"
 #include "Vector2.h"
 #include "Vector3.h"
+#include "WalkableGrid.h"
 
 class Texture;
 
 class WalkerBoundary
 {
 public:
-    bool FindPath(const Vector3& fromWorldPos, const Vector3& toWorldPos, std::vector<Vector3>& outPath);
+    // A path query running on a background thread.
+    // Poll IsDone (e.g. once per frame), and don't touch the results until it returns true.
+    struct PathQuery
+    {
+        // Where the path was found from. The walker may have moved on since then.
+        Vector3 fromWorldPos;
+
+        // The path, with goal at front and start at back - same as FindPath.
+        std::vector<Vector3> path;
+
+        // Whether a path to the goal was found. Even if not, the path may be a "best effort" to get close to the goal.
+        bool foundPath = false;
+
+        // The job doing the query.
+        JobHandle job;
+
+        bool IsDone() const { return ThreadPool::IsComplete(job); }
+        void Wait() const { ThreadPool::WaitFor(job); }
+    };
+
+    ~WalkerBoundary();
+
+    bool FindPath(const Vector3& fromWorldPos, const Vector3& toWorldPos, std::vector<Vector3>& outPath) const;
+    std::shared_ptr<PathQuery> FindPathAsync(const Vector3& fromWorldPos, const Vector3& toWorldPos);
     Vector3 FindNearestWalkablePosition(const Vector3& worldPos) const;
+    bool IsWalkableLine(const Vector3& fromWorldPos, const Vector3& toWorldPos) const;
 
-    void SetTexture(Texture* texture) { mTexture = texture; }
+    void SetTexture(Texture* texture);
     Texture* GetTexture() const { return mTexture; }
 
-    void SetSize(const Vector2& size) { mSize = size; }
+    void SetSize(const Vector2& size);
     Vector2 GetSize() const { return mSize; }
 
-    void SetOffset(const Vector2& offset) { mOffset = offset; }
+    void SetOffset(const Vector2& offset);
     Vector2 GetOffset() const { return mOffset; }
 
     void SetRegionBlocked(int regionIndex, int regionBoundaryIndex, bool blocked);
@@ -36,6 +66,8 @@ public:
     void ClearUnwalkableRect(const std::string& name);
     void DrawUnwalkableRects();
 
+    void BenchmarkPathfinding(int queryCount);
+
 private:
     // The texture provides vital data about walkable areas.
     // Each pixel correlates to a spot in the scene.
@@ -55,12 +87,48 @@ private:
     // Rectangular areas that are blocked and unwalkable.
     std::vector<std::pair<std::string, Rect>> mUnwalkableRects;
 
-    // The pathfinding grids are quite dense, and we can save some time by skipping over some nodes in the grid.
-    // This value starts higher, but is cut in half when we can't find a path.
-    int mPathfindingNodeSkip = 4;
+    // Whether each texture pixel is walkable, taking into account unwalkable regions and rects.
+    // This is what pathfinding actually uses - it's kept up-to-date as regions/rects change.
+    WalkableGrid mWalkableGrid;
+
+    // For each region (palette index), the min/max texture pixels that use it.
+    // When a region is blocked or unblocked, only this area of the walkable grid needs to be updated.
+    struct RegionBounds
+    {
+        int minX = INT_MAX;
+        int minY = INT_MAX;
+        int maxX = INT_MIN;
+        int maxY = INT_MIN;
+    };
+    RegionBounds mRegionBounds[256];
+
+    // For each texture pixel, the distance (in pixels) to the nearest unwalkable pixel. Updated whenever the walkable grid changes.
+    // Paths use this to keep some space between the walker and walls, and to quickly check if straight lines are walkable.
+    std::vector<float> mWallDistances;
+
+    // How far from walls (in pixels) paths try to stay, if there's room.
+    static constexpr float kPreferredWallDistance = 4.0f;
+
+    // Path queries that were started on background threads, and may not be done yet.
+    std::vector<JobHandle> mPathQueryJobs;
+
+    // Working memory for a single path query. Each query in progress needs its own.
+    struct PathScratch;
+    class ScopedPathScratch;
+
+    void WaitForPathQueries();
 
     bool IsWorldPosWalkable(const Vector3& worldPos) const;
     bool IsTexturePosWalkable(const Vector2& texturePos) const;
+    bool CalcTexturePosWalkable(const Vector2& texturePos) const;
+
+    // Updates the walkable grid within an area. Returns true if any cell in the area changed.
+    bool UpdateWalkableGrid(int minX, int minY, int maxX, int maxY);
+    bool UpdateWalkableGrid(const Rect& textureRect);
+
+    void UpdateWallDistances();
+    float GetWallDistance(int x, int y) const;
+    bool IsLineClear(const Vector2& from, const Vector2& to, float minWallDistance) const;
 
     Vector2 WorldPosToTexturePos(const Vector3& worldPos) const;
     Vector3 TexturePosToWorldPos(Vector2 texturePos) const;
@@ -69,6 +137,9 @@ private:
 
     Vector2 FindNearestWalkableTexturePosToWorldPos(const Vector3& worldPos) const;
 
-    bool FindPathBFS(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, int nodeSkipInterval = 1) const;
-    bool FindPathAStar(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath) const;
+    bool FindPathBFS(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, PathScratch& scratch, int nodeSkipInterval = 1) const;
+    bool FindPathAStar(const Vector2& start, const Vector2& goal, std::vector<Vector2>& outPath, PathScratch& scratch) const;
+
+    void MovePathAwayFromWalls(std::vector<Vector2>& path) const;
+    void RemoveUnneededPathNodes(std::vector<Vector2>& path) const;
 };
@@ -3,6 +3,7 @@
 #include <cctype>
 
 #include "AnimationNodes.h"
+#include "AssetBuffer.h"
 #include "AssetManager.h"
 #include "FileSystem.h"
 #include "IniParser.h"
@@ -28,9 +29,9 @@ Animation::~Animation()
     }
 }
 
-void Animation::Load(uint8_t* data, uint32_t dataLength)
+void Animation::Load(const AssetBuffer& buffer)
 {
-    ParseFromData(data, dataLength);
+    ParseFromData(buffer.GetData(), buffer.GetSize());
 }
 
 std::vector<AnimNode*>* Animation::GetFrame(int frameNumber)
@@ -86,7 +87,7 @@ VertexAnimNode* Animation::GetFirstVertexAnimationForModel(const std::string& mo
     return vertexAnimNode;
 }
 
-void Animation::ParseFromData(uint8_t* data, uint32_t dataLength)
+void Animation::ParseFromData(const uint8_t* data, uint32_t dataLength)
 {
     IniParser parser(data, dataLength);
     IniSection section;
@@ -1,12 +1,20 @@
 #include "VertexAnimation.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cfloat>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include <unordered_map>
 
 #include "BinaryReader.h"
 #include "GMath.h"
+#include "Interpolate.h"
+#include "Profiler.h"
+#include "ReportManager.h"
+#include "StringUtil.h"
+#include "TextureBuffer.h"
 
 //#define DEBUG_OUTPUT
 
@@ -80,29 +88,73 @@ void VertexAnimationPose::GetForTime(float time, int framesPerSecond, VertexAnim
     }
 }
 
-
-TYPEINFO_INIT(VertexAnimation, Asset, GENERATE_TYPE_ID)
+namespace
 {
-    TYPEINFO_VAR(VertexAnimation, VariableType::Int, mFrameCount);
-    TYPEINFO_VAR(VertexAnimation, VariableType::String, mModelName);
-}
+    // Vertex poses as they used to be stored: a linked list of separately allocated poses for each submesh, found through nested maps.
+    // Only used as a baseline when benchmarking.
+    struct LegacyVertexPose : public VertexAnimationPose
+    {
+        std::vector<Vector3> vertexPositions;
+    };
+    typedef std::unordered_map<int, std::unordered_map<int, LegacyVertexPose*>> LegacyVertexPoseMap;
 
-VertexAnimation::~VertexAnimation()
-{
-    for(auto& outerEntry : mVertexPoses)
+    // Samples poses the way they used to be sampled: walk the list to find the poses, then return a new pose by value.
+    LegacyVertexPose LegacySampleVertexPose(LegacyVertexPoseMap& vertexPoses, float time, int framesPerSecond, float duration, int meshIndex, int submeshIndex)
     {
-        for(auto& innerEntry : outerEntry.second)
+        LegacyVertexPose* firstVertexPose = nullptr;
+        auto it = vertexPoses.find(meshIndex);
+        if(it != vertexPoses.end())
         {
-            VertexAnimationPose* pose = innerEntry.second;
-            while(pose != nullptr)
+            auto it2 = it->second.find(submeshIndex);
+            if(it2 != it->second.end())
             {
-                VertexAnimationPose* temp = pose;
-                pose = pose->next;
-                delete temp;
+                firstVertexPose = it2->second;
             }
         }
+        if(firstVertexPose != nullptr)
+        {
+            float localTime = time;
+            if(localTime > duration)
+            {
+                localTime = Math::Mod(time, duration);
+            }
+
+            VertexAnimationPose* current;
+            VertexAnimationPose* next;
+            float t;
+            firstVertexPose->GetForTime(localTime, framesPerSecond, current, next, t);
+            if(current != nullptr)
+            {
+                if(next == nullptr)
+                {
+                    return *static_cast<LegacyVertexPose*>(current);
+                }
+
+                LegacyVertexPose* currentVertPose = static_cast<LegacyVertexPose*>(current);
+                LegacyVertexPose* nextVertPose = static_cast<LegacyVertexPose*>(next);
+                LegacyVertexPose pose;
+                for(size_t i = 0; i < currentVertPose->vertexPositions.size(); i++)
+                {
+                    pose.vertexPositions.push_back(Vector3::Lerp(currentVertPose->vertexPositions[i], nextVertPose->vertexPositions[i], t));
+                }
+                return pose;
+            }
+        }
+
+        LegacyVertexPose invalidPose;
+        invalidPose.frameNumber = -1;
+        return invalidPose;
     }
+}
 
+TYPEINFO_INIT(VertexAnimation, Asset, GENERATE_TYPE_ID)
+{
+    TYPEINFO_VAR(VertexAnimation, VariableType::Int, mFrameCount);
+    TYPEINFO_VAR(VertexAnimation, VariableType::String, mModelName);
+}
+
+VertexAnimation::~VertexAnimation()
+{
     for(auto& poseElement : mTransformPoses)
     {
         VertexAnimationPose* pose = poseElement;
@@ -113,6 +165,8 @@ VertexAnimation::~VertexAnimation()
             delete temp;
         }
     }
+
+    delete mVertexPoseBuffer;
 }
 
 void VertexAnimation::Load(uint8_t* data, uint32_t dataLength)
@@ -182,171 +236,255 @@ VertexAnimationTransformPose VertexAnimation::SampleTransformPose(float time, in
     return invalidPose;
 }
 
-VertexAnimationVertexPose VertexAnimation::SampleVertexPose(int frame, int meshIndex, int submeshIndex)
+bool VertexAnimation::SampleVertexPoses(int frame, int meshIndex, int submeshIndex, VertexAnimationVertexSample& outSample) const
+{
+    const VertexPoseTrack* track = GetVertexPoseTrack(meshIndex, submeshIndex);
+    if(track == nullptr) { return false; }
+
+    // Use the keyframe in effect on this frame. No blending is needed.
+    int keyframe = track->frameKeyframes[Math::Clamp(frame, 0, mFrameCount - 1)];
+    return SampleVertexPoses(*track, keyframe, outSample);
+}
+
+bool VertexAnimation::SampleVertexPoses(float time, int framesPerSecond, int meshIndex, int submeshIndex, VertexAnimationVertexSample& outSample) const
 {
-    // Find the first vertex pose defined for this mesh/submesh.
-    VertexAnimationVertexPose* firstVertexPose = nullptr;
-    auto it = mVertexPoses.find(meshIndex);
-    if(it != mVertexPoses.end())
+    const VertexPoseTrack* track = GetVertexPoseTrack(meshIndex, submeshIndex);
+    if(track == nullptr) { return false; }
+
+    // Caller may pass in a global time that extends beyond the local time of this particular animation.
+    // Desire here is for the animation to "loop", so we calculate how many seconds in we are.
+    float duration = GetDuration(framesPerSecond);
+    float localTime = time;
+    if(localTime > duration)
     {
-        auto it2 = it->second.find(submeshIndex);
-        if(it2 != it->second.end())
-        {
-            firstVertexPose = it2->second;
-        }
+        localTime = Math::Mod(time, duration);
     }
 
-    // Make sure we found a valid pose.
-    if(firstVertexPose != nullptr)
+    // Determine the frame this time falls on, and use the keyframe in effect on that frame.
+    float frameTime = localTime * framesPerSecond;
+    int frame = Math::Clamp(static_cast<int>(frameTime), 0, mFrameCount - 1);
+    int keyframe = track->frameKeyframes[frame];
+    SampleVertexPoses(*track, keyframe, outSample);
+
+    // GK3 does a somewhat wasteful thing: poses are expected to be defined for all frames. If NOT, use the closest previous frame.
+    // SO: only blend if this frame has a keyframe AND the next keyframe is on the very next frame.
+    int nextKeyframe = keyframe + 1;
+    if(track->keyframeFrames[keyframe] == frame && nextKeyframe < static_cast<int>(track->keyframeFrames.size()) &&
+       track->keyframeFrames[nextKeyframe] == frame + 1)
     {
-        VertexAnimationPose* pose = firstVertexPose->GetForFrame(frame);
-        if(pose != nullptr)
-        {
-            return *static_cast<VertexAnimationVertexPose*>(pose);
-        }
+        outSample.toOffset = track->keyframeOffsets[nextKeyframe];
+        outSample.toPositions = &mVertexPoseData[outSample.toOffset];
+        outSample.t = Math::Clamp(frameTime - frame, 0.0f, 1.0f);
     }
+    return true;
+}
 
-    // Error case: return something invalid.
-    VertexAnimationVertexPose invalidPose;
-    invalidPose.frameNumber = -1;
-    return invalidPose;
+bool VertexAnimation::SampleVertexPositions(int frame, int meshIndex, int submeshIndex, float* outPositions) const
+{
+    VertexAnimationVertexSample sample;
+    if(!SampleVertexPoses(frame, meshIndex, submeshIndex, sample)) { return false; }
+    memcpy(outPositions, sample.fromPositions, sample.vertexCount * 3 * sizeof(float));
+    return true;
 }
 
-VertexAnimationVertexPose VertexAnimation::SampleVertexPose(float time, int framesPerSecond, int meshIndex, int submeshIndex)
+bool VertexAnimation::SampleVertexPositions(float time, int framesPerSecond, int meshIndex, int submeshIndex, float* outPositions) const
 {
-    // Find the first vertex pose defined for this mesh/submesh.
-    VertexAnimationVertexPose* firstVertexPose = nullptr;
-    auto it = mVertexPoses.find(meshIndex);
-    if(it != mVertexPoses.end())
+    VertexAnimationVertexSample sample;
+    if(!SampleVertexPoses(time, framesPerSecond, meshIndex, submeshIndex, sample)) { return false; }
+    Interpolate::Linear(sample.fromPositions, sample.toPositions, sample.t, outPositions, sample.vertexCount * 3);
+    return true;
+}
+
+uint32_t VertexAnimation::GetVertexCount(int meshIndex, int submeshIndex) const
+{
+    const VertexPoseTrack* track = GetVertexPoseTrack(meshIndex, submeshIndex);
+    return track != nullptr ? track->vertexCount : 0;
+}
+
+bool VertexAnimation::GetMeshBounds(int meshIndex, AABB& outBounds) const
+{
+    if(meshIndex < 0 || meshIndex >= static_cast<int>(mMeshBounds.size()) || !mMeshBounds[meshIndex].IsValid()) { return false; }
+    outBounds = mMeshBounds[meshIndex];
+    return true;
+}
+
+TextureBuffer* VertexAnimation::GetVertexPoseBuffer()
+{
+    // Only try to create the buffer once - if it fails, it'll fail again.
+    if(!mVertexPoseBufferCreated)
     {
-        auto it2 = it->second.find(submeshIndex);
-        if(it2 != it->second.end())
+        mVertexPoseBufferCreated = true;
+
+        // Pose data is already laid out as one big array, so it can be uploaded as-is.
+        mVertexPoseBuffer = new TextureBuffer(mVertexPoseData.data(), static_cast<uint32_t>(mVertexPoseData.size()));
+        if(!mVertexPoseBuffer->IsGood())
         {
-            firstVertexPose = it2->second;
+            delete mVertexPoseBuffer;
+            mVertexPoseBuffer = nullptr;
         }
     }
+    return mVertexPoseBuffer;
+}
 
-    // Make sure we found a pose.
-    if(firstVertexPose != nullptr)
+Vector3 VertexAnimation::SampleVertexPosition(int frame, int meshIndex, int submeshIndex, int vertexIndex) const
+{
+    VertexAnimationVertexSample sample;
+    if(SampleVertexPoses(frame, meshIndex, submeshIndex, sample) && vertexIndex >= 0 && vertexIndex < sample.vertexCount)
     {
-        // Caller may pass in a global time that extends beyond the local time of this particular animation.
-        // Desire here is for the animation to "loop", so we calculate how many seconds in we are.
-        float duration = GetDuration(framesPerSecond);
-        float localTime = time;
-        if(localTime > duration)
-        {
-            localTime = Math::Mod(time, duration);
-        }
+        const float* position = sample.fromPositions + vertexIndex * 3;
+        return Vector3(position[0], position[1], position[2]);
+    }
+    return Vector3::Zero;
+}
 
-        // Retrieve current/next poses based on the desired time.
-        VertexAnimationPose* current;
-        VertexAnimationPose* next;
-        float t;
-        firstVertexPose->GetForTime(localTime, framesPerSecond, current, next, t);
+Vector3 VertexAnimation::SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex) const
+{
+    VertexAnimationVertexSample sample;
+    if(SampleVertexPoses(time, framesPerSecond, meshIndex, submeshIndex, sample) && vertexIndex >= 0 && vertexIndex < sample.vertexCount)
+    {
+        const float* from = sample.fromPositions + vertexIndex * 3;
+        const float* to = sample.toPositions + vertexIndex * 3;
+        return Vector3::Lerp(Vector3(from[0], from[1], from[2]), Vector3(to[0], to[1], to[2]), sample.t);
+    }
+    return Vector3::Zero;
+}
 
-        // We at least need a valid current pose.
-        if(current != nullptr)
+void VertexAnimation::BenchmarkSampling(int iterations, int framesPerSecond)
+{
+    if(iterations <= 0 || framesPerSecond <= 0 || mFrameCount <= 0) { return; }
+
+    // Sample at a few points within each frame, so both blended and unblended samples are measured.
+    const int kSamplesPerFrame = 4;
+    float secondsPerSample = 1.0f / (framesPerSecond * kSamplesPerFrame);
+    int sampleCount = mFrameCount * kSamplesPerFrame;
+
+    // Rebuild this animation's poses in the old layout, to compare against. Allocate the poses in file order (frame by frame), like the old parser did.
+    LegacyVertexPoseMap legacyVertexPoses;
+    std::vector<LegacyVertexPose*> legacyLastPoses(mVertexPoseTracks.size(), nullptr);
+    for(int frame = 0; frame < mFrameCount; ++frame)
+    {
+        for(size_t meshIndex = 0; meshIndex < mVertexPoseTrackIndexes.size(); ++meshIndex)
         {
-            // If no next pose, we can just use the current pose directly.
-            if(next == nullptr)
+            for(size_t submeshIndex = 0; submeshIndex < mVertexPoseTrackIndexes[meshIndex].size(); ++submeshIndex)
             {
-                return *static_cast<VertexAnimationVertexPose*>(current);
+                int trackIndex = mVertexPoseTrackIndexes[meshIndex][submeshIndex];
+                if(trackIndex < 0) { continue; }
+                const VertexPoseTrack& track = mVertexPoseTracks[trackIndex];
+
+                auto keyframeIt = std::find(track.keyframeFrames.begin(), track.keyframeFrames.end(), frame);
+                if(keyframeIt == track.keyframeFrames.end()) { continue; }
+                const Vector3* keyframePositions = reinterpret_cast<const Vector3*>(&mVertexPoseData[track.keyframeOffsets[keyframeIt - track.keyframeFrames.begin()]]);
+
+                LegacyVertexPose* pose = new LegacyVertexPose();
+                pose->frameNumber = frame;
+                pose->vertexPositions.assign(keyframePositions, keyframePositions + track.vertexCount);
+                if(legacyLastPoses[trackIndex] == nullptr)
+                {
+                    legacyVertexPoses[static_cast<int>(meshIndex)][static_cast<int>(submeshIndex)] = pose;
+                }
+                else
+                {
+                    legacyLastPoses[trackIndex]->next = pose;
+                }
+                legacyLastPoses[trackIndex] = pose;
             }
+        }
+    }
 
-            // Now calculate interpolated positions between current and next poses for this time t.
-            VertexAnimationVertexPose* currentVertPose = static_cast<VertexAnimationVertexPose*>(current);
-            VertexAnimationVertexPose* nextVertPose = static_cast<VertexAnimationVertexPose*>(next);
-            VertexAnimationVertexPose pose;
-            for(int i = 0; i < currentVertPose->vertexPositions.size(); i++)
+    // Sample every submesh the old way: nested map lookup, linked list walk, and a new pose returned by value.
+    float checksum = 0.0f;
+    uint64_t vertexCount = 0;
+    float duration = GetDuration(framesPerSecond);
+    Stopwatch stopwatch;
+    for(int iteration = 0; iteration < iterations; ++iteration)
+    {
+        for(int i = 0; i < sampleCount; ++i)
+        {
+            float time = i * secondsPerSample;
+            for(size_t meshIndex = 0; meshIndex < mVertexPoseTrackIndexes.size(); ++meshIndex)
             {
-                pose.vertexPositions.push_back(Vector3::Lerp(currentVertPose->vertexPositions[i], nextVertPose->vertexPositions[i], t));
+                for(size_t submeshIndex = 0; submeshIndex < mVertexPoseTrackIndexes[meshIndex].size(); ++submeshIndex)
+                {
+                    LegacyVertexPose pose = LegacySampleVertexPose(legacyVertexPoses, time, framesPerSecond, duration, meshIndex, submeshIndex);
+                    if(pose.frameNumber < 0 || pose.vertexPositions.empty()) { continue; }
+                    checksum += pose.vertexPositions.back().x;
+                }
             }
-            return pose;
         }
     }
+    float oldMs = stopwatch.GetMilliseconds();
 
-    // Error case: return something invalid.
-    VertexAnimationVertexPose invalidPose;
-    invalidPose.frameNumber = -1;
-    return invalidPose;
-}
-
-Vector3 VertexAnimation::SampleVertexPosition(int frame, int meshIndex, int submeshIndex, int vertexIndex)
-{
-    // Find the first vertex pose defined for this mesh/submesh.
-    VertexAnimationVertexPose* firstVertexPose = nullptr;
-    auto it = mVertexPoses.find(meshIndex);
-    if(it != mVertexPoses.end())
+    for(auto& meshEntry : legacyVertexPoses)
     {
-        auto it2 = it->second.find(submeshIndex);
-        if(it2 != it->second.end())
+        for(auto& submeshEntry : meshEntry.second)
         {
-            firstVertexPose = it2->second;
+            VertexAnimationPose* pose = submeshEntry.second;
+            while(pose != nullptr)
+            {
+                VertexAnimationPose* next = pose->next;
+                delete pose;
+                pose = next;
+            }
         }
     }
 
-    // Make sure we found a pose.
-    if(firstVertexPose != nullptr)
+    // Sample every submesh the same way VertexAnimator does on the CPU path: O(1) keyframe lookup and SIMD blending into a persistent buffer.
+    std::vector<float> positions;
+    stopwatch.Reset();
+    for(int iteration = 0; iteration < iterations; ++iteration)
     {
-        VertexAnimationPose* pose = firstVertexPose->GetForFrame(frame);
-        if(pose != nullptr)
+        for(int i = 0; i < sampleCount; ++i)
         {
-            VertexAnimationVertexPose* vertexPose = static_cast<VertexAnimationVertexPose*>(pose);
-            if(vertexIndex >= 0 && vertexIndex < vertexPose->vertexPositions.size())
+            float time = i * secondsPerSample;
+            for(size_t meshIndex = 0; meshIndex < mVertexPoseTrackIndexes.size(); ++meshIndex)
             {
-                return vertexPose->vertexPositions[vertexIndex];
+                for(size_t submeshIndex = 0; submeshIndex < mVertexPoseTrackIndexes[meshIndex].size(); ++submeshIndex)
+                {
+                    uint32_t count = GetVertexCount(meshIndex, submeshIndex) * 3;
+                    if(count == 0) { continue; }
+                    if(positions.size() < count)
+                    {
+                        positions.resize(count);
+                    }
+                    SampleVertexPositions(time, framesPerSecond, meshIndex, submeshIndex, positions.data());
+                    checksum += positions[count - 3];
+                    vertexCount += count / 3;
+                }
             }
         }
     }
-    return Vector3::Zero;
+    float newMs = stopwatch.GetMilliseconds();
+
+    // The checksum covers both passes, so neither can be optimized away.
+    gReportManager.Log("Dump", StringUtil::Format("ACT %s: %d frames, %u tracks, %llu vertices sampled (checksum %.1f)", GetName().c_str(),
+                                                  mFrameCount, static_cast<unsigned int>(mVertexPoseTracks.size()),
+                                                  static_cast<unsigned long long>(vertexCount), checksum));
+    gReportManager.Log("Dump", StringUtil::Format("Linked list + by-value: %.3fms, flat + SIMD: %.3fms (%.1fx)",
+                                                  oldMs, newMs, newMs > 0.0f ? oldMs / newMs : 0.0f));
 }
 
-Vector3 VertexAnimation::SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex)
+const VertexAnimation::VertexPoseTrack* VertexAnimation::GetVertexPoseTrack(int meshIndex, int submeshIndex) const
 {
-    // Find the first vertex pose defined for this mesh/submesh.
-    VertexAnimationVertexPose* firstVertexPose = nullptr;
-    auto it = mVertexPoses.find(meshIndex);
-    if(it != mVertexPoses.end())
+    if(meshIndex >= 0 && meshIndex < mVertexPoseTrackIndexes.size())
     {
-        auto it2 = it->second.find(submeshIndex);
-        if(it2 != it->second.end())
+        const std::vector<int>& trackIndexes = mVertexPoseTrackIndexes[meshIndex];
+        if(submeshIndex >= 0 && submeshIndex < trackIndexes.size() && trackIndexes[submeshIndex] >= 0)
         {
-            firstVertexPose = it2->second;
+            return &mVertexPoseTracks[trackIndexes[submeshIndex]];
         }
     }
+    return nullptr;
+}
 
-    // Make sure we found a valid first pose.
-    if(firstVertexPose != nullptr)
-    {
-        float duration = GetDuration(framesPerSecond);
-        float localTime = time;
-        if(localTime > duration)
-        {
-            localTime = Math::Mod(time, duration);
-        }
-
-        // Retrieve current/next poses based on the desired time.
-        VertexAnimationPose* current;
-        VertexAnimationPose* next;
-        float t;
-        firstVertexPose->GetForTime(localTime, framesPerSecond, current, next, t);
-
-        // We at least need a valid current pose.
-        if(current != nullptr)
-        {
-            // If no next pose, we can just use the current pose directly.
-            if(next == nullptr)
-            {
-                return static_cast<VertexAnimationVertexPose*>(current)->vertexPositions[vertexIndex];
-            }
-
-            // Now calculate interpolated positions between current and next poses for this time t.
-            VertexAnimationVertexPose* currentVertPose = static_cast<VertexAnimationVertexPose*>(current);
-            VertexAnimationVertexPose* nextVertPose = static_cast<VertexAnimationVertexPose*>(next);
-            return Vector3::Lerp(currentVertPose->vertexPositions[vertexIndex], nextVertPose->vertexPositions[vertexIndex], t);
-        }
-    }
-    return Vector3::Zero;
+bool VertexAnimation::SampleVertexPoses(const VertexPoseTrack& track, int keyframe, VertexAnimationVertexSample& outSample) const
+{
+    outSample.fromOffset = track.keyframeOffsets[keyframe];
+    outSample.fromPositions = &mVertexPoseData[outSample.fromOffset];
+    outSample.toOffset = outSample.fromOffset;
+    outSample.toPositions = outSample.fromPositions;
+    outSample.t = 0.0f;
+    outSample.vertexCount = track.vertexCount;
+    return true;
 }
 
 void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
@@ -374,6 +512,7 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
     // This should 100% correlate to the mesh count for the model file itself.
     // If not, the animation probably won't play correctly.
     uint32_t meshCount = reader.ReadUInt();
+    mMeshBounds.assign(meshCount, AABB(Vector3(FLT_MAX, FLT_MAX, FLT_MAX), Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX)));
 
     // File contents size after header info. Not important to us.
     reader.ReadUInt();
@@ -396,7 +535,6 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
     }
 
     // Read in data for each keyframe.
-    std::unordered_map<int, VertexAnimationVertexPose*> lastVertexPoseLookup;
     std::unordered_map<int, VertexAnimationTransformPose*> lastTransformPoseLookup;
     for(int i = 0; i < mFrameCount; i++)
     {
@@ -447,37 +585,19 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
                     std::cout << "        Submesh Index: " << submeshIndex << std::endl;
                     #endif
 
-                    // This is a pretty sorry hash...but assuming we'll never
-                    // have more than 1000 submeshes (pretty likely for GK3), this'll do OK.
-                    int hash = meshIndex * 1000 + submeshIndex;
-
-                    // Create a vertex pose for this frame and stick it in our dictionary and linked list.
-                    VertexAnimationVertexPose* vertexPose = new VertexAnimationVertexPose();
-                    vertexPose->frameNumber = i;
-                    if(i == 0)
-                    {
-                        mVertexPoses[meshIndex][submeshIndex] = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-                    else
-                    {
-                        lastVertexPoseLookup[hash]->next = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-
                     // 2 bytes: Vertex count.
                     unsigned short vertexCount = reader.ReadUShort();
                     #ifdef DEBUG_OUTPUT
                     std::cout << "        Vertex Count: " << vertexCount << std::endl;
                     #endif
 
+                    // Add a keyframe for this frame to the submesh's track.
+                    uint32_t poseOffset = AddVertexPose(meshIndex, submeshIndex, i, vertexCount);
+
                     // Next, three floats per vertex (X, Y, Z).
-                    for(int k = 0; k < vertexCount; k++)
+                    for(int k = 0; k < vertexCount * 3; k++)
                     {
-                        float x = reader.ReadFloat();
-                        float y = reader.ReadFloat();
-                        float z = reader.ReadFloat();
-                        vertexPose->vertexPositions.push_back(Vector3(x, y, z));
+                        mVertexPoseData[poseOffset + k] = reader.ReadFloat();
                     }
                 }
                 // Identifier 1 also is vertex data, but in a compressed format.
@@ -497,30 +617,23 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
                     std::cout << "        Submesh Index: " << submeshIndex << std::endl;
                     #endif
 
-                    // Find position data from last recorded frame.
-                    int hash = meshIndex * 1000 + submeshIndex;
-                    std::vector<Vector3>& prevPositions = lastVertexPoseLookup[hash]->vertexPositions;
-
-                    // Create a vertex pose to hold this new data and insert it into the vertex pose chain.
-                    VertexAnimationVertexPose* vertexPose = new VertexAnimationVertexPose();
-                    vertexPose->frameNumber = i;
-                    if(i == 0)
-                    {
-                        mVertexPoses[meshIndex][submeshIndex] = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-                    else
-                    {
-                        lastVertexPoseLookup[hash]->next = vertexPose;
-                        lastVertexPoseLookup[hash] = vertexPose;
-                    }
-
                     // 2 bytes: Vertex count.
                     unsigned short vertexCount = reader.ReadUShort();
                     #ifdef DEBUG_OUTPUT
                     std::cout << "        Vertex Count: " << vertexCount << std::endl;
                     #endif
 
+                    // Find position data from last recorded keyframe (if none, deltas are relative to the origin).
+                    const VertexPoseTrack* track = GetVertexPoseTrack(meshIndex, submeshIndex);
+                    int prevPoseOffset = (track != nullptr && track->vertexCount == vertexCount) ? static_cast<int>(track->keyframeOffsets.back()) : -1;
+
+                    // Add a keyframe for this frame to the submesh's track.
+                    uint32_t poseOffset = AddVertexPose(meshIndex, submeshIndex, i, vertexCount);
+                    if(prevPoseOffset >= 0)
+                    {
+                        memcpy(&mVertexPoseData[poseOffset], &mVertexPoseData[prevPoseOffset], vertexCount * 3 * sizeof(float));
+                    }
+
                     // Next ((VertexCount/4) + 1) bytes: Compression info for vertex data.
                     // Every 2 bits indicates how the vertex at that index is compressed.
                     unsigned short compressionInfoSize = (vertexCount / 4) + 1;
@@ -554,39 +667,39 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
                     }
 
                     // Now that we have deciphered how each vertex is compressed, we can read in each vertex.
+                    // Positions start as a copy of the previous keyframe's positions, and the compressed data are deltas from those.
                     for(int k = 0; k < vertexCount; k++)
                     {
+                        float* position = &mVertexPoseData[poseOffset + k * 3];
+
                         // 0 means no vertex data, so just use whatever we had for the previous frame.
                         // If the vertex data hasn't changed since last frame, it isn't stored, to save space.
                         if(vertexDataFormat[k] == 0)
                         {
-                            vertexPose->vertexPositions.push_back(prevPositions[k]);
+                            continue;
                         }
                         // 1 means (X, Y, Z) are compressed in next 3 bytes.
                         // This tends to be used for storing vertex position delta for internal vertices in a mesh.
                         else if(vertexDataFormat[k] == 1)
                         {
-                            float x = DecompressFloatFromByte(reader.ReadSByte());
-                            float y = DecompressFloatFromByte(reader.ReadSByte());
-                            float z = DecompressFloatFromByte(reader.ReadSByte());
-                            vertexPose->vertexPositions.push_back(prevPositions[k] + Vector3(x, y, z));
+                            position[0] += DecompressFloatFromByte(reader.ReadSByte());
+                            position[1] += DecompressFloatFromByte(reader.ReadSByte());
+                            position[2] += DecompressFloatFromByte(reader.ReadSByte());
                         }
                         // 2 means (X, Y, Z) are compressed in next 3 ushorts.
                         // This tends to be used for storing vertex position deltas where meshes meet (like a knee or elbow).
                         else if(vertexDataFormat[k] == 2)
                         {
-                            float x = DecompressFloatFromUShort(reader.ReadUShort());
-                            float y = DecompressFloatFromUShort(reader.ReadUShort());
-                            float z = DecompressFloatFromUShort(reader.ReadUShort());
-                            vertexPose->vertexPositions.push_back(prevPositions[k] + Vector3(x, y, z));
+                            position[0] += DecompressFloatFromUShort(reader.ReadUShort());
+                            position[1] += DecompressFloatFromUShort(reader.ReadUShort());
+                            position[2] += DecompressFloatFromUShort(reader.ReadUShort());
                         }
                         // 3 means (X, Y, Z) are not compressed - just floats.
                         else if(vertexDataFormat[k] == 3)
                         {
-                            float x = reader.ReadFloat();
-                            float y = reader.ReadFloat();
-                            float z = reader.ReadFloat();
-                            vertexPose->vertexPositions.push_back(prevPositions[k] + Vector3(x, y, z));
+                            position[0] += reader.ReadFloat();
+                            position[1] += reader.ReadFloat();
+                            position[2] += reader.ReadFloat();
                         }
                     }
 
@@ -655,16 +768,15 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
                     assert(blockByteCount == 24);
                     byteCount -= blockByteCount + 4;
 
-                    // Assign min/max data.
-                    #ifdef DEBUG_OUTPUT
+                    // Poses can move vertices well outside the model's bind pose bounds (e.g. lying down), so keep bounds that contain every frame.
                     Vector3 min = reader.ReadVector3();
                     Vector3 max = reader.ReadVector3();
+                    #ifdef DEBUG_OUTPUT
                     std::cout << "        Min: " << min << std::endl;
                     std::cout << "        Max: " << max << std::endl;
-                    #else
-                    reader.ReadVector3();
-                    reader.ReadVector3();
                     #endif
+                    mMeshBounds[meshIndex].GrowToContain(min);
+                    mMeshBounds[meshIndex].GrowToContain(max);
                 }
                 else
                 {
@@ -673,6 +785,52 @@ void VertexAnimation::ParseFromData(uint8_t* data, uint32_t dataLength)
             } // while(byteCount > 0)
         } // iterate mesh groups
     } // iterate keyframes
+
+    // Now that all keyframes are known, map each frame to the keyframe in effect on that frame.
+    // Frames before a track's first keyframe just use the first keyframe.
+    for(VertexPoseTrack& track : mVertexPoseTracks)
+    {
+        track.frameKeyframes.resize(mFrameCount);
+        int keyframe = 0;
+        for(int frame = 0; frame < mFrameCount; ++frame)
+        {
+            while(keyframe + 1 < static_cast<int>(track.keyframeFrames.size()) && track.keyframeFrames[keyframe + 1] <= frame)
+            {
+                ++keyframe;
+            }
+            track.frameKeyframes[frame] = keyframe;
+        }
+    }
+}
+
+uint32_t VertexAnimation::AddVertexPose(int meshIndex, int submeshIndex, int frame, uint32_t vertexCount)
+{
+    // Find or create the track for this submesh.
+    if(meshIndex >= mVertexPoseTrackIndexes.size())
+    {
+        mVertexPoseTrackIndexes.resize(meshIndex + 1);
+    }
+    std::vector<int>& trackIndexes = mVertexPoseTrackIndexes[meshIndex];
+    if(submeshIndex >= trackIndexes.size())
+    {
+        trackIndexes.resize(submeshIndex + 1, -1);
+    }
+    if(trackIndexes[submeshIndex] < 0)
+    {
+        trackIndexes[submeshIndex] = static_cast<int>(mVertexPoseTracks.size());
+        mVertexPoseTracks.emplace_back();
+        mVertexPoseTracks.back().vertexCount = vertexCount;
+    }
+
+    // Add a keyframe to the track, with space for its positions at the end of the pose data.
+    // If pose sizes don't agree (they always should), only the vertices common to all poses can be sampled.
+    VertexPoseTrack& track = mVertexPoseTracks[trackIndexes[submeshIndex]];
+    track.vertexCount = std::min(track.vertexCount, vertexCount);
+    uint32_t offset = static_cast<uint32_t>(mVertexPoseData.size());
+    track.keyframeFrames.push_back(frame);
+    track.keyframeOffsets.push_back(offset);
+    mVertexPoseData.resize(offset + vertexCount * 3);
+    return offset;
 }
 
 float VertexAnimation::DecompressFloatFromByte(unsigned char val)
@@ -10,11 +10,13 @@
 #include "Asset.h"
 
 #include <vector>
-#include <unordered_map>
 
+#include "AABB.h"
 #include "Matrix4.h"
 #include "Vector3.h"
 
+class TextureBuffer;
+
 struct VertexAnimationPose
 {
     int frameNumber = 0;
@@ -25,9 +27,22 @@ struct VertexAnimationPose
     void GetForTime(float time, int framesPerSecond, VertexAnimationPose*& outCurrent, VertexAnimationPose*& outNext, float& outT);
 };
 
-struct VertexAnimationVertexPose : public VertexAnimationPose
+// The result of sampling vertex poses for a submesh: two poses, and how far to blend between them.
+struct VertexAnimationVertexSample
 {
-    std::vector<Vector3> vertexPositions;
+    // Positions of the two poses, as (x, y, z) floats for each vertex.
+    const float* fromPositions = nullptr;
+    const float* toPositions = nullptr;
+
+    // Where the two poses start in the animation's vertex pose buffer (in floats).
+    uint32_t fromOffset = 0;
+    uint32_t toOffset = 0;
+
+    // How far to blend from one pose to the other. If the poses are the same, this is zero.
+    float t = 0.0f;
+
+    // Number of vertices in each pose.
+    uint32_t vertexCount = 0;
 };
 
 struct VertexAnimationTransformPose : public VertexAnimationPose
@@ -48,13 +63,32 @@ public:
     VertexAnimationTransformPose SampleTransformPose(int frame, int meshIndex);
     VertexAnimationTransformPose SampleTransformPose(float time, int framesPerSecond, int meshIndex);
 
-    // Queries ALL vertices for a submesh at a frame/time.
-    VertexAnimationVertexPose SampleVertexPose(int frame, int meshIndex, int submeshIndex);
-    VertexAnimationVertexPose SampleVertexPose(float time, int framesPerSecond, int meshIndex, int submeshIndex);
+    // Queries the two poses to blend between for a submesh at a frame/time, without calculating any positions.
+    // Useful if blending is done elsewhere (e.g. on the GPU). Returns false if the submesh has no poses in this animation.
+    bool SampleVertexPoses(int frame, int meshIndex, int submeshIndex, VertexAnimationVertexSample& outSample) const;
+    bool SampleVertexPoses(float time, int framesPerSecond, int meshIndex, int submeshIndex, VertexAnimationVertexSample& outSample) const;
+
+    // Queries ALL vertices for a submesh at a frame/time, writing (x, y, z) floats for each vertex to the passed buffer.
+    // The buffer must have room for GetVertexCount() * 3 floats. Returns false if the submesh has no poses in this animation.
+    bool SampleVertexPositions(int frame, int meshIndex, int submeshIndex, float* outPositions) const;
+    bool SampleVertexPositions(float time, int framesPerSecond, int meshIndex, int submeshIndex, float* outPositions) const;
+
+    // Number of vertices in each pose for a submesh, or zero if the submesh has no poses in this animation.
+    uint32_t GetVertexCount(int meshIndex, int submeshIndex) const;
+
+    // Gets bounds (in mesh space) that contain a mesh on every frame of the animation. Returns false if the animation has no bounds for the mesh.
+    bool GetMeshBounds(int meshIndex, AABB& outBounds) const;
+
+    // A buffer containing every vertex pose in this animation, for blending poses on the GPU.
+    // Sampled pose offsets index into this buffer. Created on first use - returns null if it couldn't be created.
+    TextureBuffer* GetVertexPoseBuffer();
 
     // Queries single vertex for a submesh at a frame/time.
-    Vector3 SampleVertexPosition(int frame, int meshIndex, int submeshIndex, int vertexIndex);
-    Vector3 SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex);
+    Vector3 SampleVertexPosition(int frame, int meshIndex, int submeshIndex, int vertexIndex) const;
+    Vector3 SampleVertexPosition(float time, int framesPerSecond, int meshIndex, int submeshIndex, int vertexIndex) const;
+
+    // Logs how long it takes to sample every vertex pose in this animation, compared to the old linked list layout and by-value sampling.
+    void BenchmarkSampling(int iterations, int framesPerSecond);
 
     // Length and duration.
     int GetFrameCount() const { return mFrameCount; }
@@ -70,14 +104,45 @@ private:
     // If we ever play the animation on a mismatched model, the graphics will probably glitch out.
     std::string mModelName;
 
-    // Each array element is the FIRST vertex pose for each mesh/submesh index.
-    // Subsequent poses for the mesh are stored in the "next" of the first pose.
-    std::unordered_map<int, std::unordered_map<int, VertexAnimationVertexPose*>> mVertexPoses;
+    // Vertex poses for a single submesh over the course of the animation.
+    struct VertexPoseTrack
+    {
+        // Number of vertices in each pose.
+        uint32_t vertexCount = 0;
+
+        // For each keyframe (in frame order): the frame it occurs on, and where its positions start in the pose data (in floats).
+        std::vector<int> keyframeFrames;
+        std::vector<uint32_t> keyframeOffsets;
+
+        // For each frame of the animation, the index of the keyframe in effect on that frame.
+        // If no keyframe exists for a frame, the rule is to use the closest previous keyframe.
+        std::vector<int> frameKeyframes;
+    };
+
+    // Positions for every vertex pose in the animation, as (x, y, z) floats for each vertex, one pose after another.
+    std::vector<float> mVertexPoseData;
+
+    // Vertex pose tracks for all animated submeshes.
+    std::vector<VertexPoseTrack> mVertexPoseTracks;
+
+    // Index of the track for each mesh/submesh (as [meshIndex][submeshIndex]), or -1 if a submesh isn't animated.
+    std::vector<std::vector<int>> mVertexPoseTrackIndexes;
+
+    // For each mesh, the combined min/max data of all frames. Invalid if no frame had min/max data for the mesh.
+    std::vector<AABB> mMeshBounds;
 
     // Each element of array is the FIRST transform poses for each mesh index.
     // Subsequent poses for the mesh are stored in the "next" of the first pose.
     std::vector<VertexAnimationTransformPose*> mTransformPoses;
 
+    // All vertex poses, uploaded to the GPU. Created on demand, since many animations are never played.
+    TextureBuffer* mVertexPoseBuffer = nullptr;
+    bool mVertexPoseBufferCreated = false;
+
+    uint32_t AddVertexPose(int meshIndex, int submeshIndex, int frame, uint32_t vertexCount);
+    const VertexPoseTrack* GetVertexPoseTrack(int meshIndex, int submeshIndex) const;
+    bool SampleVertexPoses(const VertexPoseTrack& track, int keyframe, VertexAnimationVertexSample& outSample) const;
+
     void ParseFromData(uint8_t* data, uint32_t dataLength);
 
     float DecompressFloatFromByte(unsigned char val);
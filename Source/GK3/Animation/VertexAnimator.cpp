@@ -1,12 +1,31 @@
 #include "VertexAnimator.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "Actor.h"
+#include "AssetManager.h"
+#include "Debug.h"
 #include "Mesh.h"
 #include "MeshRenderer.h"
+#include "Shader.h"
 #include "VertexAnimation.h"
 
+namespace
+{
+    // Blending vertex poses on the GPU requires a vertex shader that reads positions from the animation's pose buffer.
+    // Only the lit shader (used by actors and props) has such a variant. Meshes using other shaders are animated on the CPU.
+    Shader* GetLitShader()
+    {
+        return gAssetManager.LoadShader("3D-Tex-Lit");
+    }
+
+    Shader* GetVertexAnimShader()
+    {
+        return gAssetManager.LoadShader("3D-Tex-Lit-VertexAnim", "3D-Tex-Lit");
+    }
+}
+
 TYPEINFO_INIT(VertexAnimator, Component, 10)
 {
 
@@ -39,6 +58,12 @@ void VertexAnimator::Stop(VertexAnimation* anim)
     // Stop if animation matches playing one OR null was passed in.
     if(mCurrentParams.vertexAnimation != nullptr && (mCurrentParams.vertexAnimation == anim || anim == nullptr))
     {
+        // If poses were being blended on the GPU, apply the final pose to the meshes before letting go of the animation.
+        if(mUsingGPUPoses)
+        {
+            TakeSample(mCurrentParams.vertexAnimation, mLastSampleTime, false);
+        }
+
         // Fire stop callback if an animation was in progress.
         if(mCurrentParams.stopCallback != nullptr)
         {
@@ -113,10 +138,11 @@ void VertexAnimator::TakeSample(VertexAnimation* animation, int frame)
         const std::vector<Submesh*>& submeshes = meshes[i]->GetSubmeshes();
         for(size_t j = 0; j < submeshes.size(); j++)
         {
-            VertexAnimationVertexPose sample = animation->SampleVertexPose(frame, i, j);
-            if(sample.frameNumber >= 0)
+            float* positions = GetPositionsBuffer(std::max(animation->GetVertexCount(i, j), submeshes[j]->GetVertexCount()));
+            if(animation->SampleVertexPositions(frame, i, j, positions))
             {
-                submeshes[j]->SetPositions(reinterpret_cast<float*>(sample.vertexPositions.data()));
+                StopGPUPose(mMeshRenderer->GetMaterial(i, j));
+                submeshes[j]->SetPositions(positions);
             }
         }
 
@@ -125,23 +151,71 @@ void VertexAnimator::TakeSample(VertexAnimation* animation, int frame)
         {
             meshes[i]->SetMeshToLocalMatrix(transformSample.meshToLocalMatrix);
         }
+        GrowMeshAABB(animation, i, meshes[i]);
     }
 }
 
-void VertexAnimator::TakeSample(VertexAnimation* animation, float time)
+void VertexAnimator::TakeSample(VertexAnimation* animation, float time, bool allowGPU)
 {
+    mLastSampleTime = time;
+    mUsingGPUPoses = false;
+
+    // Vertex poses can be blended on the GPU if the animation's poses are uploaded and the vertex anim shader is usable.
+    // This also requires one material per submesh, since the pose to use is a material property.
+    const std::vector<Mesh*> meshes = mMeshRenderer->GetMeshes();
+    TextureBuffer* poseBuffer = nullptr;
+    Shader* vertexAnimShader = GetVertexAnimShader();
+    if(allowGPU && !Debug::GetFlag("DisableGPUVertexAnimation") && vertexAnimShader != nullptr && vertexAnimShader->IsGood())
+    {
+        size_t submeshCount = 0;
+        for(Mesh* mesh : meshes)
+        {
+            submeshCount += mesh->GetSubmeshes().size();
+        }
+        if(submeshCount == mMeshRenderer->GetMaterials().size())
+        {
+            poseBuffer = animation->GetVertexPoseBuffer();
+        }
+    }
+    Shader* litShader = GetLitShader();
+
     // Iterate through each mesh and sample it in the vertex animation.
     // We need to sample both vertex poses and transform poses to get the right result.
-    const std::vector<Mesh*> meshes = mMeshRenderer->GetMeshes();
     for(size_t i = 0; i < meshes.size(); i++)
     {
         const std::vector<Submesh*>& submeshes = meshes[i]->GetSubmeshes();
         for(size_t j = 0; j < submeshes.size(); j++)
         {
-            VertexAnimationVertexPose sample = animation->SampleVertexPose(time, mCurrentParams.framesPerSecond, i, j);
-            if(sample.frameNumber >= 0)
+            // On the GPU, just tell the material which poses to blend between.
+            // The submesh is also told, so that position queries (raycasts, etc) still give animated positions.
+            Material* material = mMeshRenderer->GetMaterial(i, j);
+            if(poseBuffer != nullptr && (material->GetShader() == litShader || material->GetShader() == vertexAnimShader))
+            {
+                VertexAnimationVertexSample sample;
+                if(animation->SampleVertexPoses(time, mCurrentParams.framesPerSecond, i, j, sample))
+                {
+                    material->SetShader(vertexAnimShader);
+                    material->SetTextureBuffer("uVertexPoses", poseBuffer);
+                    material->SetInt("uPoseOffsetFrom", static_cast<int>(sample.fromOffset));
+                    material->SetInt("uPoseOffsetTo", static_cast<int>(sample.toOffset));
+                    material->SetFloat("uPoseT", sample.t);
+
+                    submeshes[j]->SetBlendedPositions(sample.fromPositions, sample.toPositions, sample.t);
+                    mUsingGPUPoses = true;
+                }
+                else
+                {
+                    StopGPUPose(material);
+                }
+                continue;
+            }
+
+            // Otherwise, blend the positions on the CPU and upload them.
+            float* positions = GetPositionsBuffer(std::max(animation->GetVertexCount(i, j), submeshes[j]->GetVertexCount()));
+            if(animation->SampleVertexPositions(time, mCurrentParams.framesPerSecond, i, j, positions))
             {
-                submeshes[j]->SetPositions(reinterpret_cast<float*>(sample.vertexPositions.data()));
+                StopGPUPose(material);
+                submeshes[j]->SetPositions(positions);
             }
         }
 
@@ -150,5 +224,38 @@ void VertexAnimator::TakeSample(VertexAnimation* animation, float time)
         {
             meshes[i]->SetMeshToLocalMatrix(transformSample.meshToLocalMatrix);
         }
+        GrowMeshAABB(animation, i, meshes[i]);
+    }
+}
+
+void VertexAnimator::GrowMeshAABB(VertexAnimation* animation, int meshIndex, Mesh* mesh)
+{
+    // The mesh's AABB is from the model's bind pose, but animated poses can go well outside it (e.g. lying down or sitting).
+    // Culling uses the AABB, so grow it to contain the animation - otherwise, the mesh could be culled while it's still on screen.
+    // The AABB never shrinks back, since the last pose of an animation usually stays in place after the animation ends.
+    AABB animationBounds;
+    if(animation->GetMeshBounds(meshIndex, animationBounds))
+    {
+        mesh->GrowAABB(animationBounds);
+    }
+}
+
+float* VertexAnimator::GetPositionsBuffer(uint32_t vertexCount)
+{
+    // The buffer is kept between samples and only grows, so sampling doesn't allocate once it's big enough.
+    if(mPositionsBuffer.size() < vertexCount * 3)
+    {
+        mPositionsBuffer.resize(vertexCount * 3);
+    }
+    return mPositionsBuffer.data();
+}
+
+void VertexAnimator::StopGPUPose(Material* material)
+{
+    // Switch back to the regular shader, which uses the positions in the submesh's vertex data.
+    if(material != nullptr && material->GetShader() == GetVertexAnimShader())
+    {
+        material->SetShader(GetLitShader());
+        material->SetTextureBuffer("uVertexPoses", nullptr);
     }
 }
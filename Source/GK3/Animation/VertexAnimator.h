@@ -7,11 +7,14 @@
 #include "Component.h"
 
 #include <functional>
+#include <vector>
 
 #include "Heading.h"
 #include "Profiler.h" // For Stopwatch
 #include "Vector3.h"
 
+class Material;
+class Mesh;
 class MeshRenderer;
 class VertexAnimation;
 
@@ -81,6 +84,19 @@ private:
     // To work around that, we'll use this timer to track how long a VertexAnimator is disabled.
     Stopwatch mDisabledTimer;
 
+    // When possible, vertex poses are blended on the GPU, which avoids blending and uploading positions every frame.
+    // When that's happening, the animation and time of the last sample are needed to apply the final pose when the animation stops.
+    bool mUsingGPUPoses = false;
+    float mLastSampleTime = 0.0f;
+
+    // When poses are blended on the CPU, positions are written to this buffer before being passed to the submesh.
+    std::vector<float> mPositionsBuffer;
+
     void TakeSample(VertexAnimation* animation, int frame);
-    void TakeSample(VertexAnimation* animation, float time);
+    void TakeSample(VertexAnimation* animation, float time, bool allowGPU = true);
+
+    void GrowMeshAABB(VertexAnimation* animation, int meshIndex, Mesh* mesh);
+
+    float* GetPositionsBuffer(uint32_t vertexCount);
+    void StopGPUPose(Material* material);
 };
@@ -673,7 +673,6 @@ Vector3 GameCamera::ResolveCollisions(const Vector3& startPosition, const Vector
         bool collided = false;
         float smallestT = 1.0f;
         Vector3 collisionNormal;
-        Triangle collideTriangle;
 
         // Create sphere at current position.
         Sphere sphere(currentPosition, kCameraColliderRadius);
@@ -705,61 +704,28 @@ Vector3 GameCamera::ResolveCollisions(const Vector3& startPosition, const Vector
                         collided = true;
                         smallestT = sphereT;
                         collisionNormal = normal;
-                        collideTriangle = tri;
                     }
                 }
             }
         }
         */
 
-        // Check collision against each individual triangle of each bounds model.
+        // Check collision against the triangles of each bounds model.
+        // Each mesh's triangle BVH narrows this down to just the triangles near the camera's path.
         for(auto& model : mBoundsModels)
         {
             auto& meshes = model->GetMeshes();
             for(auto& mesh : meshes)
             {
                 // Bounds model is positioned at (0,0,0) in world space (so no need to multiply local to world...it's identity).
-                Matrix4 meshToWorld = mesh->GetMeshToLocalMatrix();
-
-                auto submeshes = mesh->GetSubmeshes();
-                for(auto& submesh : submeshes)
+                // Record the t/normal if it's smaller than any previously discovered one.
+                float sphereT = smallestT;
+                Vector3 normal;
+                if(mesh->SweepSphere(mesh->GetMeshToLocalMatrix(), sphere, currentMoveOffset, sphereT, normal))
                 {
-                    int triangleCount = submesh->GetTriangleCount();
-                    for(int i = 0; i < triangleCount; ++i)
-                    {
-                        Vector3 p0, p1, p2;
-                        if(submesh->GetTriangle(i, p0, p1, p2))
-                        {
-                            // Transform triangle to world space.
-                            p0 = meshToWorld.TransformPoint(p0);
-                            p1 = meshToWorld.TransformPoint(p1);
-                            p2 = meshToWorld.TransformPoint(p2);
-                            Triangle triangle(p0, p1, p2);
-
-                            // Check collision and record the t/normal if it's smaller than any previously discovered one.
-                            float sphereT = 0.0f;
-                            Vector3 normal;
-                            if(Collide::SphereTriangle(sphere, triangle, currentMoveOffset, sphereT, normal))
-                            {
-                                // If a triangle reports a negative-t collision, it means we are already intersecting it.
-                                // We better be actively intersecting in this case.
-                                //TODO: Probably Collide::SphereTriangle should handle this internally?
-                                Vector3 intersectPoint;
-                                if(sphereT < 0.0f && !Intersect::TestSphereTriangle(sphere, triangle, intersectPoint))
-                                {
-                                    continue;
-                                }
-
-                                if(sphereT < smallestT)
-                                {
-                                    collided = true;
-                                    smallestT = sphereT;
-                                    collisionNormal = normal;
-                                    collideTriangle = triangle;
-                                }
-                            }
-                        }
-                    }
+                    collided = true;
+                    smallestT = sphereT;
+                    collisionNormal = normal;
                 }
             }
         }
@@ -776,9 +742,6 @@ Vector3 GameCamera::ResolveCollisions(const Vector3& startPosition, const Vector
             break;
         }
 
-        //Debug::DrawTriangle(collideTriangle, Color32::Yellow);
-        //Debug::DrawLine(collideTriangle.GetCenter(), collideTriangle.GetCenter() + collideTriangle.GetNormal() * 5.0f, Color32::Yellow);
-
         // We DID collide with something, so the camera's movement was cut short. This means only a portion of its velocity was utilized.
         // If we just stopped here, the camera's movement would be quite jerky and hard to control.
         // To have it "glide" along walls and obstacles, we must "redirect" remaining velocity in a new direction and then do collision checks again.
@@ -21,6 +21,7 @@ public:
     void Update();
 
     bool IsValidLocation(const std::string& locationCode) const;
+    const std::string_map_ci<std::string>& GetLocationCodes() const { return mLocCodeShortToLocCodeLong; }
     void DumpLocations() const;
 
     void ChangeLocation(const std::string& location, std::function<void()> callback = nullptr);
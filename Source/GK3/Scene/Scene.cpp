@@ -257,6 +257,9 @@ void Scene::Load()
         actor->SetRotation(scenePosition->heading.ToQuaternion());
     }
 
+    // Now that all BSPActors exist, map BSP objects to them for raycasts.
+    UpdateBSPActorsByObjectIndex();
+
     // Init construction system.
     mConstruction.Init(this, mSceneData);
 }
@@ -503,20 +506,23 @@ namespace
 
 SceneCastResult Scene::Raycast(const Ray& ray, bool interactiveOnly, GKObject** ignore, int ignoreCount) const
 {
-    // First, iterate all Props and Actors to find the closest one that was hit by the ray and meets our criteria (if any).
+    // First, find the closest Prop or Actor that was hit by the ray and meets our criteria (if any).
+    // Rather than check every Prop and Actor, only check ones whose bounds the ray hits, nearest first.
+    // Once something is hit, anything with bounds further away can't be closer, so it can be skipped.
+    UpdateRaycastTree();
     SceneCastResult result;
-    for(GKObject* object : mPropsAndActors)
-    {
+    mRaycastTree.Raycast(ray, FLT_MAX, [&](uint32_t objectIndex, float aabbT) {
+        GKObject* object = mPropsAndActors[objectIndex];
+
         // Ignore inactive objects.
-        if(!object->IsActive()) { continue; }
+        if(!object->IsActive()) { return result.hitInfo.t; }
 
         // Completely ignore anything in the ignore list. It doesn't exist to us.
-        if(IsInIgnoreList(ignore, ignoreCount, object)) { continue; }
+        if(IsInIgnoreList(ignore, ignoreCount, object)) { return result.hitInfo.t; }
 
         // See if the ray hits this object's 3D model.
         RaycastHit hitInfo;
-        MeshRenderer* meshRenderer = object->GetMeshRenderer();
-        if(meshRenderer != nullptr && meshRenderer->Raycast(ray, hitInfo))
+        if(object->GetMeshRenderer()->Raycast(ray, hitInfo))
         {
             // We did hit the 3D model, but is it closer than anything else we've hit thus far?
             if(hitInfo.t < result.hitInfo.t)
@@ -537,7 +543,8 @@ SceneCastResult Scene::Raycast(const Ray& ray, bool interactiveOnly, GKObject**
                 }
             }
         }
-    }
+        return result.hitInfo.t;
+    });
 
     // The raycast logic for Actors/Props doesn't automatically fill in the HitInfo name field.
     // So, if something was hit, do that now.
@@ -561,25 +568,16 @@ SceneCastResult Scene::Raycast(const Ray& ray, bool interactiveOnly, GKObject**
         result.hitObject = nullptr;
 
         // Try to identify a BSPActor that correlates to the BSP geometry that was hit (and also meets our other criteria).
-        for(BSPActor* object : mBSPActors)
+        BSPActor* object = bspHitInfo.index >= 0 && bspHitInfo.index < static_cast<int>(mBSPActorsByObjectIndex.size()) ?
+                           mBSPActorsByObjectIndex[bspHitInfo.index] : nullptr;
+        if(object != nullptr && !IsInIgnoreList(ignore, ignoreCount, object))
         {
-            // Name matches means that this BSPActor corresponds to the BSP geometry that was hit!
-            if(StringUtil::EqualsIgnoreCase(object->GetName(), bspHitInfo.name))
-            {
-                //printf("Raycast hit BSPActor %s, t=%f\n", object->GetName().c_str(), bspHitInfo.t);
-
-                // Completely ignore anything in the ignore list. It doesn't exist to us.
-                if(IsInIgnoreList(ignore, ignoreCount, object)) { break; }
+            //printf("Raycast hit BSPActor %s, t=%f\n", object->GetName().c_str(), bspHitInfo.t);
 
-                // As long as this object meets the interactivity criteria, this BSPActor is our hit object.
-                if(interactiveOnly && !object->CanInteract())
-                {
-                    result.hitObject = nullptr;
-                }
-                else
-                {
-                    result.hitObject = object;
-                }
+            // As long as this object meets the interactivity criteria, this BSPActor is our hit object.
+            if(!interactiveOnly || object->CanInteract())
+            {
+                result.hitObject = object;
             }
         }
     }
@@ -1152,6 +1150,9 @@ void Scene::SetOverrideBSP(BSP* bsp)
             mOverrideBSP->SetHitTest(hitTest->GetName(), true);
         }
     }
+
+    // BSP objects may have different indexes in the new BSP.
+    UpdateBSPActorsByObjectIndex();
 }
 
 void Scene::ClearOverrideBSP()
@@ -1161,6 +1162,7 @@ void Scene::ClearOverrideBSP()
 
     // Revert to rendering the original scene's BSP.
     gRenderer.SetBSP(mSceneData != nullptr ? mSceneData->GetBSP() : nullptr);
+    UpdateBSPActorsByObjectIndex();
 }
 
 void Scene::ApplyAmbientLightColorToActors()
@@ -1186,6 +1188,57 @@ BSP* Scene::GetBSP() const
     return mSceneData != nullptr ? mSceneData->GetBSP() : nullptr;
 }
 
+void Scene::UpdateRaycastTree() const
+{
+    // Props and actors are only ever added when the scene loads. If the list has grown since the tree was built, start over.
+    if(mRaycastTreeEntries.size() != mPropsAndActors.size())
+    {
+        mRaycastTree.Clear();
+        mRaycastTreeEntries.clear();
+        mRaycastTreeEntries.resize(mPropsAndActors.size());
+    }
+
+    for(size_t i = 0; i < mPropsAndActors.size(); ++i)
+    {
+        // Only objects with models can be hit by raycasts.
+        MeshRenderer* meshRenderer = mPropsAndActors[i]->GetMeshRenderer();
+        if(meshRenderer == nullptr) { continue; }
+
+        // Only update the tree if the object's bounds may have changed since last time.
+        RaycastTreeEntry& entry = mRaycastTreeEntries[i];
+        uint32_t aabbChangeCount = meshRenderer->GetAABBChangeCount();
+        if(entry.id == AABBTree::kInvalidId)
+        {
+            entry.id = mRaycastTree.Add(meshRenderer->GetAABB(), static_cast<uint32_t>(i));
+        }
+        else if(entry.aabbChangeCount != aabbChangeCount)
+        {
+            mRaycastTree.Update(entry.id, meshRenderer->GetAABB());
+        }
+        entry.aabbChangeCount = aabbChangeCount;
+    }
+}
+
+void Scene::UpdateBSPActorsByObjectIndex()
+{
+    // BSP raycasts identify the object hit by index. Map each index to the BSPActor for that object, if any.
+    // This depends on which BSP is being used, since BSPActors are matched to BSP objects by name.
+    mBSPActorsByObjectIndex.clear();
+    BSP* bsp = GetBSP();
+    if(bsp == nullptr) { return; }
+    for(BSPActor* actor : mBSPActors)
+    {
+        uint32_t objectIndex = bsp->GetObjectIndex(actor->GetName());
+        if(objectIndex == UINT32_MAX) { continue; }
+
+        if(objectIndex >= mBSPActorsByObjectIndex.size())
+        {
+            mBSPActorsByObjectIndex.resize(objectIndex + 1, nullptr);
+        }
+        mBSPActorsByObjectIndex[objectIndex] = actor;
+    }
+}
+
 void Scene::ExecuteAction(const Action* action)
 {
     // Ignore nulls.
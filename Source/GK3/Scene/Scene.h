@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "AABBTree.h"
 #include "Collisions.h"
 #include "SceneConstruction.h"
 #include "SceneData.h"
@@ -152,9 +153,24 @@ private:
     // Just "props".
     std::vector<GKProp*> mProps;
 
+    // A tree of prop/actor bounds, used to quickly find which props/actors a ray may hit.
+    // Each prop/actor's entry in the tree is updated when raycasting, if its bounds may have changed since the last raycast.
+    // Bounds in the tree are a bit bigger than the actual bounds, so moving objects (e.g. walking actors) don't need the tree to change every frame.
+    struct RaycastTreeEntry
+    {
+        uint32_t id = AABBTree::kInvalidId;
+        uint32_t aabbChangeCount = 0;
+    };
+    mutable AABBTree mRaycastTree = AABBTree(10.0f);
+    mutable std::vector<RaycastTreeEntry> mRaycastTreeEntries;
+
     // Actors in the BSP.
     std::vector<BSPActor*> mBSPActors;
 
+    // For each object in the current BSP, the BSPActor for that object (or null if none).
+    // Allows identifying the BSPActor hit by a BSP raycast without comparing names.
+    std::vector<BSPActor*> mBSPActorsByObjectIndex;
+
     // Actors that are marked as hit test models.
     std::vector<BSPActor*> mHitTestActors;
 
@@ -185,6 +201,8 @@ private:
 
     void ApplyAmbientLightColorToActors();
     BSP* GetBSP() const;
+    void UpdateRaycastTree() const;
+    void UpdateBSPActorsByObjectIndex();
     void ExecuteAction(const Action* action);
 };
 
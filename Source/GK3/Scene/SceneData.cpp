@@ -3,6 +3,7 @@
 #include "ActionManager.h"
 #include "AssetManager.h"
 #include "BSP.h"
+#include "FileSystem.h"
 #include "ReportManager.h"
 #include "SheepManager.h"
 #include "Skybox.h"
@@ -62,6 +63,24 @@ void SceneData::ResolveSceneData()
     // Load the desired scene asset - chosen based on settings block.
     mSceneAsset = gAssetManager.LoadSceneAsset(mGeneralSettings.sceneAssetName, AssetScope::Scene);
 
+    // The BSP, lightmap, and walker boundary are the biggest assets in the scene, and they don't depend on one another.
+    // Preload them as a batch, so they can be decompressed/parsed in parallel. The loads below then just hit the cache.
+    if(mSceneAsset != nullptr)
+    {
+        auto withExtension = [](const std::string& name, const std::string& extension) {
+            return Path::HasExtension(name) ? name : name + extension;
+        };
+        std::vector<std::string> preloadNames = {
+            withExtension(mSceneAsset->GetBSPName(), ".BSP"),
+            withExtension(mGeneralSettings.sceneAssetName, ".MUL")
+        };
+        if(!mGeneralSettings.walkerBoundaryTextureName.empty())
+        {
+            preloadNames.push_back(withExtension(mGeneralSettings.walkerBoundaryTextureName, ".BMP"));
+        }
+        gAssetManager.PreloadAssets(preloadNames, AssetScope::Scene);
+    }
+
     // Load the BSP data, which is specified by the scene model.
     // If this is null, the game will still work...but there's no BSP geometry!
     if(mSceneAsset != nullptr)
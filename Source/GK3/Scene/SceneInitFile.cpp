@@ -99,7 +99,7 @@ TYPEINFO_INIT(SceneInitFile, Asset, GENERATE_TYPE_ID)
 
 SceneInitFile::~SceneInitFile()
 {
-    //TODO: delete any block conditions - we own them after compiling!
+    // Block conditions are cached/owned by the SheepManager, so there's nothing to delete here.
 }
 
 void SceneInitFile::Load(uint8_t* data, uint32_t dataLength)
@@ -177,7 +177,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         {
             // Why is this called "Int Evaluation"? Not sure - but testing in GK3 seems to suggest it is...
             general.conditionText = section.condition;
-            general.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            general.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Handle all key/value pairs in this block.
@@ -290,7 +290,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             cameraBlock.conditionText = section.condition;
-            cameraBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            cameraBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Handle creation of each camera in this block.
@@ -334,7 +334,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             cameraBlock.conditionText = section.condition;
-            cameraBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            cameraBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Handle creation of each camera in this block.
@@ -386,7 +386,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             cameraBlock.conditionText = section.condition;
-            cameraBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            cameraBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Handle creation of each camera in this block.
@@ -432,7 +432,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             cameraBlock.conditionText = section.condition;
-            cameraBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            cameraBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Create each camera in this block.
@@ -500,7 +500,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             positionBlock.conditionText = section.condition;
-            positionBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            positionBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Create each scene position.
@@ -544,7 +544,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             actorBlock.conditionText = section.condition;
-            actorBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            actorBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Create each actor defined in the block.
@@ -607,7 +607,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             modelBlock.conditionText = section.condition;
-            modelBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            modelBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Create each model defined in block.
@@ -701,7 +701,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             regionBlock.conditionText = section.condition;
-            regionBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            regionBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Create each region.
@@ -736,7 +736,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             triggerBlock.conditionText = section.condition;
-            triggerBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            triggerBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Create each trigger defined.
@@ -769,7 +769,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             soundtrackBlock.conditionText = section.condition;
-            soundtrackBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            soundtrackBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Add soundtracks.
@@ -793,7 +793,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             conversationBlock.conditionText = section.condition;
-            conversationBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            conversationBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         // Add conversation settings.
@@ -842,7 +842,7 @@ void SceneInitFile::ParseFromData(uint8_t* data, uint32_t dataLength)
         if(!section.condition.empty())
         {
             actionBlock.conditionText = section.condition;
-            actionBlock.condition = gSheepManager.Compile("Int Evaluation", section.condition);
+            actionBlock.condition = gSheepManager.CompileCached("Int Evaluation", section.condition);
         }
 
         for(auto& line : section.lines)
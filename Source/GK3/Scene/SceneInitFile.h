@@ -246,6 +246,8 @@ public:
     const SceneActor* FindCurrentEgo() const;
     GeneralBlock FindCurrentGeneralBlock() const;
 
+    const std::vector<GeneralBlock>& GetGeneralBlocks() const { return mGeneralBlocks; }
+
     const std::vector<ConditionalBlock<SceneActor>>& GetActorBlocks() const { return mActors; }
 
     const std::vector<ConditionalBlock<SceneModel>>& GetModelBlocks() const { return mModels; }
@@ -99,6 +99,9 @@ void SceneManager::LoadSceneInternal()
 
     // Once loading is done, init scene and away we go.
     Loader::DoAfterLoading([this](){
+        // Loading is done, so textures queued for upload during the scene load can now be uploaded to the GPU.
+        gAssetManager.UploadPreloadedTextures();
+
         mScene->Init();
         mSceneLoading = false;
 
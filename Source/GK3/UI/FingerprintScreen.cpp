@@ -417,11 +417,12 @@ void FingerprintScreen::Show(const std::string& nounName)
 
             // Set fingerprint texture on the image.
             FingerprintObject::Fingerprint& fp = mActiveObject->fingerprints[fpIndex];
+            // The black background of the fingerprint texture is made transparent with a chroma key.
             Texture* printTexture = gAssetManager.LoadTexture(fp.textureName);
-            printTexture->SetTransparentColor(Color32::Black);
             //Texture* alphaTexture = gAssetManager.LoadTexture(printTexture->GetNameNoExtension() + "A");
             //printTexture->ApplyAlphaChannel(*alphaTexture, true);
             mPrintsToCollect[imageIndex].image->SetTexture(printTexture, true);
+            mPrintsToCollect[imageIndex].image->SetChromaKey(Color32::Black);
 
             // Enable the image and position it correctly.
             mPrintsToCollect[imageIndex].image->SetEnabled(true);
@@ -368,7 +368,7 @@ void SidneyAnalyze::AnalyzeImage_OnViewGeometryButtonPressed()
         // Play initial video.
         gActionManager.StartManualAction();
         AnalyzeImage_PlayVideo("TenierGeoA.avi", mAnalyzeVideoImages[0], "TENIERGEOA.BMP", [this](){
-            mAnalyzeVideoImages[0]->GetTexture()->SetTransparentColor(Color32(0, 255, 0));
+            mAnalyzeVideoImages[0]->SetChromaKey(Color32(0, 255, 0));
 
             // Says something about the result of the first video.
             ShowAnalyzeMessage("GeometryTenier2", Vector2(190.0f, -160.0f), HorizontalAlignment::Center, true);
@@ -376,7 +376,7 @@ void SidneyAnalyze::AnalyzeImage_OnViewGeometryButtonPressed()
 
                 // Play another video.
                 AnalyzeImage_PlayVideo("TenierGeob.avi", mAnalyzeVideoImages[0], "TENIERGEOB.BMP", [this](){
-                    mAnalyzeVideoImages[0]->GetTexture()->SetTransparentColor(Color32(0, 255, 0));
+                    mAnalyzeVideoImages[0]->SetChromaKey(Color32(0, 255, 0));
 
                     // Says something about the result of the second video.
                     ShowAnalyzeMessage("GeometryTenier3", Vector2(190.0f, -160.0f), HorizontalAlignment::Center, true);
@@ -384,7 +384,7 @@ void SidneyAnalyze::AnalyzeImage_OnViewGeometryButtonPressed()
 
                         // Show tilted square.
                         mAnalyzeVideoImages[0]->SetTexture(gAssetManager.LoadTexture("TENIERGEOC.BMP", AssetScope::Scene));
-                        mAnalyzeVideoImages[0]->GetTexture()->SetTransparentColor(Color32(0, 255, 0));
+                        mAnalyzeVideoImages[0]->SetChromaKey(Color32(0, 255, 0));
                         gAudioManager.PlaySFX(gAssetManager.LoadAudio("SIDBUTTON4.WAV"));
                         ShowAnalyzeMessage("GeometryTenier4", Vector2(190.0f, -160.0f), HorizontalAlignment::Center, true);
 
@@ -540,6 +540,7 @@ void SidneyAnalyze::AnalyzeImage_ResetVideoImage(UIImage* image)
 {
     image->GetRectTransform()->SetAnchoredPosition(mAnalyzeImage->GetRectTransform()->GetAnchoredPosition());
     image->GetRectTransform()->SetSizeDelta(mAnalyzeImage->GetRectTransform()->GetSizeDelta());
+    image->ClearChromaKey();
     image->SetEnabled(false);
 }
 
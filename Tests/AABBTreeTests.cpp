@@ -0,0 +1,178 @@
+//
+// Clark Kromenaker
+//
+// Tests for AABBTree class.
+//
+#include "catch.hh"
+#include "AABBTree.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+namespace
+{
+    // Slab test of a ray against a box, to compare against tree results.
+    bool TestRayBox(const Ray& ray, const AABB& aabb, float& outT)
+    {
+        float tMin = 0.0f;
+        float tMax = FLT_MAX;
+        for(int i = 0; i < 3; ++i)
+        {
+            float invDirection = 1.0f / ray.direction[i];
+            float t1 = (aabb.GetMin()[i] - ray.origin[i]) * invDirection;
+            float t2 = (aabb.GetMax()[i] - ray.origin[i]) * invDirection;
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+        outT = tMin;
+        return tMin <= tMax;
+    }
+
+    AABB RandomAABB(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> posDist(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> sizeDist(1.0f, 10.0f);
+        Vector3 min(posDist(random), posDist(random), posDist(random));
+        return AABB(min, min + Vector3(sizeDist(random), sizeDist(random), sizeDist(random)));
+    }
+
+    Ray RandomRay(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> posDist(-120.0f, 120.0f);
+        std::uniform_real_distribution<float> dirDist(-1.0f, 1.0f);
+        Vector3 direction(dirDist(random), dirDist(random), dirDist(random));
+        if(direction.GetLengthSq() < 0.01f)
+        {
+            direction = Vector3::UnitX;
+        }
+        return Ray(Vector3(posDist(random), posDist(random), posDist(random)), Vector3::Normalize(direction));
+    }
+}
+
+TEST_CASE("AABBTree raycast finds objects")
+{
+    AABBTree tree;
+    REQUIRE(tree.GetHeight() == -1);
+
+    // Three boxes along the x-axis, and one off to the side.
+    tree.Add(AABB(Vector3(10.0f, -1.0f, -1.0f), Vector3(12.0f, 1.0f, 1.0f)), 0);
+    tree.Add(AABB(Vector3(20.0f, -1.0f, -1.0f), Vector3(22.0f, 1.0f, 1.0f)), 1);
+    uint32_t id = tree.Add(AABB(Vector3(30.0f, -1.0f, -1.0f), Vector3(32.0f, 1.0f, 1.0f)), 2);
+    tree.Add(AABB(Vector3(10.0f, 10.0f, -1.0f), Vector3(12.0f, 12.0f, 1.0f)), 3);
+
+    // A ray down the x-axis visits the three boxes along it, nearest first.
+    Ray ray(Vector3::Zero, Vector3::UnitX);
+    std::vector<uint32_t> visited;
+    tree.Raycast(ray, FLT_MAX, [&visited](uint32_t objectIndex, float t) {
+        visited.push_back(objectIndex);
+        return FLT_MAX;
+    });
+    REQUIRE(visited == std::vector<uint32_t>({ 0, 1, 2 }));
+
+    // If the first box counts as a hit, nothing further is visited.
+    visited.clear();
+    tree.Raycast(ray, FLT_MAX, [&visited](uint32_t objectIndex, float t) {
+        visited.push_back(objectIndex);
+        return t;
+    });
+    REQUIRE(visited == std::vector<uint32_t>({ 0 }));
+
+    // Move the last box out of the way.
+    REQUIRE(tree.Update(id, AABB(Vector3(30.0f, 10.0f, -1.0f), Vector3(32.0f, 12.0f, 1.0f))));
+    visited.clear();
+    tree.Raycast(ray, FLT_MAX, [&visited](uint32_t objectIndex, float t) {
+        visited.push_back(objectIndex);
+        return FLT_MAX;
+    });
+    REQUIRE(visited == std::vector<uint32_t>({ 0, 1 }));
+
+    // Remove the rest.
+    tree.Remove(id);
+    tree.Clear();
+    REQUIRE(tree.GetHeight() == -1);
+    visited.clear();
+    tree.Raycast(ray, FLT_MAX, [&visited](uint32_t objectIndex, float t) {
+        visited.push_back(objectIndex);
+        return FLT_MAX;
+    });
+    REQUIRE(visited.empty());
+}
+
+TEST_CASE("AABBTree fattens bounds")
+{
+    AABBTree tree(2.0f);
+    uint32_t id = tree.Add(AABB(Vector3::Zero, Vector3::One), 7);
+    REQUIRE(tree.GetObjectIndex(id) == 7);
+    REQUIRE(tree.GetFatAABB(id).GetMin() == Vector3(-2.0f, -2.0f, -2.0f));
+    REQUIRE(tree.GetFatAABB(id).GetMax() == Vector3(3.0f, 3.0f, 3.0f));
+
+    // Small moves stay within the fattened bounds, so the tree doesn't change.
+    REQUIRE_FALSE(tree.Update(id, AABB(Vector3(1.0f, 1.0f, 1.0f), Vector3(2.0f, 2.0f, 2.0f))));
+    REQUIRE(tree.GetFatAABB(id).GetMin() == Vector3(-2.0f, -2.0f, -2.0f));
+
+    // Larger moves re-fatten around the new bounds.
+    REQUIRE(tree.Update(id, AABB(Vector3(10.0f, 10.0f, 10.0f), Vector3(11.0f, 11.0f, 11.0f))));
+    REQUIRE(tree.GetFatAABB(id).GetMin() == Vector3(8.0f, 8.0f, 8.0f));
+    REQUIRE(tree.GetFatAABB(id).GetMax() == Vector3(13.0f, 13.0f, 13.0f));
+}
+
+TEST_CASE("AABBTree raycasts match brute force")
+{
+    // Add lots of random boxes, then move and remove some of them.
+    std::mt19937 random(4321);
+    AABBTree tree(1.0f);
+    const uint32_t kObjectCount = 500;
+    std::vector<uint32_t> ids(kObjectCount);
+    for(uint32_t i = 0; i < kObjectCount; ++i)
+    {
+        ids[i] = tree.Add(RandomAABB(random), i);
+    }
+    for(uint32_t i = 0; i < kObjectCount; i += 3)
+    {
+        tree.Update(ids[i], RandomAABB(random));
+    }
+    std::set<uint32_t> removed;
+    for(uint32_t i = 1; i < kObjectCount; i += 7)
+    {
+        tree.Remove(ids[i]);
+        removed.insert(i);
+    }
+
+    // The tree should stay balanced. A perfectly balanced tree would have a height of about 9.
+    REQUIRE(tree.GetHeight() <= 16);
+
+    for(int rayIndex = 0; rayIndex < 200; ++rayIndex)
+    {
+        Ray ray = RandomRay(random);
+
+        // Brute force: every remaining object whose fattened bounds the ray hits.
+        std::set<uint32_t> expected;
+        float expectedNearestT = FLT_MAX;
+        for(uint32_t i = 0; i < kObjectCount; ++i)
+        {
+            float t = 0.0f;
+            if(removed.count(i) == 0 && TestRayBox(ray, tree.GetFatAABB(ids[i]), t))
+            {
+                expected.insert(i);
+                expectedNearestT = std::min(expectedNearestT, t);
+            }
+        }
+
+        // Visiting all objects should find the same ones.
+        std::set<uint32_t> visited;
+        tree.Raycast(ray, FLT_MAX, [&visited](uint32_t objectIndex, float t) {
+            visited.insert(objectIndex);
+            return FLT_MAX;
+        });
+        REQUIRE(visited == expected);
+
+        // Treating boxes as solid, the nearest hit should match too.
+        float nearestT = FLT_MAX;
+        tree.Raycast(ray, FLT_MAX, [&nearestT](uint32_t objectIndex, float t) {
+            nearestT = std::min(nearestT, t);
+            return nearestT;
+        });
+        REQUIRE(nearestT == Approx(expectedNearestT));
+    }
+}
@@ -0,0 +1,47 @@
+//
+// Clark Kromenaker
+//
+// Tests for Frustum class.
+//
+#include "catch.hh"
+#include "Frustum.h"
+
+#include "AABB.h"
+#include "Matrix4.h"
+
+TEST_CASE("Frustum contains point")
+{
+    // An identity matrix produces a frustum that is a cube from -1 to 1 on each axis.
+    Frustum frustum(Matrix4::Identity);
+    REQUIRE(frustum.ContainsPoint(Vector3::Zero));
+    REQUIRE(frustum.ContainsPoint(Vector3(0.9f, -0.9f, 0.9f)));
+    REQUIRE_FALSE(frustum.ContainsPoint(Vector3(1.5f, 0.0f, 0.0f)));
+    REQUIRE_FALSE(frustum.ContainsPoint(Vector3(0.0f, 0.0f, -2.0f)));
+}
+
+TEST_CASE("Frustum intersects AABB")
+{
+    Frustum frustum(Matrix4::Identity);
+
+    // Fully inside.
+    REQUIRE(frustum.IntersectsAABB(AABB(Vector3(-0.5f, -0.5f, -0.5f), Vector3(0.5f, 0.5f, 0.5f))));
+
+    // Fully contains the frustum.
+    REQUIRE(frustum.IntersectsAABB(AABB(Vector3(-10.0f, -10.0f, -10.0f), Vector3(10.0f, 10.0f, 10.0f))));
+
+    // Partially overlapping one side.
+    REQUIRE(frustum.IntersectsAABB(AABB(Vector3(0.5f, 0.0f, 0.0f), Vector3(2.0f, 0.5f, 0.5f))));
+
+    // Flat box (zero size on one axis) inside the frustum.
+    REQUIRE(frustum.IntersectsAABB(AABB(Vector3(-0.5f, 0.0f, -0.5f), Vector3(0.5f, 0.0f, 0.5f))));
+
+    // Entirely outside on various sides.
+    REQUIRE_FALSE(frustum.IntersectsAABB(AABB(Vector3(2.0f, 0.0f, 0.0f), Vector3(3.0f, 0.5f, 0.5f))));
+    REQUIRE_FALSE(frustum.IntersectsAABB(AABB(Vector3(0.0f, -3.0f, 0.0f), Vector3(0.5f, -2.0f, 0.5f))));
+    REQUIRE_FALSE(frustum.IntersectsAABB(AABB(Vector3(0.0f, 0.0f, 5.0f), Vector3(0.5f, 0.5f, 6.0f))));
+
+    // Moving the frustum (by transforming it) changes what's inside.
+    Frustum movedFrustum(Matrix4::MakeTranslate(Vector3(-2.5f, 0.0f, 0.0f)));
+    REQUIRE(movedFrustum.IntersectsAABB(AABB(Vector3(2.0f, 0.0f, 0.0f), Vector3(3.0f, 0.5f, 0.5f))));
+    REQUIRE_FALSE(movedFrustum.IntersectsAABB(AABB(Vector3(-0.5f, -0.5f, -0.5f), Vector3(0.5f, 0.5f, 0.5f))));
+}
@@ -0,0 +1,122 @@
+//
+// Clark Kromenaker
+//
+// Tests for the null graphics API, which tracks resources and counts calls rather than rendering.
+//
+#include "catch.hh"
+#include "GAPI_Null.h"
+
+#include "Matrix4.h"
+
+TEST_CASE("Null GAPI tracks resources")
+{
+    GAPI_Null gapi;
+
+    TextureHandle texture = gapi.CreateTexture(4, 4, Texture::Format::RGBA, nullptr);
+    BufferHandle uniformBuffer = gapi.CreateUniformBuffer(64);
+    ShaderHandle shader = gapi.CreateShader(nullptr, nullptr);
+    REQUIRE(gapi.GetResources().textures == 1);
+    REQUIRE(gapi.GetResources().uniformBuffers == 1);
+    REQUIRE(gapi.GetResources().shaders == 1);
+
+    // Texture buffers can't be empty.
+    REQUIRE(gapi.CreateTextureBuffer(0, nullptr) == nullptr);
+    REQUIRE(gapi.GetResources().textureBuffers == 0);
+
+    gapi.DestroyTexture(texture);
+    gapi.DestroyUniformBuffer(uniformBuffer);
+    gapi.DestroyShader(shader);
+    REQUIRE(gapi.GetResources().textures == 0);
+    REQUIRE(gapi.GetResources().uniformBuffers == 0);
+    REQUIRE(gapi.GetResources().shaders == 0);
+}
+
+TEST_CASE("Null GAPI counts draws, state changes, and uploads")
+{
+    GAPI_Null gapi;
+
+    // Create a triangle's worth of vertices (positions only) and a quad's worth of indexes.
+    VertexDefinition vertexDefinition;
+    vertexDefinition.attributes.push_back(VertexAttribute::Position);
+    float positions[9] = { 0.0f };
+    BufferHandle vertexBuffer = gapi.CreateVertexBuffer(3, vertexDefinition, positions, MeshUsage::Static);
+    uint16_t indexes[6] = { 0, 1, 2, 2, 1, 0 };
+    BufferHandle indexBuffer = gapi.CreateIndexBuffer(6, indexes, MeshUsage::Static);
+    REQUIRE(gapi.GetStats().bytesUploaded == sizeof(positions) + sizeof(indexes));
+
+    // Uploading single-channel pixels counts one byte per pixel.
+    TextureHandle texture = gapi.CreateTexture(8, 8, Texture::Format::R8, nullptr);
+    gapi.ResetStats();
+    gapi.StreamTexturePixels(texture, 8, 8, Texture::Format::R8, nullptr, 16);
+    REQUIRE(gapi.GetStats().bytesUploaded == 64);
+
+    // Draw a frame.
+    gapi.ResetStats();
+    gapi.ActivateTexture(texture);
+    gapi.SetBlendEnabled(true);
+    gapi.Draw(GAPI::Primitive::Triangles, vertexBuffer);
+    gapi.Draw(GAPI::Primitive::Triangles, vertexBuffer, indexBuffer);
+    gapi.Draw(GAPI::Primitive::Triangles, vertexBuffer, indexBuffer, 3, 3);
+    gapi.Present();
+    REQUIRE(gapi.GetLastFrameStats().drawCalls == 3);
+    REQUIRE(gapi.GetLastFrameStats().verticesDrawn == 3 + 6 + 3);
+    REQUIRE(gapi.GetLastFrameStats().stateChanges == 2);
+
+    // The next frame's stats start over, but running stats keep accumulating.
+    gapi.Draw(GAPI::Primitive::Lines, vertexBuffer, 0, 2);
+    gapi.Present();
+    REQUIRE(gapi.GetLastFrameStats().drawCalls == 1);
+    REQUIRE(gapi.GetLastFrameStats().stateChanges == 0);
+    REQUIRE(gapi.GetStats().drawCalls == 4);
+
+    gapi.DestroyVertexBuffer(vertexBuffer);
+    gapi.DestroyIndexBuffer(indexBuffer);
+    gapi.DestroyTexture(texture);
+    REQUIRE(gapi.GetResources().vertexBuffers == 0);
+    REQUIRE(gapi.GetResources().indexBuffers == 0);
+}
+
+TEST_CASE("Null GAPI reports uniforms declared in shader source")
+{
+    GAPI_Null gapi;
+
+    const char* vertSource =
+        "#version 330\n"
+        "layout(std140) uniform FrameUniforms\n"
+        "{\n"
+        "    mat4 gViewMatrix;\n"
+        "};\n"
+        "uniform mat4 gObjectToWorldMatrix;\n"
+        "uniform int uPoseOffsetFrom = 0; // uniform float uCommentedOut;\n"
+        "/* uniform vec4 uAlsoCommentedOut; */\n"
+        "uniform vec4 uColors[4];\n";
+    const char* fragSource =
+        "#version 330\n"
+        "uniform sampler2D uDiffuse;\n"
+        "uniform mat4 gObjectToWorldMatrix;\n";
+    ShaderHandle shader = gapi.CreateShader(reinterpret_cast<const uint8_t*>(vertSource), reinterpret_cast<const uint8_t*>(fragSource));
+
+    // Uniform block members and commented out declarations don't count, and uniforms in both shaders are only reported once.
+    std::vector<Uniform> uniforms;
+    gapi.GetShaderUniforms(shader, uniforms);
+    REQUIRE(uniforms.size() == 4);
+    REQUIRE(uniforms[0].name == "gObjectToWorldMatrix");
+    REQUIRE(uniforms[0].type == UniformType::Matrix4);
+    REQUIRE(uniforms[1].name == "uPoseOffsetFrom");
+    REQUIRE(uniforms[1].type == UniformType::Int);
+    REQUIRE(uniforms[2].name == "uColors[0]");
+    REQUIRE(uniforms[2].type == UniformType::Vector4);
+    REQUIRE(uniforms[3].name == "uDiffuse");
+    REQUIRE(uniforms[3].type == UniformType::Texture2D);
+    for(size_t i = 0; i < uniforms.size(); ++i)
+    {
+        REQUIRE(uniforms[i].location == static_cast<int>(i));
+    }
+
+    // So setting them counts toward stats, just like it would with a real graphics API.
+    gapi.ResetStats();
+    gapi.SetShaderUniformMatrix4(shader, uniforms[0].location, Matrix4::Identity);
+    gapi.SetShaderUniformInt(shader, uniforms[1].location, 3);
+    REQUIRE(gapi.GetStats().uniformsSet == 2);
+    gapi.DestroyShader(shader);
+}
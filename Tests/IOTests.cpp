@@ -6,10 +6,12 @@
 #include "catch.hh"
 
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 
 #include "BinaryReader.h"
 #include "BinaryWriter.h"
+#include "MemoryMappedFile.h"
 
 TEST_CASE("Read/Write binary memory works")
 {
@@ -121,4 +123,44 @@ TEST_CASE("Read/Write binary memory works")
 
     reader.Skip(100);
     REQUIRE(reader.GetPosition() == 100);
+}
+
+TEST_CASE("Memory mapped file matches file contents")
+{
+    const char* filePath = "MemoryMappedFileTest.bin";
+
+    // Write some data out to a file.
+    {
+        BinaryWriter writer(filePath);
+        REQUIRE(writer.OK());
+        writer.WriteUInt(0x21334B47);
+        writer.WriteUInt(8675309);
+        writer.Write("Barn", 4);
+    }
+
+    // Map the file and check its contents.
+    {
+        MemoryMappedFile mappedFile;
+        REQUIRE(!mappedFile.IsOpen());
+        REQUIRE(mappedFile.Open(filePath));
+        REQUIRE(mappedFile.IsOpen());
+        REQUIRE(mappedFile.GetSize() == 12);
+
+        // Mapped memory can be read just like any other memory.
+        BinaryReader reader(mappedFile.GetData(), mappedFile.GetSize());
+        REQUIRE(reader.ReadUInt() == 0x21334B47);
+        REQUIRE(reader.ReadUInt() == 8675309);
+        REQUIRE(memcmp(mappedFile.GetData() + 8, "Barn", 4) == 0);
+
+        mappedFile.Close();
+        REQUIRE(!mappedFile.IsOpen());
+        REQUIRE(mappedFile.GetData() == nullptr);
+        REQUIRE(mappedFile.GetSize() == 0);
+    }
+    remove(filePath);
+
+    // Mapping a file that doesn't exist fails gracefully.
+    MemoryMappedFile missingFile;
+    REQUIRE(!missingFile.Open(filePath));
+    REQUIRE(!missingFile.IsOpen());
 }
\ No newline at end of file
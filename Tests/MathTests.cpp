@@ -5,6 +5,7 @@
 //
 #include "catch.hh"
 #include "GMath.h"
+#include "Interpolate.h"
 
 TEST_CASE("Floating-point comparison works")
 {
@@ -18,3 +19,30 @@ TEST_CASE("Math::Abs works")
 {
     REQUIRE(Math::Abs(-5.0f) == 5.0f);
 }
+
+TEST_CASE("Interpolate::Linear works on arrays")
+{
+    // Use a count that isn't a multiple of four, to cover both the SIMD and leftover paths.
+    const uint32_t kCount = 11;
+    float a[kCount];
+    float b[kCount];
+    for(uint32_t i = 0; i < kCount; ++i)
+    {
+        a[i] = static_cast<float>(i);
+        b[i] = static_cast<float>(i) * -2.0f + 10.0f;
+    }
+
+    float out[kCount];
+    Interpolate::Linear(a, b, 0.25f, out, kCount);
+    for(uint32_t i = 0; i < kCount; ++i)
+    {
+        REQUIRE(Math::AreEqual(out[i], Interpolate::Linear(a[i], b[i], 0.25f)));
+    }
+
+    // Output can be the same as an input.
+    Interpolate::Linear(a, b, 1.0f, a, kCount);
+    for(uint32_t i = 0; i < kCount; ++i)
+    {
+        REQUIRE(Math::AreEqual(a[i], b[i]));
+    }
+}
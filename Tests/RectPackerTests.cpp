@@ -0,0 +1,106 @@
+//
+// Clark Kromenaker
+//
+// Tests for RectPacker class.
+//
+#include "catch.hh"
+#include "RectPacker.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("RectPacker places rects on shelves")
+{
+    RectPacker packer(64, 64);
+
+    // First rect starts the first shelf in the top-left corner.
+    uint32_t x = 0;
+    uint32_t y = 0;
+    REQUIRE(packer.Pack(32, 16, x, y));
+    REQUIRE(x == 0);
+    REQUIRE(y == 0);
+
+    // A shorter rect fits next to it on the same shelf.
+    REQUIRE(packer.Pack(16, 8, x, y));
+    REQUIRE(x == 32);
+    REQUIRE(y == 0);
+
+    // A rect too wide for the remaining shelf space starts a new shelf.
+    REQUIRE(packer.Pack(32, 8, x, y));
+    REQUIRE(x == 0);
+    REQUIRE(y == 16);
+    REQUIRE(packer.GetUsedHeight() == 24);
+
+    // A small rect prefers the shelf that wastes the least height.
+    REQUIRE(packer.Pack(8, 8, x, y));
+    REQUIRE(x == 32);
+    REQUIRE(y == 16);
+}
+
+TEST_CASE("RectPacker fails when out of room")
+{
+    RectPacker packer(32, 32);
+    uint32_t x = 0;
+    uint32_t y = 0;
+
+    // Too big to ever fit.
+    REQUIRE_FALSE(packer.Pack(33, 1, x, y));
+    REQUIRE_FALSE(packer.Pack(1, 33, x, y));
+
+    // Fill the area exactly, then nothing else fits.
+    REQUIRE(packer.Pack(32, 16, x, y));
+    REQUIRE(packer.Pack(16, 16, x, y));
+    REQUIRE(packer.Pack(16, 16, x, y));
+    REQUIRE(packer.GetUsedHeight() == 32);
+    REQUIRE_FALSE(packer.Pack(1, 1, x, y));
+}
+
+TEST_CASE("RectPacker never overlaps rects")
+{
+    struct PackedRect
+    {
+        uint32_t x, y, width, height;
+    };
+
+    // Pack random rects, tallest-first, until the area is full.
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint32_t> sizeDist(1, 40);
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;
+    for(int i = 0; i < 300; ++i)
+    {
+        sizes.emplace_back(sizeDist(rng), sizeDist(rng));
+    }
+    std::sort(sizes.begin(), sizes.end(), [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+        return a.second > b.second;
+    });
+
+    RectPacker packer(256, 256);
+    std::vector<PackedRect> packed;
+    for(auto& size : sizes)
+    {
+        PackedRect rect { 0, 0, size.first, size.second };
+        if(packer.Pack(rect.width, rect.height, rect.x, rect.y))
+        {
+            packed.push_back(rect);
+        }
+    }
+    REQUIRE(!packed.empty());
+
+    for(size_t i = 0; i < packed.size(); ++i)
+    {
+        // In bounds.
+        REQUIRE(packed[i].x + packed[i].width <= 256);
+        REQUIRE(packed[i].y + packed[i].height <= 256);
+
+        // No overlap with any other rect.
+        for(size_t j = i + 1; j < packed.size(); ++j)
+        {
+            bool separate = packed[i].x + packed[i].width <= packed[j].x ||
+                            packed[j].x + packed[j].width <= packed[i].x ||
+                            packed[i].y + packed[i].height <= packed[j].y ||
+                            packed[j].y + packed[j].height <= packed[i].y;
+            REQUIRE(separate);
+        }
+    }
+}
@@ -0,0 +1,299 @@
+//
+// Clark Kromenaker
+//
+// Tests for the thread pool, parallel-for, and job graphs.
+//
+#include "catch.hh"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "JobGraph.h"
+#include "ThreadPool.h"
+
+TEST_CASE("Task function stores small and large callables")
+{
+    // Small callables are stored inline.
+    int value = 0;
+    TaskFunction small([&value]() { value += 1; });
+    REQUIRE(small);
+    small();
+    REQUIRE(value == 1);
+
+    // Large callables go on the heap, but work the same way.
+    char padding[TaskFunction::kInlineSize * 2] = { };
+    padding[0] = 10;
+    TaskFunction large([&value, padding]() { value += padding[0]; });
+    large();
+    REQUIRE(value == 11);
+
+    // Moving transfers the callable, and leaves the source empty.
+    TaskFunction moved(std::move(small));
+    REQUIRE(moved);
+    REQUIRE(!small);
+    moved();
+    REQUIRE(value == 12);
+
+    // Captured state is destroyed along with the task.
+    std::shared_ptr<int> shared = std::make_shared<int>(0);
+    TaskFunction holder([shared]() { });
+    REQUIRE(shared.use_count() == 2);
+    holder.Reset();
+    REQUIRE(shared.use_count() == 1);
+
+    // Empty std::functions create empty tasks.
+    std::function<void()> emptyFunc;
+    TaskFunction empty(emptyFunc);
+    REQUIRE(!empty);
+}
+
+TEST_CASE("Thread pool runs tasks")
+{
+    ThreadPool::Init(2);
+    REQUIRE(ThreadPool::GetThreadCount() == 2);
+
+    // Add more tasks than there are job slots, to make sure slots are reused.
+    const int kTaskCount = 10000;
+    std::atomic<int> counter { 0 };
+    std::vector<JobHandle> handles;
+    for(int i = 0; i < kTaskCount; ++i)
+    {
+        handles.push_back(ThreadPool::AddTask([&counter]() { ++counter; }));
+    }
+    bool allComplete = true;
+    for(JobHandle& handle : handles)
+    {
+        ThreadPool::WaitFor(handle);
+        allComplete &= ThreadPool::IsComplete(handle);
+    }
+    REQUIRE(allComplete);
+    REQUIRE(counter == kTaskCount);
+
+    // Invalid handles are always complete.
+    REQUIRE(ThreadPool::IsComplete(JobHandle()));
+    ThreadPool::Shutdown();
+}
+
+TEST_CASE("Thread pool respects dependencies")
+{
+    ThreadPool::Init(2);
+
+    // A chain of continuations must run in order.
+    std::atomic<int> nextExpected { 0 };
+    std::atomic<int> outOfOrderCount { 0 };
+    JobHandle last;
+    for(int i = 0; i < 100; ++i)
+    {
+        last = ThreadPool::AddContinuation(last, [i, &nextExpected, &outOfOrderCount]() {
+            if(nextExpected++ != i)
+            {
+                ++outOfOrderCount;
+            }
+        });
+    }
+    ThreadPool::WaitFor(last);
+    REQUIRE(nextExpected == 100);
+    REQUIRE(outOfOrderCount == 0);
+
+    // A task with multiple dependencies waits for all of them.
+    std::atomic<int> doneCount { 0 };
+    JobHandle first = ThreadPool::AddTask([&doneCount]() { ++doneCount; });
+    JobHandle second = ThreadPool::AddTask([&doneCount]() { ++doneCount; });
+    int doneCountSeen = 0;
+    JobHandle joined = ThreadPool::AddTask([&doneCount, &doneCountSeen]() { doneCountSeen = doneCount; }, { first, second });
+    ThreadPool::WaitFor(joined);
+    REQUIRE(doneCountSeen == 2);
+
+    // Depending on an already completed task is fine.
+    bool ran = false;
+    ThreadPool::WaitFor(ThreadPool::AddContinuation(joined, [&ran]() { ran = true; }));
+    REQUIRE(ran);
+    ThreadPool::Shutdown();
+}
+
+TEST_CASE("Parallel for covers the whole range exactly once")
+{
+    ThreadPool::Init(2);
+
+    // Try a variety of grain sizes, including ones that don't evenly divide the range.
+    const size_t kCount = 10007;
+    for(size_t grainSize : { 0, 1, 7, 64, 1000, 20000 })
+    {
+        std::vector<std::atomic<int>> visits(kCount);
+        for(auto& visit : visits)
+        {
+            visit = 0;
+        }
+
+        std::atomic<size_t> maxChunkSize { 0 };
+        ThreadPool::ParallelFor(0, kCount, grainSize, [&visits, &maxChunkSize](size_t begin, size_t end) {
+            for(size_t i = begin; i < end; ++i)
+            {
+                ++visits[i];
+            }
+
+            size_t chunkSize = end - begin;
+            size_t prevMax = maxChunkSize;
+            while(chunkSize > prevMax && !maxChunkSize.compare_exchange_weak(prevMax, chunkSize)) { }
+        });
+
+        bool allVisitedOnce = true;
+        for(auto& visit : visits)
+        {
+            allVisitedOnce &= (visit == 1);
+        }
+        REQUIRE(allVisitedOnce);
+        REQUIRE(maxChunkSize <= (grainSize == 0 ? 1 : grainSize));
+    }
+
+    // Empty ranges do nothing.
+    bool called = false;
+    ThreadPool::ParallelFor(5, 5, 1, [&called](size_t begin, size_t end) { called = true; });
+    REQUIRE(!called);
+
+    // Parallel fors can be nested (e.g. inside a task), without deadlocking.
+    std::atomic<int> total { 0 };
+    ThreadPool::ParallelFor(0, 8, 1, [&total](size_t begin, size_t end) {
+        ThreadPool::ParallelFor(0, 100, 10, [&total](size_t innerBegin, size_t innerEnd) {
+            total += static_cast<int>(innerEnd - innerBegin);
+        });
+    });
+    REQUIRE(total == 800);
+    ThreadPool::Shutdown();
+}
+
+TEST_CASE("Job graph runs jobs after their dependencies")
+{
+    ThreadPool::Init(2);
+
+    // A diamond: A -> (B, C) -> D
+    std::atomic<int> order { 0 };
+    int a = -1, b = -1, c = -1, d = -1;
+    JobGraph graph;
+    uint32_t jobA = graph.AddJob([&]() { a = order++; });
+    uint32_t jobB = graph.AddJob([&]() { b = order++; }, { jobA });
+    uint32_t jobC = graph.AddJob([&]() { c = order++; }, { jobA });
+    graph.AddJob([&]() { d = order++; }, { jobB, jobC });
+    REQUIRE(graph.GetJobCount() == 4);
+
+    graph.RunAndWait();
+    REQUIRE(graph.IsComplete());
+    REQUIRE(a == 0);
+    REQUIRE(b > a);
+    REQUIRE(c > a);
+    REQUIRE(d == 3);
+
+    // Dependencies on jobs that don't exist yet are ignored.
+    JobGraph badGraph;
+    bool ran = false;
+    badGraph.AddJob([&ran]() { ran = true; }, { 5 });
+    badGraph.RunAndWait();
+    REQUIRE(ran);
+    ThreadPool::Shutdown();
+}
+
+TEST_CASE("Waiting doesn't run unrelated jobs")
+{
+    ThreadPool::Init(1);
+    std::thread::id testThreadId = std::this_thread::get_id();
+
+    // Keep the only worker busy until the end of the test, so anything else queued stays queued unless the waiting thread runs it.
+    std::atomic<bool> workerStarted { false };
+    std::atomic<bool> releaseWorker { false };
+    JobHandle blocker = ThreadPool::AddTask([&workerStarted, &releaseWorker]() {
+        workerStarted = true;
+        while(!releaseWorker)
+        {
+            std::this_thread::yield();
+        }
+    });
+    while(!workerStarted)
+    {
+        std::this_thread::yield();
+    }
+
+    // Queue a long unrelated job (e.g. loading) in the middle of a parallel for. The parallel for must not pick it up.
+    std::atomic<bool> unrelatedRanOnTestThread { false };
+    auto unrelatedJob = [testThreadId, &unrelatedRanOnTestThread]() {
+        if(std::this_thread::get_id() == testThreadId)
+        {
+            unrelatedRanOnTestThread = true;
+        }
+    };
+    JobHandle unrelated;
+    std::atomic<int> total { 0 };
+    ThreadPool::ParallelFor(0, 100, 10, [&](size_t begin, size_t end) {
+        if(begin == 0)
+        {
+            unrelated = ThreadPool::AddTask(unrelatedJob);
+        }
+        total += static_cast<int>(end - begin);
+    });
+    REQUIRE(total == 100);
+    REQUIRE(!ThreadPool::IsComplete(unrelated));
+
+    // Same for job graphs. Here, the second job is only queued once the first is done, behind the unrelated job.
+    JobGraph graph;
+    int order = 0;
+    int first = -1;
+    int second = -1;
+    uint32_t firstJob = graph.AddJob([&order, &first]() { first = order++; });
+    graph.AddJob([&order, &second]() { second = order++; }, { firstJob });
+    graph.Run();
+    JobHandle unrelated2 = ThreadPool::AddTask(unrelatedJob);
+    graph.Wait();
+    REQUIRE(first == 0);
+    REQUIRE(second == 1);
+    REQUIRE(!ThreadPool::IsComplete(unrelated2));
+
+    // Once the worker is free, it runs the unrelated jobs.
+    releaseWorker = true;
+    ThreadPool::WaitFor(blocker);
+    while(!ThreadPool::IsComplete(unrelated) || !ThreadPool::IsComplete(unrelated2))
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(!unrelatedRanOnTestThread);
+    ThreadPool::Shutdown();
+}
+
+TEST_CASE("Priority tasks run before other queued tasks")
+{
+    ThreadPool::Init(1);
+
+    // Keep the only worker busy while queuing, so the order the queued tasks run in is up to the pool.
+    std::atomic<bool> workerStarted { false };
+    std::atomic<bool> releaseWorker { false };
+    ThreadPool::AddTask([&workerStarted, &releaseWorker]() {
+        workerStarted = true;
+        while(!releaseWorker)
+        {
+            std::this_thread::yield();
+        }
+    });
+    while(!workerStarted)
+    {
+        std::this_thread::yield();
+    }
+
+    // Only the worker thread touches these, one task at a time.
+    int order = 0;
+    int normal = -1;
+    int priority1 = -1;
+    int priority2 = -1;
+    JobHandle normalJob = ThreadPool::AddTask([&order, &normal]() { normal = order++; });
+    JobHandle priorityJob1 = ThreadPool::AddPriorityTask([&order, &priority1]() { priority1 = order++; });
+    JobHandle priorityJob2 = ThreadPool::AddPriorityTask([&order, &priority2]() { priority2 = order++; });
+
+    releaseWorker = true;
+    while(!ThreadPool::IsComplete(normalJob) || !ThreadPool::IsComplete(priorityJob1) || !ThreadPool::IsComplete(priorityJob2))
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(priority1 == 0);
+    REQUIRE(priority2 == 1);
+    REQUIRE(normal == 2);
+    ThreadPool::Shutdown();
+}
@@ -0,0 +1,218 @@
+//
+// Clark Kromenaker
+//
+// Tests for TriangleBVH class.
+//
+#include "catch.hh"
+#include "TriangleBVH.h"
+
+#include <random>
+
+#include "Matrix4.h"
+#include "Sphere.h"
+#include "Triangle.h"
+
+namespace
+{
+    // Finds the nearest triangle hit by testing every triangle, to compare against BVH results.
+    int RaycastBruteForce(const std::vector<Triangle>& triangles, const std::vector<uint32_t>& flags, const Ray& ray,
+                          uint32_t flagMask, bool cullBackfaces, float& outRayT)
+    {
+        int nearestIndex = -1;
+        float nearestT = FLT_MAX;
+        for(size_t i = 0; i < triangles.size(); ++i)
+        {
+            if((flags[i] & flagMask) == 0) { continue; }
+            if(cullBackfaces && Vector3::Dot(ray.direction, triangles[i].GetNormal()) >= 0.0f) { continue; }
+
+            float t = 0.0f;
+            if(Intersect::TestRayTriangle(ray, triangles[i], t) && t < nearestT)
+            {
+                nearestT = t;
+                nearestIndex = static_cast<int>(i);
+            }
+        }
+        outRayT = nearestT;
+        return nearestIndex;
+    }
+
+    // Finds the first triangle hit by a moving sphere by testing every triangle, to compare against BVH results.
+    int SweepSphereBruteForce(const std::vector<Triangle>& triangles, const Matrix4& toSphereSpace, const Sphere& sphere,
+                              const Vector3& moveOffset, float& outSphereT)
+    {
+        int nearestIndex = -1;
+        float nearestT = 1.0f;
+        for(size_t i = 0; i < triangles.size(); ++i)
+        {
+            Triangle triangle(toSphereSpace.TransformPoint(triangles[i].p0),
+                              toSphereSpace.TransformPoint(triangles[i].p1),
+                              toSphereSpace.TransformPoint(triangles[i].p2));
+            float t = 0.0f;
+            Vector3 normal;
+            Vector3 intersectPoint;
+            if(Collide::SphereTriangle(sphere, triangle, moveOffset, t, normal) && t < nearestT &&
+               (t >= 0.0f || Intersect::TestSphereTriangle(sphere, triangle, intersectPoint)))
+            {
+                nearestT = t;
+                nearestIndex = static_cast<int>(i);
+            }
+        }
+        outSphereT = nearestT;
+        return nearestIndex;
+    }
+}
+
+TEST_CASE("TriangleBVH raycast hits nearest triangle")
+{
+    // Two triangles facing -z, one behind the other.
+    TriangleBVH bvh;
+    uint32_t nearIndex = bvh.AddTriangle(Vector3(-1.0f, -1.0f, 5.0f), Vector3(0.0f, 1.0f, 5.0f), Vector3(1.0f, -1.0f, 5.0f), 1);
+    uint32_t farIndex = bvh.AddTriangle(Vector3(-1.0f, -1.0f, 10.0f), Vector3(0.0f, 1.0f, 10.0f), Vector3(1.0f, -1.0f, 10.0f), 2);
+    bvh.Build();
+
+    Ray ray(Vector3::Zero, Vector3::UnitZ);
+    float t = 0.0f;
+    REQUIRE(bvh.Raycast(ray, 1 | 2, false, t) == nearIndex);
+    REQUIRE(t == Approx(5.0f));
+
+    // Filtering by flags skips the near triangle.
+    REQUIRE(bvh.Raycast(ray, 2, false, t) == farIndex);
+    REQUIRE(t == Approx(10.0f));
+
+    // No triangle has this flag.
+    REQUIRE(bvh.Raycast(ray, 4, false, t) == -1);
+
+    // Rejecting a hit in the accept callback moves on to the next nearest.
+    int index = bvh.Raycast(ray, 1 | 2, false, t, [nearIndex](uint32_t triangleIndex, float u, float v) {
+        return triangleIndex != nearIndex;
+    });
+    REQUIRE(index == farIndex);
+
+    // Changing flags is respected once node flags are updated.
+    bvh.SetFlags(farIndex, 4);
+    bvh.UpdateNodeFlags();
+    REQUIRE(bvh.GetFlags(farIndex) == 4);
+    REQUIRE(bvh.Raycast(ray, 4, false, t) == farIndex);
+    REQUIRE(bvh.Raycast(ray, 2, false, t) == -1);
+
+    // Pointing away from the triangles misses.
+    REQUIRE(bvh.Raycast(Ray(Vector3::Zero, -Vector3::UnitZ), 1 | 2 | 4, false, t) == -1);
+}
+
+TEST_CASE("TriangleBVH raycast matches brute force")
+{
+    // Generate a bunch of random triangles, with random flags.
+    std::default_random_engine generator(12345);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+    std::uniform_int_distribution<uint32_t> flag(0, 2);
+
+    TriangleBVH bvh;
+    std::vector<Triangle> triangles;
+    std::vector<uint32_t> flags;
+    for(int i = 0; i < 2000; ++i)
+    {
+        Vector3 center(position(generator), position(generator), position(generator));
+        Triangle triangle(center + Vector3(offset(generator), offset(generator), offset(generator)),
+                          center + Vector3(offset(generator), offset(generator), offset(generator)),
+                          center + Vector3(offset(generator), offset(generator), offset(generator)));
+        triangles.push_back(triangle);
+        flags.push_back(1 << flag(generator));
+        bvh.AddTriangle(triangle.p0, triangle.p1, triangle.p2, flags.back());
+    }
+    bvh.Build();
+    REQUIRE(bvh.GetTriangleCount() == 2000);
+
+    // Fire random rays, and make sure the BVH finds the same nearest hits as testing every triangle.
+    int hitCount = 0;
+    for(int i = 0; i < 1000; ++i)
+    {
+        Ray ray(Vector3(position(generator), position(generator), position(generator)),
+                Vector3::Normalize(Vector3(offset(generator), offset(generator), offset(generator))));
+        uint32_t flagMask = (i % 2 == 0) ? 7 : 2;
+        bool cullBackfaces = (i % 3 == 0);
+
+        float expectedT = 0.0f;
+        int expected = RaycastBruteForce(triangles, flags, ray, flagMask, cullBackfaces, expectedT);
+
+        float t = 0.0f;
+        int actual = bvh.Raycast(ray, flagMask, cullBackfaces, t);
+        REQUIRE(actual == expected);
+        if(expected >= 0)
+        {
+            REQUIRE(t == expectedT);
+            ++hitCount;
+        }
+    }
+
+    // Sanity check that the test actually exercised hits.
+    REQUIRE(hitCount > 0);
+}
+
+TEST_CASE("TriangleBVH refit follows moved triangles")
+{
+    TriangleBVH bvh;
+    uint32_t index = bvh.AddTriangle(Vector3(-1.0f, -1.0f, 5.0f), Vector3(0.0f, 1.0f, 5.0f), Vector3(1.0f, -1.0f, 5.0f), 1);
+    bvh.AddTriangle(Vector3(50.0f, 50.0f, 5.0f), Vector3(51.0f, 52.0f, 5.0f), Vector3(52.0f, 50.0f, 5.0f), 1);
+    bvh.Build();
+
+    // Move the first triangle up, out of the ray's path.
+    Ray ray(Vector3::Zero, Vector3::UnitZ);
+    Ray movedRay(Vector3(0.0f, 20.0f, 0.0f), Vector3::UnitZ);
+    bvh.SetTriangle(index, Vector3(-1.0f, 19.0f, 8.0f), Vector3(0.0f, 21.0f, 8.0f), Vector3(1.0f, 19.0f, 8.0f));
+    bvh.Refit();
+
+    float t = 0.0f;
+    REQUIRE(bvh.Raycast(ray, 1, false, t) == -1);
+    REQUIRE(bvh.Raycast(movedRay, 1, false, t) == index);
+    REQUIRE(t == Approx(8.0f));
+}
+
+TEST_CASE("TriangleBVH sphere sweep matches brute force")
+{
+    // Generate a bunch of random triangles.
+    std::default_random_engine generator(54321);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> move(-30.0f, 30.0f);
+
+    TriangleBVH bvh;
+    std::vector<Triangle> triangles;
+    for(int i = 0; i < 2000; ++i)
+    {
+        Vector3 center(position(generator), position(generator), position(generator));
+        Triangle triangle(center + Vector3(offset(generator), offset(generator), offset(generator)),
+                          center + Vector3(offset(generator), offset(generator), offset(generator)),
+                          center + Vector3(offset(generator), offset(generator), offset(generator)));
+        triangles.push_back(triangle);
+        bvh.AddTriangle(triangle.p0, triangle.p1, triangle.p2, 1);
+    }
+    bvh.Build();
+
+    // Sweep random spheres, both in the triangles' own space and through a transform with non-uniform scale.
+    Matrix4 transform = Matrix4::MakeTranslate(Vector3(10.0f, -20.0f, 5.0f)) * Matrix4::MakeRotateY(0.7f) * Matrix4::MakeScale(Vector3(2.0f, 1.0f, 0.5f));
+    int hitCount = 0;
+    for(int i = 0; i < 1000; ++i)
+    {
+        const Matrix4& toSphereSpace = (i % 2 == 0) ? Matrix4::Identity : transform;
+        Sphere sphere(Vector3(position(generator), position(generator), position(generator)), 5.0f);
+        Vector3 moveOffset(move(generator), move(generator), move(generator));
+
+        float expectedT = 0.0f;
+        int expected = SweepSphereBruteForce(triangles, toSphereSpace, sphere, moveOffset, expectedT);
+
+        float t = 1.0f;
+        Vector3 normal;
+        int actual = (i % 2 == 0) ? bvh.SweepSphere(sphere, moveOffset, 1, t, normal)
+                                  : bvh.SweepSphere(sphere, moveOffset, transform, 1, t, normal);
+        REQUIRE(actual == expected);
+        if(expected >= 0)
+        {
+            REQUIRE(t == expectedT);
+            ++hitCount;
+        }
+    }
+
+    // Sanity check that the test actually exercised hits.
+    REQUIRE(hitCount > 0);
+}
@@ -0,0 +1,293 @@
+//
+// Clark Kromenaker
+//
+// Tests for WalkableGrid class.
+//
+#include "catch.hh"
+#include "WalkableGrid.h"
+
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <random>
+
+#include "ThreadPool.h"
+
+namespace
+{
+    const float kDiagonalCost = 1.41421356f;
+
+    // Finds the cost of the shortest path using a plain Dijkstra search over all 8 neighbors, to compare against jump point search results.
+    // Straight moves cost 1 and diagonal moves cost sqrt(2). Returns -1 if there's no path.
+    float FindPathCostBruteForce(const WalkableGrid& grid, int startX, int startY, int goalX, int goalY)
+    {
+        int width = grid.GetWidth();
+        int height = grid.GetHeight();
+        std::vector<float> costs(width * height, -1.0f);
+        std::vector<bool> closed(width * height, false);
+
+        typedef std::pair<float, int> OpenEntry;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openSet;
+        costs[startY * width + startX] = 0.0f;
+        openSet.push(OpenEntry(0.0f, startY * width + startX));
+        while(!openSet.empty())
+        {
+            int current = openSet.top().second;
+            openSet.pop();
+            if(closed[current]) { continue; }
+            closed[current] = true;
+
+            int x = current % width;
+            int y = current / width;
+            if(x == goalX && y == goalY) { return costs[current]; }
+
+            for(int dy = -1; dy <= 1; ++dy)
+            {
+                for(int dx = -1; dx <= 1; ++dx)
+                {
+                    if(!grid.IsWalkable(x + dx, y + dy)) { continue; }
+
+                    int neighbor = (y + dy) * width + (x + dx);
+                    if(closed[neighbor]) { continue; }
+                    float cost = costs[current] + (dx != 0 && dy != 0 ? kDiagonalCost : 1.0f);
+                    if(costs[neighbor] < 0.0f || cost < costs[neighbor])
+                    {
+                        costs[neighbor] = cost;
+                        openSet.push(OpenEntry(cost, neighbor));
+                    }
+                }
+            }
+        }
+        return -1.0f;
+    }
+}
+
+TEST_CASE("WalkableGrid stores walkable cells")
+{
+    WalkableGrid grid;
+    grid.Resize(70, 3);
+    REQUIRE(grid.GetWidth() == 70);
+    REQUIRE(grid.GetHeight() == 3);
+
+    // All cells start unwalkable.
+    REQUIRE_FALSE(grid.IsWalkable(0, 0));
+    REQUIRE_FALSE(grid.IsWalkable(69, 2));
+
+    // Cells can be set and cleared, including ones that cross a 64-bit boundary.
+    grid.SetWalkable(63, 0, true);
+    grid.SetWalkable(64, 0, true);
+    REQUIRE(grid.IsWalkable(63, 0));
+    REQUIRE(grid.IsWalkable(64, 0));
+    REQUIRE_FALSE(grid.IsWalkable(62, 0));
+    REQUIRE_FALSE(grid.IsWalkable(65, 0));
+
+    grid.SetWalkable(63, 0, false);
+    REQUIRE_FALSE(grid.IsWalkable(63, 0));
+    REQUIRE(grid.IsWalkable(64, 0));
+
+    // Out of bounds is never walkable.
+    REQUIRE_FALSE(grid.IsWalkable(-1, 0));
+    REQUIRE_FALSE(grid.IsWalkable(0, -1));
+    REQUIRE_FALSE(grid.IsWalkable(70, 0));
+    REQUIRE_FALSE(grid.IsWalkable(0, 3));
+}
+
+TEST_CASE("WalkableGrid finds path around a wall")
+{
+    // A 10x10 open grid with a wall down the middle, leaving a gap at the bottom.
+    WalkableGrid grid;
+    grid.Resize(10, 10);
+    for(uint32_t y = 0; y < 10; ++y)
+    {
+        for(uint32_t x = 0; x < 10; ++x)
+        {
+            grid.SetWalkable(x, y, x != 5 || y == 9);
+        }
+    }
+
+    std::vector<Vector2> path;
+    WalkableGrid::SearchScratch scratch;
+    REQUIRE(grid.FindPath(Vector2(0, 0), Vector2(9, 0), path, scratch));
+
+    // Goal is at the front, start is at the back.
+    REQUIRE(path.size() >= 3);
+    REQUIRE(path.front() == Vector2(9, 0));
+    REQUIRE(path.back() == Vector2(0, 0));
+
+    // Path must go through the gap.
+    bool usesGap = false;
+    for(const Vector2& point : path)
+    {
+        if(point == Vector2(5, 9)) { usesGap = true; }
+    }
+    REQUIRE(usesGap);
+
+    // Block the gap - no more path.
+    grid.SetWalkable(5, 9, false);
+    REQUIRE_FALSE(grid.FindPath(Vector2(0, 0), Vector2(9, 0), path, scratch));
+    REQUIRE(path.empty());
+}
+
+TEST_CASE("WalkableGrid paths match brute force search")
+{
+    // Generate random grids, and make sure the jump point search agrees with a brute force search.
+    // The same scratch is reused for every search, as the game does.
+    std::mt19937 random(1234);
+    WalkableGrid::SearchScratch scratch;
+    for(int gridIndex = 0; gridIndex < 20; ++gridIndex)
+    {
+        const int kSize = 40;
+        WalkableGrid grid;
+        grid.Resize(kSize, kSize);
+        std::uniform_int_distribution<int> cellDist(0, 99);
+        for(int y = 0; y < kSize; ++y)
+        {
+            for(int x = 0; x < kSize; ++x)
+            {
+                grid.SetWalkable(x, y, cellDist(random) >= 30);
+            }
+        }
+
+        std::uniform_int_distribution<int> posDist(0, kSize - 1);
+        for(int queryIndex = 0; queryIndex < 20; ++queryIndex)
+        {
+            int startX = posDist(random);
+            int startY = posDist(random);
+            int goalX = posDist(random);
+            int goalY = posDist(random);
+            grid.SetWalkable(startX, startY, true);
+            grid.SetWalkable(goalX, goalY, true);
+
+            std::vector<Vector2> path;
+            bool foundPath = grid.FindPath(Vector2(startX, startY), Vector2(goalX, goalY), path, scratch);
+            float expectedCost = FindPathCostBruteForce(grid, startX, startY, goalX, goalY);
+            REQUIRE(foundPath == (expectedCost >= 0.0f));
+            if(!foundPath || (startX == goalX && startY == goalY)) { continue; }
+
+            // Each segment must be a straight or diagonal line over walkable cells.
+            // The total cost of the segments must match the optimal cost, not just any path.
+            REQUIRE(path.front() == Vector2(goalX, goalY));
+            REQUIRE(path.back() == Vector2(startX, startY));
+            float pathCost = 0.0f;
+            for(size_t i = 0; i + 1 < path.size(); ++i)
+            {
+                int dx = static_cast<int>(path[i + 1].x - path[i].x);
+                int dy = static_cast<int>(path[i + 1].y - path[i].y);
+                REQUIRE((dx == 0 || dy == 0 || std::abs(dx) == std::abs(dy)));
+                pathCost += (dx != 0 && dy != 0) ? std::abs(dx) * kDiagonalCost : std::abs(dx) + std::abs(dy);
+
+                int stepX = (dx > 0) - (dx < 0);
+                int stepY = (dy > 0) - (dy < 0);
+                int x = static_cast<int>(path[i].x);
+                int y = static_cast<int>(path[i].y);
+                while(x != static_cast<int>(path[i + 1].x) || y != static_cast<int>(path[i + 1].y))
+                {
+                    x += stepX;
+                    y += stepY;
+                    REQUIRE(grid.IsWalkable(x, y));
+                }
+            }
+            REQUIRE(pathCost == Approx(expectedCost));
+        }
+    }
+}
+
+TEST_CASE("WalkableGrid calculates distances to walls")
+{
+    // A single walkable row: each cell's nearest wall is above/below it.
+    WalkableGrid grid;
+    grid.Resize(5, 1);
+    for(uint32_t x = 0; x < 5; ++x)
+    {
+        grid.SetWalkable(x, 0, true);
+    }
+    std::vector<float> distances;
+    grid.CalculateWallDistances(distances);
+    REQUIRE(distances.size() == 5);
+    for(float distance : distances)
+    {
+        REQUIRE(distance == Approx(1.0f));
+    }
+
+    // Compare random grids against a brute force search for the nearest wall.
+    std::mt19937 random(5678);
+    std::uniform_int_distribution<int> cellDist(0, 99);
+    for(int gridIndex = 0; gridIndex < 10; ++gridIndex)
+    {
+        const int kWidth = 30;
+        const int kHeight = 20;
+        grid.Resize(kWidth, kHeight);
+        for(int y = 0; y < kHeight; ++y)
+        {
+            for(int x = 0; x < kWidth; ++x)
+            {
+                grid.SetWalkable(x, y, cellDist(random) >= 5);
+            }
+        }
+        grid.CalculateWallDistances(distances);
+        REQUIRE(distances.size() == kWidth * kHeight);
+
+        for(int y = 0; y < kHeight; ++y)
+        {
+            for(int x = 0; x < kWidth; ++x)
+            {
+                // Check all cells, plus a border around the grid, which counts as walls.
+                int nearestSq = INT_MAX;
+                for(int wallY = -1; wallY <= kHeight; ++wallY)
+                {
+                    for(int wallX = -1; wallX <= kWidth; ++wallX)
+                    {
+                        if(grid.IsWalkable(wallX, wallY)) { continue; }
+                        int distSq = (wallX - x) * (wallX - x) + (wallY - y) * (wallY - y);
+                        nearestSq = std::min(nearestSq, distSq);
+                    }
+                }
+                REQUIRE(distances[y * kWidth + x] == Approx(std::sqrt(static_cast<float>(nearestSq))));
+            }
+        }
+    }
+}
+
+TEST_CASE("WalkableGrid searches can run on several threads at once")
+{
+    // An open grid, with rows of walls that have a gap at alternating ends.
+    const int kSize = 64;
+    WalkableGrid grid;
+    grid.Resize(kSize, kSize);
+    for(int y = 0; y < kSize; ++y)
+    {
+        for(int x = 0; x < kSize; ++x)
+        {
+            bool wall = (y % 4 == 2) && (y % 8 == 2 ? x < kSize - 2 : x > 1);
+            grid.SetWalkable(x, y, !wall);
+        }
+    }
+
+    // Find a path from each cell in the first row to the last row, one at a time.
+    std::vector<std::vector<Vector2>> expectedPaths(kSize);
+    WalkableGrid::SearchScratch scratch;
+    for(int i = 0; i < kSize; ++i)
+    {
+        REQUIRE(grid.FindPath(Vector2(i, 0), Vector2(kSize - 1 - i, kSize - 1), expectedPaths[i], scratch));
+    }
+
+    // Do the same searches on the thread pool, each with its own scratch. Results should be identical.
+    ThreadPool::Init(2);
+    std::vector<std::vector<Vector2>> paths(kSize);
+    std::vector<int> found(kSize, 0);
+    ThreadPool::ParallelFor(0, kSize, 4, [&](size_t begin, size_t end) {
+        WalkableGrid::SearchScratch threadScratch;
+        for(size_t i = begin; i < end; ++i)
+        {
+            found[i] = grid.FindPath(Vector2(i, 0), Vector2(kSize - 1 - i, kSize - 1), paths[i], threadScratch) ? 1 : 0;
+        }
+    });
+    ThreadPool::Shutdown();
+
+    for(int i = 0; i < kSize; ++i)
+    {
+        REQUIRE(found[i] == 1);
+        REQUIRE(paths[i] == expectedPaths[i]);
+    }
+}